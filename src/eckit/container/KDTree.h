@@ -38,10 +38,12 @@ public:
 
     /// ITER must be a random access iterator
     /// WARNING: container is changed (sorted)
+    /// The container is ordered in parallel (if OpenMP is available), the tree is the same as built serially
     template <typename ITER>
     void build(ITER begin, ITER end) {
-        Alloc& a    = this->alloc_;
-        this->root_ = a.convert(Node::build(a, begin, end));
+        Alloc& a = this->alloc_;
+        Node::partition(begin, end);
+        this->root_ = a.convert(Node::link(a, begin, end));
         a.root(this->root_);
     }
 
@@ -156,6 +156,81 @@ KDNode<Traits>* KDNode<Traits>::build(Alloc& a, const ITER& begin, const ITER& e
 }
 
 
+template <class Traits>
+template <typename ITER>
+void KDNode<Traits>::partition(const ITER& begin, const ITER& end, int depth) {
+#if defined(_OPENMP)
+    if (end - begin > PARTITION_GRAIN) {
+#pragma omp parallel
+#pragma omp single
+        partitionX(begin, end, depth);
+        return;
+    }
+#endif
+    partitionX(begin, end, depth);
+}
+
+
+template <class Traits>
+template <typename ITER>
+void KDNode<Traits>::partitionX(ITER begin, ITER end, int depth) {
+    // Same ordering as build(): nth_element only reorders within a range, so disjoint subranges are independent and
+    // the result does not depend on the order (or thread) in which they are processed
+    if (end - begin < 2)
+        return;
+
+    size_t k    = Point::DIMS;
+    size_t axis = depth % k;
+
+    size_t median = (end - begin) / 2;
+
+    std::nth_element(begin, begin + median, end, sorter<Value>(axis));
+
+    ITER e2 = begin + median;
+    ITER b2 = begin + median + 1;
+
+#if defined(_OPENMP)
+    if (end - begin > PARTITION_GRAIN) {
+#pragma omp task default(none) firstprivate(begin, e2, depth)
+        partitionX(begin, e2, depth + 1);
+
+        partitionX(b2, end, depth + 1);
+
+#pragma omp taskwait
+        return;
+    }
+#endif
+
+    partitionX(begin, e2, depth + 1);
+    partitionX(b2, end, depth + 1);
+}
+
+
+template <class Traits>
+template <typename ITER>
+KDNode<Traits>* KDNode<Traits>::link(Alloc& a, const ITER& begin, const ITER& end, int depth) {
+    if (end == begin)
+        return 0;
+
+    a.statsDepth(depth);
+
+    size_t k    = Point::DIMS;
+    size_t axis = depth % k;
+
+    size_t median = (end - begin) / 2;
+
+    ITER e2 = begin + median;
+    ITER b2 = begin + median + 1;
+
+    KDNode* n = a.newNode2(*e2, axis, (KDNode*)0);
+
+    n->left(a, link(a, begin, e2, depth + 1));
+    n->right(a, link(a, b2, end, depth + 1));
+
+    return n;
+}
+
+
 template <class Traits>
 KDNode<Traits>* KDNode<Traits>::insert(Alloc& a, const Value& value, KDNode<Traits>* node, int depth) {
 
@@ -37,6 +37,12 @@ private:
 
     size_t axis_;
 
+    /// Ranges up to this size are ordered by a single thread
+    static constexpr long PARTITION_GRAIN = 1L << 14;
+
+    template <typename ITER>
+    static void partitionX(ITER begin, ITER end, int depth);
+
 public:
 
     KDNode(const Value& value, size_t axis);
@@ -45,6 +51,14 @@ public:
     template <typename ITER>
     static KDNode* build(Alloc& a, const ITER& begin, const ITER& end, int depth = 0);
 
+    /// Order the range as build() does, without creating nodes; subranges are ordered in parallel (OpenMP tasks)
+    template <typename ITER>
+    static void partition(const ITER& begin, const ITER& end, int depth = 0);
+
+    /// Create the nodes of a range ordered by partition(), in the same order as build()
+    template <typename ITER>
+    static KDNode* link(Alloc& a, const ITER& begin, const ITER& end, int depth = 0);
+
     static KDNode<Traits>* insert(Alloc& a, const Value& value, KDNode<Traits>* node, int depth = 0);
 
     /// Return the axis along which this node is split.
@@ -161,16 +161,20 @@ std::vector<Point> Grid::to_points() const {
 
 std::pair<std::vector<double>, std::vector<double>> Grid::to_latlons() const {
     std::pair<std::vector<double>, std::vector<double>> ll;
-    ll.first.reserve(size());
-    ll.second.reserve(size());
+    ll.first.resize(size());
+    ll.second.resize(size());
 
-    std::for_each(cbegin(), cend(), [&ll](const auto& p) {
+    fill_latlons(ll.first.data(), ll.second.data());
+    return ll;
+}
+
+
+void Grid::fill_latlons(double* lat, double* lon) const {
+    std::for_each(cbegin(), cend(), [&lat, &lon](const auto& p) {
         auto q = std::get<PointLonLat>(p);
-        ll.first.emplace_back(q.lat());
-        ll.second.emplace_back(q.lon());
+        *lat++ = q.lat();
+        *lon++ = q.lon();
     });
-
-    return ll;
 }
 
 
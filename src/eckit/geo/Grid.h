@@ -136,6 +136,9 @@ public:
     [[nodiscard]] virtual std::vector<Point> to_points() const;
     [[nodiscard]] virtual std::pair<std::vector<double>, std::vector<double>> to_latlons() const;
 
+    /// Coordinates into caller arrays (of size() elements), in parallel where supported
+    virtual void fill_latlons(double* lat, double* lon) const;
+
     [[nodiscard]] virtual std::vector<double> distinct_latitudes() const;
     [[nodiscard]] virtual std::vector<double> distinct_longitudes() const;
 
@@ -45,6 +45,20 @@ class lock_type {
 };
 
 
+PointXY coordinates(const Point& p) {
+    if (std::holds_alternative<PointXY>(p)) {
+        return std::get<PointXY>(p);
+    }
+
+    if (std::holds_alternative<PointLonLat>(p)) {
+        const auto& q = std::get<PointLonLat>(p);
+        return {q.lon(), q.lat()};
+    }
+
+    throw exception::ProjectionError("Projection: batch transform supports lon/lat and x/y points only", Here());
+}
+
+
 }  // namespace
 
 
@@ -53,6 +67,16 @@ Projection::Projection(Figure* figure_ptr) : figure_(figure_ptr != nullptr ? fig
 }
 
 
+void Projection::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return coordinates(fwd(Point{p})); });
+}
+
+
+void Projection::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointXY>(x, y, ox, oy, n, [this](const PointXY& q) { return coordinates(inv(Point{q})); });
+}
+
+
 const Figure& Projection::figure() const {
     ASSERT(figure_);
     return *figure_;
@@ -12,9 +12,12 @@
 
 #pragma once
 
+#include <cstddef>
+#include <exception>
 #include <memory>
 #include <string>
 
+#include "eckit/eckit.h"
 #include "eckit/geo/Point.h"
 #include "eckit/memory/Builder.h"
 #include "eckit/memory/Factory.h"
@@ -59,6 +62,11 @@ public:
     virtual Point fwd(const Point&) const = 0;
     virtual Point inv(const Point&) const = 0;
 
+    /// Transform n points, given and returned as separate coordinate arrays (lon/lat or x/y, as the single point
+    /// methods); the output arrays can be the input arrays
+    virtual void fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const;
+    virtual void inv(const double* x, const double* y, double* ox, double* oy, size_t n) const;
+
     void falseXY(const PointXY& falseXY) { false_ = falseXY; }
     const PointXY& falseXY() const { return false_; }
 
@@ -79,6 +87,14 @@ public:
 
     [[nodiscard]] static Projection* make_from_spec(const Spec&);
 
+protected:
+
+    // -- Class methods
+
+    /// Apply f to n points of type P, storing the coordinates of the results (in parallel, if OpenMP is available)
+    template <typename P, typename F>
+    static void transform(const double* x, const double* y, double* ox, double* oy, size_t n, F f);
+
 private:
 
     // -- Members
@@ -96,6 +112,41 @@ private:
 };
 
 
+template <typename P, typename F>
+void Projection::transform(const double* x, const double* y, double* ox, double* oy, size_t n, F f) {
+    const auto N = static_cast<std::ptrdiff_t>(n);
+
+#if eckit_HAVE_OMP
+    std::exception_ptr error;
+
+#pragma omp parallel for schedule(static) if (N > 1024)
+    for (std::ptrdiff_t i = 0; i < N; ++i) {
+        try {
+            const auto q = f(P{x[i], y[i]});
+            ox[i]        = q.data()[0];
+            oy[i]        = q.data()[1];
+        }
+        catch (...) {
+#pragma omp critical
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+#else
+    for (std::ptrdiff_t i = 0; i < N; ++i) {
+        const auto q = f(P{x[i], y[i]});
+        ox[i]        = q.data()[0];
+        oy[i]        = q.data()[1];
+    }
+#endif
+}
+
+
 using ProjectionFactoryType = Factory<Projection>;
 using ProjectionSpecByName  = spec::GeneratorT<spec::SpecGeneratorT1<const std::string&>>;
 
@@ -72,6 +72,18 @@ void Search::closestWithinRadius(const PointType& pt, double radius, std::vector
 }
 
 
+void Search::closestNPoints(const std::vector<PointType>& pts, size_t n,
+                            std::vector<std::vector<PointValueType>>& closest) const {
+    closest = tree_->kNearestNeighboursBatch(pts, n);
+}
+
+
+void Search::closestWithinRadius(const std::vector<PointType>& pts, double radius,
+                                 std::vector<std::vector<PointValueType>>& closest) const {
+    closest = tree_->findInSphereBatch(pts, radius);
+}
+
+
 void Search::build(const Grid& r) {
     Trace trace("eckit::geo::Search: building k-d tree");
 
@@ -58,6 +58,14 @@ public:
     /// Finds closest points within a radius
     void closestWithinRadius(const PointType&, double radius, std::vector<PointValueType>& closest) const;
 
+    /// Finds closest N points to each input point
+    void closestNPoints(const std::vector<PointType>&, size_t n,
+                        std::vector<std::vector<PointValueType>>& closest) const;
+
+    /// Finds closest points within a radius of each input point
+    void closestWithinRadius(const std::vector<PointType>&, double radius,
+                             std::vector<std::vector<PointValueType>>& closest) const;
+
 private:
 
     // -- Members
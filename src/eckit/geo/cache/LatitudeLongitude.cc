@@ -12,6 +12,7 @@
 
 #include "eckit/geo/cache/LatitudeLongitude.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -47,8 +48,16 @@ struct Loader final : Cache::Loader {
         std::unique_ptr<const Grid::Spec> spec(GridSpecByUID::instance().get(uid).spec());
         ASSERT(spec);
 
+        auto read = [&uid, &record](const PathName& path) {
+            if (SharedMemory::enabled()) {
+                record.read_shared(path, "latlon-" + uid);
+                return;
+            }
+            record.read(path);
+        };
+
         if (spec->has("cached_path")) {
-            record.read(spec->get_string("cached_path"));
+            read(spec->get_string("cached_path"));
             return;
         }
 
@@ -56,7 +65,7 @@ struct Loader final : Cache::Loader {
             static cache::Download download(PathName{LibEcKitGeo::cacheDir()} / "latlon" /
                                             std::to_string(cache::Download::version()));
 
-            record.read(download.to_cached_path(LibEcKitGeo::url(spec->get_string("url")), "", ".ek"));
+            read(download.to_cached_path(LibEcKitGeo::url(spec->get_string("url")), "", ".ek"));
             return;
         }
 
@@ -102,6 +111,36 @@ void LatitudeLongitude::read(const PathName& p) {
     record.wait();
 
     ASSERT(lat_.size() == lon_.size());
+    shared_.reset();
+}
+
+
+void LatitudeLongitude::read_shared(const PathName& p, const std::string& name) {
+    struct Reader final : SharedMemory::Loader {
+        explicit Reader(const PathName& path) : path(path) {}
+
+        SharedMemory::bytes_size_t load() override {
+            ll.read(path);
+            return ll.footprint();
+        }
+
+        void fill(void* data) const override {
+            auto* lat = static_cast<double*>(data);
+            auto* lon = std::copy(ll.lat_.begin(), ll.lat_.end(), lat);
+            std::copy(ll.lon_.begin(), ll.lon_.end(), lon);
+        }
+
+        const PathName& path;
+        LatitudeLongitude ll;
+    } reader(p);
+
+    shared_ = std::make_unique<const SharedMemory>(name, reader);
+    ASSERT(shared_->size() % (2 * sizeof(double)) == 0);
+
+    lat_.clear();
+    lat_.shrink_to_fit();
+    lon_.clear();
+    lon_.shrink_to_fit();
 }
 
 
@@ -116,8 +155,15 @@ void LatitudeLongitude::write(const PathName& p) const {
         record.compression(cmp);
     }
 
-    record.set("latitude", codec::ref(lat_));
-    record.set("longitude", codec::ref(lon_));
+    std::vector<double> lat;
+    std::vector<double> lon;
+    if (shared_) {
+        lat.assign(latitude().begin(), latitude().end());
+        lon.assign(longitude().begin(), longitude().end());
+    }
+
+    record.set("latitude", codec::ref(shared_ ? lat : lat_));
+    record.set("longitude", codec::ref(shared_ ? lon : lon_));
     record.write(p);
 }
 
@@ -146,7 +192,19 @@ PathName LatitudeLongitude::to_cached_path() const {
 
 
 size_t LatitudeLongitude::size() const {
-    return lat_.size();
+    return shared_ ? shared_->size() / (2 * sizeof(double)) : lat_.size();
+}
+
+
+util::span<const double> LatitudeLongitude::longitude() const {
+    return shared_ ? util::span<const double>{static_cast<const double*>(shared_->data()) + size(), size()}
+                   : util::span<const double>{lon_};
+}
+
+
+util::span<const double> LatitudeLongitude::latitude() const {
+    return shared_ ? util::span<const double>{static_cast<const double*>(shared_->data()), size()}
+                   : util::span<const double>{lat_};
 }
 
 
@@ -12,11 +12,15 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "eckit/filesystem/PathName.h"
 #include "eckit/geo/Grid.h"
 #include "eckit/geo/cache/RecordCache.h"
+#include "eckit/geo/cache/SharedMemory.h"
+#include "eckit/geo/util/span.h"
 
 
 namespace eckit::geo::cache {
@@ -38,17 +42,22 @@ public:
     void read(const PathName&) override;
     void write(const PathName&) const;
 
+    /// Read into shared memory segment (name), or attach to it if published by another process
+    void read_shared(const PathName&, const std::string& name);
+
     PathName to_cached_path() const;
 
     size_t size() const;
 
-    const std::vector<double>& longitude() const { return lon_; }
-    const std::vector<double>& latitude() const { return lat_; }
+    util::span<const double> longitude() const;
+    util::span<const double> latitude() const;
 
 private:
 
     std::vector<double> lon_;
     std::vector<double> lat_;
+
+    std::unique_ptr<const SharedMemory> shared_;  // (latitudes then longitudes)
 };
 
 
@@ -15,6 +15,8 @@
 #include <algorithm>
 #include <vector>
 
+#include "eckit/geo/cache/SharedMemory.h"
+
 
 namespace eckit::geo::cache {
 
@@ -36,6 +38,11 @@ void MemoryCache::total_purge() {
 }
 
 
+MemoryCache::bytes_size_t MemoryCache::total_footprint_shared() {
+    return SharedMemory::total_footprint();
+}
+
+
 MemoryCache::MemoryCache() {
     util::lock_guard<util::recursive_mutex> lock(MUTEX);
     CACHES.emplace_back(this);
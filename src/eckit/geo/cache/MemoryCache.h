@@ -30,6 +30,9 @@ public:
     static bytes_size_t total_footprint();
     static void total_purge();
 
+    /// Part of the total footprint in shared memory (mapped by, but not private to, this process)
+    static bytes_size_t total_footprint_shared();
+
 protected:
 
     MemoryCache();
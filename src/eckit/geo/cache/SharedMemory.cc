@@ -0,0 +1,314 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "eckit/geo/cache/SharedMemory.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/geo/LibEcKitGeo.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/memory/MMap.h"
+#include "eckit/os/Stat.h"
+
+
+namespace eckit::geo::cache {
+
+
+namespace {
+
+
+enum state_type : uint32_t
+{
+    BUILDING = 0,  // (zero-initialised by ftruncate)
+    READY,
+    FAILED,
+    UNLINKED,
+};
+
+
+struct Header {
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> users;
+    uint64_t size;
+};
+
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "SharedMemory: atomics in shared memory are lock-free");
+
+
+size_t header_size() {
+    // page-aligned payload, so it can be protected independently
+    static const auto size = std::max(sizeof(Header), static_cast<size_t>(::sysconf(_SC_PAGESIZE)));
+    return size;
+}
+
+
+std::string shm_name(const std::string& name) {
+    auto n = "/eckit-geo-" + std::to_string(::getuid()) + "-" + name;
+    std::replace(n.begin() + 1, n.end(), '/', '-');
+    return n;
+}
+
+
+std::atomic<SharedMemory::bytes_size_t> FOOTPRINT{0};
+
+
+struct Wait {
+    Wait() : start_(std::chrono::steady_clock::now()) {}
+
+    void operator()(const std::string& name) const {
+        static const auto timeout =
+            LibResource<int, LibEcKitGeo>("eckit-geo-cache-shared-timeout;$ECKIT_GEO_CACHE_SHARED_TIMEOUT", 600);
+
+        if (timeout > 0 && std::chrono::steady_clock::now() - start_ > std::chrono::seconds(timeout)) {
+            throw TimeOut("SharedMemory: waiting for '" + name + "' to be published", static_cast<unsigned long>(timeout));
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    const std::chrono::steady_clock::time_point start_;
+};
+
+
+}  // namespace
+
+
+SharedMemory::SharedMemory(const std::string& name, Loader& loader) : name_(shm_name(name)) {
+    try {
+        for (;;) {
+            if (auto fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600); fd >= 0) {
+                publish(fd, loader);
+                return;
+            }
+
+            if (errno != EEXIST) {
+                throw FailedSystemCall("shm_open(" + name_ + ", O_CREAT | O_EXCL)", Here(), errno);
+            }
+
+            if (auto fd = ::shm_open(name_.c_str(), O_RDWR, 0600); fd >= 0) {
+                if (attach(fd)) {
+                    return;
+                }
+            }
+            else if (errno != ENOENT) {
+                throw FailedSystemCall("shm_open(" + name_ + ")", Here(), errno);
+            }
+
+            // failed to publish or unlinked concurrently, try again
+        }
+    }
+    catch (...) {
+        detach();
+        throw;
+    }
+}
+
+
+SharedMemory::~SharedMemory() {
+    detach();
+}
+
+
+const void* SharedMemory::data() const {
+    ASSERT(map_ != nullptr);
+    return static_cast<const char*>(map_) + header_size();
+}
+
+
+bool SharedMemory::enabled() {
+    static const auto shared = LibResource<bool, LibEcKitGeo>("eckit-geo-cache-shared;$ECKIT_GEO_CACHE_SHARED", false);
+    return shared;
+}
+
+
+SharedMemory::bytes_size_t SharedMemory::total_footprint() {
+    return FOOTPRINT;
+}
+
+
+void SharedMemory::remove(const std::string& name) {
+    if (auto n = shm_name(name); ::shm_unlink(n.c_str()) != 0 && errno != ENOENT) {
+        throw FailedSystemCall("shm_unlink(" + n + ")", Here(), errno);
+    }
+}
+
+
+void SharedMemory::publish(int fd, Loader& loader) {
+    std::exception_ptr error;
+
+    bytes_size_t size = 0;
+    try {
+        size = loader.load();
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    // resize once (a header is needed to signal failure)
+    if (::ftruncate(fd, static_cast<off_t>(header_size() + size)) != 0) {
+        const auto err = errno;
+        ::shm_unlink(name_.c_str());
+        ::close(fd);
+        throw FailedSystemCall("ftruncate(" + name_ + ")", Here(), err);
+    }
+
+    try {
+        map(fd, size);
+    }
+    catch (...) {
+        ::shm_unlink(name_.c_str());
+        throw;
+    }
+    ::close(fd);
+
+    auto* header = static_cast<Header*>(map_);
+    header->users.fetch_add(1);
+
+    if (!error) {
+        try {
+            loader.fill(static_cast<char*>(map_) + header_size());
+        }
+        catch (...) {
+            // (a payload that cannot be backed raises SIGBUS, not an exception)
+            error = std::current_exception();
+        }
+    }
+
+    if (error) {
+        header->state.store(FAILED, std::memory_order_release);
+        ::shm_unlink(name_.c_str());
+        detach();
+        std::rethrow_exception(error);
+    }
+
+    header->size = size;
+    header->state.store(READY, std::memory_order_release);
+    protect();
+
+    published_ = true;
+    Log::debug() << "SharedMemory: published '" << name_ << "' (" << Bytes(static_cast<double>(size_)) << ")"
+                 << std::endl;
+}
+
+
+bool SharedMemory::attach(int fd) {
+    Wait wait;
+    Stat::Struct s;
+
+    // wait for the publisher to size the segment
+    for (;;) {
+        if (Stat::fstat(fd, &s) != 0) {
+            const auto err = errno;
+            ::close(fd);
+            throw FailedSystemCall("fstat(" + name_ + ")", Here(), err);
+        }
+
+        if (static_cast<bytes_size_t>(s.st_size) >= header_size()) {
+            break;
+        }
+
+        if (s.st_nlink == 0) {
+            ::close(fd);
+            return false;  // unlinked
+        }
+
+        wait(name_);
+    }
+
+    map(fd, static_cast<bytes_size_t>(s.st_size) - header_size());
+    ::close(fd);
+
+    auto* header = static_cast<Header*>(map_);
+    header->users.fetch_add(1);
+
+    // wait for the publisher to fill the segment
+    for (;;) {
+        if (auto state = header->state.load(std::memory_order_acquire); state == READY) {
+            break;
+        }
+        else if (state != BUILDING) {
+            detach();
+            return false;
+        }
+
+        wait(name_);
+    }
+
+    ASSERT(header->size == size_);
+    protect();
+
+    Log::debug() << "SharedMemory: attached '" << name_ << "' (" << Bytes(static_cast<double>(size_)) << ")"
+                 << std::endl;
+
+    return true;
+}
+
+
+void SharedMemory::map(int fd, bytes_size_t size) {
+    ASSERT(map_ == nullptr);
+
+    length_ = header_size() + size;
+    size_   = size;
+
+    map_ = MMap::mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map_ == MAP_FAILED) {
+        const auto err = errno;
+        map_ = nullptr;
+        ::close(fd);
+        throw FailedSystemCall("mmap(" + name_ + ")", Here(), err);
+    }
+
+    FOOTPRINT += size_;
+}
+
+
+void SharedMemory::protect() {
+    // payload is read-only, header (reference count) is not
+    if (size_ > 0 && ::mprotect(static_cast<char*>(map_) + header_size(), size_, PROT_READ) != 0) {
+        throw FailedSystemCall("mprotect(" + name_ + ")", Here(), errno);
+    }
+}
+
+
+void SharedMemory::detach() {
+    if (map_ == nullptr) {
+        return;
+    }
+
+    // last process to detach unlinks (if another process attaches meanwhile, it keeps its mapping)
+    if (auto* header = static_cast<Header*>(map_); header->users.fetch_sub(1) == 1) {
+        if (uint32_t ready = READY; header->state.compare_exchange_strong(ready, UNLINKED)) {
+            ::shm_unlink(name_.c_str());
+        }
+    }
+
+    FOOTPRINT -= size_;
+    MMap::munmap(map_, length_);
+    map_ = nullptr;
+}
+
+
+}  // namespace eckit::geo::cache
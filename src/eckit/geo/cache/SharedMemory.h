@@ -0,0 +1,104 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <string>
+
+#include "eckit/geo/cache/MemoryCache.h"
+
+
+namespace eckit::geo::cache {
+
+
+/**
+ * @brief Named segment of (POSIX) shared memory, published by the first process needing it and attached by the others
+ * @details The first process creates the segment exclusively, computes and copies the payload, then marks it ready;
+ * the other processes (e.g. MPI ranks on the same node) attach to it, waiting until it is ready. If publishing fails
+ * the segment is unlinked, and waiting processes try again. The payload is mapped read-only. Segments are reference
+ * counted across processes, and unlinked when the last process detaches (segments left behind by processes that did
+ * not terminate cleanly can be removed explicitly).
+ */
+class SharedMemory final {
+public:
+
+    // -- Types
+
+    using bytes_size_t = MemoryCache::bytes_size_t;
+
+    struct Loader {
+        virtual ~Loader() = default;
+
+        /// Compute the payload (only called by the publishing process), return its size [B]
+        virtual bytes_size_t load() = 0;
+
+        /// Copy the computed payload
+        virtual void fill(void*) const = 0;
+    };
+
+    // -- Constructors
+
+    SharedMemory(const std::string& name, Loader&);
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory(SharedMemory&&)      = delete;
+
+    // -- Destructor
+
+    ~SharedMemory();
+
+    // -- Operators
+
+    SharedMemory& operator=(const SharedMemory&) = delete;
+    SharedMemory& operator=(SharedMemory&&)      = delete;
+
+    // -- Methods
+
+    const std::string& name() const { return name_; }
+    const void* data() const;
+    bytes_size_t size() const { return size_; }
+
+    /// If this process published the segment (and so computed its payload)
+    bool published() const { return published_; }
+
+    // -- Class methods
+
+    /// If caches use shared memory (eckit-geo-cache-shared;$ECKIT_GEO_CACHE_SHARED)
+    static bool enabled();
+
+    /// Payload size [B] of the segments attached by this process
+    static bytes_size_t total_footprint();
+
+    /// Unlink a segment by name, if it exists (processes attached to it are not affected)
+    static void remove(const std::string& name);
+
+private:
+
+    // -- Members
+
+    const std::string name_;
+    void* map_           = nullptr;
+    bytes_size_t length_ = 0;
+    bytes_size_t size_   = 0;
+    bool published_      = false;
+
+    // -- Methods
+
+    void publish(int fd, Loader&);
+    bool attach(int fd);
+    void map(int fd, bytes_size_t size);
+    void protect();
+    void detach();
+};
+
+
+}  // namespace eckit::geo::cache
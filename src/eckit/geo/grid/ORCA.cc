@@ -12,18 +12,20 @@
 
 #include "eckit/geo/grid/ORCA.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "eckit/geo/Exceptions.h"
 #include "eckit/geo/cache/LatitudeLongitude.h"
 #include "eckit/geo/iterator/Unstructured.h"
+#include "eckit/geo/util/span.h"
 #include "eckit/spec/Custom.h"
 #include "eckit/spec/Spec.h"
 #include "eckit/utils/MD5.h"
 
 
 namespace eckit::geo::util {
-void hash_vector_double(MD5&, const std::vector<double>&);
+void hash_vector_double(MD5&, span<const double>);
 }
 
 
@@ -104,7 +106,15 @@ std::vector<Point> ORCA::to_points() const {
 
 
 std::pair<std::vector<double>, std::vector<double>> ORCA::to_latlons() const {
-    return {record().latitude(), record().longitude()};
+    const auto& rec = record();
+    return {{rec.latitude().begin(), rec.latitude().end()}, {rec.longitude().begin(), rec.longitude().end()}};
+}
+
+
+void ORCA::fill_latlons(double* lat, double* lon) const {
+    const auto& rec = record();
+    std::copy(rec.latitude().begin(), rec.latitude().end(), lat);
+    std::copy(rec.longitude().begin(), rec.longitude().end(), lon);
 }
 
 
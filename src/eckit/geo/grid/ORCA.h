@@ -62,6 +62,7 @@ public:
     [[nodiscard]] Point last_point() const override;
     [[nodiscard]] std::vector<Point> to_points() const override;
     [[nodiscard]] std::pair<std::vector<double>, std::vector<double>> to_latlons() const override;
+    void fill_latlons(double* lat, double* lon) const override;
 
     const order_type& order() const override;
     renumber_type reorder(const order_type& to) const override;
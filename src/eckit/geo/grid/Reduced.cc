@@ -12,6 +12,10 @@
 
 #include "eckit/geo/grid/Reduced.h"
 
+#include <algorithm>
+#include <cstddef>
+
+#include "eckit/eckit.h"
 #include "eckit/geo/Exceptions.h"
 
 
@@ -34,6 +38,32 @@ Point Reduced::last_point() const {
 }
 
 
+void Reduced::fill_latlons(double* lat, double* lon) const {
+    const auto& lats = latitudes();
+    const auto& acc  = nxacc();
+
+    // row longitudes are (thread-safe) cached, fetch them once
+    const auto Nj = static_cast<std::ptrdiff_t>(ny());
+    std::vector<const std::vector<double>*> lons(Nj);
+    for (std::ptrdiff_t j = 0; j < Nj; ++j) {
+        lons[j] = &longitudes(j);
+        ASSERT(lons[j]->size() == acc[j + 1] - acc[j]);
+    }
+
+    // grid (projected) coordinates by row, then (batch) projection into latitude/longitude
+#if eckit_HAVE_OMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (std::ptrdiff_t j = 0; j < Nj; ++j) {
+        const auto& row = *lons[j];
+        std::copy(row.begin(), row.end(), lon + acc[j]);
+        std::fill_n(lat + acc[j], row.size(), lats[j]);
+    }
+
+    projection().fwd(lon, lat, lon, lat, size());
+}
+
+
 const std::vector<size_t>& Reduced::nxacc() const {
     if (nxacc_.empty()) {
         nxacc_.resize(1 + ny());
@@ -37,6 +37,8 @@ public:
     [[nodiscard]] Point first_point() const override;
     [[nodiscard]] Point last_point() const override;
 
+    void fill_latlons(double* lat, double* lon) const override;
+
     // Methods
 
     virtual const std::vector<double>& latitudes() const        = 0;
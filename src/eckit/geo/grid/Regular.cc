@@ -12,6 +12,10 @@
 
 #include "eckit/geo/grid/Regular.h"
 
+#include <algorithm>
+#include <cstddef>
+
+#include "eckit/eckit.h"
 #include "eckit/geo/iterator/Regular.h"
 #include "eckit/geo/order/Scan.h"
 #include "eckit/spec/Custom.h"
@@ -40,6 +44,26 @@ Grid::iterator Regular::cend() const {
 }
 
 
+void Regular::fill_latlons(double* lat, double* lon) const {
+    const auto& xs = x().values();
+    const auto& ys = y().values();
+
+    const auto Ni = xs.size();
+    const auto Nj = static_cast<std::ptrdiff_t>(ys.size());
+
+    // grid (projected) coordinates by row, then (batch) projection into latitude/longitude
+#if eckit_HAVE_OMP
+#pragma omp parallel for
+#endif
+    for (std::ptrdiff_t j = 0; j < Nj; ++j) {
+        std::copy_n(xs.data(), Ni, lon + j * Ni);
+        std::fill_n(lat + j * Ni, Ni, ys[j]);
+    }
+
+    projection().fwd(lon, lat, lon, lat, size());
+}
+
+
 const Regular::order_type& Regular::order() const {
     return scan_.order();
 }
@@ -50,6 +50,8 @@ public:
     const order_type& order() const final;
     renumber_type reorder(const order_type& to) const final;
 
+    void fill_latlons(double* lat, double* lon) const override;
+
     // -- Class methods
 
     static const order::Scan& scan_default();
@@ -12,19 +12,21 @@
 
 #include "eckit/geo/grid/Unstructured.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "eckit/geo/Exceptions.h"
 #include "eckit/geo/cache/Grid.h"
 #include "eckit/geo/cache/LatitudeLongitude.h"
 #include "eckit/geo/iterator/Unstructured.h"
+#include "eckit/geo/util/span.h"
 #include "eckit/spec/Custom.h"
 #include "eckit/spec/Spec.h"
 #include "eckit/utils/MD5.h"
 
 
 namespace eckit::geo::util {
-void hash_vector_double(MD5&, const std::vector<double>&);
+void hash_vector_double(MD5&, span<const double>);
 }
 
 
@@ -143,7 +145,15 @@ std::vector<Point> Unstructured::to_points() const {
 
 
 std::pair<std::vector<double>, std::vector<double>> Unstructured::to_latlons() const {
-    return {record().latitude(), record().longitude()};
+    const auto& rec = record();
+    return {{rec.latitude().begin(), rec.latitude().end()}, {rec.longitude().begin(), rec.longitude().end()}};
+}
+
+
+void Unstructured::fill_latlons(double* lat, double* lon) const {
+    const auto& rec = record();
+    std::copy(rec.latitude().begin(), rec.latitude().end(), lat);
+    std::copy(rec.longitude().begin(), rec.longitude().end(), lon);
 }
 
 
@@ -152,7 +162,7 @@ Grid::uid_type Unstructured::calculate_uid() const {
 }
 
 
-Grid::uid_type Unstructured::uid_from_latlons(const std::vector<double>& lat, const std::vector<double>& lon) {
+Grid::uid_type Unstructured::uid_from_latlons(util::span<const double> lat, util::span<const double> lon) {
     ASSERT(lat.size() == lon.size());
 
     MD5 hash;
@@ -13,6 +13,7 @@
 #pragma once
 
 #include "eckit/geo/Grid.h"
+#include "eckit/geo/util/span.h"
 
 
 namespace eckit::geo {
@@ -55,6 +56,7 @@ public:
 
     [[nodiscard]] std::vector<Point> to_points() const override;
     [[nodiscard]] std::pair<std::vector<double>, std::vector<double>> to_latlons() const override;
+    void fill_latlons(double* lat, double* lon) const override;
 
     uid_type calculate_uid() const override;
     const std::string& type() const override;
@@ -62,7 +64,7 @@ public:
 
     // -- Class methods
 
-    [[nodiscard]] static uid_type uid_from_latlons(const std::vector<double>&, const std::vector<double>&);
+    [[nodiscard]] static uid_type uid_from_latlons(util::span<const double>, util::span<const double>);
 
 protected:
 
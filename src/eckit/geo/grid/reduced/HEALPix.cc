@@ -15,9 +15,11 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstddef>
 #include <regex>
 #include <utility>
 
+#include "eckit/eckit.h"
 #include "eckit/geo/Exceptions.h"
 #include "eckit/geo/cache/MemoryCache.h"
 #include "eckit/geo/iterator/Reduced.h"
@@ -33,6 +35,14 @@ namespace eckit::geo::grid::reduced {
 static const std::string HEALPIX_PATTERN = "h[rn][1-9][0-9]*|h[1-9][0-9]*[rn]?";
 
 
+/// First longitude and increment of ring j
+std::pair<double, double> healpix_longitude_start_step(size_t Nside, size_t j, size_t Ni) {
+    const auto step  = PointLonLat::FULL_ANGLE / static_cast<double>(Ni);
+    const auto start = j < Nside || 3 * Nside - 1 < j || static_cast<bool>((j + Nside) % 2) ? step / 2. : 0.;
+    return {start, step};
+}
+
+
 const std::vector<double>& healpix_longitudes(size_t Nside, size_t j) {
     using cache_t = cache::MemoryCacheT<std::pair<size_t, size_t>, std::vector<double>>;
     const cache_t::key_type key{Nside, j};
@@ -50,8 +60,7 @@ const std::vector<double>& healpix_longitudes(size_t Nside, size_t j) {
     const auto Ni = j < Nside ? 4 * (j + 1) : j < 3 * Nside ? 4 * Nside : 4 * (4 * Nside - 1 - j);
     ASSERT(0 < Ni);
 
-    const auto step  = PointLonLat::FULL_ANGLE / static_cast<double>(Ni);
-    const auto start = j < Nside || 3 * Nside - 1 < j || static_cast<bool>((j + Nside) % 2) ? step / 2. : 0.;
+    const auto [start, step] = healpix_longitude_start_step(Nside, j, Ni);
 
     std::vector<double> lons(Ni);
     std::generate_n(lons.begin(), Ni,
@@ -80,7 +89,7 @@ Grid::iterator HEALPix::cbegin() const {
 
     // order=nested: cache full latitudes/longitudes for the unstructured iterator
     if (nested_latitudes_.empty()) {
-        const auto ren = order::HEALPix{}.reorder(order(), Nside_);
+        const auto& ren = order::HEALPix{}.renumbering(order(), Nside_);
 
         nested_latitudes_.resize(size());
         nested_longitudes_.resize(size());
@@ -173,6 +182,42 @@ std::vector<Point> HEALPix::to_points() const {
 }
 
 
+void HEALPix::fill_latlons(double* lat, double* lon) const {
+    // ring longitudes are calculated (not cached), nested order scatters them
+    const auto& lats = latitudes();
+    const auto& acc  = nxacc();
+
+    const auto nested = healpix_.order() == order::HEALPix::NESTED;
+
+    static const order::HEALPix::renumber_type none;
+    const auto& ren = nested ? order::HEALPix{}.renumbering(order(), Nside_) : none;
+
+    const auto Nj = static_cast<std::ptrdiff_t>(ny());
+
+#if eckit_HAVE_OMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (std::ptrdiff_t j = 0; j < Nj; ++j) {
+        const auto Ni            = acc[j + 1] - acc[j];
+        const auto [start, step] = healpix_longitude_start_step(Nside_, static_cast<size_t>(j), Ni);
+
+        if (nested) {
+            for (size_t i = 0, k = acc[j]; i < Ni; ++i, ++k) {
+                const auto r = ren[k];
+                lat[r]       = lats[j];
+                lon[r]       = start + static_cast<double>(i) * step;
+            }
+            continue;
+        }
+
+        std::fill_n(lat + acc[j], Ni, lats[j]);
+        for (size_t i = 0; i < Ni; ++i) {
+            lon[acc[j] + i] = start + static_cast<double>(i) * step;
+        }
+    }
+}
+
+
 const std::vector<double>& HEALPix::latitudes() const {
     const auto Nj = ny();
 
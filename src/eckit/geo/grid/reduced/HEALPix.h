@@ -44,6 +44,7 @@ public:
     size_t ny() const override;
 
     [[nodiscard]] std::vector<Point> to_points() const override;
+    void fill_latlons(double* lat, double* lon) const override;
 
     const order_type& order() const override { return healpix_.order(); }
     renumber_type reorder(const order_type& to) const override { return healpix_.reorder(to, Nside_); }
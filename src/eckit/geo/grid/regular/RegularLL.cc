@@ -133,25 +133,6 @@ Point RegularLL::last_point() const {
 }
 
 
-std::pair<std::vector<double>, std::vector<double>> RegularLL::to_latlons() const {
-    const auto N = size();
-
-    std::pair<std::vector<double>, std::vector<double>> latlon;
-    auto& lat = latlon.first;
-    auto& lon = latlon.second;
-    lat.reserve(N);
-    lon.reserve(N);
-
-    for (auto point : *this) {
-        const auto& p = std::get<PointLonLat>(point);
-        lat.emplace_back(p.lat());
-        lon.emplace_back(p.lon());
-    }
-
-    return latlon;
-}
-
-
 Grid* RegularLL::make_grid_cropped(const Area& crop) const {
     if (auto cropped(boundingBox()); crop.intersects(cropped)) {
         return new RegularLL({dlon(), dlat()}, cropped);
@@ -65,7 +65,6 @@ public:
     [[nodiscard]] std::vector<double> distinct_latitudes() const override { return y_.values(); }
     [[nodiscard]] std::vector<double> distinct_longitudes() const override { return x_.values(); }
 
-    [[nodiscard]] std::pair<std::vector<double>, std::vector<double>> to_latlons() const override;
 
     [[nodiscard]] Grid* make_grid_cropped(const Area&) const override;
     [[nodiscard]] BoundingBox* calculate_bbox() const override;
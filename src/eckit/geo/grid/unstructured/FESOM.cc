@@ -18,11 +18,12 @@
 #include "eckit/geo/Exceptions.h"
 #include "eckit/geo/LibEcKitGeo.h"
 #include "eckit/geo/cache/Download.h"
+#include "eckit/geo/util/span.h"
 #include "eckit/utils/MD5.h"
 
 
 namespace eckit::geo::util {
-void hash_vector_double(MD5&, const std::vector<double>&);
+void hash_vector_double(MD5&, span<const double>);
 void hash_vector_size_t(MD5&, const std::vector<size_t>&);
 }  // namespace eckit::geo::util
 
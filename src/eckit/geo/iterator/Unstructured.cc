@@ -37,16 +37,15 @@ struct UnstructuredInstance : Instance, Unstructured {
 };
 
 
-Unstructured::Unstructured(const Grid& grid, size_t index, const std::vector<double>& longitudes,
-                           const std::vector<double>& latitudes) :
-    longitudes_(&longitudes), latitudes_(&latitudes), index_(index), size_(longitudes.size()), uid_(grid.uid()) {
+Unstructured::Unstructured(const Grid& grid, size_t index, util::span<const double> longitudes,
+                           util::span<const double> latitudes) :
+    longitudes_(longitudes), latitudes_(latitudes), index_(index), size_(longitudes.size()), uid_(grid.uid()) {
     ASSERT(longitudes.size() == latitudes.size());
     ASSERT(size_ == grid.size());
 }
 
 
-Unstructured::Unstructured(const Grid& grid) :
-    longitudes_(nullptr), latitudes_(nullptr), index_(grid.size()), size_(grid.size()), uid_(grid.uid()) {}
+Unstructured::Unstructured(const Grid& grid) : index_(grid.size()), size_(grid.size()), uid_(grid.uid()) {}
 
 
 bool Unstructured::operator==(const geo::Iterator& other) const {
@@ -82,9 +81,8 @@ Unstructured::operator bool() const {
 
 
 Point Unstructured::operator*() const {
-    ASSERT(longitudes_ != nullptr);
-    ASSERT(latitudes_ != nullptr);
-    return PointLonLat{longitudes_->at(index_), latitudes_->at(index_)};
+    ASSERT(index_ < longitudes_.size());
+    return PointLonLat{longitudes_[index_], latitudes_[index_]};
 }
 
 
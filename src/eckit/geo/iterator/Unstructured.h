@@ -12,9 +12,8 @@
 
 #pragma once
 
-#include <vector>
-
 #include "eckit/geo/Iterator.h"
+#include "eckit/geo/util/span.h"
 
 
 namespace eckit::geo::iterator {
@@ -25,16 +24,15 @@ public:
 
     // -- Constructors
 
-    Unstructured(const Grid&, size_t index, const std::vector<double>& longitudes,
-                 const std::vector<double>& latitudes);
+    Unstructured(const Grid&, size_t index, util::span<const double> longitudes, util::span<const double> latitudes);
     explicit Unstructured(const Grid&);
 
 private:
 
     // -- Members
 
-    const std::vector<double>* longitudes_;
-    const std::vector<double>* latitudes_;
+    const util::span<const double> longitudes_;
+    const util::span<const double> latitudes_;
     size_t index_;
     const size_t size_;
     const std::string uid_;
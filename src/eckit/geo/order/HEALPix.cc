@@ -14,12 +14,26 @@
 
 #include <bitset>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <numeric>
 #include <tuple>
+#include <vector>
 
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "eckit/eckit.h"
 #include "eckit/geo/Exceptions.h"
+#include "eckit/geo/LibEcKitGeo.h"
+#include "eckit/geo/cache/MemoryCache.h"
 #include "eckit/geo/grid/reduced/HEALPix.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/log/Log.h"
+#include "eckit/os/AutoUmask.h"
 #include "eckit/spec/Spec.h"
 
 
@@ -37,6 +51,16 @@ struct CodecFijNest {
     static constexpr uint64_t MASKS[] = {0x00000000ffffffff, 0x0000ffff0000ffff, 0x00ff00ff00ff00ff,
                                          0x0f0f0f0f0f0f0f0f, 0x3333333333333333, 0x5555555555555555};
 
+#if defined(__BMI2__)
+    // bit deposit/extract (PDEP/PEXT) into/from the even bits
+    inline static int nest_encode_bits(int n) {
+        return static_cast<int>(_pdep_u32(static_cast<uint32_t>(n), static_cast<uint32_t>(MASKS[5])));
+    }
+
+    inline static int nest_decode_bits(int n) {
+        return static_cast<int>(_pext_u32(static_cast<uint32_t>(n), static_cast<uint32_t>(MASKS[5])));
+    }
+#else
     inline static int nest_encode_bits(int n) {
         auto b = static_cast<uint64_t>(n) & MASKS[0];
         b      = (b ^ (b << 16)) & MASKS[1];
@@ -56,6 +80,7 @@ struct CodecFijNest {
         b      = (b ^ (b >> 16)) & MASKS[0];
         return static_cast<int>(b);
     }
+#endif
 
     static std::tuple<int, int, int> nest_to_fij(int n, int k) {
         ASSERT(0 <= n);
@@ -214,6 +239,19 @@ struct Renumber {
 };
 
 
+/// A renumbering read from the disk cache must be a permutation, as it is used to index arrays
+bool is_permutation(const std::vector<size_t>& ren) {
+    std::vector<bool> seen(ren.size(), false);
+    for (auto r : ren) {
+        if (r >= ren.size() || seen[r]) {
+            return false;
+        }
+        seen[r] = true;
+    }
+    return true;
+}
+
+
 }  // namespace
 
 
@@ -228,25 +266,137 @@ HEALPix::HEALPix(const Spec& spec) : HEALPix(spec.get_string("order", order_defa
 
 
 HEALPix::renumber_type HEALPix::reorder(const order_type& to, size_t Nside) const {
+    return renumbering(to, Nside);
+}
+
+
+const HEALPix::renumber_type& HEALPix::renumbering(const order_type& to, size_t Nside) const {
     ASSERT(to == NESTED || to == RING);
 
-    auto size = static_cast<int>(grid::reduced::HEALPix::size_from_nside(Nside));
+    using cache_t = cache::MemoryCacheT<std::tuple<size_t, order_type, order_type>, renumber_type>;
+    const cache_t::key_type key{Nside, order_, to};
+
+    static cache_t cache;
+    if (cache.contains(key)) {
+        return cache[key];
+    }
+
+    const auto size = grid::reduced::HEALPix::size_from_nside(Nside);
     renumber_type ren(size);
 
     if (order_ == to) {
         // no reordering
         std::iota(ren.begin(), ren.end(), 0);
-        return ren;
+        return (cache[key] = std::move(ren));
+    }
+
+    const auto path = renumbering_path(to, Nside);
+    if (LibEcKitGeo::caching() && path.exists() && static_cast<size_t>(path.size()) == size * sizeof(size_t)) {
+        FileHandle in(path);
+        in.openForRead();
+        auto c = closer(in);
+
+        const auto bytes = static_cast<long>(size * sizeof(size_t));
+        if (in.read(ren.data(), bytes) == bytes && is_permutation(ren)) {
+            return (cache[key] = std::move(ren));
+        }
+
+        Log::warning() << "HEALPix: invalid cached renumbering '" << path << "', recomputing" << std::endl;
     }
 
     auto from_nested = order_ == NESTED;
-    Renumber renumber(Nside);
+    Renumber renumber(static_cast<int>(Nside));
+
+    const auto N = static_cast<std::ptrdiff_t>(size);
+
+#if eckit_HAVE_OMP
+    std::exception_ptr error;
+
+#pragma omp parallel for
+    for (std::ptrdiff_t i = 0; i < N; ++i) {
+        try {
+            auto r = static_cast<int>(i);
+            ren[i] = static_cast<size_t>(from_nested ? renumber.nest_to_ring(r) : renumber.ring_to_nest(r));
+        }
+        catch (...) {
+#pragma omp critical
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
 
-    for (int i = 0; i < size; ++i) {
-        ren[i] = from_nested ? renumber.nest_to_ring(i) : renumber.ring_to_nest(i);
+    if (error) {
+        std::rethrow_exception(error);
     }
+#else
+    for (std::ptrdiff_t i = 0; i < N; ++i) {
+        auto r = static_cast<int>(i);
+        ren[i] = static_cast<size_t>(from_nested ? renumber.nest_to_ring(r) : renumber.ring_to_nest(r));
+    }
+#endif
+
+    if (LibEcKitGeo::caching()) {
+        try {
+            AutoUmask umask(0);
+
+            auto tmp = PathName::unique(path);
+            {
+                FileHandle out(tmp);
+                out.openForWrite(0);
+                auto c = closer(out);
+
+                const auto bytes = static_cast<long>(size * sizeof(size_t));
+                ASSERT(out.write(ren.data(), bytes) == bytes);
+            }
+
+            PathName::rename(tmp, path);
+        }
+        catch (const Exception& e) {
+            Log::warning() << "HEALPix: cannot cache renumbering '" << path << "': " << e.what() << std::endl;
+        }
+    }
+
+    return (cache[key] = std::move(ren));
+}
+
+
+void HEALPix::reorder(const order_type& to, size_t Nside, double* values) const {
+    reorder_values(to, Nside, values);
+}
+
+
+void HEALPix::reorder(const order_type& to, size_t Nside, float* values) const {
+    reorder_values(to, Nside, values);
+}
+
+
+template <typename T>
+void HEALPix::reorder_values(const order_type& to, size_t Nside, T* values) const {
+    ASSERT(to == NESTED || to == RING);
+    if (order_ == to) {
+        return;
+    }
+
+    // gather through the reverse renumbering, where index i (of the new ordering) comes from ren[i]
+    const auto& ren = HEALPix(to).renumbering(order_, Nside);
+    const std::vector<T> copy(values, values + ren.size());
+
+    const auto N = static_cast<std::ptrdiff_t>(ren.size());
+
+#if eckit_HAVE_OMP
+#pragma omp parallel for
+#endif
+    for (std::ptrdiff_t i = 0; i < N; ++i) {
+        values[i] = copy[ren[i]];
+    }
+}
+
 
-    return ren;
+PathName HEALPix::renumbering_path(const order_type& to, size_t Nside) const {
+    static const int VERSION = 1;
+    return PathName{LibEcKitGeo::cacheDir(), true} / "eckit/geo/order/healpix" / std::to_string(VERSION) /
+           (order_ + "-" + to + "-" + std::to_string(Nside) + ".bin");
 }
 
 
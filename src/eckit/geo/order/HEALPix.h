@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include "eckit/filesystem/PathName.h"
 #include "eckit/geo/Grid.h"
 
 
@@ -37,6 +38,13 @@ public:
     const order_type& order() const { return order_; }
     renumber_type reorder(const order_type& to, size_t Nside) const;
 
+    /// Renumbering from this to another ordering, index i moving to ren[i] (cached in memory, and on disk if caching)
+    const renumber_type& renumbering(const order_type& to, size_t Nside) const;
+
+    /// Reorder field values (in place) from this to another ordering
+    void reorder(const order_type& to, size_t Nside, double* values) const;
+    void reorder(const order_type& to, size_t Nside, float* values) const;
+
     // -- Class members
 
     static const order_type RING;
@@ -51,6 +59,13 @@ private:
     // -- Members
 
     order_type order_;
+
+    // -- Methods
+
+    template <typename T>
+    void reorder_values(const order_type& to, size_t Nside, T* values) const;
+
+    PathName renumbering_path(const order_type& to, size_t Nside) const;
 };
 
 
@@ -88,6 +88,16 @@ PointLonLat AlbersEqualArea::inv(const PointXY& p) const {
 }
 
 
+void AlbersEqualArea::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return fwd(p); });
+}
+
+
+void AlbersEqualArea::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointXY>(x, y, ox, oy, n, [this](const PointXY& q) { return inv(q); });
+}
+
+
 const std::string& AlbersEqualArea::type() const {
     static const std::string type{"aea"};
     return type;
@@ -42,6 +42,9 @@ public:
     inline Point fwd(const Point& p) const override { return fwd(std::get<PointLonLat>(p)); }
     inline Point inv(const Point& q) const override { return inv(std::get<PointXY>(q)); }
 
+    void fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const override;
+    void inv(const double* x, const double* y, double* ox, double* oy, size_t n) const override;
+
 private:
 
     // -- Members
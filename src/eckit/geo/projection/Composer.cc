@@ -12,6 +12,8 @@
 
 #include "eckit/geo/projection/Composer.h"
 
+#include <algorithm>
+
 #include "eckit/spec/Custom.h"
 
 
@@ -88,6 +90,45 @@ Point Composer::inv(const Point& p) const {
 }
 
 
+void Composer::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    if (empty()) {
+        if (x != ox) {
+            std::copy_n(x, n, ox);
+        }
+        if (y != oy) {
+            std::copy_n(y, n, oy);
+        }
+        return;
+    }
+
+    // first projection writes the output, the others transform it in place
+    for (const auto* proj : *this) {
+        proj->fwd(x, y, ox, oy, n);
+        x = ox;
+        y = oy;
+    }
+}
+
+
+void Composer::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    if (empty()) {
+        if (x != ox) {
+            std::copy_n(x, n, ox);
+        }
+        if (y != oy) {
+            std::copy_n(y, n, oy);
+        }
+        return;
+    }
+
+    for (auto proj = rbegin(); proj != rend(); ++proj) {
+        (*proj)->inv(x, y, ox, oy, n);
+        x = ox;
+        y = oy;
+    }
+}
+
+
 Projection* Composer::compose_back(Projection* p, const Spec& spec) {
     return new Composer{p, ProjectionFactoryType::instance().get(spec.get_string("type")).create(spec)};
 }
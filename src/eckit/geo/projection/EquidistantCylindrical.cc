@@ -58,6 +58,16 @@ EquidistantCylindrical::EquidistantCylindrical(double lat_ts, double lat_0) :
 }
 
 
+void EquidistantCylindrical::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return fwd(p); });
+}
+
+
+void EquidistantCylindrical::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointXY>(x, y, ox, oy, n, [this](const PointXY& q) { return inv(q); });
+}
+
+
 const std::string& EquidistantCylindrical::type() const {
     static const std::string type{"eqc"};
     return type;
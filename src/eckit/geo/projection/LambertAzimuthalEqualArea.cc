@@ -61,6 +61,16 @@ PointLonLat LambertAzimuthalEqualArea::inv(const PointXY& p) const {
 }
 
 
+void LambertAzimuthalEqualArea::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return fwd(p); });
+}
+
+
+void LambertAzimuthalEqualArea::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointXY>(x, y, ox, oy, n, [this](const PointXY& q) { return inv(q); });
+}
+
+
 const std::string& LambertAzimuthalEqualArea::type() const {
     static const std::string type{"laea"};
     return type;
@@ -91,6 +91,16 @@ PointLonLat LambertConformalConic::inv(const PointXY& p) const {
 }
 
 
+void LambertConformalConic::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return fwd(p); });
+}
+
+
+void LambertConformalConic::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointXY>(x, y, ox, oy, n, [this](const PointXY& q) { return inv(q); });
+}
+
+
 const std::string& LambertConformalConic::type() const {
     static const std::string type{"lcc"};
     return type;
@@ -12,6 +12,7 @@
 
 #include "eckit/geo/projection/LonLatToXYZ.h"
 
+#include "eckit/geo/Exceptions.h"
 #include "eckit/geo/figure/OblateSpheroid.h"
 #include "eckit/geo/figure/Sphere.h"
 #include "eckit/spec/Custom.h"
@@ -67,6 +68,16 @@ LonLatToXYZ::LonLatToXYZ(double a, double b) :
 LonLatToXYZ::LonLatToXYZ(const Spec& spec) : LonLatToXYZ(FigureFactory::build(spec)) {}
 
 
+void LonLatToXYZ::fwd(const double*, const double*, double*, double*, size_t) const {
+    throw exception::ProjectionError("LonLatToXYZ: batch transform to [x, y, z] is not supported", Here());
+}
+
+
+void LonLatToXYZ::inv(const double*, const double*, double*, double*, size_t) const {
+    throw exception::ProjectionError("LonLatToXYZ: batch transform from [x, y, z] is not supported", Here());
+}
+
+
 const std::string& LonLatToXYZ::type() const {
     static const std::string type{TYPE};
     return type;
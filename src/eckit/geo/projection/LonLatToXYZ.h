@@ -46,6 +46,9 @@ public:
     inline Point fwd(const Point& p) const override { return (*impl_)(std::get<PointLonLat>(p)); }
     inline Point inv(const Point& q) const override { return (*impl_)(std::get<PointXYZ>(q)); }
 
+    void fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const override;
+    void inv(const double* x, const double* y, double* ox, double* oy, size_t n) const override;
+
 protected:
 
     // -- Overridden methods
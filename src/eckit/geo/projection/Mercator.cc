@@ -105,6 +105,16 @@ PointLonLat Mercator::inv(const PointXY& q) const {
 }
 
 
+void Mercator::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return fwd(p); });
+}
+
+
+void Mercator::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointXY>(x, y, ox, oy, n, [this](const PointXY& q) { return inv(q); });
+}
+
+
 const std::string& Mercator::type() const {
     static const std::string type{"mercator"};
     return type;
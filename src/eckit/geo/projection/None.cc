@@ -12,6 +12,8 @@
 
 #include "eckit/geo/projection/None.h"
 
+#include <algorithm>
+
 
 namespace eckit::geo::projection {
 
@@ -19,6 +21,21 @@ namespace eckit::geo::projection {
 static ProjectionRegisterType<None> PROJECTION("none");
 
 
+void None::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    if (x != ox) {
+        std::copy_n(x, n, ox);
+    }
+    if (y != oy) {
+        std::copy_n(y, n, oy);
+    }
+}
+
+
+void None::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    fwd(x, y, ox, oy, n);
+}
+
+
 const std::string& None::type() const {
     static const std::string type{"none"};
     return type;
@@ -14,6 +14,7 @@
 
 #include <proj.h>
 
+#include <algorithm>
 #include <map>
 #include <set>
 #include <utility>
@@ -57,6 +58,10 @@ struct Convert {
 
     virtual PJ_COORD to_coord(const Point&) const = 0;
     virtual Point to_point(const PJ_COORD&) const = 0;
+
+    // batch transformations (two coordinates)
+    virtual bool planar() const { return true; }
+    virtual void normalise(double* /*x*/, double* /*y*/, size_t /*n*/) const {}
 };
 
 
@@ -68,6 +73,14 @@ struct LonLat final : Convert {
 
     Point to_point(const PJ_COORD& c) const final { return PointLonLat::make(c.enu.e, c.enu.n, lon_minimum_); }
 
+    void normalise(double* lon, double* lat, size_t n) const final {
+        for (size_t i = 0; i < n; ++i) {
+            const auto p = PointLonLat::make(lon[i], lat[i], lon_minimum_);
+            lon[i]       = p.lon();
+            lat[i]       = p.lat();
+        }
+    }
+
     explicit LonLat(double lon_minimum) : lon_minimum_(lon_minimum) {}
     const double lon_minimum_;
 };
@@ -90,6 +103,8 @@ struct XYZ final : Convert {
     }
 
     Point to_point(const PJ_COORD& c) const final { return PointXYZ{c.xy.x, c.xy.y, c.xyz.z}; }
+
+    bool planar() const final { return false; }
 };
 
 
@@ -128,6 +143,27 @@ struct PROJ::Implementation {
         return source_->to_point(proj_trans(proj_.get(), PJ_INV, target_->to_coord(p)));
     }
 
+    void trans(PJ_DIRECTION dir, const double* x, const double* y, double* ox, double* oy, size_t n) const {
+        const auto& from = dir == PJ_FWD ? *source_ : *target_;
+        const auto& to   = dir == PJ_FWD ? *target_ : *source_;
+
+        if (!from.planar() || !to.planar()) {
+            throw exception::ProjectionError("PROJ: batch transform supports lon/lat and x/y coordinates only", Here());
+        }
+
+        if (x != ox) {
+            std::copy_n(x, n, ox);
+        }
+        if (y != oy) {
+            std::copy_n(y, n, oy);
+        }
+
+        // PJ objects are not thread-safe, PROJ transforms the arrays in place
+        proj_trans_generic(proj_.get(), dir, ox, sizeof(double), n, oy, sizeof(double), n, nullptr, 0, 0, nullptr, 0,
+                           0);
+        to.normalise(ox, oy, n);
+    }
+
 private:
 
     const pj_t proj_;
@@ -189,6 +225,16 @@ Point PROJ::inv(const Point& q) const {
 }
 
 
+void PROJ::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    implementation_->trans(PJ_FWD, x, y, ox, oy, n);
+}
+
+
+void PROJ::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    implementation_->trans(PJ_INV, x, y, ox, oy, n);
+}
+
+
 std::string PROJ::proj_str(const spec::Custom& custom) {
     using key_value_type = std::pair<std::string, std::string>;
     using keys_type      = std::vector<std::string>;
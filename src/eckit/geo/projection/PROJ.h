@@ -41,6 +41,9 @@ public:
     Point fwd(const Point&) const override;
     Point inv(const Point&) const override;
 
+    void fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const override;
+    void inv(const double* x, const double* y, double* ox, double* oy, size_t n) const override;
+
     // -- Class methods
 
     static std::string proj_str(const spec::Custom&);
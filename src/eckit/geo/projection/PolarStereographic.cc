@@ -65,6 +65,16 @@ PointLonLat PolarStereographic::inv(const PointXY& q) const {
 }
 
 
+void PolarStereographic::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return fwd(p); });
+}
+
+
+void PolarStereographic::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointXY>(x, y, ox, oy, n, [this](const PointXY& q) { return inv(q); });
+}
+
+
 const std::string& PolarStereographic::type() const {
     static const std::string type{"polar_stereographic"};
     return type;
@@ -36,6 +36,14 @@ public:
     inline Point fwd(const Point& p) const override { return P::inv(p); }
     inline Point inv(const Point& p) const override { return P::fwd(p); }
 
+    inline void fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const override {
+        P::inv(x, y, ox, oy, n);
+    }
+
+    inline void inv(const double* x, const double* y, double* ox, double* oy, size_t n) const override {
+        P::fwd(x, y, ox, oy, n);
+    }
+
 private:
 
     // -- Overridden methods
@@ -12,6 +12,7 @@
 
 #include "eckit/geo/projection/Rotation.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "eckit/geo/figure/UnitSphere.h"
@@ -55,11 +56,27 @@ Rotation::Rotation(const PointLonLat& south_pole, double angle) :
 
     struct NonRotated final : Implementation {
         PointLonLat operator()(const PointLonLat& p) const override { return p; }
+        void operator()(const double* lon, const double* lat, double* olon, double* olat, size_t n) const override {
+            if (lon != olon) {
+                std::copy_n(lon, n, olon);
+            }
+            if (lat != olat) {
+                std::copy_n(lat, n, olat);
+            }
+        }
     };
 
     struct RotationAngle final : Implementation {
         explicit RotationAngle(double angle) : angle_(angle) {}
         PointLonLat operator()(const PointLonLat& p) const override { return {p.lon() + angle_, p.lat()}; }
+        void operator()(const double* lon, const double* lat, double* olon, double* olat, size_t n) const override {
+            for (size_t i = 0; i < n; ++i) {
+                olon[i] = lon[i] + angle_;
+            }
+            if (lat != olat) {
+                std::copy_n(lat, n, olat);
+            }
+        }
         const double angle_;
     };
 
@@ -69,6 +86,12 @@ Rotation::Rotation(const PointLonLat& south_pole, double angle) :
             return figure::UnitSphere::_convertCartesianToSpherical(
                 R_ * figure::UnitSphere::_convertSphericalToCartesian(p));
         }
+        void operator()(const double* lon, const double* lat, double* olon, double* olat, size_t n) const override {
+            transform<PointLonLat>(lon, lat, olon, olat, n, [this](const PointLonLat& p) {
+                return figure::UnitSphere::_convertCartesianToSpherical(
+                    R_ * figure::UnitSphere::_convertSphericalToCartesian(p));
+            });
+        }
         const M R_;
     };
 
@@ -120,6 +143,16 @@ Rotation::Rotation(const PointLonLat& south_pole, double angle) :
 }
 
 
+void Rotation::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    (*fwd_)(x, y, ox, oy, n);
+}
+
+
+void Rotation::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    (*inv_)(x, y, ox, oy, n);
+}
+
+
 const std::string& Rotation::type() const {
     static const std::string type{"rotation"};
     return type;
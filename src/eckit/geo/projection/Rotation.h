@@ -45,6 +45,9 @@ public:
     inline Point fwd(const Point& p) const override { return fwd(std::get<PointLonLat>(p)); }
     inline Point inv(const Point& q) const override { return inv(std::get<PointLonLat>(q)); }
 
+    void fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const override;
+    void inv(const double* x, const double* y, double* ox, double* oy, size_t n) const override;
+
     // -- Class methods
 
     [[nodiscard]] static Rotation* make_from_spec(const Spec&);
@@ -69,6 +72,10 @@ private:
         void operator=(Implementation&&)      = delete;
 
         virtual PointLonLat operator()(const PointLonLat&) const = 0;
+
+        virtual void operator()(const double* lon, const double* lat, double* olon, double* olat, size_t n) const {
+            transform<PointLonLat>(lon, lat, olon, olat, n, [this](const PointLonLat& p) { return (*this)(p); });
+        }
     };
 
     // -- Members
@@ -34,6 +34,16 @@ PointLonLat SpaceView::inv(const PointXY&) const {
 }
 
 
+void SpaceView::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return fwd(p); });
+}
+
+
+void SpaceView::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointXY>(x, y, ox, oy, n, [this](const PointXY& q) { return inv(q); });
+}
+
+
 const std::string& SpaceView::type() const {
     static const std::string type{"space_view"};
     return type;
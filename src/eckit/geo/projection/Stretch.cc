@@ -37,6 +37,16 @@ Stretch::Stretch(double c) : c_(c) {
 Stretch::Stretch(const Spec& spec) : Stretch(spec.get_double("stretching_factor")) {}
 
 
+void Stretch::fwd(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& p) { return fwd(p); });
+}
+
+
+void Stretch::inv(const double* x, const double* y, double* ox, double* oy, size_t n) const {
+    transform<PointLonLat>(x, y, ox, oy, n, [this](const PointLonLat& q) { return inv(q); });
+}
+
+
 const std::string& Stretch::type() const {
     static const std::string type{"stretch"};
     return type;
@@ -0,0 +1,435 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "eckit/geo/search/KDTreeFlat.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <utility>
+
+#include "eckit/geo/Exceptions.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/memory/MMap.h"
+
+
+namespace eckit::geo::search {
+
+
+namespace {
+
+
+constexpr size_t DIMS      = KDTreeFlat::Point::DIMS;
+constexpr size_t ALIGNMENT = 64;
+constexpr size_t MAX_DEPTH = 64;
+
+
+size_t align(size_t offset) {
+    return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+
+}  // namespace
+
+
+/// File (and memory) layout, sections are aligned to 64 bytes
+struct KDTreeFlat::Header {
+    static constexpr std::uint64_t MAGIC = 0x46444b54494b4345ULL;  // "ECKITKDF" in memory, little-endian
+
+    std::uint64_t magic_;
+    std::uint32_t version_;
+    std::uint32_t bucket_;
+    std::uint64_t size_;   ///< points
+    std::uint64_t depth_;  ///< levels of internal nodes, (2^depth - 1) internal nodes and 2^depth leaves
+    std::uint64_t x_[DIMS];
+    std::uint64_t payload_;
+    std::uint64_t split_;
+    std::uint64_t axis_;
+    std::uint64_t total_;
+
+    size_t nodes() const { return (static_cast<size_t>(1) << depth_) - 1; }
+
+    static Header make(size_t size, size_t depth, size_t bucket) {
+        Header h{};
+        h.magic_   = MAGIC;
+        h.version_ = VERSION;
+        h.bucket_  = static_cast<std::uint32_t>(bucket);
+        h.size_    = size;
+        h.depth_   = depth;
+
+        size_t offset = align(sizeof(Header));
+        for (size_t d = 0; d < DIMS; ++d) {
+            h.x_[d] = offset;
+            offset  = align(offset + size * sizeof(double));
+        }
+
+        h.payload_ = offset;
+        h.split_   = align(h.payload_ + size * sizeof(std::uint64_t));
+        h.axis_    = align(h.split_ + h.nodes() * sizeof(double));
+        h.total_   = align(h.axis_ + h.nodes() * sizeof(std::uint8_t));
+        return h;
+    }
+};
+
+
+KDTreeFlat::~KDTreeFlat() {
+    clear();
+}
+
+
+void KDTreeFlat::clear() {
+    if (mapped_ != nullptr && MMap::munmap(mapped_, bufferSize_) != 0) {
+        Log::error() << "KDTreeFlat: fails to munmap" << Log::syserr << std::endl;
+    }
+
+    mapped_ = nullptr;
+    storage_.clear();
+    storage_.shrink_to_fit();
+
+    buffer_     = nullptr;
+    bufferSize_ = 0;
+    size_       = 0;
+    depth_      = 0;
+    bucket_     = 0;
+}
+
+
+void KDTreeFlat::attach(const void* buffer, size_t size) {
+    ASSERT(buffer != nullptr);
+
+    Header h;
+    if (size < sizeof(Header) || (std::memcpy(&h, buffer, sizeof(Header)), h.magic_ != Header::MAGIC)) {
+        throw exception::SearchError("KDTreeFlat: not a flat k-d tree", Here());
+    }
+
+    if (h.version_ != VERSION) {
+        throw exception::SearchError("KDTreeFlat: unsupported version " + std::to_string(h.version_), Here());
+    }
+
+    if (h.depth_ >= MAX_DEPTH || size < Header::make(h.size_, h.depth_, h.bucket_).total_) {
+        throw exception::SearchError("KDTreeFlat: truncated or corrupted tree", Here());
+    }
+
+    const auto* base = static_cast<const char*>(buffer);
+
+    buffer_     = buffer;
+    bufferSize_ = size;
+    size_       = h.size_;
+    depth_      = h.depth_;
+    bucket_     = h.bucket_;
+
+    for (size_t d = 0; d < DIMS; ++d) {
+        x_[d] = reinterpret_cast<const double*>(base + h.x_[d]);
+    }
+
+    payload_ = reinterpret_cast<const std::uint64_t*>(base + h.payload_);
+    split_   = reinterpret_cast<const double*>(base + h.split_);
+    axis_    = reinterpret_cast<const std::uint8_t*>(base + h.axis_);
+}
+
+
+void KDTreeFlat::build(const std::vector<PointValueType>& points, size_t bucket) {
+    ASSERT(bucket > 0);
+    clear();
+
+    const auto n = points.size();
+
+    size_t depth = 0;
+    while (((n + (static_cast<size_t>(1) << depth) - 1) >> depth) > bucket) {
+        ++depth;
+    }
+    ASSERT(depth < MAX_DEPTH);
+
+    const auto h = Header::make(n, depth, bucket);
+    storage_.assign(h.total_ / sizeof(std::uint64_t), 0);
+
+    auto* base = reinterpret_cast<char*>(storage_.data());
+    std::memcpy(base, &h, sizeof(Header));
+
+    auto* split = reinterpret_cast<double*>(base + h.split_);
+    auto* axis  = reinterpret_cast<std::uint8_t*>(base + h.axis_);
+
+    // order points, splitting each range at the median along the axis of largest extent
+    std::vector<PointValueType> v(points);
+
+    struct Range {
+        size_t node;
+        size_t level;
+        size_t begin;
+        size_t end;
+    };
+
+    std::vector<Range> stack{{0, 0, 0, n}};
+    while (!stack.empty()) {
+        const auto r = stack.back();
+        stack.pop_back();
+
+        if (r.level == depth) {
+            continue;
+        }
+
+        std::array<double, DIMS> min;
+        std::array<double, DIMS> max;
+        min.fill(std::numeric_limits<double>::max());
+        max.fill(std::numeric_limits<double>::lowest());
+
+        for (auto i = r.begin; i < r.end; ++i) {
+            for (size_t d = 0; d < DIMS; ++d) {
+                min[d] = std::min(min[d], v[i].point().x(d));
+                max[d] = std::max(max[d], v[i].point().x(d));
+            }
+        }
+
+        size_t a = 0;
+        for (size_t d = 1; d < DIMS; ++d) {
+            if (max[d] - min[d] > max[a] - min[a]) {
+                a = d;
+            }
+        }
+
+        const auto mid = r.begin + (r.end - r.begin) / 2;
+        std::nth_element(v.begin() + r.begin, v.begin() + mid, v.begin() + r.end,
+                         [a](const auto& p, const auto& q) { return p.point().x(a) < q.point().x(a); });
+
+        axis[r.node]  = static_cast<std::uint8_t>(a);
+        split[r.node] = mid < r.end ? v[mid].point().x(a) : 0.;
+
+        stack.push_back({2 * r.node + 1, r.level + 1, r.begin, mid});
+        stack.push_back({2 * r.node + 2, r.level + 1, mid, r.end});
+    }
+
+    for (size_t d = 0; d < DIMS; ++d) {
+        auto* x = reinterpret_cast<double*>(base + h.x_[d]);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = v[i].point().x(d);
+        }
+    }
+
+    auto* payload = reinterpret_cast<std::uint64_t*>(base + h.payload_);
+    for (size_t i = 0; i < n; ++i) {
+        payload[i] = v[i].payload();
+    }
+
+    attach(storage_.data(), h.total_);
+}
+
+
+void KDTreeFlat::save(const PathName& path) const {
+    ASSERT(buffer_ != nullptr);
+
+    FileHandle out(path);
+    out.openForWrite(0);
+    auto c = closer(out);
+
+    ASSERT(out.write(buffer_, static_cast<long>(bufferSize_)) == static_cast<long>(bufferSize_));
+}
+
+
+void KDTreeFlat::load(const PathName& path) {
+    clear();
+
+    const size_t size = path.size();
+    ASSERT(size > 0);
+
+    int fd;
+    SYSCALL2(fd = ::open(path.localPath(), O_RDONLY), path);
+
+    auto* address = MMap::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (address == MAP_FAILED) {
+        Log::error() << "KDTreeFlat path=" << path << " size=" << size << " fails to mmap" << Log::syserr
+                     << std::endl;
+        throw FailedSystemCall("mmap", Here());
+    }
+
+    mapped_     = address;
+    bufferSize_ = size;
+
+    try {
+        attach(address, size);
+    }
+    catch (...) {
+        clear();
+        throw;
+    }
+}
+
+
+template <typename LEAF>
+void KDTreeFlat::traverse(const Point& p, const double& bound2, LEAF&& leaf) const {
+    if (size_ == 0) {
+        return;
+    }
+
+    // lower bound of the (squared) distance to the points of a node, from the split planes crossed to reach it
+    struct Node {
+        size_t node;
+        size_t level;
+        size_t begin;
+        size_t end;
+        double d2;
+    };
+
+    std::array<Node, MAX_DEPTH + 1> stack;
+    size_t top = 0;
+
+    stack[top++] = {0, 0, 0, size_, 0.};
+
+    while (top > 0) {
+        const auto n = stack[--top];
+        if (n.d2 > bound2) {
+            continue;
+        }
+
+        if (n.level == depth_) {
+            leaf(n.begin, n.end);
+            continue;
+        }
+
+        const auto a    = axis_[n.node];
+        const auto diff = p.x(a) - split_[n.node];
+        const auto mid  = n.begin + (n.end - n.begin) / 2;
+
+        Node left{2 * n.node + 1, n.level + 1, n.begin, mid, n.d2};
+        Node right{2 * n.node + 2, n.level + 1, mid, n.end, n.d2};
+
+        // visit the near side first (pushed last)
+        if (diff < 0) {
+            right.d2     = std::max(n.d2, diff * diff);
+            stack[top++] = right;
+            stack[top++] = left;
+        }
+        else {
+            left.d2      = std::max(n.d2, diff * diff);
+            stack[top++] = left;
+            stack[top++] = right;
+        }
+    }
+}
+
+
+KDTreeFlat::PointValueType KDTreeFlat::nearestNeighbour(const Point& p) const {
+    ASSERT(size_ > 0);
+
+    auto best  = std::numeric_limits<double>::infinity();
+    size_t arg = 0;
+
+    traverse(p, best, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            const auto dx = x_[0][i] - p.x(0);
+            const auto dy = x_[1][i] - p.x(1);
+            const auto dz = x_[2][i] - p.x(2);
+            const auto d2 = dx * dx + dy * dy + dz * dz;
+            if (d2 < best) {
+                best = d2;
+                arg  = i;
+            }
+        }
+    });
+
+    return value(arg);
+}
+
+
+std::vector<KDTreeFlat::PointValueType> KDTreeFlat::kNearestNeighbours(const Point& p, size_t k) const {
+    k = std::min(k, size_);
+    if (k == 0) {
+        return {};
+    }
+
+    // max-heap of (squared distance, index) of the closest points found so far
+    std::vector<std::pair<double, size_t>> heap;
+    heap.reserve(k);
+
+    auto bound = std::numeric_limits<double>::infinity();
+
+    traverse(p, bound, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            const auto dx = x_[0][i] - p.x(0);
+            const auto dy = x_[1][i] - p.x(1);
+            const auto dz = x_[2][i] - p.x(2);
+            const auto d2 = dx * dx + dy * dy + dz * dz;
+
+            if (heap.size() < k) {
+                heap.emplace_back(d2, i);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else if (d2 < heap.front().first) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = {d2, i};
+                std::push_heap(heap.begin(), heap.end());
+            }
+
+            if (heap.size() == k) {
+                bound = heap.front().first;
+            }
+        }
+    });
+
+    std::sort_heap(heap.begin(), heap.end());
+
+    std::vector<PointValueType> result;
+    result.reserve(heap.size());
+    for (const auto& [d2, i] : heap) {
+        result.emplace_back(value(i));
+    }
+
+    return result;
+}
+
+
+std::vector<KDTreeFlat::PointValueType> KDTreeFlat::findInSphere(const Point& p, double radius) const {
+    const auto r2 = radius * radius;
+
+    std::vector<std::pair<double, size_t>> found;
+
+    traverse(p, r2, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            const auto dx = x_[0][i] - p.x(0);
+            const auto dy = x_[1][i] - p.x(1);
+            const auto dz = x_[2][i] - p.x(2);
+            const auto d2 = dx * dx + dy * dy + dz * dz;
+            if (d2 <= r2) {
+                found.emplace_back(d2, i);
+            }
+        }
+    });
+
+    std::sort(found.begin(), found.end());
+
+    std::vector<PointValueType> result;
+    result.reserve(found.size());
+    for (const auto& [d2, i] : found) {
+        result.emplace_back(value(i));
+    }
+
+    return result;
+}
+
+
+void KDTreeFlat::print(std::ostream& out) const {
+    out << "KDTreeFlat[size=" << size_ << ",bucket=" << bucket_ << ",depth=" << depth_ << ","
+        << Bytes{static_cast<double>(bufferSize_)} << (mapped_ != nullptr ? ",mapped" : "") << "]";
+}
+
+
+}  // namespace eckit::geo::search
@@ -0,0 +1,124 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/geo/search/Tree.h"
+
+
+namespace eckit::geo::search {
+
+
+/**
+ * @brief k-d tree in flat arrays
+ * @details Points are ordered by leaf bucket, with coordinates in separate arrays; internal nodes (split axis and
+ * value) are in implicit (heap) order, children of node i being 2i+1 and 2i+2, and each node halving the range of
+ * points of its parent. Traversal is index arithmetic, without pointers. The arrays have the same layout in memory and
+ * in file, a saved tree is memory-mapped (read-only). Queries are const, and safe to run concurrently.
+ */
+class KDTreeFlat {
+public:
+
+    // -- Types
+
+    using Point          = Tree::Point;
+    using Payload        = Tree::Payload;
+    using PointValueType = Tree::PointValueType;
+
+    // -- Constructors
+
+    KDTreeFlat() = default;
+
+    KDTreeFlat(const KDTreeFlat&) = delete;
+    KDTreeFlat(KDTreeFlat&&)      = delete;
+
+    // -- Destructor
+
+    ~KDTreeFlat();
+
+    // -- Operators
+
+    KDTreeFlat& operator=(const KDTreeFlat&) = delete;
+    KDTreeFlat& operator=(KDTreeFlat&&)      = delete;
+
+    // -- Methods
+
+    void build(const std::vector<PointValueType>&, size_t bucket = BUCKET);
+
+    void save(const PathName&) const;
+    void load(const PathName&);
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    size_t bucket() const { return bucket_; }
+    size_t depth() const { return depth_; }
+    size_t footprint() const { return bufferSize_; }
+
+    PointValueType nearestNeighbour(const Point&) const;
+    std::vector<PointValueType> kNearestNeighbours(const Point&, size_t k) const;
+    std::vector<PointValueType> findInSphere(const Point&, double radius) const;
+
+    void print(std::ostream&) const;
+
+    // -- Class members
+
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr size_t BUCKET         = 16;
+
+private:
+
+    // -- Types
+
+    struct Header;
+
+    // -- Members
+
+    std::vector<std::uint64_t> storage_;
+    void* mapped_ = nullptr;
+
+    const void* buffer_ = nullptr;
+    size_t bufferSize_  = 0;
+
+    size_t size_   = 0;
+    size_t depth_  = 0;
+    size_t bucket_ = 0;
+
+    const double* x_[Point::DIMS]{};
+    const std::uint64_t* payload_ = nullptr;
+    const double* split_          = nullptr;
+    const std::uint8_t* axis_     = nullptr;
+
+    // -- Methods
+
+    void attach(const void* buffer, size_t size);
+    void clear();
+
+    PointValueType value(size_t i) const { return {Point{x_[0][i], x_[1][i], x_[2][i]}, payload_[i]}; }
+
+    template <typename LEAF>
+    void traverse(const Point&, const double& bound2, LEAF&&) const;
+
+    // -- Friends
+
+    friend std::ostream& operator<<(std::ostream& out, const KDTreeFlat& tree) {
+        tree.print(out);
+        return out;
+    }
+};
+
+
+}  // namespace eckit::geo::search
@@ -80,6 +80,28 @@ std::vector<Tree::PointValueType> Tree::findInSphere(const Point& /*unused*/, do
 }
 
 
+std::vector<std::vector<Tree::PointValueType>> Tree::kNearestNeighboursBatch(const std::vector<Point>& points,
+                                                                            size_t k) {
+    std::vector<std::vector<PointValueType>> result;
+    result.reserve(points.size());
+    for (const auto& p : points) {
+        result.emplace_back(kNearestNeighbours(p, k));
+    }
+    return result;
+}
+
+
+std::vector<std::vector<Tree::PointValueType>> Tree::findInSphereBatch(const std::vector<Point>& points,
+                                                                      double radius) {
+    std::vector<std::vector<PointValueType>> result;
+    result.reserve(points.size());
+    for (const auto& p : points) {
+        result.emplace_back(findInSphere(p, radius));
+    }
+    return result;
+}
+
+
 bool Tree::ready() const {
     throw exception::SeriousBug("Tree::ready() not implemented for " + str());
 }
@@ -80,6 +80,10 @@ public:
     virtual std::vector<PointValueType> kNearestNeighbours(const Point&, size_t k);
     virtual std::vector<PointValueType> findInSphere(const Point&, double);
 
+    /// Batched queries, one result per point (in parallel, if the tree supports concurrent queries)
+    virtual std::vector<std::vector<PointValueType>> kNearestNeighboursBatch(const std::vector<Point>&, size_t k);
+    virtual std::vector<std::vector<PointValueType>> findInSphereBatch(const std::vector<Point>&, double);
+
     virtual bool ready() const;
     virtual void commit();
     virtual void print(std::ostream&) const;
@@ -0,0 +1,154 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "eckit/geo/search/TreeCache.h"
+
+#include <algorithm>
+#include <ostream>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/geo/LibEcKitGeo.h"
+#include "eckit/geo/search/TreeMappedFile.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/os/AutoUmask.h"
+
+
+namespace eckit::geo::search {
+
+
+TreeCache::TreeCache(const PathName& root) : DiskCache(root) {}
+
+
+std::vector<TreeCache::Entry> TreeCache::entries() const {
+    std::vector<Entry> entries;
+    if (!cache_root().exists()) {
+        return entries;
+    }
+
+    std::vector<PathName> files;
+    std::vector<PathName> dirs;
+    cache_root().childrenRecursive(files, dirs);
+
+    for (const auto& file : files) {
+        if (file.extension() != EXTENSION) {
+            continue;  // lock files, and trees being built
+        }
+
+        try {
+            entries.push_back({file, static_cast<size_t>(file.size()), file.lastModified()});
+        }
+        catch (FailedSystemCall&) {
+            // evicted or replaced concurrently
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.used != b.used ? a.used > b.used : a.path.asString() < b.path.asString();
+    });
+
+    return entries;
+}
+
+
+size_t TreeCache::footprint() const {
+    size_t bytes = 0;
+    for (const auto& entry : entries()) {
+        bytes += entry.bytes;
+    }
+    return bytes;
+}
+
+
+std::vector<TreeCache::Entry> TreeCache::prune(size_t budget, const PathName& keep) const {
+    auto all = entries();
+
+    size_t bytes = 0;
+    for (const auto& entry : all) {
+        bytes += entry.bytes;
+    }
+
+    std::vector<Entry> evicted;
+    for (auto entry = all.rbegin(); entry != all.rend() && bytes > budget; ++entry) {
+        if (entry->path == keep) {
+            continue;
+        }
+
+        try {
+            entry->path.unlink(false);
+            bytes -= entry->bytes;
+            evicted.push_back(*entry);
+            Log::debug() << "TreeCache: evicted '" << entry->path << "' (" << Bytes(static_cast<double>(entry->bytes))
+                         << ")" << std::endl;
+        }
+        catch (FailedSystemCall&) {
+            // evicted concurrently
+        }
+    }
+
+    return evicted;
+}
+
+
+std::vector<TreeCache> TreeCache::caches() {
+    std::vector<TreeCache> caches;
+    for (const auto& root : cache_roots()) {
+        caches.emplace_back(PathName(root) / "eckit/geo/search");
+    }
+    return caches;
+}
+
+
+size_t TreeCache::budget() {
+    static const auto budget = LibResource<size_t, LibEcKitGeo>(
+        "eckit-geo-search-cache-budget;$ECKIT_GEO_SEARCH_CACHE_BUDGET", 0);
+    return budget;
+}
+
+
+void TreeCache::use(const PathName& path) {
+    try {
+        path.touch();
+    }
+    catch (FailedSystemCall&) {
+        Log::debug() << "TreeCache: cannot mark '" << path << "' as used" << std::endl;
+    }
+}
+
+
+void TreeCache::publish(const PathName& from, const PathName& to) {
+    AutoUmask umask(0);
+    PathName::rename(from, to);
+
+    if (const auto b = budget(); b > 0) {
+        for (const auto& cache : caches()) {
+            cache.prune(b, to);
+        }
+    }
+}
+
+
+std::ostream& operator<<(std::ostream& out, const TreeCache& cache) {
+    auto entries = cache.entries();
+
+    size_t bytes = 0;
+    for (const auto& entry : entries) {
+        bytes += entry.bytes;
+    }
+
+    return out << "TreeCache[root=" << cache.cache_root() << ",entries=" << entries.size()
+               << ",footprint=" << Bytes(static_cast<double>(bytes)) << "]";
+}
+
+
+}  // namespace eckit::geo::search
@@ -0,0 +1,81 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <ctime>
+#include <iosfwd>
+#include <vector>
+
+#include "eckit/geo/cache/DiskCache.h"
+
+
+namespace eckit::geo::search {
+
+
+/**
+ * @brief Cache of search trees on disk, one file per grid ("<uid>.kdtree", by tree type and version)
+ * @details Trees are built into a unique file and published by renaming, so readers only see complete trees. Using a
+ * tree marks it as recently used (modification time), and publishing one evicts the least recently used trees above
+ * the budget (if set). Evicting unlinks the file, which is safe for processes that already map it.
+ */
+class TreeCache final : public cache::DiskCache {
+public:
+
+    // -- Types
+
+    struct Entry {
+        PathName path;
+        size_t bytes;
+        time_t used;
+    };
+
+    // -- Constructors
+
+    explicit TreeCache(const PathName& root);
+
+    // -- Methods
+
+    /// Cached trees, most recently used first
+    std::vector<Entry> entries() const;
+
+    /// Total size of cached trees [B]
+    size_t footprint() const;
+
+    /// Evict least recently used trees (except keep) until the footprint is within the budget [B], return evicted
+    std::vector<Entry> prune(size_t budget, const PathName& keep = "") const;
+
+    // -- Class methods
+
+    /// Cache of search trees in each of the cache roots
+    static std::vector<TreeCache> caches();
+
+    /// Budget [B] of each cache, 0 for unlimited (eckit-geo-search-cache-budget;$ECKIT_GEO_SEARCH_CACHE_BUDGET)
+    static size_t budget();
+
+    /// Mark a cached tree as recently used
+    static void use(const PathName&);
+
+    /// Publish a tree built in a temporary path, then evict trees above the budget
+    static void publish(const PathName& from, const PathName& to);
+
+    static constexpr const char* EXTENSION = ".kdtree";
+
+private:
+
+    // -- Friends
+
+    friend std::ostream& operator<<(std::ostream&, const TreeCache&);
+};
+
+
+}  // namespace eckit::geo::search
@@ -0,0 +1,211 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include "eckit/geo/search/TreeFlat.h"
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <exception>
+#include <fstream>
+
+#include "eckit/eckit.h"
+#include "eckit/geo/Exceptions.h"
+#include "eckit/geo/Grid.h"
+#include "eckit/geo/search/TreeCache.h"
+#include "eckit/geo/search/TreeMappedFile.h"
+#include "eckit/log/Log.h"
+#include "eckit/os/AutoUmask.h"
+#include "eckit/os/Semaphore.h"
+#include "eckit/runtime/Main.h"
+
+
+namespace eckit::geo::search {
+
+
+namespace {
+
+
+/// Apply f to each point, storing the results (in parallel, if OpenMP is available)
+template <typename F>
+std::vector<std::vector<Tree::PointValueType>> batch(const std::vector<Tree::Point>& points, F f) {
+    std::vector<std::vector<Tree::PointValueType>> result(points.size());
+    const auto N = static_cast<std::ptrdiff_t>(points.size());
+
+#if eckit_HAVE_OMP
+    std::exception_ptr error;
+
+#pragma omp parallel for schedule(dynamic, 256)
+    for (std::ptrdiff_t i = 0; i < N; ++i) {
+        try {
+            result[i] = f(points[i]);
+        }
+        catch (...) {
+#pragma omp critical
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+#else
+    for (std::ptrdiff_t i = 0; i < N; ++i) {
+        result[i] = f(points[i]);
+    }
+#endif
+
+    return result;
+}
+
+
+}  // namespace
+
+
+void TreeFlat::build(std::vector<PointValueType>& v) {
+    tree_.build(v);
+}
+
+
+void TreeFlat::statsPrint(std::ostream& out, bool /*pretty*/) {
+    out << tree_;
+}
+
+
+void TreeFlat::statsReset() {
+    // Empty
+}
+
+
+Tree::PointValueType TreeFlat::nearestNeighbour(const Tree::Point& pt) {
+    return tree_.nearestNeighbour(pt);
+}
+
+
+std::vector<Tree::PointValueType> TreeFlat::kNearestNeighbours(const Tree::Point& pt, size_t k) {
+    return tree_.kNearestNeighbours(pt, k);
+}
+
+
+std::vector<Tree::PointValueType> TreeFlat::findInSphere(const Tree::Point& pt, double radius) {
+    return tree_.findInSphere(pt, radius);
+}
+
+
+std::vector<std::vector<Tree::PointValueType>> TreeFlat::kNearestNeighboursBatch(const std::vector<Point>& points,
+                                                                                size_t k) {
+    return batch(points, [this, k](const Point& p) { return tree_.kNearestNeighbours(p, k); });
+}
+
+
+std::vector<std::vector<Tree::PointValueType>> TreeFlat::findInSphereBatch(const std::vector<Point>& points,
+                                                                          double radius) {
+    return batch(points, [this, radius](const Point& p) { return tree_.findInSphere(p, radius); });
+}
+
+
+bool TreeFlat::ready() const {
+    return false;
+}
+
+
+void TreeFlat::commit() {}
+
+
+void TreeFlat::print(std::ostream& out) const {
+    out << "TreeFlat[" << tree_ << "]";
+}
+
+
+static const TreeBuilder<TreeFlat> builder1("flat");
+
+
+/// Flat k-d tree in the cache of search trees ("flat-cache-file"): built once, then memory-mapped
+class TreeFlatCacheFile : public TreeFlat {
+    PathName real_;
+    Semaphore lock_;  // Must be after real
+
+    static PathName treePath(const Grid& r) {
+        return cache_path(cache_roots(),
+                          "eckit/geo/search/flat/" + std::to_string(KDTreeFlat::VERSION) + "/" + r.uid() + ".kdtree",
+                          false);
+    }
+
+    static PathName lockFile(const PathName& path) {
+        AutoUmask umask(0);
+        path.dirName().mkdir(0777);
+        return cache_lock_file(path);
+    }
+
+    bool ready() const override { return !tree_.empty(); }
+
+    void commit() override {
+        AutoUmask umask(0);
+
+        auto path = PathName::unique(real_);
+        tree_.save(path);
+        TreeCache::publish(path, real_);
+    }
+
+    void print(std::ostream& out) const override {
+        out << "TreeFlatCacheFile[path=" << real_ << ",ready?" << ready() << "," << tree_ << "]";
+    }
+
+    void lock() override {
+        AutoUmask umask(0);
+        auto path = cache_lock_file(real_);
+        lock_.lock();
+
+        std::ofstream os(path.asString().c_str());
+        os << Main::hostname() << " " << ::getpid() << std::endl;
+
+        if (real_.exists()) {
+            try {
+                tree_.load(real_);
+                TreeCache::use(real_);
+                Log::debug() << "Loading " << *this << std::endl;
+            }
+            catch (const exception::SearchError& e) {
+                Log::warning() << "TreeFlatCacheFile: " << e.what() << ", removing '" << real_ << "'" << std::endl;
+                real_.unlink();
+            }
+            catch (const Exception& e) {
+                // evicted by another process (without the lock) since checked: a cache miss, the tree is rebuilt
+                if (real_.exists()) {
+                    throw;
+                }
+                Log::debug() << "TreeFlatCacheFile: '" << real_ << "' removed while loading (" << e.what() << ")"
+                             << std::endl;
+            }
+        }
+    }
+
+    void unlock() override {
+        PathName path = cache_lock_file(real_);
+        std::ofstream os(path.asString().c_str());
+        os << std::endl;
+        lock_.unlock();
+    }
+
+public:
+
+    explicit TreeFlatCacheFile(const Grid& r) :
+        TreeFlat(r), real_(treePath(r)), lock_(lockFile(real_)) {}
+};
+
+
+static const TreeBuilder<TreeFlatCacheFile> builder2("flat-cache-file");
+
+
+}  // namespace eckit::geo::search
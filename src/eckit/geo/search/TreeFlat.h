@@ -0,0 +1,49 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include "eckit/geo/search/KDTreeFlat.h"
+#include "eckit/geo/search/Tree.h"
+
+
+namespace eckit::geo::search {
+
+
+/// Search tree using a flat k-d tree, in memory ("flat"), batched queries run in parallel
+class TreeFlat : public Tree {
+protected:
+
+    KDTreeFlat tree_;
+
+    void build(std::vector<PointValueType>&) override;
+    void statsPrint(std::ostream&, bool pretty) override;
+    void statsReset() override;
+
+    PointValueType nearestNeighbour(const Tree::Point&) override;
+    std::vector<PointValueType> kNearestNeighbours(const Point&, size_t k) override;
+    std::vector<PointValueType> findInSphere(const Point&, double radius) override;
+
+    std::vector<std::vector<PointValueType>> kNearestNeighboursBatch(const std::vector<Point>&, size_t k) override;
+    std::vector<std::vector<PointValueType>> findInSphereBatch(const std::vector<Point>&, double radius) override;
+
+    bool ready() const override;
+    void commit() override;
+    void print(std::ostream&) const override;
+
+public:
+
+    using Tree::Tree;
+};
+
+
+}  // namespace eckit::geo::search
@@ -24,19 +24,27 @@
 namespace eckit::geo::search {
 
 
-template <class T>
-PathName TreeMappedFile<T>::treePath(const Grid& r, bool makeUnique) {
+std::vector<std::string> cache_roots() {
+    static auto roots = []() {
+        std::vector<std::string> r;
+        Tokenizer{":"}(LibEcKitGeo::cacheDir(), r);
+        for (auto& root : r) {
+            root = PathExpander::expand(root);
+        }
+        return r;
+    }();
+    return roots;
+}
 
-    // LocalPathName::unique and LocalPathName::mkdir call mkdir, make sure to use umask = 0
-    AutoUmask umask(0);
 
-    static const long VERSION = 2;
+PathName cache_path(const std::vector<std::string>& roots, const std::string& relative, bool makeUnique) {
 
-    const std::string relative = "eckit/geo/search/" + std::to_string(VERSION) + "/" + r.uid() + ".kdtree";
+    // LocalPathName::unique and LocalPathName::mkdir call mkdir, make sure to use umask = 0
+    AutoUmask umask(0);
 
     auto writable = [](const PathName& path) -> bool { return (::access(path.asString().c_str(), W_OK) == 0); };
 
-    for (PathName path : T::roots()) {
+    for (PathName path : roots) {
         if (not path.exists()) {
             if (not writable(path.dirName())) {
                 continue;
@@ -68,8 +76,7 @@ PathName TreeMappedFile<T>::treePath(const Grid& r, bool makeUnique) {
 }
 
 
-template <class T>
-PathName TreeMappedFile<T>::lockFile(const std::string& path) {
+PathName cache_lock_file(const std::string& path) {
     AutoUmask umask(0);
 
     PathName lock(path + ".lock");
@@ -78,25 +85,27 @@ PathName TreeMappedFile<T>::lockFile(const std::string& path) {
 }
 
 
+template <class T>
+PathName TreeMappedFile<T>::treePath(const Grid& r, bool makeUnique) {
+    static const long VERSION = 2;
+    return cache_path(T::roots(), "eckit/geo/search/" + std::to_string(VERSION) + "/" + r.uid() + ".kdtree",
+                      makeUnique);
+}
+
+
+template <class T>
+PathName TreeMappedFile<T>::lockFile(const std::string& path) {
+    return cache_lock_file(path);
+}
+
+
 class TreeMappedCacheFile : public TreeMappedFile<TreeMappedCacheFile> {
     using P = TreeMappedFile<TreeMappedCacheFile>;
 
 public:
 
     using P::P;
-    static std::vector<std::string> roots() {
-        static auto roots = []() {
-            std::vector<std::string> r;
-            Tokenizer{":"}(LibEcKitGeo::cacheDir(), r);
-
-            for (auto& root : r) {
-                root = PathExpander::expand(root);
-            }
-
-            return r;
-        }();
-        return roots;
-    }
+    static std::vector<std::string> roots() { return cache_roots(); }
 };
 
 
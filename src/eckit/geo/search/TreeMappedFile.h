@@ -15,7 +15,10 @@
 #include <unistd.h>
 
 #include <fstream>
+#include <string>
+#include <vector>
 
+#include "eckit/geo/search/TreeCache.h"
 #include "eckit/geo/search/TreeMapped.h"
 #include "eckit/os/Semaphore.h"
 #include "eckit/runtime/Main.h"
@@ -24,6 +27,16 @@
 namespace eckit::geo::search {
 
 
+/// Roots of the cache of search trees (LibEcKitGeo::cacheDir, separated by ':')
+std::vector<std::string> cache_roots();
+
+/// Path of a cached search tree in the first writable root, unique (to build into) or not
+PathName cache_path(const std::vector<std::string>& roots, const std::string& relative, bool makeUnique);
+
+/// Lock file of a cached search tree
+PathName cache_lock_file(const std::string& path);
+
+
 template <class T>
 class TreeMappedFile : public TreeMapped {
 protected:
@@ -33,7 +46,7 @@ protected:
 
     bool ready() const override { return path() == real_; }
 
-    void commit() override { PathName::rename(path(), real_); }
+    void commit() override { TreeCache::publish(path(), real_); }
 
     void print(std::ostream& out) const override {
         out << "TreeMappedFile["
@@ -72,6 +85,7 @@ public:
         lockFile(real_).touch();
 
         if (ready()) {
+            TreeCache::use(real_);
             Log::debug() << "Loading " << *this << std::endl;
         }
     }
@@ -13,6 +13,7 @@
 #include <vector>
 
 #include "eckit/eckit_config.h"
+#include "eckit/geo/util/span.h"
 #include "eckit/utils/MD5.h"
 
 #if eckit_LITTLE_ENDIAN
@@ -25,26 +26,26 @@ namespace eckit::geo::util {
 
 
 template <typename T>
-void hash_vector(MD5& hash, const std::vector<T>& v) {
+void hash_vector(MD5& hash, span<const T> v) {
     const auto len = static_cast<long>(v.size() * sizeof(T));
 
 #if eckit_LITTLE_ENDIAN
     hash.add(v.data(), len);
 #else
-    auto w = v;
+    std::vector<T> w(v.begin(), v.end());
     byteswap(w);
     hash.add(w.data(), len);
 #endif
 }
 
 
-void hash_vector_double(MD5& hash, const std::vector<double>& v) {
+void hash_vector_double(MD5& hash, span<const double> v) {
     hash_vector(hash, v);
 }
 
 
 void hash_vector_size_t(MD5& hash, const std::vector<size_t>& v) {
-    hash_vector(hash, v);
+    hash_vector(hash, span<const size_t>(v));
 }
 
 
@@ -0,0 +1,63 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+
+namespace eckit::geo::util {
+
+
+/// Contiguous sequence not owning its elements (subset of C++20 std::span)
+template <typename T>
+class span {
+public:
+
+    using element_type = T;
+    using value_type   = std::remove_cv_t<T>;
+    using size_type    = std::size_t;
+    using pointer      = T*;
+    using reference    = T&;
+    using iterator     = T*;
+
+    constexpr span() noexcept = default;
+
+    constexpr span(pointer data, size_type size) noexcept : data_(data), size_(size) {}
+
+    template <typename V, typename = std::enable_if_t<std::is_const_v<T> && std::is_same_v<V, value_type>>>
+    span(const std::vector<V>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+    template <typename V, typename = std::enable_if_t<std::is_same_v<V, value_type>>>
+    span(std::vector<V>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+    constexpr pointer data() const noexcept { return data_; }
+    constexpr size_type size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+
+    constexpr reference front() const { return data_[0]; }
+    constexpr reference back() const { return data_[size_ - 1]; }
+    constexpr reference operator[](size_type i) const { return data_[i]; }
+
+private:
+
+    pointer data_   = nullptr;
+    size_type size_ = 0;
+};
+
+
+}  // namespace eckit::geo::util
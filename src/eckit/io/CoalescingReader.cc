@@ -0,0 +1,212 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/CoalescingReader.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/io/PositionalFile.h"
+#include "eckit/runtime/Metrics.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static size_t defaultWindow() {
+    static long window = Resource<long>("coalesceReadsWindow;$ECKIT_COALESCE_READS_WINDOW", 32 * 1024 * 1024);
+    return size_t(std::max(window, 1L));
+}
+
+static size_t defaultGap() {
+    static long gap = Resource<long>("coalesceReadsGap;$ECKIT_COALESCE_READS_GAP", 64 * 1024);
+    return size_t(std::max(gap, 0L));
+}
+
+bool CoalescingReader::enabled() {
+    static bool coalesce = Resource<bool>("coalesceReads;$ECKIT_COALESCE_READS", true);
+    return coalesce;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CoalescingReader::CoalescingReader() : CoalescingReader(defaultWindow(), defaultGap()) {}
+
+CoalescingReader::CoalescingReader(size_t window, size_t gap) :
+    windowSize_(window),
+    gap_(gap),
+    size_(0),
+    pos_(0),
+    windowStart_(0),
+    windowEnd_(0),
+    fragmentsRead_(0),
+    readsIssued_(0),
+    gapBytes_(0) {
+    ASSERT(windowSize_ > 0);
+}
+
+CoalescingReader::~CoalescingReader() = default;
+
+void CoalescingReader::add(const PathName& path, const Offset& offset, const Length& length) {
+    if (length == Length(0)) {
+        return;
+    }
+
+    std::string name = path.localPath();
+
+    auto j = index_.find(name);
+    if (j == index_.end()) {
+        j = index_.emplace(name, paths_.size()).first;
+        paths_.push_back(name);
+        files_.emplace_back(new PositionalFile(name));
+    }
+
+    fragments_.push_back({j->second, (long long)offset, (long long)length, size_});
+    size_ += (long long)length;
+}
+
+void CoalescingReader::close() {
+    for (auto& f : files_) {
+        f->close();
+    }
+    window_.resize(0);
+    hole_.resize(0);
+    windowStart_ = windowEnd_ = 0;
+}
+
+Offset CoalescingReader::seek(const Offset& offset) {
+    long long to = offset;
+    ASSERT(0 <= to && to <= size_);
+
+    pos_ = to;
+    return offset;
+}
+
+long CoalescingReader::read(void* buffer, long length) {
+    char* p    = static_cast<char*>(buffer);
+    long total = 0;
+
+    while (length > 0 && pos_ < size_) {
+
+        if (pos_ < windowStart_ || pos_ >= windowEnd_) {
+            long long left = std::min<long long>(length, size_ - pos_);
+
+            // Large requests are scheduled straight into the caller's buffer
+            if (left >= (long long)windowSize_) {
+                fill(p, left);
+                pos_ += left;
+                total += left;
+                p += left;
+                length -= left;
+                continue;
+            }
+
+            long long size = std::min<long long>(windowSize_, size_ - pos_);
+            if (window_.size() < size_t(size)) {
+                window_.resize(size);
+            }
+            fill(window_, size);
+            windowStart_ = pos_;
+            windowEnd_   = pos_ + size;
+        }
+
+        const char* w = window_;
+        long n         = std::min<long long>(length, windowEnd_ - pos_);
+        ::memcpy(p, w + (pos_ - windowStart_), n);
+
+        pos_ += n;
+        total += n;
+        p += n;
+        length -= n;
+    }
+
+    return total;
+}
+
+void CoalescingReader::fill(char* into, long long length) {
+    const long long from = pos_;
+    const long long to   = pos_ + length;
+
+    // Fragments overlapping [from, to), pointing to their place in the output
+
+    auto first = std::upper_bound(fragments_.begin(), fragments_.end(), from,
+                                  [](long long pos, const Fragment& f) { return pos < f.start; });
+    ASSERT(first != fragments_.begin());
+    --first;
+
+    std::vector<std::pair<size_t, ReadRange>> pieces;
+    for (auto f = first; f != fragments_.end() && f->start < to; ++f) {
+        long long lo = std::max(from, f->start);
+        long long hi = std::min(to, f->start + f->length);
+        pieces.emplace_back(f->file, ReadRange{into + (lo - from), long(hi - lo), f->offset + (lo - f->start)});
+    }
+
+    std::sort(pieces.begin(), pieces.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first < b.first : (long long)a.second.offset < (long long)b.second.offset;
+    });
+
+    if (hole_.size() < gap_) {
+        hole_.resize(gap_);
+    }
+
+    // Merge the pieces of each file separated by less than the gap, reading the holes into a scratch buffer,
+    // so that every extent is a single (vectored) read
+
+    std::vector<ReadRange> ranges;
+    for (size_t i = 0; i < pieces.size();) {
+        const size_t file = pieces[i].first;
+
+        ranges.clear();
+        Length expected = 0;
+        long long end   = -1;
+
+        for (; i < pieces.size() && pieces[i].first == file; ++i) {
+            const ReadRange& r = pieces[i].second;
+            long long offset   = r.offset;
+
+            if (end >= 0 && offset >= end && offset - end <= (long long)gap_) {
+                if (offset > end) {
+                    ranges.push_back({hole_, long(offset - end), end});
+                    expected += Length(offset - end);
+                    gapBytes_ += offset - end;
+                }
+            }
+            else {
+                readsIssued_++;
+            }
+
+            ranges.push_back(r);
+            expected += Length(r.length);
+            end = offset + r.length;
+            fragmentsRead_++;
+        }
+
+        Length n = files_[file]->readv(ranges);
+        if (n != expected) {
+            std::ostringstream s;
+            s << paths_[file] << ": cannot read " << expected << ", got only " << n;
+            throw ReadError(s.str());
+        }
+    }
+}
+
+void CoalescingReader::collectMetrics(const std::string& what) const {
+    Metrics::set(what + "_fragments", fragmentsRead_);
+    Metrics::set(what + "_reads", readsIssued_);
+    Metrics::set(what + "_seeks_avoided", fragmentsRead_ - readsIssued_);
+    Metrics::set(what + "_gap_bytes", gapBytes_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
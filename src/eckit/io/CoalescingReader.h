@@ -0,0 +1,112 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_io_CoalescingReader_h
+#define eckit_io_CoalescingReader_h
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/Length.h"
+#include "eckit/io/Offset.h"
+
+namespace eckit {
+
+class PositionalFile;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Reads a sequence of file fragments (as described by PartFileHandles) in their logical order, but
+/// by windows: the fragments of a window are sorted by file and offset, fragments closer than a gap are
+/// merged, and each merged extent is read with a single positional read. Bytes are then delivered in the
+/// order of the fragments.
+///
+/// Resources:
+///   coalesceReads;$ECKIT_COALESCE_READS               enable the optimisation (default true)
+///   coalesceReadsGap;$ECKIT_COALESCE_READS_GAP        largest hole read through between fragments (64 KiB)
+///   coalesceReadsWindow;$ECKIT_COALESCE_READS_WINDOW  bytes scheduled at once (32 MiB)
+
+class CoalescingReader {
+public:  // methods
+
+    CoalescingReader();
+    CoalescingReader(size_t window, size_t gap);
+
+    CoalescingReader(const CoalescingReader&)            = delete;
+    CoalescingReader& operator=(const CoalescingReader&) = delete;
+
+    ~CoalescingReader();
+
+    void add(const PathName&, const Offset&, const Length&);
+
+    long read(void*, long);
+    Offset seek(const Offset&);
+    Offset position() const { return pos_; }
+    Length size() const { return size_; }
+
+    /// Releases the files and the window, keeps the statistics
+    void close();
+
+    /// Statistics: fragments read, reads issued, seeks avoided, bytes read through holes
+    void collectMetrics(const std::string& what) const;
+
+    size_t fragmentsRead() const { return fragmentsRead_; }
+    size_t readsIssued() const { return readsIssued_; }
+    unsigned long long gapBytes() const { return gapBytes_; }
+
+    /// True if PartFileHandle and MultiHandle should coalesce their reads
+    static bool enabled();
+
+private:  // types
+
+    struct Fragment {
+        size_t file;
+        long long offset;  ///< in the file
+        long long length;
+        long long start;  ///< in the logical stream
+    };
+
+private:  // methods
+
+    void fill(char* into, long long length);
+
+private:  // members
+
+    std::vector<std::string> paths_;
+    std::vector<std::unique_ptr<PositionalFile>> files_;
+    std::map<std::string, size_t> index_;
+
+    std::vector<Fragment> fragments_;
+
+    Buffer window_;
+    Buffer hole_;
+
+    size_t windowSize_;
+    size_t gap_;
+
+    long long size_;
+    long long pos_;
+    long long windowStart_;
+    long long windowEnd_;
+
+    size_t fragmentsRead_;
+    size_t readsIssued_;
+    unsigned long long gapBytes_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
@@ -21,10 +21,13 @@
 #include "eckit/io/DataHandle.h"
 #include "eckit/io/DblBuffer.h"
 #include "eckit/io/MoverTransfer.h"
+#include "eckit/io/ZeroCopy.h"
 #include "eckit/log/Bytes.h"
 #include "eckit/log/Progress.h"
 #include "eckit/log/Timer.h"
 #include "eckit/runtime/Metrics.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Mutex.h"
 
 
 namespace eckit {
@@ -51,6 +54,18 @@ AutoClose::~AutoClose() noexcept(false) {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+static long doubleBufferSize() {
+    static const long bufsize = Resource<long>("doubleBufferSize", 10 * 1024 * 1024 / 20);
+    return bufsize;
+}
+
+static long doubleBufferCount() {
+    static const long count = Resource<long>("doubleBufferCount", 20);
+    return count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 
 ClassSpec DataHandle::classSpec_ = {
     &Streamable::classSpec(),
@@ -89,13 +104,11 @@ Length DataHandle::saveInto(DataHandle& other, TransferWatcher& watcher) {
 
     static const bool doubleBuffer = Resource<bool>("doubleBuffer", 0);
 
-    if (doubleBuffer && doubleBufferOK() && other.doubleBufferOK()) {
-        static const long bufsize = Resource<long>("doubleBufferSize", 10 * 1024 * 1024 / 20);
-        static const long count   = Resource<long>("doubleBufferCount", 20);
+    if ((doubleBuffer || DblBuffer::multiStream()) && doubleBufferOK() && other.doubleBufferOK()) {
 
         Metrics::set("double_buffering", true);
 
-        DblBuffer buf(count, bufsize, watcher);
+        DblBuffer buf(doubleBufferCount(), doubleBufferSize(), watcher);
         return buf.copy(*this, other);
     }
 
@@ -114,14 +127,19 @@ Length DataHandle::saveInto(DataHandle& other, TransferWatcher& watcher) {
 
     Progress progress("Moving data", 0, estimate);
 
-    Length total     = 0;
-    long length      = -1;
-    double readTime  = 0;
-    double lastRead  = 0;
+    Timer timer("Save into");
+
+    // Let the kernel move the data if it can, the loop below completes the transfer
+    Length moved = zeroCopy(*this, other, estimate, bufsize, watcher);
+    progress(moved);
+
+    Length total     = moved;
+    long length      = moved > Length(0) ? 0 : -1;
+    double readTime  = timer.elapsed();
+    double lastRead  = readTime;
     double writeTime = 0;
     double lastWrite = 0;
-    Timer timer("Save into");
-    bool more = true;
+    bool more        = true;
 
     while (more) {
         more = false;
@@ -185,6 +203,7 @@ Length DataHandle::saveInto(DataHandle& other, TransferWatcher& watcher) {
     Metrics::set("read_time", readTime);
     Metrics::set("write_time", writeTime);
     Metrics::set("double_buffering", false);
+    Metrics::set("zero_copy", moved);
 
     return total;
 }
@@ -211,8 +230,18 @@ Length DataHandle::copyTo(DataHandle& other, long bufsize, Length maxsize, Trans
     watcher.toHandleOpened();
     AutoClose closer2(other);
 
-    Length total = 0;
-    long length  = -1;
+    Length total = zeroCopy(*this, other, toRead, bufsize, watcher);
+    long length  = total > Length(0) ? 0 : -1;
+
+    // Several readers and writers, if configured and the handles allow it
+    if (DblBuffer::multiStream() && toRead > total) {
+        DblBuffer streams(doubleBufferCount(), doubleBufferSize(), watcher);
+        Length copied = streams.copyStreams(*this, other, toRead - total);
+        if (copied > Length(0)) {
+            total += copied;
+            length = 0;
+        }
+    }
 
     while ((toRead <= Length(0) || total < toRead) &&
            (length = read(buffer, toRead <= Length(0) ? bufsize : std::min(bufsize, (long)(toRead - total)))) > 0) {
@@ -387,6 +416,61 @@ void DataHandle::skip(const Length& len) {
     seek(position() + len);
 }
 
+long DataHandle::pread(void* buffer, long length, const Offset& offset) {
+    if (!canSeek()) {
+        std::ostringstream os;
+        os << "DataHandle::pread() [" << *this << "]";
+        throw NotImplemented(os.str(), Here());
+    }
+
+    AutoLock<Mutex> lock(positionalMutex_);
+
+    Offset here = position();
+    seek(offset);
+
+    char* p    = static_cast<char*>(buffer);
+    long total = 0;
+    long n     = 0;
+    while (total < length && (n = read(p + total, length - total)) > 0) {
+        total += n;
+    }
+
+    seek(here);
+
+    return total;
+}
+
+Length DataHandle::readv(const std::vector<ReadRange>& ranges) {
+    Length total = 0;
+    for (const auto& r : ranges) {
+        long n = pread(r.buffer, r.length, r.offset);
+        total += n;
+        if (n < r.length) {
+            break;
+        }
+    }
+    return total;
+}
+
+long DataHandle::pwrite(const void* buffer, long length, const Offset& offset) {
+    if (!canSeek()) {
+        std::ostringstream os;
+        os << "DataHandle::pwrite() [" << *this << "]";
+        throw NotImplemented(os.str(), Here());
+    }
+
+    AutoLock<Mutex> lock(positionalMutex_);
+
+    Offset here = position();
+    seek(offset);
+
+    long written = write(buffer, length);
+
+    seek(here);
+
+    return written;
+}
+
 void DataHandle::restartReadFrom(const Offset& from) {
     std::ostringstream os;
     os << "DataHandle::restartReadFrom(" << from << ") [" << *this << "]";
@@ -17,12 +17,14 @@
 #define eckit_io_DataHandle_h
 
 #include <cstdio>
+#include <vector>
 
 #include "eckit/filesystem/PathName.h"
 #include "eckit/io/Length.h"
 #include "eckit/io/Offset.h"
 #include "eckit/io/TransferWatcher.h"
 #include "eckit/serialisation/Streamable.h"
+#include "eckit/thread/Mutex.h"
 
 namespace eckit {
 
@@ -42,6 +44,15 @@ public:
 };
 
 
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A byte range to read with DataHandle::readv() into a caller-provided buffer
+struct ReadRange {
+    void* buffer;
+    long length;
+    Offset offset;
+};
+
 //----------------------------------------------------------------------------------------------------------------------
 
 class DataHandle : public Streamable {
@@ -86,6 +97,27 @@ public:
     virtual bool canSeek() const;
     virtual void skip(const Length&);
 
+    /// Positional read: reads up to length bytes at offset, without changing the position of the handle.
+    /// Returns less than length only at the end of the data.
+    /// Handles implementing it natively allow concurrent calls from several threads; the default
+    /// implementation serialises seek() and read() on the handle and requires it to be opened for read.
+    virtual long pread(void*, long, const Offset&);
+
+    /// Vectored positional read of the ranges, in order; stops at the first range cut short by the end of data.
+    /// Returns the total number of bytes read.
+    virtual Length readv(const std::vector<ReadRange>&);
+
+    /// True if the handle implements pread() natively, so that several threads can read it at once
+    virtual bool canPread() const { return false; }
+
+    /// Positional write: writes length bytes at offset, without changing the position of the handle.
+    /// Handles implementing it natively allow concurrent calls from several threads; the default
+    /// implementation serialises seek() and write() on the handle and requires it to be opened for write.
+    virtual long pwrite(const void*, long, const Offset&);
+
+    /// True if the handle is opened for write and implements pwrite() natively
+    virtual bool canPwrite() const { return false; }
+
     virtual void rewind();
     virtual void restartReadFrom(const Offset&);
     virtual void restartWriteFrom(const Offset&);
@@ -99,7 +131,7 @@ public:
     virtual Length saveInto(const PathName&, TransferWatcher& = TransferWatcher::dummy());
 
     /// Quiet version of saveInto
-    /// Does not support progess, restart and double buffering
+    /// Does not support progess, restart and double buffering, but uses several streams if configured (see DblBuffer)
     virtual Length copyTo(DataHandle&, long bufsize = -1, Length maxsize = -1,
                           TransferWatcher& = TransferWatcher::dummy());
 
@@ -149,6 +181,14 @@ public:
 
     virtual bool doubleBufferOK() const { return true; }
 
+    // For transfers done by the kernel (see zeroCopy())
+
+    /// Descriptor the open handle reads from or writes to, or -1 if the data must go through read()/write()
+    virtual int fileDescriptor() { return -1; }
+
+    /// Informs the handle that the kernel moved length bytes through fileDescriptor()
+    virtual void transferred(const Length&) {}
+
     // -- Overridden methods
 
     // From Streamble
@@ -162,6 +202,11 @@ public:
 
 private:
 
+    // -- Members
+
+    /// Serialises the default positional reads and writes, which move the position of the handle
+    Mutex positionalMutex_;
+
     // -- Class members
 
     static ClassSpec classSpec_;
@@ -9,10 +9,16 @@
  */
 
 
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
 #include "eckit/io/DblBuffer.h"
 #include "eckit/config/Resource.h"
 #include "eckit/io/AutoCloser.h"
 #include "eckit/io/Buffer.h"
+#include "eckit/io/ZeroCopy.h"
 #include "eckit/log/Bytes.h"
 #include "eckit/log/Log.h"
 #include "eckit/log/Progress.h"
@@ -57,8 +63,96 @@ public:
     virtual void run();
 };
 
+/// State shared by the threads of DblBuffer::copyStreams(). The source is cut in chunks of the size of a buffer;
+/// readers take a free buffer and the next chunk, writers take any chunk read (or the next one, if ordered).
+struct StreamChunks {
+    StreamChunks(long count, long size, const Length& length, const Offset& in, const Offset& out, bool ordered) :
+        memory_(size_t(count) * size),
+        size_(size),
+        length_(length),
+        chunks_((length_ + size_ - 1) / size_),
+        inStart_(in),
+        outStart_(out),
+        ordered_(ordered),
+        done_(chunks_, false) {
+        char* addr = memory_;
+        for (long j = 0; j < count; j++) {
+            free_.push_back(addr);
+            addr += size;
+        }
+    }
+
+    long length(long long k) const { return std::min(size_, length_ - k * size_); }
+
+    void fail() {
+        AutoLock<MutexCond> lock(cond_);
+        failed_ = true;
+        cond_.broadcast();
+    }
+
+    MutexCond cond_;
+    Buffer memory_;
+
+    const long long size_;
+    const long long length_;
+    const long long chunks_;
+    const long long inStart_;
+    const long long outStart_;
+    const bool ordered_;
+
+    std::vector<char*> free_;
+    std::map<long long, std::pair<char*, long>> full_;
+    std::vector<bool> done_;
+
+    long long nextRead_  = 0;
+    long long nextWrite_ = 0;
+    long long prefix_    = 0;  ///< chunks written without a gap from the start
+    long long bytes_     = 0;
+    bool failed_         = false;
+};
+
+class DblBufferStream : public Thread {
+    DblBuffer& owner_;
+    StreamChunks& chunks_;
+    DataHandle& handle_;
+    bool reader_;
+    long parent_;
+
+    void read();
+    void write();
+
+public:
+
+    DblBufferStream(DblBuffer&, StreamChunks&, DataHandle&, bool reader, long parent);
+    virtual void run();
+};
+
+static long defaultReaders() {
+    static long readers = Resource<long>("doubleBufferReaders;$ECKIT_DOUBLE_BUFFER_READERS", 1);
+    return readers;
+}
+
+static long defaultWriters() {
+    static long writers = Resource<long>("doubleBufferWriters;$ECKIT_DOUBLE_BUFFER_WRITERS", 1);
+    return writers;
+}
+
+bool DblBuffer::multiStream() {
+    return defaultReaders() > 1 || defaultWriters() > 1;
+}
+
 DblBuffer::DblBuffer(long count, long size, TransferWatcher& watcher) :
-    count_(count), bufSize_(size), error_(false), restart_(false), restartFrom_(0), watcher_(watcher) {
+    DblBuffer(count, size, watcher, defaultReaders(), defaultWriters()) {}
+
+DblBuffer::DblBuffer(long count, long size, TransferWatcher& watcher, long readers, long writers) :
+    count_(count),
+    bufSize_(size),
+    readers_(std::max(readers, 1L)),
+    writers_(std::max(writers, 1L)),
+    error_(false),
+    restart_(false),
+    restartFrom_(0),
+    watcher_(watcher) {
     Log::info() << "Double buffering: " << count_ << " buffers of " << Bytes(size) << " is " << Bytes(count * size)
                 << std::endl;
 }
@@ -100,14 +194,23 @@ Length DblBuffer::copy(DataHandle& in, DataHandle& out) {
     Length total  = estimate;
     Length copied = 0;
 
+    // Let the kernel move the data if it can, the buffers complete the transfer
+    Length moved = zeroCopy(in, out, estimate, long(count_) * bufSize_, watcher_);
+    if (moved > Length(0)) {
+        Log::info() << "Moved by the kernel: " << moved << ", estimate: " << estimate << std::endl;
+        if (estimate != Length(0)) {
+            estimate = estimate - moved;
+        }
+    }
+
     static Resource<long> maxRetriesResource("dblBufferMaxRetries", 5);
     long maxRetries = maxRetriesResource;
 
-    bool more = true;
+    bool more = !(moved > Length(0) && total != Length(0) && estimate == Length(0));
     while (more) {
         more = false;
         try {
-            copied = copy(in, out, estimate);
+            copied = streams(in, out, estimate) ? copyStreams(in, out, estimate) : copy(in, out, estimate);
             Log::info() << "Copied: " << copied << ", estimate: " << estimate << std::endl;
             if (estimate) {
                 if (copied != estimate) {
@@ -134,8 +237,8 @@ Length DblBuffer::copy(DataHandle& in, DataHandle& out) {
         }
     }
 
-    Log::info() << "Transfer rate " << Bytes(estimate, timer) << std::endl;
-    return copied;
+    Log::info() << "Transfer rate " << Bytes(total != Length(0) ? total : copied + moved, timer) << std::endl;
+    return copied + moved;
 }
 
 Length DblBuffer::copy(DataHandle& in, DataHandle& out, const Length& estimate) {
@@ -255,6 +358,181 @@ Length DblBuffer::copy(DataHandle& in, DataHandle& out, const Length& estimate)
     return inBytes_;
 }
 
+bool DblBuffer::streams(DataHandle& in, DataHandle& out, const Length& length) const {
+    return (readers_ > 1 || writers_ > 1) && length > Length(0) && in.canPread();
+}
+
+Length DblBuffer::copyStreams(DataHandle& in, DataHandle& out, const Length& length) {
+    if (!streams(in, out, length)) {
+        return 0;
+    }
+
+    // Watchers looking at the data, and targets without positional writes, get the chunks in order
+    const bool ordered = watcher_.needsData() || !out.canPwrite();
+    const long writers = ordered ? 1 : writers_;
+
+    StreamChunks chunks(count_, bufSize_, length, in.position(), ordered ? Offset(0) : out.position(), ordered);
+
+    error_   = false;
+    restart_ = false;
+
+    Log::info() << "Copying " << Bytes(length) << " with " << readers_ << " readers and " << writers
+                << (ordered ? " ordered" : "") << " writers" << std::endl;
+
+    Timer timer("Double buffer streams");
+
+    watcher_.watch(nullptr, 0);
+
+    long parent = Monitor::instance().self();
+
+    std::vector<std::unique_ptr<ThreadControler>> threads;
+    for (long i = 0; i < readers_; i++) {
+        threads.emplace_back(new ThreadControler(new DblBufferStream(*this, chunks, in, true, parent), false));
+    }
+    for (long i = 0; i < writers; i++) {
+        threads.emplace_back(new ThreadControler(new DblBufferStream(*this, chunks, out, false, parent), false));
+    }
+
+    for (auto& t : threads) {
+        t->start();
+    }
+    for (auto& t : threads) {
+        t->wait();
+    }
+
+    if (error_) {
+        if (restart_) {
+            // Chunks are written out of order: restart after the last one written without a gap
+            throw RestartTransfer(chunks.inStart_ + chunks.prefix_ * chunks.size_);
+        }
+        throw DblBufferError(why_);
+    }
+
+    PANIC(chunks.bytes_ != chunks.length_);
+
+    // Positional I/O did not move the handles
+    in.seek(chunks.inStart_ + chunks.length_);
+    if (!ordered) {
+        out.seek(chunks.outStart_ + chunks.length_);
+    }
+
+    Log::info() << "Streams rate " << Bytes(length, timer) << std::endl;
+
+    in.collectMetrics("source");
+    out.collectMetrics("target");
+    Metrics::set("size", length);
+    Metrics::set("time", timer.elapsed());
+    Metrics::set("readers", readers_);
+    Metrics::set("writers", writers);
+
+    return length;
+}
+
+DblBufferStream::DblBufferStream(DblBuffer& owner, StreamChunks& chunks, DataHandle& handle, bool reader,
+                                 long parent) :
+    Thread(false), owner_(owner), chunks_(chunks), handle_(handle), reader_(reader), parent_(parent) {}
+
+void DblBufferStream::run() {
+    Monitor::instance().parent(parent_);
+
+    try {
+        if (reader_) {
+            read();
+        }
+        else {
+            write();
+        }
+    }
+    catch (RestartTransfer& retry) {
+        Log::warning() << "RestartTransfer: Exiting " << (reader_ ? "reader" : "writer") << " thread" << std::endl;
+        owner_.restart(retry);
+        chunks_.fail();
+    }
+    catch (std::exception& e) {
+        Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+        Log::error() << "** Exception is handled" << std::endl;
+        owner_.error(e.what());
+        chunks_.fail();
+    }
+}
+
+void DblBufferStream::read() {
+    for (;;) {
+        char* buffer;
+        long long k;
+        {
+            AutoLock<MutexCond> lock(chunks_.cond_);
+            while (!chunks_.failed_ && chunks_.nextRead_ < chunks_.chunks_ && chunks_.free_.empty()) {
+                chunks_.cond_.wait();
+            }
+            if (chunks_.failed_ || chunks_.nextRead_ >= chunks_.chunks_) {
+                return;
+            }
+            buffer = chunks_.free_.back();
+            chunks_.free_.pop_back();
+            k = chunks_.nextRead_++;
+        }
+
+        long length = chunks_.length(k);
+        if (handle_.pread(buffer, length, chunks_.inStart_ + k * chunks_.size_) != length) {
+            throw ShortFile(handle_.name());
+        }
+
+        AutoLock<MutexCond> lock(chunks_.cond_);
+        chunks_.full_.emplace(k, std::make_pair(buffer, length));
+        chunks_.cond_.broadcast();
+    }
+}
+
+void DblBufferStream::write() {
+    for (;;) {
+        long long k;
+        char* buffer;
+        long length;
+        {
+            AutoLock<MutexCond> lock(chunks_.cond_);
+            auto j = chunks_.full_.end();
+            for (;;) {
+                if (chunks_.failed_ || chunks_.nextWrite_ >= chunks_.chunks_) {
+                    return;
+                }
+                j = chunks_.ordered_ ? chunks_.full_.find(chunks_.nextWrite_) : chunks_.full_.begin();
+                if (j != chunks_.full_.end()) {
+                    break;
+                }
+                chunks_.cond_.wait();
+            }
+            k      = j->first;
+            buffer = j->second.first;
+            length = j->second.second;
+            chunks_.full_.erase(j);
+            chunks_.nextWrite_++;
+        }
+
+        long written = chunks_.ordered_ ? handle_.write(buffer, length)
+                                        : handle_.pwrite(buffer, length, chunks_.outStart_ + k * chunks_.size_);
+        if (written != length) {
+            throw WriteError(handle_.name());
+        }
+
+        if (chunks_.ordered_) {
+            owner_.watcher_.watch(buffer, length);
+        }
+
+        AutoLock<MutexCond> lock(chunks_.cond_);
+        chunks_.done_[k] = true;
+        while (chunks_.prefix_ < chunks_.chunks_ && chunks_.done_[chunks_.prefix_]) {
+            chunks_.prefix_++;
+        }
+        chunks_.bytes_ += length;
+        if (!chunks_.ordered_) {
+            owner_.watcher_.watch(nullptr, length);
+        }
+        chunks_.free_.push_back(buffer);
+        chunks_.cond_.broadcast();
+    }
+}
+
 DblBufferTask::DblBufferTask(DataHandle& out, DblBuffer& owner, OneBuffer* buffers, const Length& estimate,
                              long parent) :
     Thread(false), owner_(owner), out_(out), estimate_(estimate), buffers_(buffers), parent_(parent) {}
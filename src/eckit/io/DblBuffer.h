@@ -24,12 +24,20 @@
 namespace eckit {
 
 
+/// Copies a handle into another with a reader and a writer thread sharing count buffers of size bytes.
+///
+/// With several readers or writers, a seekable source of known length is split in chunks of size bytes,
+/// read concurrently with pread() and written with pwrite() when the target allows it (in order otherwise).
+/// The number of threads comes from the resources doubleBufferReaders;$ECKIT_DOUBLE_BUFFER_READERS and
+/// doubleBufferWriters;$ECKIT_DOUBLE_BUFFER_WRITERS (default 1, a single stream).
+
 class DblBuffer {
 public:
 
     // -- Contructors
 
     DblBuffer(long count = 5, long size = 1024 * 1024, TransferWatcher& = TransferWatcher::dummy());
+    DblBuffer(long count, long size, TransferWatcher&, long readers, long writers);
 
     DblBuffer(const DblBuffer&)            = delete;
     DblBuffer& operator=(const DblBuffer&) = delete;
@@ -44,6 +52,13 @@ public:
 
     Length copy(DataHandle&, DataHandle&);
 
+    /// Copies length bytes between two opened handles, from their current positions, with several streams.
+    /// Returns 0 if there is a single stream or the handles do not allow it, and the caller should carry on.
+    Length copyStreams(DataHandle& in, DataHandle& out, const Length& length);
+
+    /// True if the resources ask for more than one reader or writer
+    static bool multiStream();
+
     bool error();
     void error(const std::string&);
     void restart(RestartTransfer&);
@@ -51,6 +66,7 @@ public:
 private:  // methods
 
     Length copy(DataHandle&, DataHandle&, const Length&);
+    bool streams(DataHandle&, DataHandle&, const Length&) const;
 
 private:  // members
 
@@ -58,6 +74,8 @@ private:  // members
 
     long count_;
     long bufSize_;
+    long readers_;
+    long writers_;
 
     Length inBytes_;
     Length outBytes_;
@@ -73,6 +91,7 @@ private:  // members
     // -- Friends
 
     friend class DblBufferTask;
+    friend class DblBufferStream;
 };
 
 
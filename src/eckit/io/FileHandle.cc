@@ -10,6 +10,9 @@
 
 #include <dirent.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
 
 #include "eckit/eckit.h"
 
@@ -17,7 +20,9 @@
 #include "eckit/io/DataHandle.h"
 #include "eckit/io/FDataSync.h"
 #include "eckit/io/FileHandle.h"
+#include "eckit/io/HandleMetrics.h"
 #include "eckit/io/MoverTransferSelection.h"
+#include "eckit/io/PositionalFile.h"
 #include "eckit/io/cluster/NodeInfo.h"
 #include "eckit/log/Bytes.h"
 #include "eckit/log/Log.h"
@@ -27,6 +32,16 @@
 
 namespace eckit {
 
+namespace {
+
+/// The metrics of the FileHandles, if enabled (n.b. costs two clock reads per operation)
+HandleMetrics* metrics() {
+    static HandleMetrics* metrics =
+        Resource<bool>("fileHandleMetrics;$ECKIT_FILEHANDLE_METRICS", false) ? new HandleMetrics("io.file") : nullptr;
+    return metrics;
+}
+
+}  // namespace
 
 ClassSpec FileHandle::classSpec_ = {
     &DataHandle::classSpec(),
@@ -44,17 +59,26 @@ void FileHandle::encode(Stream& s) const {
     s << overwrite_;
 }
 
-FileHandle::FileHandle(Stream& s) : DataHandle(s), overwrite_(false), file_{nullptr}, read_(false) {
+FileHandle::FileHandle(Stream& s) :
+    DataHandle(s), overwrite_(false), file_{nullptr}, read_(false), append_(false) {
     s >> name_;
     s >> overwrite_;
+    positional_.reset(new PositionalFile(name_));
 }
 
 FileHandle::FileHandle(const std::string& name, bool overwrite) :
-    name_(name), overwrite_(overwrite), file_{nullptr}, read_(false) {}
+    name_(name),
+    overwrite_(overwrite),
+    file_{nullptr},
+    read_(false),
+    append_(false),
+    positional_(new PositionalFile(name)) {}
 
 FileHandle::~FileHandle() {}
 
 void FileHandle::open(const char* mode) {
+    flushed_ = false;
+
     file_ = ::fopen(name_.c_str(), mode);
     if (file_ == nullptr) {
         throw CantOpenFile(name_);
@@ -84,13 +108,15 @@ void FileHandle::open(const char* mode) {
 }
 
 Length FileHandle::openForRead() {
-    read_ = true;
+    read_   = true;
+    append_ = false;
     open("r");
     return estimate();
 }
 
 void FileHandle::openForWrite(const Length& length) {
-    read_ = false;
+    read_   = false;
+    append_ = false;
     PathName path(name_);
     // This is for preallocated files
     if (overwrite_ && path.exists()) {
@@ -103,16 +129,29 @@ void FileHandle::openForWrite(const Length& length) {
 }
 
 void FileHandle::openForAppend(const Length&) {
+    read_   = false;
+    append_ = true;
     open("a");
 }
 
 long FileHandle::read(void* buffer, long length) {
+    if (HandleMetrics* m = metrics()) {
+        const uint64_t start = HandleMetrics::now();
+        long len             = ::fread(buffer, 1, length, file_);
+        m->read(len, start);
+        return len;
+    }
     return ::fread(buffer, 1, length, file_);
 }
 
 long FileHandle::write(const void* buffer, long length) {
     ASSERT(buffer);
 
+    HandleMetrics* m     = metrics();
+    const uint64_t start = m ? HandleMetrics::now() : 0;
+
+    flushed_.store(false, std::memory_order_relaxed);
+
     errno        = 0;
     long written = ::fwrite(buffer, 1, length, file_);
 
@@ -135,6 +174,10 @@ long FileHandle::write(const void* buffer, long length) {
         } while (len != length && errno == ENOSPC);
     }
 
+    if (m) {
+        m->write(written, start);
+    }
+
     return written;
 }
 
@@ -168,6 +211,8 @@ void FileHandle::flush() {
 
 
 void FileHandle::close() {
+    positional_->close();
+
     if (file_ == nullptr) {
         return;
     }
@@ -190,6 +235,47 @@ void FileHandle::close() {
     file_ = nullptr;
 }
 
+long FileHandle::pread(void* buffer, long length, const Offset& offset) {
+    return positional_->read(buffer, length, offset);
+}
+
+Length FileHandle::readv(const std::vector<ReadRange>& ranges) {
+    return positional_->readv(ranges);
+}
+
+bool FileHandle::canPwrite() const {
+    // Files opened for append are always written at the end
+    return file_ != nullptr && !read_ && !append_;
+}
+
+long FileHandle::pwrite(const void* buffer, long length, const Offset& offset) {
+    ASSERT(canPwrite());
+
+    // Flush once when switching from write() to positional writes
+
+    if (!flushed_.exchange(true) && ::fflush(file_) != 0) {
+        throw WriteError(std::string("fflush ") + name());
+    }
+
+    int fd        = ::fileno(file_);
+    const char* p = static_cast<const char*>(buffer);
+    off_t pos     = offset;
+    long written  = 0;
+
+    while (written < length) {
+        ssize_t n = ::pwrite(fd, p + written, length - written, pos + written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            throw WriteError(name_, Here());
+        }
+        written += n;
+    }
+
+    return written;
+}
+
 void FileHandle::rewind() {
     ::rewind(file_);
 }
@@ -219,6 +305,31 @@ Offset FileHandle::position() {
     return ::ftello(file_);
 }
 
+int FileHandle::fileDescriptor() {
+    if (file_ == nullptr) {
+        return -1;
+    }
+    if (!read_ && ::fflush(file_) != 0) {
+        throw WriteError(std::string("fflush ") + name());
+    }
+    return ::fileno(file_);
+}
+
+void FileHandle::transferred(const Length& len) {
+    ASSERT(file_);
+    if (read_) {
+        // The data was read at position(), without moving the descriptor
+        advance(len);
+    }
+    else {
+        // The data was written at the offset of the descriptor
+        off_t here = ::lseek(::fileno(file_), 0, SEEK_CUR);
+        if (here < 0 || ::fseeko(file_, here, SEEK_SET) < 0) {
+            throw WriteError(name_);
+        }
+    }
+}
+
 void FileHandle::advance(const Length& len) {
     off_t l = len;
     if (::fseeko(file_, l, SEEK_CUR) < 0) {
@@ -249,12 +360,19 @@ void FileHandle::restartWriteFrom(const Offset& from) {
 }
 
 Offset FileHandle::seek(const Offset& from) {
+    HandleMetrics* m     = metrics();
+    const uint64_t start = m ? HandleMetrics::now() : 0;
+
     off_t l = from;
     if (::fseeko(file_, l, SEEK_SET) < 0) {
         throw ReadError(name_);
     }
     off_t w = ::ftello(file_);
     ASSERT(w == l);
+
+    if (m) {
+        m->seek(start);
+    }
     return w;
 }
 
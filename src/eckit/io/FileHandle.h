@@ -15,6 +15,7 @@
 #ifndef eckit_io_FileHandle_h
 #define eckit_io_FileHandle_h
 
+#include <atomic>
 #include <memory>
 
 #include "eckit/io/Buffer.h"
@@ -22,6 +23,8 @@
 
 namespace eckit {
 
+class PositionalFile;
+
 class FileHandle : public DataHandle {
 
 public:
@@ -68,6 +71,15 @@ public:
     bool canSeek() const override;
     void skip(const Length&) override;
 
+    long pread(void*, long, const Offset&) override;
+    Length readv(const std::vector<ReadRange>&) override;
+    bool canPread() const override { return true; }
+    long pwrite(const void*, long, const Offset&) override;
+    bool canPwrite() const override;
+
+    int fileDescriptor() override;
+    void transferred(const Length&) override;
+
     DataHandle* clone() const override;
     void hash(MD5& md5) const override;
 
@@ -86,8 +98,13 @@ private:  // members
     bool overwrite_;
     FILE* file_;
     bool read_;
+    bool append_;
+
+    /// Whether the FILE* was flushed for pwrite(), since opened or last written to
+    std::atomic<bool> flushed_{false};
 
     std::unique_ptr<Buffer> buffer_;
+    std::unique_ptr<PositionalFile> positional_;
 
 private:  // methods
 
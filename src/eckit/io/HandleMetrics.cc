@@ -0,0 +1,31 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/io/HandleMetrics.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HandleMetrics::HandleMetrics(const std::string& prefix) :
+    reads_(MetricsRegistry::counter(prefix + ".reads")),
+    readBytes_(MetricsRegistry::counter(prefix + ".read_bytes")),
+    readSize_(MetricsRegistry::histogram(prefix + ".read_size")),
+    readLatency_(MetricsRegistry::histogram(prefix + ".read_latency")),
+    writes_(MetricsRegistry::counter(prefix + ".writes")),
+    writeBytes_(MetricsRegistry::counter(prefix + ".write_bytes")),
+    writeSize_(MetricsRegistry::histogram(prefix + ".write_size")),
+    writeLatency_(MetricsRegistry::histogram(prefix + ".write_latency")),
+    seeks_(MetricsRegistry::counter(prefix + ".seeks")),
+    seekLatency_(MetricsRegistry::histogram(prefix + ".seek_latency")) {}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,86 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   HandleMetrics.h
+/// @date   Oct 2026
+
+#ifndef eckit_io_HandleMetrics_h
+#define eckit_io_HandleMetrics_h
+
+#include <cstdint>
+#include <string>
+
+#include "eckit/runtime/MetricsRegistry.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// The operations of a kind of DataHandle, in the MetricsRegistry: for a @param prefix "io.file", the counters
+/// io.file.reads, io.file.read_bytes, io.file.writes, io.file.write_bytes and io.file.seeks, and the histograms
+/// io.file.read_size, io.file.read_latency, io.file.write_size, io.file.write_latency (bytes and nanoseconds) and
+/// io.file.seek_latency.
+
+class HandleMetrics {
+public:
+
+    explicit HandleMetrics(const std::string& prefix);
+
+    HandleMetrics(const HandleMetrics&)            = delete;
+    HandleMetrics& operator=(const HandleMetrics&) = delete;
+
+    void read(long length, uint64_t start) {
+        const uint64_t elapsed = now() - start;
+        const uint64_t bytes   = length > 0 ? length : 0;
+        reads_.add();
+        readBytes_.add(bytes);
+        readSize_.record(bytes);
+        readLatency_.record(elapsed);
+    }
+
+    void write(long length, uint64_t start) {
+        const uint64_t elapsed = now() - start;
+        const uint64_t bytes   = length > 0 ? length : 0;
+        writes_.add();
+        writeBytes_.add(bytes);
+        writeSize_.record(bytes);
+        writeLatency_.record(elapsed);
+    }
+
+    void seek(uint64_t start) {
+        const uint64_t elapsed = now() - start;
+        seeks_.add();
+        seekLatency_.record(elapsed);
+    }
+
+    /// The start of an operation, in nanoseconds
+    static uint64_t now() { return MetricsRegistry::Latency::now(); }
+
+private:
+
+    MetricsRegistry::Counter& reads_;
+    MetricsRegistry::Counter& readBytes_;
+    MetricsRegistry::Histogram& readSize_;
+    MetricsRegistry::Histogram& readLatency_;
+
+    MetricsRegistry::Counter& writes_;
+    MetricsRegistry::Counter& writeBytes_;
+    MetricsRegistry::Histogram& writeSize_;
+    MetricsRegistry::Histogram& writeLatency_;
+
+    MetricsRegistry::Counter& seeks_;
+    MetricsRegistry::Histogram& seekLatency_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
@@ -14,6 +14,9 @@
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
+
 #include "eckit/exception/Exceptions.h"
 #include "eckit/io/MMappedFileHandle.h"
 #include "eckit/io/MemoryHandle.h"
@@ -153,6 +156,21 @@ void MMappedFileHandle::skip(const Length& n) {
     handle_->skip(n);
 }
 
+long MMappedFileHandle::pread(void* buffer, long length, const Offset& offset) {
+    ASSERT(mmap_);
+
+    off_t from = offset;
+    ASSERT(from >= 0);
+
+    if (from >= length_) {
+        return 0;
+    }
+
+    long n = static_cast<long>(std::min<off_t>(length, length_ - from));
+    ::memcpy(buffer, static_cast<const char*>(mmap_) + from, n);
+    return n;
+}
+
 
 std::string MMappedFileHandle::title() const {
     return "mmap(" + PathName::shorten(path_) + ")";
@@ -59,6 +59,9 @@ public:
     bool canSeek() const override { return true; }
     void skip(const Length&) override;
 
+    long pread(void*, long, const Offset&) override;
+    bool canPread() const override { return mmap_ != nullptr; }
+
     DataHandle* clone() const override;
     void hash(MD5& md5) const override;
 
@@ -8,12 +8,16 @@
  * does it submit to any jurisdiction.
  */
 
+#include <algorithm>
 #include <numeric>
 
 #include "eckit/config/Resource.h"
+#include "eckit/io/CoalescingReader.h"
 #include "eckit/io/MultiHandle.h"
+#include "eckit/io/PartFileHandle.h"
 #include "eckit/log/Timer.h"
 #include "eckit/runtime/Metrics.h"
+#include "eckit/thread/AutoLock.h"
 #include "eckit/types/Types.h"
 
 namespace eckit {
@@ -64,6 +68,8 @@ MultiHandle::~MultiHandle() {
 void MultiHandle::operator+=(DataHandle* dh) {
     ASSERT(dh != nullptr);
 
+    starts_.clear();
+
     // Try to merge with self
 
     if (merge(dh)) {
@@ -88,10 +94,46 @@ void MultiHandle::operator+=(const Length& length) {
     length_.push_back(length);
 }
 
+bool MultiHandle::coalesce() {
+    coalescing_.reset();
+
+    if (!CoalescingReader::enabled()) {
+        return false;
+    }
+
+    // Only handles made of parts of files can be scheduled together
+    size_t parts = 0;
+    for (auto* dh : datahandles_) {
+        auto* part = dynamic_cast<PartFileHandle*>(dh);
+        if (!part) {
+            return false;
+        }
+        parts += part->offsets().size();
+    }
+
+    if (parts < 2) {
+        return false;
+    }
+
+    coalescing_.reset(new CoalescingReader());
+    for (auto* dh : datahandles_) {
+        auto* part = static_cast<PartFileHandle*>(dh);
+        for (size_t i = 0; i < part->offsets().size(); ++i) {
+            coalescing_->add(part->path(), part->offsets()[i], part->lengths()[i]);
+        }
+    }
+    return true;
+}
+
 Length MultiHandle::openForRead() {
 
     read_ = true;
 
+    current_ = datahandles_.end();
+    if (coalesce()) {
+        return estimate();
+    }
+
     current_ = datahandles_.begin();
     openCurrent();
 
@@ -105,6 +147,7 @@ void MultiHandle::openForWrite(const Length& length) {
     ASSERT(datahandles_.size() == length_.size());
 
     read_ = false;
+    coalescing_.reset();
 
     Log::info() << "MultiHandle::openForWrite " << length << std::endl;
     Log::info() << "MultiHandle::openForWrite " << datahandles_.size() << std::endl;
@@ -159,6 +202,10 @@ long MultiHandle::read1(char* buffer, long length) {
 }
 
 long MultiHandle::read(void* buffer, long length) {
+    if (coalescing_) {
+        return coalescing_->read(buffer, length);
+    }
+
     char* p    = static_cast<char*>(buffer);
     long n     = 0;
     long total = 0;
@@ -219,6 +266,9 @@ long MultiHandle::write(const void* buffer, long length) {
 }
 
 void MultiHandle::close() {
+    if (coalescing_) {
+        coalescing_->close();
+    }
     if (current_ != datahandles_.end()) {
         (*current_)->close();
     }
@@ -233,6 +283,10 @@ void MultiHandle::flush() {
 
 void MultiHandle::rewind() {
     ASSERT(read_);
+    if (coalescing_) {
+        coalescing_->seek(0);
+        return;
+    }
     if (current_ != datahandles_.end()) {
         (*current_)->close();
     }
@@ -320,6 +374,9 @@ bool MultiHandle::canSeek() const {
 }
 
 Offset MultiHandle::position() {
+    if (coalescing_) {
+        return coalescing_->position();
+    }
     long long accumulated = 0;
     for (HandleList::iterator it = datahandles_.begin(); it != current_ && it != datahandles_.end(); ++it) {
         accumulated += (*it)->size();
@@ -330,6 +387,15 @@ Offset MultiHandle::position() {
 Offset MultiHandle::seek(const Offset& offset) {
     ASSERT(read_);  /// seek only allowed on read mode
 
+    if (coalescing_) {
+        // As below, seeking beyond EOF leaves the position at EOF before asserting
+        const long long seekto = offset;
+        const long long end    = coalescing_->size();
+        coalescing_->seek(std::min(seekto, end));
+        ASSERT(seekto <= end);
+        return offset;
+    }
+
     if (current_ != datahandles_.end()) {
         (*current_)->close();
     }
@@ -351,9 +417,96 @@ Offset MultiHandle::seek(const Offset& offset) {
     return offset;
 }
 
+const std::vector<long long>& MultiHandle::starts() {
+    AutoLock<Mutex> lock(mutex_);
+    if (starts_.empty()) {
+        starts_.reserve(datahandles_.size() + 1);
+        starts_.push_back(0);
+        for (auto* dh : datahandles_) {
+            starts_.push_back(starts_.back() + (long long)dh->size());
+        }
+    }
+    return starts_;
+}
+
+bool MultiHandle::canPread() const {
+    for (size_t i = 0; i < datahandles_.size(); i++) {
+        if (!datahandles_[i]->canPread()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+long MultiHandle::pread(void* buffer, long length, const Offset& offset) {
+    return readv({{buffer, length, offset}});
+}
+
+Length MultiHandle::readv(const std::vector<ReadRange>& ranges) {
+    const std::vector<long long>& starts = this->starts();
+
+    // Split the ranges across the handles
+
+    std::vector<std::pair<size_t, ReadRange>> parts;
+    parts.reserve(ranges.size());
+
+    for (const auto& r : ranges) {
+        long long from = r.offset;
+        ASSERT(from >= 0);
+        ASSERT(r.length >= 0);
+
+        size_t i  = std::upper_bound(starts.begin(), starts.end(), from) - starts.begin() - 1;
+        char* p   = static_cast<char*>(r.buffer);
+        long left = r.length;
+
+        for (; left > 0 && i < datahandles_.size(); ++i) {
+            long long within = from - starts[i];
+            long size        = std::min<long long>(left, starts[i + 1] - from);
+            if (size > 0) {
+                parts.emplace_back(i, ReadRange{p, size, within});
+                p += size;
+                left -= size;
+                from += size;
+            }
+        }
+
+        if (left > 0) {
+            break;
+        }
+    }
+
+    // Consecutive parts of the same handle are read with one call
+
+    Length total = 0;
+    std::vector<ReadRange> batch;
+
+    for (size_t j = 0; j < parts.size();) {
+        size_t i = parts[j].first;
+
+        batch.clear();
+        Length expected = 0;
+        for (; j < parts.size() && parts[j].first == i; ++j) {
+            batch.push_back(parts[j].second);
+            expected += parts[j].second.length;
+        }
+
+        Length n = datahandles_[i]->readv(batch);
+        total += n;
+        if (n != expected) {
+            break;
+        }
+    }
+
+    return total;
+}
+
 void MultiHandle::restartReadFrom(const Offset& offset) {
     Log::warning() << *this << " restart read from " << offset << std::endl;
     ASSERT(read_);
+    if (coalescing_) {
+        coalescing_->seek(offset);
+        return;
+    }
     if (current_ != datahandles_.end()) {
         (*current_)->close();
     }
@@ -402,6 +555,7 @@ void MultiHandle::toLocal(Stream& s) const {
 }
 
 DataHandle* MultiHandle::toLocal() {
+    starts_.clear();
     for (size_t i = 0; i < datahandles_.size(); i++) {
         DataHandle* loc = datahandles_[i]->toLocal();
         if (loc != datahandles_[i]) {
@@ -441,6 +595,10 @@ std::string MultiHandle::title() const {
 }
 
 void MultiHandle::collectMetrics(const std::string& what) const {
+    if (coalescing_) {
+        coalescing_->collectMetrics(what);
+    }
+
     if (datahandles_.size() == 1) {
         return datahandles_[0]->collectMetrics(what);
     }
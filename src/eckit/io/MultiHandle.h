@@ -17,10 +17,15 @@
 #ifndef eckit_filesystem_MultiHandle_h
 #define eckit_filesystem_MultiHandle_h
 
+#include <memory>
+
 #include "eckit/io/DataHandle.h"
+#include "eckit/thread/Mutex.h"
 
 namespace eckit {
 
+class CoalescingReader;
+
 //----------------------------------------------------------------------------------------------------------------------
 
 class MultiHandle : public DataHandle {
@@ -65,6 +70,11 @@ public:
     Offset seek(const Offset&) override;
     bool canSeek() const override;
 
+    /// Positional reads are dispatched to the positional reads of the handles
+    long pread(void*, long, const Offset&) override;
+    Length readv(const std::vector<ReadRange>&) override;
+    bool canPread() const override;
+
     bool merge(DataHandle*) override;
     bool compress(bool = false) override;
 
@@ -100,11 +110,17 @@ private:
     mutable std::set<std::string> requiredAttributes_;
     bool read_;
 
+    Mutex mutex_;
+    std::vector<long long> starts_;  ///< positions of the handles, for positional reads
+    std::unique_ptr<CoalescingReader> coalescing_;
+
     // -- Methods
 
     void openCurrent();
     void open();
+    bool coalesce();
     long read1(char*, long);
+    const std::vector<long long>& starts();
 
     // -- Class members
 
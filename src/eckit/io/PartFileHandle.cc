@@ -9,16 +9,19 @@
  */
 
 
+#include <algorithm>
 #include <numeric>
 
 #include "eckit/io/cluster/NodeInfo.h"
 #include "eckit/log/Log.h"
 
 #include "eckit/exception/Exceptions.h"
+#include "eckit/io/CoalescingReader.h"
 #include "eckit/io/PartFileHandle.h"
 
 #include "eckit/io/MoverTransferSelection.h"
 #include "eckit/io/PooledHandle.h"
+#include "eckit/io/PositionalFile.h"
 
 namespace eckit {
 
@@ -52,17 +55,31 @@ PartFileHandle::PartFileHandle(Stream& s) : DataHandle(s), pos_(0), index_(0) {
     s >> length_;
 
     ASSERT(offset_.size() == length_.size());
+
+    positional_.reset(new PositionalFile(path_.localPath()));
 }
 
 PartFileHandle::PartFileHandle(const PathName& name, const OffsetList& offset, const LengthList& length) :
-    path_(name), handle_(), pos_(0), index_(0), offset_(offset), length_(length) {
+    path_(name),
+    handle_(),
+    positional_(new PositionalFile(name.localPath())),
+    pos_(0),
+    index_(0),
+    offset_(offset),
+    length_(length) {
     //    Log::info() << "PartFileHandle::PartFileHandle " << name << std::endl;
     ASSERT(offset_.size() == length_.size());
     compress(false);
 }
 
 PartFileHandle::PartFileHandle(const PathName& name, const Offset& offset, const Length& length) :
-    path_(name), handle_(), pos_(0), index_(0), offset_(1, offset), length_(1, length) {}
+    path_(name),
+    handle_(),
+    positional_(new PositionalFile(name.localPath())),
+    pos_(0),
+    index_(0),
+    offset_(1, offset),
+    length_(1, length) {}
 
 
 DataHandle* PartFileHandle::clone() const {
@@ -80,6 +97,16 @@ bool PartFileHandle::compress(bool sorted) {
 PartFileHandle::~PartFileHandle() {}
 
 Length PartFileHandle::openForRead() {
+    // Many parts: read them sorted and merged, see CoalescingReader
+    if (offset_.size() > 1 && CoalescingReader::enabled()) {
+        coalescing_.reset(new CoalescingReader());
+        for (Ordinal i = 0; i < offset_.size(); ++i) {
+            coalescing_->add(path_, offset_[i], length_[i]);
+        }
+        return estimate();
+    }
+    coalescing_.reset();
+
     if (!handle_) {
         // The handle may already exists if a  restartReadFrom()
         // is requested
@@ -140,6 +167,10 @@ long PartFileHandle::read1(char* buffer, long length) {
 
 
 long PartFileHandle::read(void* buffer, long length) {
+    if (coalescing_) {
+        return coalescing_->read(buffer, length);
+    }
+
     char* p = (char*)buffer;
 
     long n     = 0;
@@ -159,6 +190,10 @@ long PartFileHandle::write(const void*, long) {
 }
 
 void PartFileHandle::close() {
+    positional_->close();
+    if (coalescing_) {
+        coalescing_->close();
+    }
     if (handle_) {
         handle_->close();
         // Don't delete the handle here so the PooledHandle entry continues
@@ -170,12 +205,19 @@ void PartFileHandle::close() {
 }
 
 void PartFileHandle::rewind() {
+    if (coalescing_) {
+        coalescing_->seek(0);
+    }
     pos_   = 0;
     index_ = 0;
 }
 
 void PartFileHandle::restartReadFrom(const Offset& from) {
     Log::warning() << *this << " restart read from " << from << std::endl;
+    if (coalescing_) {
+        coalescing_->seek(from);
+        return;
+    }
     rewind();
     long long len = from;
     long long pos = 0;
@@ -194,6 +236,9 @@ void PartFileHandle::restartReadFrom(const Offset& from) {
 }
 
 Offset PartFileHandle::position() {
+    if (coalescing_) {
+        return coalescing_->position();
+    }
     long long position = 0;
     for (Ordinal i = 0; i < index_; i++) {
         position += length_[i];
@@ -202,6 +247,14 @@ Offset PartFileHandle::position() {
 }
 
 Offset PartFileHandle::seek(const Offset& offset) {
+    if (coalescing_) {
+        // As below, seeking beyond EOF leaves the position at EOF before asserting
+        const long long seekto = offset;
+        const long long end    = coalescing_->size();
+        coalescing_->seek(std::min(seekto, end));
+        ASSERT(seekto <= end);
+        return offset;
+    }
     rewind();
     const long long seekto = offset;
     long long accumulated  = 0;
@@ -225,6 +278,60 @@ bool PartFileHandle::canSeek() const {
     return true;
 }
 
+Length PartFileHandle::locate(const ReadRange& range, const std::vector<long long>& starts,
+                              std::vector<ReadRange>& parts) const {
+    long long from = range.offset;
+    ASSERT(from >= 0);
+    ASSERT(range.length >= 0);
+
+    // starts[i] is the position of part i in the handle, starts.back() the size of the handle
+    size_t i = std::upper_bound(starts.begin(), starts.end(), from) - starts.begin() - 1;
+
+    char* p   = static_cast<char*>(range.buffer);
+    long left = range.length;
+
+    for (; left > 0 && i < length_.size(); ++i) {
+        long long within = from - starts[i];
+        long size        = std::min<long long>(left, (long long)length_[i] - within);
+        if (size > 0) {
+            parts.push_back({p, size, (long long)offset_[i] + within});
+            p += size;
+            left -= size;
+            from += size;
+        }
+    }
+
+    return range.length - left;
+}
+
+long PartFileHandle::pread(void* buffer, long length, const Offset& offset) {
+    return readv({{buffer, length, offset}});
+}
+
+Length PartFileHandle::readv(const std::vector<ReadRange>& ranges) {
+    std::vector<long long> starts(1, 0);
+    starts.reserve(length_.size() + 1);
+    for (const auto& len : length_) {
+        starts.push_back(starts.back() + (long long)len);
+    }
+
+    std::vector<ReadRange> parts;
+    parts.reserve(ranges.size());
+
+    Length expected = 0;
+    for (const auto& r : ranges) {
+        Length n = locate(r, starts, parts);
+        expected += n;
+        if (n < Length(r.length)) {
+            break;
+        }
+    }
+
+    // n.b. less than expected if the file is shorter than its parts
+
+    return positional_->readv(parts);
+}
+
 bool PartFileHandle::merge(DataHandle* other) {
     if (other->isEmpty()) {
         return true;
@@ -284,6 +391,13 @@ std::string PartFileHandle::metricsTag() const {
     return PathName::metricsTag(path_);
 }
 
+void PartFileHandle::collectMetrics(const std::string& what) const {
+    DataHandle::collectMetrics(what);
+    if (coalescing_) {
+        coalescing_->collectMetrics(what);
+    }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 }  // namespace eckit
@@ -25,7 +25,9 @@
 
 namespace eckit {
 
+class CoalescingReader;
 class PooledHandle;
+class PositionalFile;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -39,6 +41,8 @@ public:  // methods
     ~PartFileHandle() override;
 
     const PathName& path() const { return path_; }
+    const OffsetList& offsets() const { return offset_; }
+    const LengthList& lengths() const { return length_; }
 
     // -- Overridden methods
 
@@ -64,10 +68,16 @@ public:  // methods
     Offset seek(const Offset&) override;
     bool canSeek() const override;
 
+    /// Positional reads go straight to the file at the offsets of the parts, and don't need the handle to be opened
+    long pread(void*, long, const Offset&) override;
+    Length readv(const std::vector<ReadRange>&) override;
+    bool canPread() const override { return true; }
+
     void selectMover(MoverTransferSelection&, bool read) const override;
 
     std::string title() const override;
     std::string metricsTag() const override;
+    void collectMetrics(const std::string& what) const override;
 
 
     bool moveable() const override { return true; }
@@ -86,6 +96,8 @@ private:  // members
 
     PathName path_;
     std::unique_ptr<PooledHandle> handle_;
+    std::unique_ptr<PositionalFile> positional_;
+    std::unique_ptr<CoalescingReader> coalescing_;
     long long pos_;
     Ordinal index_;
     OffsetList offset_;
@@ -94,6 +106,7 @@ private:  // members
 private:  // methods
 
     long read1(char*, long);
+    Length locate(const ReadRange&, const std::vector<long long>& starts, std::vector<ReadRange>& parts) const;
 
     static ClassSpec classSpec_;
     static Reanimator<PartFileHandle> reanimator_;
@@ -0,0 +1,210 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/io/Poller.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+
+#include "eckit/eckit.h"
+
+#if eckit_HAVE_EPOLL
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif
+
+#include "eckit/exception/Exceptions.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Poller::available() {
+    return eckit_HAVE_EPOLL;
+}
+
+#if eckit_HAVE_EPOLL
+
+namespace {
+
+epoll_event event(int fd, unsigned events, bool edgeTriggered) {
+    epoll_event e{};
+    e.events = 0;
+    if (events & Poller::Read) {
+        e.events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (events & Poller::Write) {
+        e.events |= EPOLLOUT;
+    }
+    if (edgeTriggered) {
+        e.events |= EPOLLET;
+    }
+    e.data.fd = fd;
+    return e;
+}
+
+}  // namespace
+
+Poller::Poller() : epoll_(SYSCALL(::epoll_create1(EPOLL_CLOEXEC))), size_(0) {}
+
+Poller::~Poller() {
+    for (int timer : timers_) {
+        ::close(timer);
+    }
+    ::close(epoll_);
+}
+
+void Poller::add(int fd, unsigned events, bool edgeTriggered) {
+    ASSERT(fd >= 0);
+    epoll_event e = event(fd, events, edgeTriggered);
+    SYSCALL(::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &e));
+    size_++;
+}
+
+void Poller::modify(int fd, unsigned events, bool edgeTriggered) {
+    epoll_event e = event(fd, events, edgeTriggered);
+    SYSCALL(::epoll_ctl(epoll_, EPOLL_CTL_MOD, fd, &e));
+}
+
+void Poller::remove(int fd) {
+
+    // A descriptor closed before being removed is no longer watched
+
+    if (::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr) < 0 && errno != EBADF && errno != ENOENT) {
+        throw FailedSystemCall("epoll_ctl");
+    }
+    size_--;
+
+    events_.erase(std::remove_if(events_.begin(), events_.end(), [fd](const Event& e) { return e.fd == fd; }),
+                  events_.end());
+}
+
+int Poller::addTimer(long milliseconds, bool repeat) {
+    ASSERT(milliseconds > 0);
+
+    int timer = SYSCALL(::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC));
+
+    itimerspec spec{};
+    spec.it_value.tv_sec  = milliseconds / 1000;
+    spec.it_value.tv_nsec = (milliseconds % 1000) * 1000000;
+    if (repeat) {
+        spec.it_interval = spec.it_value;
+    }
+
+    if (::timerfd_settime(timer, 0, &spec, nullptr) < 0) {
+        ::close(timer);
+        throw FailedSystemCall("timerfd_settime");
+    }
+
+    timers_.push_back(timer);
+    add(timer, Read);
+    return timer;
+}
+
+void Poller::removeTimer(int timer) {
+    auto j = std::find(timers_.begin(), timers_.end(), timer);
+    ASSERT(j != timers_.end());
+
+    remove(timer);
+    timers_.erase(j);
+    ::close(timer);
+}
+
+size_t Poller::wait(long milliseconds) {
+
+    std::vector<epoll_event> ready(std::max<size_t>(1, std::min<size_t>(size_, 1024)));
+
+    int n;
+    while ((n = ::epoll_wait(epoll_, ready.data(), int(ready.size()), int(milliseconds))) < 0) {
+        if (errno != EINTR) {
+            throw FailedSystemCall("epoll_wait");
+        }
+    }
+
+    events_.clear();
+    events_.reserve(n);
+
+    for (int i = 0; i < n; ++i) {
+        const epoll_event& e = ready[i];
+
+        Event event{e.data.fd, (e.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0,
+                    (e.events & EPOLLOUT) != 0, false};
+
+        // Acknowledge the expiry, as the timers are level-triggered
+
+        if (std::find(timers_.begin(), timers_.end(), event.fd) != timers_.end()) {
+            uint64_t expirations;
+            if (::read(event.fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+                throw FailedSystemCall("read timerfd");
+            }
+            event.readable = false;
+            event.timer    = true;
+        }
+
+        events_.push_back(event);
+    }
+
+    return events_.size();
+}
+
+#else
+
+Poller::Poller() : epoll_(-1), size_(0) {
+    NOTIMP;
+}
+
+Poller::~Poller() {}
+
+void Poller::add(int, unsigned, bool) {
+    NOTIMP;
+}
+
+void Poller::modify(int, unsigned, bool) {
+    NOTIMP;
+}
+
+void Poller::remove(int) {
+    NOTIMP;
+}
+
+int Poller::addTimer(long, bool) {
+    NOTIMP;
+}
+
+void Poller::removeTimer(int) {
+    NOTIMP;
+}
+
+size_t Poller::wait(long) {
+    NOTIMP;
+}
+
+#endif
+
+bool Poller::readable(int fd) const {
+    return std::any_of(events_.begin(), events_.end(), [fd](const Event& e) { return e.fd == fd && e.readable; });
+}
+
+bool Poller::writable(int fd) const {
+    return std::any_of(events_.begin(), events_.end(), [fd](const Event& e) { return e.fd == fd && e.writable; });
+}
+
+bool Poller::expired(int timer) const {
+    return std::any_of(events_.begin(), events_.end(), [timer](const Event& e) { return e.fd == timer && e.timer; });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,102 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date Oct 2026
+
+#ifndef eckit_Poller_h
+#define eckit_Poller_h
+
+#include <cstddef>
+#include <vector>
+
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Waits on many file descriptors with epoll, without the FD_SETSIZE limit of Select and without scanning all the
+/// descriptors at every wait: the cost of wait() depends on the number of descriptors ready, not watched.
+///
+/// Descriptors are watched for reading and/or writing, level-triggered (as Select) or edge-triggered (reported once
+/// per change of state, until the descriptor is read or written until EAGAIN). Timers are watched like descriptors,
+/// and reported when they expire.
+///
+/// Where epoll is not available, available() is false and the constructor throws.
+
+class Poller {
+public:
+
+    // -- Types
+
+    enum Events : unsigned {
+        Read  = 1,
+        Write = 2,
+    };
+
+    struct Event {
+        int fd;
+        bool readable;  ///< or at end of file, hung up or in error, as with select()
+        bool writable;
+        bool timer;     ///< a timer expired
+    };
+
+    // -- Contructors
+
+    Poller();
+
+    Poller(const Poller&)            = delete;
+    Poller& operator=(const Poller&) = delete;
+    Poller(Poller&&)                 = delete;
+    Poller& operator=(Poller&&)      = delete;
+
+    // -- Destructor
+
+    ~Poller();
+
+    // -- Methods
+
+    void add(int fd, unsigned events = Read, bool edgeTriggered = false);
+    void modify(int fd, unsigned events, bool edgeTriggered = false);
+    void remove(int fd);
+
+    /// A timer expiring after @param milliseconds (and then every @param milliseconds if repeated), returning its
+    /// identifier, reported as the fd of its Event
+    int addTimer(long milliseconds, bool repeat = false);
+    void removeTimer(int timer);
+
+    /// Wait @param milliseconds (-1 for ever) for descriptors to be ready, returning how many are
+    size_t wait(long milliseconds);
+
+    /// The descriptors ready, after wait()
+    const std::vector<Event>& events() const { return events_; }
+
+    bool readable(int fd) const;
+    bool writable(int fd) const;
+    bool expired(int timer) const;
+
+    size_t size() const { return size_; }
+
+    static bool available();
+
+private:
+
+    // -- Members
+
+    int epoll_;
+    size_t size_;
+    std::vector<int> timers_;
+    std::vector<Event> events_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
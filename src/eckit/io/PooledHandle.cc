@@ -176,6 +176,25 @@ public:
         return n;
     }
 
+    Offset position(const PooledHandle* handle) {
+        auto s = statuses_.find(handle);
+        ASSERT(s != statuses_.end());
+        return s->second.position_;
+    }
+
+    int fileDescriptor(const PooledHandle* handle) {
+        auto s = statuses_.find(handle);
+        ASSERT(s != statuses_.end());
+        ASSERT(s->second.opened_);
+        return handle_->fileDescriptor();
+    }
+
+    void transferred(const PooledHandle* handle, const Length& length) {
+        auto s = statuses_.find(handle);
+        ASSERT(s != statuses_.end());
+        s->second.position_ += length;
+    }
+
     long seek(const PooledHandle* handle, Offset position) {
         auto s = statuses_.find(handle);
         ASSERT(s != statuses_.end());
@@ -268,7 +287,18 @@ void PooledHandle::hash(MD5& md5) const {
 }
 
 Offset PooledHandle::position() {
-    return entry_->handle_->position();
+    ASSERT(entry_);
+    return entry_->position(this);
+}
+
+int PooledHandle::fileDescriptor() {
+    ASSERT(entry_);
+    return entry_->fileDescriptor(this);
+}
+
+void PooledHandle::transferred(const Length& length) {
+    ASSERT(entry_);
+    entry_->transferred(this, length);
 }
 
 }  // namespace eckit
@@ -44,6 +44,9 @@ public:
     void hash(MD5& md5) const override;
     Offset position() override;
 
+    int fileDescriptor() override;
+    void transferred(const Length&) override;
+
     // for testing
 
     size_t nbOpens() const;
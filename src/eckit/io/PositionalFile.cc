@@ -0,0 +1,196 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+
+#include "eckit/eckit.h"
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/PositionalFile.h"
+#include "eckit/thread/AutoLock.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+#ifdef IOV_MAX
+constexpr size_t maxIOV = IOV_MAX;
+#else
+constexpr size_t maxIOV = 1024;
+#endif
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// The descriptor, kept open for the duration of a read
+class PositionalFile::Use {
+public:
+
+    explicit Use(PositionalFile& file) : file_(file), fd_(file.acquire()) {}
+
+    Use(const Use&)            = delete;
+    Use& operator=(const Use&) = delete;
+
+    ~Use() { file_.release(); }
+
+    int fd() const { return fd_; }
+
+private:
+
+    PositionalFile& file_;
+    int fd_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+PositionalFile::PositionalFile(const std::string& path) : path_(path), fd_(-1), users_(0), closing_(false) {}
+
+PositionalFile::~PositionalFile() {
+    ASSERT(users_ == 0);
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+int PositionalFile::acquire() {
+    AutoLock<Mutex> lock(mutex_);
+    if (fd_ < 0) {
+        SYSCALL2(fd_ = ::open(path_.c_str(), O_RDONLY), path_);
+    }
+    users_++;
+    return fd_;
+}
+
+void PositionalFile::release() {
+    AutoLock<Mutex> lock(mutex_);
+    ASSERT(users_ > 0);
+    if (--users_ == 0 && closing_) {
+        closing_ = false;
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void PositionalFile::close() {
+    AutoLock<Mutex> lock(mutex_);
+    if (fd_ < 0) {
+        return;
+    }
+
+    // n.b. the reads in progress keep using the descriptor, the last one closes it
+    if (users_ > 0) {
+        closing_ = true;
+        return;
+    }
+
+    int fd = fd_;
+    fd_    = -1;
+    SYSCALL2(::close(fd), path_);
+}
+
+long PositionalFile::read(void* buffer, long length, off_t offset) {
+    Use use(*this);
+    const int fd = use.fd();
+
+    char* p    = static_cast<char*>(buffer);
+    long total = 0;
+
+    while (total < length) {
+        ssize_t n = ::pread(fd, p + total, length - total, offset + total);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw ReadError(path_, Here());
+        }
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+
+    return total;
+}
+
+Length PositionalFile::readv(const std::vector<ReadRange>& ranges) {
+#if eckit_HAVE_PREADV
+    Use use(*this);
+    const int fd = use.fd();
+
+    Length total = 0;
+    std::vector<struct iovec> iov;
+
+    for (size_t i = 0; i < ranges.size();) {
+
+        // Gather the ranges that follow each other in the file
+
+        off_t offset = ranges[i].offset;
+        off_t end    = offset;
+
+        iov.clear();
+        for (; i < ranges.size() && off_t(ranges[i].offset) == end && iov.size() < maxIOV; ++i) {
+            ASSERT(ranges[i].length >= 0);
+            iov.push_back({ranges[i].buffer, size_t(ranges[i].length)});
+            end += ranges[i].length;
+        }
+
+        size_t first = 0;
+        while (offset < end) {
+            ssize_t n = ::preadv(fd, &iov[first], int(iov.size() - first), offset);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw ReadError(path_, Here());
+            }
+            if (n == 0) {
+                return total;
+            }
+
+            total += Length(n);
+            offset += n;
+
+            // Skip the buffers filled, and resume within the one partially filled
+            while (first < iov.size() && size_t(n) >= iov[first].iov_len) {
+                n -= iov[first].iov_len;
+                first++;
+            }
+            if (first < iov.size()) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + n;
+                iov[first].iov_len -= n;
+            }
+        }
+    }
+
+    return total;
+#else
+    Length total = 0;
+    for (const auto& r : ranges) {
+        long n = read(r.buffer, r.length, r.offset);
+        total += n;
+        if (n < r.length) {
+            break;
+        }
+    }
+    return total;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,70 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_io_PositionalFile_h
+#define eckit_io_PositionalFile_h
+
+#include <string>
+#include <vector>
+
+#include "eckit/io/DataHandle.h"
+#include "eckit/thread/Mutex.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Read-only file descriptor for positional reads (pread/preadv), shared by all threads.
+/// The file is opened on first use, independently of the state of the DataHandle owning it, and closed once
+/// close() has been called and no read is using it any more.
+
+class PositionalFile {
+public:  // methods
+
+    explicit PositionalFile(const std::string& path);
+
+    PositionalFile(const PositionalFile&)            = delete;
+    PositionalFile& operator=(const PositionalFile&) = delete;
+
+    ~PositionalFile();
+
+    /// Reads up to length bytes at offset, short only at end of file
+    long read(void* buffer, long length, off_t offset);
+
+    /// Reads the ranges in order, where ranges[i].offset is an offset in the file.
+    /// Ranges following each other in the file are read with a single preadv().
+    Length readv(const std::vector<ReadRange>& ranges);
+
+    /// Closes the file now if no read is using it, otherwise when the last one completes
+    void close();
+
+private:  // types
+
+    class Use;
+
+private:  // methods
+
+    int acquire();
+    void release();
+
+private:  // members
+
+    std::string path_;
+    Mutex mutex_;
+    int fd_;
+    size_t users_;
+    bool closing_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
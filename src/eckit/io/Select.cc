@@ -16,6 +16,10 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <algorithm>
+
+#include "eckit/config/Resource.h"
+#include "eckit/io/Poller.h"
 #include "eckit/io/Select.h"
 #include "eckit/net/TCPSocket.h"
 
@@ -25,17 +29,25 @@ namespace eckit {
 
 //----------------------------------------------------------------------------------------------------------------------
 
-Select::Select() : last_(-1) {
-    FD_ZERO(&files_);
+namespace {
+
+/// Above that many descriptors, select() and the ioctl() checks cost more than creating an epoll instance
+bool usePoller(const std::vector<int>& files) {
+    static size_t threshold = Resource<size_t>("selectPollerThreshold;$ECKIT_SELECT_POLLER_THRESHOLD", 64);
+    return Poller::available() && (files.size() >= threshold || files.back() >= FD_SETSIZE);
 }
 
-Select::Select(net::TCPSocket& p) : last_(-1) {
-    FD_ZERO(&files_);
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Select::Select() {}
+
+Select::Select(net::TCPSocket& p) {
     add(p);
 }
 
-Select::Select(int fd) : last_(-1) {
-    FD_ZERO(&files_);
+Select::Select(int fd) {
     add(fd);
 }
 
@@ -43,9 +55,21 @@ Select::~Select() {}
 
 void Select::add(int fd) {
     ASSERT(fd >= 0 && fd < getdtablesize());
-    FD_SET(fd, &files_);
-    if (fd > last_) {
-        last_ = fd;
+
+    auto j = std::lower_bound(files_.begin(), files_.end(), fd);
+    if (j != files_.end() && *j == fd) {
+        return;
+    }
+    files_.insert(j, fd);
+
+    if (poller_) {
+        poller_->add(fd);
+    }
+    else if (usePoller(files_)) {
+        poller_.reset(new Poller());
+        for (int f : files_) {
+            poller_->add(f);
+        }
     }
 }
 
@@ -55,7 +79,16 @@ void Select::add(net::TCPSocket& p) {
 
 void Select::remove(int fd) {
     ASSERT(fd >= 0 && fd < getdtablesize());
-    FD_CLR(fd, &files_);
+
+    auto j = std::lower_bound(files_.begin(), files_.end(), fd);
+    if (j == files_.end() || *j != fd) {
+        return;
+    }
+    files_.erase(j);
+
+    if (poller_) {
+        poller_->remove(fd);
+    }
 }
 
 void Select::remove(net::TCPSocket& p) {
@@ -64,7 +97,7 @@ void Select::remove(net::TCPSocket& p) {
 
 bool Select::set(int fd) {
     ASSERT(fd >= 0 && fd < getdtablesize());
-    return FD_ISSET(fd, &set_);
+    return std::binary_search(set_.begin(), set_.end(), fd);
 }
 
 bool Select::set(net::TCPSocket& p) {
@@ -72,63 +105,83 @@ bool Select::set(net::TCPSocket& p) {
 }
 
 bool Select::ready(long sec) {
+    return poller_ ? poll(sec) : select(sec);
+}
+
+bool Select::poll(long sec) {
+
+    // epoll reports the data pending on the descriptors (level-triggered), without checking them one by one
 
-    int size = last_ + 1;
+    set_.clear();
+
+    if (poller_->wait(sec * 1000) == 0) {
+        return false;
+    }
+
+    for (const auto& e : poller_->events()) {
+        if (e.readable) {
+            set_.push_back(e.fd);
+        }
+    }
+
+    std::sort(set_.begin(), set_.end());
+    return true;
+}
+
+bool Select::select(long sec) {
 
     ::timeval timeout;
     timeout.tv_sec  = sec;
     timeout.tv_usec = 0;
 
-    for (;;) {
+    // First check with ioctl, as select is not always trustworthy
 
-        // First check with ioctl, as select is not always trustworthy
+    set_.clear();
 
-        bool some = false;
-        FD_ZERO(&set_);
+    for (int i : files_) {
+        int nbytes = 0;
 
-        for (int i = 0; i < size; i++) {
-            if (FD_ISSET(i, &files_)) {
-                int nbytes = 0;
+        // On Linux, a socket in accept() mode will return "Invalid argument"
+        // so we simply ignore the error here....
+        if ((ioctl(i, FIONREAD, &nbytes) == 0) && (nbytes > 0)) {
+            set_.push_back(i);
+        }
+    }
 
-                // cout << "ioctl(i,FIONREAD,&nbytes) " << i << " .... " << ioctl(i,FIONREAD,&nbytes) << " " << nbytes
-                // << std::endl;
-                nbytes = 0;
+    if (!set_.empty()) {
+        return true;
+    }
 
+    fd_set files;
+    FD_ZERO(&files);
+    for (int i : files_) {
+        FD_SET(i, &files);
+    }
 
-                // SYSCALL(ioctl(i,FIONREAD,&nbytes));
-                //
+    int size = files_.empty() ? 0 : files_.back() + 1;
 
-                // On Linux, a socket in acceoct() mode will return "Invalid argument"
-                // so we simply ignor ethe error here....
-                if ((ioctl(i, FIONREAD, &nbytes) == 0) && (nbytes > 0)) {
-                    FD_SET(i, &set_);
-                    some = true;
-                }
-            }
-        }
+    for (;;) {
 
-        if (some) {
-            return true;
-        }
+        fd_set set   = files;
+        fd_set excep = files;
 
-        for (;;) {
+        switch (::select(size, &set, nullptr, &excep, &timeout)) {
+            case -1:
+                if (errno != EINTR) {
+                    throw FailedSystemCall("select");
+                }
+                break;
 
-            set_         = files_;
-            fd_set excep = files_;
+            case 0:
+                return false;
 
-            switch (::select(size, &set_, nullptr, &excep, &timeout)) {
-                case -1:
-                    if (errno != EINTR) {
-                        throw FailedSystemCall("select");
+            default:
+                for (int i : files_) {
+                    if (FD_ISSET(i, &set)) {
+                        set_.push_back(i);
                     }
-                    break;
-
-                case 0:
-                    return false;
-
-                default:
-                    return true;
-            }
+                }
+                return true;
         }
     }
 }
@@ -17,6 +17,9 @@
 
 #include <sys/select.h>
 
+#include <memory>
+#include <vector>
+
 
 namespace eckit {
 
@@ -26,7 +29,10 @@ namespace net {
 class TCPSocket;
 };
 
-/// Wraps calls to select
+class Poller;
+
+/// Wraps calls to select. When watching many descriptors (or descriptors beyond FD_SETSIZE), waits with a Poller
+/// (epoll) instead, where available.
 class Select {
 
 public:
@@ -61,11 +67,16 @@ public:
 
 private:
 
+    // -- Methods
+
+    bool select(long sec);
+    bool poll(long sec);
+
     // -- Members
 
-    fd_set files_;
-    fd_set set_;
-    int last_;
+    std::vector<int> files_;  // sorted
+    std::vector<int> set_;    // sorted
+    std::unique_ptr<Poller> poller_;
 };
 
 //-----------------------------------------------------------------------------
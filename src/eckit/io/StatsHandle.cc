@@ -27,6 +27,17 @@ namespace eckit {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+HandleMetrics& metrics() {
+    static HandleMetrics* metrics = new HandleMetrics("io.stats");
+    return *metrics;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
 StatsHandle::StatsHandle(DataHandle& handle) :
     HandleHolder(handle),
     reads_(0),
@@ -38,7 +49,8 @@ StatsHandle::StatsHandle(DataHandle& handle) :
     timer_(),
     readTime_(0),
     writeTime_(0),
-    seekTime_(0) {}
+    seekTime_(0),
+    metrics_(metrics()) {}
 
 StatsHandle::StatsHandle(DataHandle* handle) :
     HandleHolder(handle),
@@ -51,7 +63,8 @@ StatsHandle::StatsHandle(DataHandle* handle) :
     timer_(),
     readTime_(0),
     writeTime_(0),
-    seekTime_(0) {}
+    seekTime_(0),
+    metrics_(metrics()) {}
 
 StatsHandle::~StatsHandle() {
     std::cout << "StatsHandle for " << handle() << std::endl;
@@ -103,7 +116,9 @@ long StatsHandle::read(void* data, long len) {
     double x = timer_.elapsed();
     reads_++;
     bytesRead_ += len;
-    long ret = handle().read(data, len);
+    uint64_t start = HandleMetrics::now();
+    long ret       = handle().read(data, len);
+    metrics_.read(ret, start);
     readTime_ += timer_.elapsed() - x;
     return ret;
 }
@@ -112,7 +127,9 @@ long StatsHandle::write(const void* data, long len) {
     double x = timer_.elapsed();
     writes_++;
     bytesWritten_ += len;
-    long ret = handle().write(data, len);
+    uint64_t start = HandleMetrics::now();
+    long ret       = handle().write(data, len);
+    metrics_.write(ret, start);
     writeTime_ += timer_.elapsed() - x;
     return ret;
 }
@@ -136,7 +153,9 @@ Offset StatsHandle::position() {
 Offset StatsHandle::seek(const Offset& o) {
     double x = timer_.elapsed();
     seeks_++;
-    Offset ret = handle().seek(o);
+    uint64_t start = HandleMetrics::now();
+    Offset ret     = handle().seek(o);
+    metrics_.seek(start);
     seekTime_ += timer_.elapsed() - x;
     return ret;
 }
@@ -144,14 +163,18 @@ Offset StatsHandle::seek(const Offset& o) {
 void StatsHandle::skip(const Length& n) {
     double x = timer_.elapsed();
     seeks_++;
+    uint64_t start = HandleMetrics::now();
     handle().skip(n);
+    metrics_.seek(start);
     seekTime_ += timer_.elapsed() - x;
 }
 
 void StatsHandle::rewind() {
     double x = timer_.elapsed();
     seeks_++;
+    uint64_t start = HandleMetrics::now();
     handle().rewind();
+    metrics_.seek(start);
     seekTime_ += timer_.elapsed() - x;
 }
 
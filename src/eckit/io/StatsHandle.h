@@ -17,6 +17,7 @@
 #include "eckit/filesystem/PathName.h"
 #include "eckit/io/Buffer.h"
 #include "eckit/io/HandleHolder.h"
+#include "eckit/io/HandleMetrics.h"
 #include "eckit/log/Timer.h"
 #include "eckit/types/Types.h"
 
@@ -109,6 +110,9 @@ private:
     double readTime_;
     double writeTime_;
     double seekTime_;
+
+    /// Shared by all the StatsHandles, in the MetricsRegistry as io.stats.*
+    HandleMetrics& metrics_;
 };
 
 
@@ -54,6 +54,8 @@ public:
 
     bool canSeek() const override { return false; }
 
+    int fileDescriptor() override { return connection_.socket(); }
+
     virtual void selectMover(eckit::MoverTransferSelection&, bool) const override;
 
     // From Streamable
@@ -54,6 +54,9 @@ public:
     Offset seek(const Offset&) override;
     bool canSeek() const override { return true; }
 
+    int fileDescriptor() override { return connection_.socket(); }
+    void transferred(const Length& length) override { position_ += length; }
+
     // From Streamable
 
 
@@ -32,6 +32,10 @@ public:
     virtual void fromHandleOpened() {}
     virtual void toHandleOpened() {}
 
+    /// Return false if watch() only looks at the lengths, so that the data can be moved by the kernel
+    /// without going through user space. watch() is then called with a null pointer.
+    virtual bool needsData() const { return true; }
+
     virtual ~TransferWatcher() {}
 
     // -- Class methods
@@ -0,0 +1,796 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/eckit.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <sstream>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/AIOHandle.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/URingHandle.h"
+#include "eckit/log/Log.h"
+#include "eckit/maths/Functions.h"
+#include "eckit/memory/Zero.h"
+#include "eckit/os/Stat.h"
+
+#if eckit_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// Alignment of offsets, lengths and memory for O_DIRECT
+constexpr size_t ALIGNMENT = 4096;
+
+enum class Op {
+    Read,
+    Write,
+    Fsync
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if eckit_HAVE_IO_URING
+
+/// Minimal io_uring wrapper on top of the raw system calls (no liburing dependency)
+class URing {
+public:  // methods
+
+    explicit URing(unsigned entries) {
+        io_uring_params params;
+        zero(params);
+
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            throw FailedSystemCall("io_uring_setup");
+        }
+
+        entries_ = params.sq_entries;
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        single_     = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+
+        try {
+            sqRing_ = map(sqRingSize_, IORING_OFF_SQ_RING);
+            cqRing_ = single_ ? sqRing_ : map(cqRingSize_, IORING_OFF_CQ_RING);
+
+            sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+            sqes_     = static_cast<io_uring_sqe*>(map(sqesSize_, IORING_OFF_SQES));
+        }
+        catch (...) {
+            release();
+            throw;
+        }
+
+        char* sq   = static_cast<char*>(sqRing_);
+        sqHead_    = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTailPtr_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_    = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_   = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqTail_    = *sqTailPtr_;
+
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_  = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_    = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    URing(const URing&)            = delete;
+    URing& operator=(const URing&) = delete;
+
+    ~URing() { release(); }
+
+    /// Queue an operation, returns false if the submission queue is full
+    bool prepare(Op op, int fd, void* buffer, size_t length, off_t offset, int index, uint64_t tag) {
+        unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (sqTail_ - head >= entries_) {
+            return false;
+        }
+
+        unsigned n        = sqTail_ & sqMask_;
+        io_uring_sqe* sqe = &sqes_[n];
+        zero(*sqe);
+
+        switch (op) {
+            case Op::Read:
+                sqe->opcode = index >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+                break;
+            case Op::Write:
+                sqe->opcode = index >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+                break;
+            case Op::Fsync:
+                sqe->opcode = IORING_OP_FSYNC;
+                break;
+        }
+
+        sqe->fd        = fd;
+        sqe->off       = static_cast<uint64_t>(offset);
+        sqe->addr      = reinterpret_cast<uintptr_t>(buffer);
+        sqe->len       = static_cast<unsigned>(length);
+        sqe->buf_index = index >= 0 ? static_cast<uint16_t>(index) : 0;
+        sqe->user_data = tag;
+
+        sqArray_[n] = n;
+        sqTail_++;
+        prepared_++;
+        return true;
+    }
+
+    /// Submit the queued operations, waiting for at least @param wait completions
+    void enter(unsigned wait) {
+        __atomic_store_n(sqTailPtr_, sqTail_, __ATOMIC_RELEASE);
+
+        unsigned flags = wait > 0 ? IORING_ENTER_GETEVENTS : 0;
+        for (;;) {
+            long n = ::syscall(__NR_io_uring_enter, fd_, prepared_, wait, flags, nullptr, 0);
+            if (n >= 0) {
+                prepared_ -= std::min<unsigned>(prepared_, static_cast<unsigned>(n));
+                return;
+            }
+            if (errno != EINTR) {
+                throw FailedSystemCall("io_uring_enter");
+            }
+        }
+    }
+
+    /// Pop a completion, if any
+    bool completion(uint64_t& tag, int& result) {
+        unsigned head = *cqHead_;
+        if (head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+
+        const io_uring_cqe& cqe = cqes_[head & cqMask_];
+        tag                     = cqe.user_data;
+        result                  = cqe.res;
+
+        __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /// Register @param count buffers of @param size bytes, contiguous from @param base
+    bool registerBuffers(char* base, size_t size, size_t count) {
+        std::vector<iovec> iov(count);
+        for (size_t i = 0; i < count; ++i) {
+            iov[i].iov_base = base + i * size;
+            iov[i].iov_len  = size;
+        }
+        return ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, iov.data(), count) == 0;
+    }
+
+    unsigned prepared() const { return prepared_; }
+
+    static bool supported() {
+        io_uring_params params;
+        zero(params);
+        int fd = static_cast<int>(::syscall(__NR_io_uring_setup, 1, &params));
+        if (fd < 0) {
+            return false;
+        }
+        ::close(fd);
+        return true;
+    }
+
+private:  // methods
+
+    void release() {
+        if (sqes_) {
+            ::munmap(sqes_, sqesSize_);
+        }
+        if (cqRing_ && !single_) {
+            ::munmap(cqRing_, cqRingSize_);
+        }
+        if (sqRing_) {
+            ::munmap(sqRing_, sqRingSize_);
+        }
+        ::close(fd_);
+    }
+
+    void* map(size_t size, off_t offset) {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        if (p == MAP_FAILED) {
+            throw FailedSystemCall("mmap io_uring");
+        }
+        return p;
+    }
+
+private:  // members
+
+    int fd_;
+    unsigned entries_;
+    unsigned prepared_ = 0;
+    unsigned sqTail_;
+    bool single_;
+
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqRingSize_;
+    size_t cqRingSize_;
+    size_t sqesSize_;
+
+    unsigned* sqHead_;
+    unsigned* sqTailPtr_;
+    unsigned* sqArray_;
+    unsigned sqMask_;
+
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    io_uring_cqe* cqes_;
+    unsigned cqMask_;
+};
+
+#else  // NO eckit_HAVE_IO_URING
+
+class URing {
+public:
+
+    explicit URing(unsigned) { NOTIMP; }
+    bool prepare(Op, int, void*, size_t, off_t, int, uint64_t) { NOTIMP; }
+    void enter(unsigned) { NOTIMP; }
+    bool completion(uint64_t&, int&) { NOTIMP; }
+    bool registerBuffers(char*, size_t, size_t) { NOTIMP; }
+    unsigned prepared() const { return 0; }
+    static bool supported() { return false; }
+};
+
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+URingHandle::URingHandle(const PathName& path, size_t count, size_t buffsize, bool fsync, bool direct) :
+    path_(path),
+    memory_(nullptr),
+    count_(std::max<size_t>(count, 1)),
+    buffsize_(eckit::round(std::max<size_t>(buffsize, 1), ALIGNMENT)),
+    inflight_(0),
+    batch_(std::max<size_t>(count_ / 4, 1)),
+    current_(-1),
+    fd_(-1),
+    pos_(0),
+    next_(0),
+    size_(0),
+    fsync_(fsync),
+    direct_(direct),
+    odirect_(false),
+    reading_(false),
+    registered_(false),
+    synced_(false) {}
+
+URingHandle::~URingHandle() {
+    if (fd_ >= 0) {
+        // Requests in flight must not outlive the buffers
+        try {
+            drain();
+        }
+        catch (std::exception& e) {
+            Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+            Log::error() << "** Exception is ignored" << std::endl;
+        }
+        ::close(fd_);
+    }
+
+    ring_.reset();
+
+    if (memory_) {
+        ::munmap(memory_, count_ * buffsize_);
+    }
+}
+
+bool URingHandle::available() {
+    static const bool available = !Resource<bool>("$ECKIT_URING_DISABLE;uringDisable", false) && URing::supported();
+    return available;
+}
+
+void URingHandle::allocate() {
+    if (!ring_) {
+        // One extra entry for fsync
+        ring_.reset(new URing(static_cast<unsigned>(count_ + 1)));
+    }
+
+    if (!memory_) {
+        void* p = ::mmap(nullptr, count_ * buffsize_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw FailedSystemCall("mmap");
+        }
+        memory_ = static_cast<char*>(p);
+
+        slots_.resize(count_);
+        for (size_t i = 0; i < count_; ++i) {
+            slots_[i].data = memory_ + i * buffsize_;
+        }
+
+        // Registration can fail because of RLIMIT_MEMLOCK, unregistered buffers still work
+        registered_ = ring_->registerBuffers(memory_, buffsize_, count_);
+        if (!registered_) {
+            Log::debug() << "URingHandle: cannot register buffers, using unregistered I/O" << std::endl;
+        }
+    }
+
+    free_.clear();
+    ahead_.clear();
+    for (size_t i = 0; i < count_; ++i) {
+        slots_[i].inflight = false;
+        free_.push_back(i);
+    }
+
+    inflight_ = 0;
+    current_  = -1;
+}
+
+bool URingHandle::setup() {
+    fallback_.reset();
+
+    if (!available()) {
+        return false;
+    }
+
+    try {
+        allocate();
+        return true;
+    }
+    catch (FailedSystemCall& e) {
+        Log::warning() << "URingHandle: " << e.what() << ", using fallback" << std::endl;
+        ring_.reset();
+        return false;
+    }
+}
+
+void URingHandle::open(int flags) {
+    reading_ = (flags & O_ACCMODE) == O_RDONLY;
+    odirect_ = false;
+    synced_  = false;
+
+    fd_ = -1;
+    if (direct_) {
+        fd_ = ::open(path_.localPath(), flags | O_DIRECT, 0777);
+        if (fd_ < 0 && errno == EINVAL) {
+            Log::warning() << "URingHandle: O_DIRECT not supported for " << path_ << ", using buffered I/O"
+                           << std::endl;
+        }
+        odirect_ = fd_ >= 0;
+    }
+
+    if (fd_ < 0) {
+        SYSCALL2(fd_ = ::open(path_.localPath(), flags, 0777), path_);
+    }
+}
+
+void URingHandle::direct(bool on) {
+    int flags;
+    SYSCALL2(flags = ::fcntl(fd_, F_GETFL), path_);
+    SYSCALL2(::fcntl(fd_, F_SETFL, on ? (flags | O_DIRECT) : (flags & ~O_DIRECT)), path_);
+    odirect_ = on;
+}
+
+Length URingHandle::openForRead() {
+    if (!setup()) {
+        fallback_.reset(new FileHandle(path_));
+        return fallback_->openForRead();
+    }
+
+    open(O_RDONLY);
+
+    Stat::Struct info;
+    SYSCALL2(Stat::fstat(fd_, &info), path_);
+
+    size_ = info.st_size;
+    pos_  = 0;
+    next_ = 0;
+
+    readAhead();
+    return size_;
+}
+
+void URingHandle::openForWrite(const Length& length) {
+    if (!setup()) {
+        fallback_.reset(makeFallback());
+        fallback_->openForWrite(length);
+        return;
+    }
+
+    open(O_WRONLY | O_CREAT | O_TRUNC);
+    pos_ = 0;
+}
+
+void URingHandle::openForAppend(const Length& length) {
+    if (!setup()) {
+        fallback_.reset(makeFallback());
+        fallback_->openForAppend(length);
+        return;
+    }
+
+    // Not O_APPEND, as writes are positional
+    open(O_WRONLY | O_CREAT);
+    SYSCALL2(pos_ = ::lseek(fd_, 0, SEEK_END), path_);
+    if (odirect_ && pos_ % ALIGNMENT != 0) {
+        direct(false);
+    }
+}
+
+DataHandle* URingHandle::makeFallback() const {
+#if eckit_HAVE_AIO
+    return new AIOHandle(path_, count_, buffsize_, fsync_);
+#else
+    return new FileHandle(path_);
+#endif
+}
+
+void URingHandle::submit(size_t n) {
+    Slot& slot = slots_[n];
+
+    Op op = reading_ ? Op::Read : Op::Write;
+    while (!ring_->prepare(op, fd_, slot.data + slot.done, slot.extent - slot.done, slot.offset + slot.done,
+                           registered_ ? static_cast<int>(n) : -1, n)) {
+        ring_->enter(0);
+    }
+
+    slot.inflight = true;
+    inflight_++;
+
+    if (ring_->prepared() >= batch_) {
+        ring_->enter(0);
+    }
+}
+
+void URingHandle::reap(bool wait) {
+    if (wait || ring_->prepared()) {
+        ring_->enter(wait ? 1 : 0);
+    }
+
+    uint64_t tag;
+    int result;
+    while (ring_->completion(tag, result)) {
+        complete(tag, result);
+    }
+}
+
+void URingHandle::complete(size_t n, int result) {
+    if (n == count_) {  // fsync
+        if (result < 0) {
+            errno = -result;
+            throw FailedSystemCall("io_uring fsync " + std::string(path_));
+        }
+        synced_ = true;
+        return;
+    }
+
+    ASSERT(n < count_);
+    Slot& slot = slots_[n];
+
+    ASSERT(slot.inflight);
+    slot.inflight = false;
+    inflight_--;
+
+    if (result < 0) {
+        errno = -result;
+        throw FailedSystemCall(std::string(reading_ ? "io_uring read " : "io_uring write ") + std::string(path_));
+    }
+
+    const size_t before = slot.done;
+    slot.done += result;
+
+    if (reading_) {
+        // Short reads are resubmitted, unless at the end of the file
+        if (result > 0 && slot.done < slot.length) {
+            if (odirect_) {
+                // O_DIRECT reads need an aligned offset and buffer: read again from the last block boundary (the bytes
+                // after it are read twice), unless the read ended within the block it started, at the end of the file
+                const size_t aligned = slot.done - slot.done % ALIGNMENT;
+                if (aligned == before) {
+                    return;
+                }
+                slot.done = aligned;
+            }
+            submit(n);
+        }
+        return;
+    }
+
+    if (result == 0) {
+        std::ostringstream os;
+        os << "URingHandle: only " << slot.done << " bytes written instead of " << slot.extent;
+        throw WriteError(os.str());
+    }
+
+    if (slot.done < slot.extent) {
+        submit(n);
+        return;
+    }
+
+    free_.push_back(n);
+}
+
+void URingHandle::drain() {
+    while (inflight_ > 0) {
+        reap(true);
+    }
+}
+
+size_t URingHandle::freeSlot() {
+    while (free_.empty()) {
+        ASSERT(inflight_ > 0);
+        reap(true);
+    }
+
+    size_t n = free_.front();
+    free_.pop_front();
+    return n;
+}
+
+void URingHandle::queueWrite(size_t n) {
+    Slot& slot = slots_[n];
+
+    // After a partial flush, the next offsets are no longer aligned
+    if (odirect_ && slot.offset % ALIGNMENT != 0) {
+        direct(false);
+    }
+
+    slot.extent = slot.length;
+    if (odirect_ && slot.extent % ALIGNMENT != 0) {
+        // Padding is truncated on close
+        slot.extent = eckit::round(slot.extent, ALIGNMENT);
+        ::memset(slot.data + slot.length, 0, slot.extent - slot.length);
+    }
+
+    slot.done = 0;
+    submit(n);
+}
+
+void URingHandle::queueRead(size_t n) {
+    Slot& slot = slots_[n];
+
+    slot.offset = next_;
+    slot.length = std::min<size_t>(buffsize_, size_ - next_);
+    slot.extent = odirect_ ? eckit::round(slot.length, ALIGNMENT) : slot.length;
+    slot.done   = 0;
+    slot.used   = 0;
+
+    next_ += slot.length;
+    ahead_.push_back(n);
+
+    submit(n);
+}
+
+void URingHandle::readAhead() {
+    while (!free_.empty() && next_ < size_) {
+        size_t n = free_.front();
+        free_.pop_front();
+        queueRead(n);
+    }
+
+    if (ring_->prepared()) {
+        ring_->enter(0);
+    }
+}
+
+long URingHandle::read(void* buffer, long length) {
+    if (fallback_) {
+        return fallback_->read(buffer, length);
+    }
+
+    ASSERT(fd_ >= 0 && reading_);
+
+    char* p    = static_cast<char*>(buffer);
+    long total = 0;
+
+    while (length > 0 && !ahead_.empty()) {
+        size_t n   = ahead_.front();
+        Slot& slot = slots_[n];
+
+        while (slot.inflight) {
+            reap(true);
+        }
+
+        size_t available = std::min(slot.done, slot.length);
+        size_t len       = std::min<size_t>(length, available - slot.used);
+
+        ::memcpy(p, slot.data + slot.used, len);
+        slot.used += len;
+        p += len;
+        length -= len;
+        total += len;
+        pos_ += len;
+
+        if (slot.used < available) {
+            continue;
+        }
+
+        ahead_.pop_front();
+
+        if (slot.done < slot.length) {
+            // The file is shorter than when it was opened
+            size_ = slot.offset + slot.done;
+            drain();
+            for (size_t m : ahead_) {
+                free_.push_back(m);
+            }
+            ahead_.clear();
+            free_.push_back(n);
+            break;
+        }
+
+        free_.push_back(n);
+        readAhead();
+    }
+
+    return total;
+}
+
+long URingHandle::write(const void* buffer, long length) {
+    if (fallback_) {
+        return fallback_->write(buffer, length);
+    }
+
+    ASSERT(fd_ >= 0 && !reading_);
+
+    const char* p = static_cast<const char*>(buffer);
+    long left     = length;
+
+    while (left > 0) {
+        if (current_ < 0) {
+            current_      = static_cast<long>(freeSlot());
+            Slot& slot    = slots_[current_];
+            slot.length   = 0;
+            slot.offset   = pos_;
+        }
+
+        Slot& slot = slots_[current_];
+        size_t len = std::min<size_t>(left, buffsize_ - slot.length);
+
+        ::memcpy(slot.data + slot.length, p, len);
+        slot.length += len;
+        p += len;
+        left -= len;
+        pos_ += len;
+
+        if (slot.length == buffsize_) {
+            queueWrite(current_);
+            current_ = -1;
+        }
+    }
+
+    return length;
+}
+
+void URingHandle::flush() {
+    if (fallback_) {
+        fallback_->flush();
+        return;
+    }
+
+    if (fd_ < 0 || reading_) {
+        return;
+    }
+
+    if (current_ >= 0) {
+        queueWrite(current_);
+        current_ = -1;
+    }
+
+    drain();
+
+    if (fsync_) {
+        synced_ = false;
+        while (!ring_->prepare(Op::Fsync, fd_, nullptr, 0, 0, -1, count_)) {
+            ring_->enter(0);
+        }
+        while (!synced_) {
+            reap(true);
+        }
+    }
+}
+
+void URingHandle::close() {
+    if (fallback_) {
+        fallback_->close();
+        return;
+    }
+
+    if (fd_ < 0) {
+        return;
+    }
+
+    if (reading_) {
+        drain();
+    }
+    else {
+        flush();  // this waits for the async requests to finish
+        if (direct_) {
+            SYSCALL2(::ftruncate(fd_, pos_), path_);
+        }
+    }
+
+    SYSCALL2(::close(fd_), path_);
+    fd_ = -1;
+
+    ahead_.clear();
+}
+
+void URingHandle::rewind() {
+    if (fallback_) {
+        fallback_->rewind();
+        return;
+    }
+
+    if (!reading_) {
+        NOTIMP;
+    }
+
+    drain();
+
+    free_.clear();
+    ahead_.clear();
+    for (size_t i = 0; i < count_; ++i) {
+        free_.push_back(i);
+    }
+
+    pos_  = 0;
+    next_ = 0;
+    readAhead();
+}
+
+void URingHandle::print(std::ostream& s) const {
+    s << "URingHandle[" << path_ << ']';
+}
+
+Length URingHandle::size() {
+    if (fallback_) {
+        return fallback_->size();
+    }
+    if (reading_) {
+        return size_;
+    }
+    Stat::Struct info;
+    SYSCALL2(Stat::fstat(fd_, &info), path_);
+    return info.st_size;
+}
+
+Length URingHandle::estimate() {
+    return size();
+}
+
+Offset URingHandle::position() {
+    if (fallback_) {
+        return fallback_->position();
+    }
+    return pos_;
+}
+
+std::string URingHandle::title() const {
+    return std::string("URING[") + PathName::shorten(path_) + "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,130 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_io_URingHandle_h
+#define eckit_io_URingHandle_h
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/DataHandle.h"
+
+namespace eckit {
+
+class URing;
+
+/// DataHandle on a local file doing its I/O through a Linux io_uring.
+///
+/// Writes are copied into @c count buffers of @c buffsize bytes, registered with the kernel,
+/// which are submitted in batches and written asynchronously at their file offset.
+/// Reads keep @c count buffers in flight ahead of the consumer (read-ahead).
+/// With @c direct the file is opened with O_DIRECT, when the file system allows it.
+///
+/// If io_uring is not available at runtime (old kernel, seccomp policy, or $ECKIT_URING_DISABLE set),
+/// the handle falls back to AIOHandle for writing and FileHandle for reading.
+
+class URingHandle : public DataHandle {
+
+public:  // methods
+
+    URingHandle(const PathName& path, size_t count = 16, size_t buffsize = 1024 * 1024, bool fsync = false,
+                bool direct = false);
+
+    ~URingHandle() override;
+
+    Length openForRead() override;
+    void openForWrite(const Length&) override;
+    void openForAppend(const Length&) override;
+
+    long read(void*, long) override;
+    long write(const void*, long) override;
+    void close() override;
+    void flush() override;
+    void rewind() override;
+    void print(std::ostream&) const override;
+
+    Length size() override;
+    Length estimate() override;
+    Offset position() override;
+
+    bool canSeek() const override { return false; }
+
+    /// True if io_uring can be used in this process
+    static bool available();
+
+private:  // types
+
+    struct Slot {
+        char* data    = nullptr;
+        size_t length = 0;  ///< bytes filled by write(), or expected from the file
+        size_t extent = 0;  ///< bytes requested from the kernel (length, or padded for O_DIRECT)
+        size_t done   = 0;  ///< bytes transferred by the kernel
+        size_t used   = 0;  ///< bytes consumed by read()
+        off_t offset  = 0;
+        bool inflight = false;
+    };
+
+private:  // methods
+
+    bool setup();
+    void open(int flags);
+    void allocate();
+    DataHandle* makeFallback() const;
+    void submit(size_t slot);
+    void reap(bool wait);
+    void complete(size_t slot, int result);
+    void drain();
+    void queueWrite(size_t slot);
+    void queueRead(size_t slot);
+    void readAhead();
+    size_t freeSlot();
+    void direct(bool);
+
+    std::string title() const override;
+
+protected:  // members
+
+    PathName path_;
+
+private:  // members
+
+    std::unique_ptr<URing> ring_;
+    std::unique_ptr<DataHandle> fallback_;
+
+    std::vector<Slot> slots_;
+    std::deque<size_t> free_;
+    std::deque<size_t> ahead_;  ///< slots read ahead, in file order
+
+    char* memory_;
+    size_t count_;
+    size_t buffsize_;
+    size_t inflight_;
+    size_t batch_;
+
+    long current_;  ///< slot being filled by write(), or -1
+
+    int fd_;
+    off_t pos_;
+    off_t next_;  ///< next offset to read ahead
+    off_t size_;
+
+    bool fsync_;
+    bool direct_;   ///< O_DIRECT requested
+    bool odirect_;  ///< O_DIRECT in effect on fd_
+    bool reading_;
+    bool registered_;
+    bool synced_;
+};
+
+}  // namespace eckit
+
+#endif
@@ -0,0 +1,268 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+#include "eckit/eckit.h"
+
+#if eckit_HAVE_SENDFILE
+#include <sys/sendfile.h>
+#endif
+
+#include "eckit/config/LibEcKit.h"
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/DataHandle.h"
+#include "eckit/io/TransferWatcher.h"
+#include "eckit/io/ZeroCopy.h"
+#include "eckit/log/Log.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+enum class Method {
+    CopyFileRange,
+    SendFile,
+    Splice,
+    None,
+};
+
+const char* name(Method m) {
+    switch (m) {
+        case Method::CopyFileRange:
+            return "copy_file_range";
+        case Method::SendFile:
+            return "sendfile";
+        case Method::Splice:
+            return "splice";
+        default:
+            return "none";
+    }
+}
+
+/// Next method to try when the kernel refuses one for this pair of descriptors
+Method fallback(Method m) {
+    return m == Method::CopyFileRange ? Method::SendFile : Method::None;
+}
+
+bool unsupported(int err) {
+    return err == EINVAL || err == ENOSYS || err == EXDEV || err == EOPNOTSUPP || err == EBADF || err == ESPIPE;
+}
+
+
+/// Moves data from a socket or a pipe through an intermediate pipe
+class Splicer {
+public:
+
+    explicit Splicer(bool open) {
+#if eckit_HAVE_SPLICE
+        if (open && ::pipe(pipe_) != 0) {
+            pipe_[0] = pipe_[1] = -1;
+        }
+#endif
+    }
+
+    ~Splicer() {
+        for (int fd : pipe_) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool ok() const { return pipe_[0] >= 0; }
+
+    ssize_t move(int in, int out, size_t length) {
+#if eckit_HAVE_SPLICE
+        ssize_t n = ::splice(in, nullptr, pipe_[1], nullptr, length, SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (n <= 0) {
+            return n;
+        }
+
+        size_t left = n;
+        while (left > 0) {
+            ssize_t m = ::splice(pipe_[0], nullptr, out, nullptr, left, SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (m < 0 && errno == EINTR) {
+                continue;
+            }
+            if (m <= 0) {
+                // The bytes are already out of the input: deliver them the slow way
+                drain(left, out);
+                break;
+            }
+            left -= m;
+        }
+        return n;
+#else
+        errno = ENOSYS;
+        return -1;
+#endif
+    }
+
+private:
+
+    /// Write to the descriptor, not to the handle, so that the bytes are where the handle expects them (e.g. not in
+    /// the buffer of a FileHandle, that transferred() would then overwrite)
+    void drain(size_t left, int out) {
+        char buffer[64 * 1024];
+        while (left > 0) {
+            ssize_t n = ::read(pipe_[0], buffer, std::min(left, sizeof(buffer)));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                throw ReadError("zeroCopy: cannot drain pipe");
+            }
+            left -= n;
+
+            const char* p = buffer;
+            while (n > 0) {
+                ssize_t m = ::write(out, p, n);
+                if (m < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (m <= 0) {
+                    throw WriteError("zeroCopy: cannot drain pipe");
+                }
+                p += m;
+                n -= m;
+            }
+        }
+    }
+
+    int pipe_[2] = {-1, -1};
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Length zeroCopy(DataHandle& in, DataHandle& out, const Length& length, long chunk, TransferWatcher& watcher) {
+
+    static bool enabled = Resource<bool>("zeroCopy;$ECKIT_ZERO_COPY", true);
+
+    if (!enabled || watcher.needsData() || chunk <= 0) {
+        return 0;
+    }
+
+    int ifd = in.fileDescriptor();
+    int ofd = out.fileDescriptor();
+
+    if (ifd < 0 || ofd < 0) {
+        return 0;
+    }
+
+    struct stat is;
+    struct stat os;
+    if (::fstat(ifd, &is) != 0 || ::fstat(ofd, &os) != 0) {
+        return 0;
+    }
+
+    // Regular files are read at the position of the handle, and the descriptor is left untouched;
+    // other descriptors (sockets, pipes) are consumed
+
+    bool file     = S_ISREG(is.st_mode);
+    off_t offset  = file ? off_t((long long)in.position()) : 0;
+    Method method = file ? (S_ISREG(os.st_mode) ? Method::CopyFileRange : Method::SendFile) : Method::Splice;
+
+#if !eckit_HAVE_COPY_FILE_RANGE
+    if (method == Method::CopyFileRange) {
+        method = Method::SendFile;
+    }
+#endif
+#if !eckit_HAVE_SENDFILE
+    if (method == Method::SendFile) {
+        method = Method::None;
+    }
+#endif
+
+    Splicer splicer(method == Method::Splice);
+    if (method == Method::Splice && !splicer.ok()) {
+        method = Method::None;
+    }
+
+    const long long limit = length;
+    long long total       = 0;
+
+    while (method != Method::None) {
+
+        long long want = chunk;
+        if (limit > 0) {
+            want = std::min(want, limit - total);
+        }
+        if (want <= 0) {
+            break;
+        }
+
+        ssize_t n = -1;
+        switch (method) {
+#if eckit_HAVE_COPY_FILE_RANGE
+            case Method::CopyFileRange:
+                n = ::copy_file_range(ifd, &offset, ofd, nullptr, want, 0);
+                break;
+#endif
+#if eckit_HAVE_SENDFILE
+            case Method::SendFile:
+                n = ::sendfile(ofd, ifd, &offset, want);
+                break;
+#endif
+            case Method::Splice:
+                n = splicer.move(ifd, ofd, want);
+                break;
+            default:
+                errno = ENOSYS;
+                break;
+        }
+
+        if (n < 0) {
+            int err = errno;
+            if (err == EINTR) {
+                continue;
+            }
+
+            // Refused by the kernel for these descriptors: try the next method, or let the caller use buffers
+            Log::debug<LibEcKit>() << "zeroCopy: " << name(method) << " " << in << " => " << out << Log::syserr
+                                   << std::endl;
+
+            method = unsupported(err) ? fallback(method) : Method::None;
+            continue;
+        }
+
+        if (n == 0) {
+            break;
+        }
+
+        total += n;
+        watcher.watch(nullptr, n);
+    }
+
+    if (total > 0) {
+        in.transferred(total);
+        out.transferred(total);
+    }
+
+    return total;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,33 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_io_ZeroCopy_h
+#define eckit_io_ZeroCopy_h
+
+#include "eckit/io/Length.h"
+
+namespace eckit {
+
+class DataHandle;
+class TransferWatcher;
+
+/// Moves data between two open handles inside the kernel (copy_file_range, sendfile or splice),
+/// when both expose a file descriptor and the watcher does not need to see the data.
+///
+/// Stops after length bytes (0 means up to the end of the input), at the end of the input, or as soon
+/// as the kernel cannot move data between these descriptors. Returns the number of bytes moved; the
+/// caller completes the transfer with read()/write(), so falling back is transparent.
+///
+/// Can be disabled with the resource zeroCopy;$ECKIT_ZERO_COPY
+Length zeroCopy(DataHandle& in, DataHandle& out, const Length& length, long chunk, TransferWatcher&);
+
+}  // namespace eckit
+
+#endif
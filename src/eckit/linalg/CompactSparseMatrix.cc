@@ -0,0 +1,410 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#include "eckit/linalg/CompactSparseMatrix.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <string>
+
+#include "eckit/eckit.h"
+
+#include "eckit/config/LibEcKit.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/linalg/Matrix.h"
+#include "eckit/linalg/SparseMatrix.h"
+#include "eckit/linalg/Triplet.h"
+#include "eckit/linalg/Vector.h"
+#include "eckit/linalg/detail/SparseFormat.h"
+#include "eckit/linalg/sparse/detail/Kernels.h"
+#include "eckit/log/Log.h"
+#include "eckit/serialisation/FileStream.h"
+#include "eckit/serialisation/Stream.h"
+
+namespace eckit::linalg {
+
+static constexpr bool littleEndian = eckit_LITTLE_ENDIAN != 0;
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename To, typename From>
+To checked(From value, const char* what) {
+    if (static_cast<unsigned long long>(value) > static_cast<unsigned long long>(std::numeric_limits<To>::max())) {
+        throw OutOfRange("CompactSparseMatrix: " + std::string(what) + "=" + std::to_string(value) +
+                             " does not fit in " + std::to_string(sizeof(To)) + " bytes",
+                         Here());
+    }
+    return static_cast<To>(value);
+}
+
+
+using sparse::detail::BLOCK;
+using sparse::detail::forEachPart;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace
+
+
+template <typename V, typename I>
+CompactSparseMatrix<V, I>::CompactSparseMatrix(const SparseMatrix& other) {
+    reserve(other.rows(), other.cols(), other.nonZeros());
+    if (other.empty()) {
+        return;
+    }
+
+    const auto* outer = other.outerIndex();
+    const auto* inner = other.inner();
+    const auto* data  = other.data();
+
+    std::transform(outer, outer + outer_.size(), outer_.begin(), [](auto o) { return static_cast<UIndex>(o); });
+    std::transform(inner, inner + inner_.size(), inner_.begin(), [](auto j) { return static_cast<Index>(j); });
+    std::transform(data, data + data_.size(), data_.begin(), [](auto v) { return static_cast<Value>(v); });
+}
+
+
+template <typename V, typename I>
+CompactSparseMatrix<V, I>::CompactSparseMatrix(Size rows, Size cols, const std::vector<Triplet>& triplets) {
+    Size nnz = std::count_if(triplets.begin(), triplets.end(), [](const auto& tri) { return tri.nonZero(); });
+    reserve(rows, cols, nnz);
+
+    Size pos = 0;
+    Size row = 0;
+
+    for (const auto& tri : triplets) {
+        if (tri.nonZero()) {
+
+            // triplets are ordered by rows
+            ASSERT(tri.row() >= row);
+            ASSERT(tri.row() < rows_);
+            ASSERT(tri.col() < cols_);
+
+            // start a new row
+            while (tri.row() > row) {
+                outer_[++row] = static_cast<UIndex>(pos);
+            }
+
+            inner_[pos] = static_cast<Index>(tri.col());
+            data_[pos]  = static_cast<Value>(tri.value());
+            ++pos;
+        }
+    }
+
+    while (row < rows_) {
+        outer_[++row] = static_cast<UIndex>(pos);
+    }
+}
+
+
+template <typename V, typename I>
+CompactSparseMatrix<V, I>::CompactSparseMatrix(Stream& s) {
+    decode(s);
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::reserve(Size rows, Size cols, Size nnz) {
+    checked<UIndex>(nnz, "nnz");
+    checked<Index>(cols, "cols");
+
+    rows_ = rows;
+    cols_ = cols;
+
+    outer_.assign(rows + 1, 0);
+    inner_.resize(nnz);
+    data_.resize(nnz);
+}
+
+
+template <typename V, typename I>
+SparseMatrix CompactSparseMatrix<V, I>::sparseMatrix() const {
+    SparseMatrix A;
+    if (empty()) {
+        return A;
+    }
+
+    checked<SparseMatrix::UIndex>(nonZeros(), "nnz");
+    checked<linalg::Index>(cols_, "cols");
+
+    A.reserve(rows_, cols_, nonZeros());
+
+    auto* outer = const_cast<SparseMatrix::UIndex*>(A.outerIndex());
+    auto* inner = const_cast<linalg::Index*>(A.inner());
+    auto* data  = const_cast<Scalar*>(A.data());
+
+    std::transform(outer_.begin(), outer_.end(), outer, [](auto o) { return static_cast<SparseMatrix::UIndex>(o); });
+    std::transform(inner_.begin(), inner_.end(), inner, [](auto j) { return static_cast<linalg::Index>(j); });
+    std::transform(data_.begin(), data_.end(), data, [](auto v) { return static_cast<Scalar>(v); });
+
+    return A;
+}
+
+
+template <typename V, typename I>
+template <typename X, typename Y>
+void CompactSparseMatrix<V, I>::spmv(const X* x, Y* y) const {
+    if (empty()) {
+        return;
+    }
+
+    const auto* const outer = outer_.data();
+    const auto* const inner = inner_.data();
+    const auto* const val   = data_.data();
+
+    const auto kernel = sparse::detail::spmvKernel<UIndex, I, V, X, Y>(sparse::detail::simd());
+
+    forEachPart(outer, rows_, [=](Size begin, Size end) { kernel(outer, inner, val, x, y, begin, end); });
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::spmv(const Vector& x, Vector& y) const {
+    ASSERT(x.rows() == cols_);
+    ASSERT(y.rows() == rows_);
+    spmv(x.data(), y.data());
+}
+
+
+template <typename V, typename I>
+template <typename X, typename Y>
+void CompactSparseMatrix<V, I>::spmm(const X* B, Y* C, Size k) const {
+    if (empty()) {
+        return;
+    }
+
+    const auto* const outer = outer_.data();
+    const auto* const inner = inner_.data();
+    const auto* const val   = data_.data();
+
+    // Blocks of columns of B are copied by row so that each non-zero reads contiguous values
+    std::vector<X> panel(cols_ * std::min(k, BLOCK));
+
+    for (Size k0 = 0; k0 < k; k0 += BLOCK) {
+        const auto K  = std::min(BLOCK, k - k0);
+        auto* const P = panel.data();
+
+        for (Size j = 0; j < cols_; ++j) {
+            for (Size kk = 0; kk < K; ++kk) {
+                P[j * K + kk] = B[(k0 + kk) * cols_ + j];
+            }
+        }
+
+        forEachPart(outer, rows_, [=](Size begin, Size end) {
+            for (Size i = begin; i < end; ++i) {
+                double sum[BLOCK] = {};
+                for (auto c = outer[i]; c < outer[i + 1]; ++c) {
+                    const auto* b = P + static_cast<Size>(inner[c]) * K;
+                    const auto v  = static_cast<double>(val[c]);
+                    for (Size kk = 0; kk < K; ++kk) {
+                        sum[kk] += v * static_cast<double>(b[kk]);
+                    }
+                }
+                for (Size kk = 0; kk < K; ++kk) {
+                    C[(k0 + kk) * rows_ + i] = static_cast<Y>(sum[kk]);
+                }
+            }
+        });
+    }
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::spmm(const Matrix& B, Matrix& C) const {
+    ASSERT(B.rows() == cols_);
+    ASSERT(C.rows() == rows_);
+    ASSERT(C.cols() == B.cols());
+    spmm(B.data(), C.data(), B.cols());
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::save(const PathName& path) const {
+    FileStream s(path, "w");
+    auto c = closer(s);
+    encode(s);
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::load(const PathName& path) {
+    FileStream s(path, "r");
+    auto c = closer(s);
+    decode(s);
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::encode(Stream& s) const {
+    s << rows_;
+    s << cols_;
+    s << nonZeros();
+
+    s << littleEndian;
+    s << sizeof(Index);
+    s << sizeof(Value);
+    s << sizeof(Size);
+
+    s.writeLargeBlob(outer_.data(), outer_.size() * sizeof(UIndex));
+    s.writeLargeBlob(inner_.data(), inner_.size() * sizeof(Index));
+    s.writeLargeBlob(data_.data(), data_.size() * sizeof(Value));
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::decode(Stream& s) {
+    Size rows = 0;
+    Size cols = 0;
+    Size nnz  = 0;
+
+    s >> rows;
+    s >> cols;
+    s >> nnz;
+
+    bool little_endian = true;
+    s >> little_endian;
+    ASSERT(littleEndian == little_endian);
+
+    size_t index_size = 0;
+    s >> index_size;
+
+    size_t value_size = 0;
+    s >> value_size;
+
+    size_t size_size = 0;
+    s >> size_size;
+    ASSERT(size_size == sizeof(Size));
+
+    reserve(rows, cols, nnz);
+
+    Log::debug<LibEcKit>() << "Decoding matrix : "
+                           << " rows " << rows << " cols " << cols << " nnz " << nnz << " index size " << index_size
+                           << " value size " << value_size << std::endl;
+
+    detail::readLargeBlob(s, outer_.data(), outer_.size(), index_size);
+    detail::readLargeBlob(s, inner_.data(), inner_.size(), index_size);
+    detail::readLargeBlob(s, data_.data(), data_.size(), value_size);
+}
+
+
+template <typename V, typename I>
+size_t CompactSparseMatrix<V, I>::dumpSize() const {
+    using detail::SPMInfoVersioned;
+    return SPMInfoVersioned::align(SPMInfoVersioned::align(SPMInfoVersioned::align(sizeof(SPMInfoVersioned)) +
+                                                           data_.size() * sizeof(Value)) +
+                                   outer_.size() * sizeof(UIndex)) +
+           inner_.size() * sizeof(Index);
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::dump(void* buffer, size_t size) const {
+    using detail::SPMInfoVersioned;
+    ASSERT(size >= dumpSize());
+
+    SPMInfoVersioned info{};
+
+    info.magic_     = SPMInfoVersioned::MAGIC;
+    info.version_   = SPMInfoVersioned::VERSION;
+    info.valueSize_ = sizeof(Value);
+    info.indexSize_ = sizeof(Index);
+
+    info.size_ = nonZeros();
+    info.rows_ = rows_;
+    info.cols_ = cols_;
+
+    info.data_  = SPMInfoVersioned::align(sizeof(SPMInfoVersioned));
+    info.outer_ = SPMInfoVersioned::align(info.data_ + data_.size() * sizeof(Value));
+    info.inner_ = SPMInfoVersioned::align(info.outer_ + outer_.size() * sizeof(UIndex));
+
+    auto* b = static_cast<char*>(buffer);
+    std::memset(b, 0, info.data_);
+    std::memcpy(b, &info, sizeof(info));
+    std::memcpy(b + info.data_, data_.data(), data_.size() * sizeof(Value));
+    std::memcpy(b + info.outer_, outer_.data(), outer_.size() * sizeof(UIndex));
+    std::memcpy(b + info.inner_, inner_.data(), inner_.size() * sizeof(Index));
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::load(const void* buffer, size_t size) {
+    const auto* b = static_cast<const char*>(buffer);
+
+    if (!detail::SPMInfoVersioned::versioned(buffer, size)) {
+        SparseMatrix::Layout layout;
+        SparseMatrix::Shape shape;
+        SparseMatrix::load(buffer, size, layout, shape);
+
+        reserve(shape.rows(), shape.cols(), shape.nonZeros());
+        detail::convert(layout.outer_, outer_.data(), outer_.size(), sizeof(SparseMatrix::UIndex));
+        detail::convert(layout.inner_, inner_.data(), inner_.size(), sizeof(linalg::Index));
+        detail::convert(layout.data_, data_.data(), data_.size(), sizeof(Scalar));
+        return;
+    }
+
+    detail::SPMInfoVersioned info;
+    ASSERT(size >= sizeof(info));
+    std::memcpy(&info, b, sizeof(info));
+
+    if (info.version_ != detail::SPMInfoVersioned::VERSION) {
+        throw BadValue("CompactSparseMatrix: unsupported dump version " + std::to_string(info.version_), Here());
+    }
+
+    ASSERT(info.data_ + info.size_ * info.valueSize_ <= size);
+    ASSERT(info.outer_ + (info.rows_ + 1) * info.indexSize_ <= size);
+    ASSERT(info.inner_ + info.size_ * info.indexSize_ <= size);
+
+    reserve(info.rows_, info.cols_, info.size_);
+    detail::convert(b + info.outer_, outer_.data(), outer_.size(), info.indexSize_);
+    detail::convert(b + info.inner_, inner_.data(), inner_.size(), info.indexSize_);
+    detail::convert(b + info.data_, data_.data(), data_.size(), info.valueSize_);
+}
+
+
+template <typename V, typename I>
+size_t CompactSparseMatrix<V, I>::footprint() const {
+    return sizeof(*this) + outer_.size() * sizeof(UIndex) + inner_.size() * sizeof(Index) +
+           data_.size() * sizeof(Value);
+}
+
+
+template <typename V, typename I>
+void CompactSparseMatrix<V, I>::print(std::ostream& os) const {
+    os << "CompactSparseMatrix[nnz=" << nonZeros() << ",rows=" << rows_ << ",cols=" << cols_
+       << ",value=" << sizeof(Value) << ",index=" << sizeof(Index) << "]";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Explicit template instantiation, products for all combinations of double and float operands
+#define ECKIT_LINALG_COMPACT_SPARSE_MATRIX(V, I)                                                   \
+    template class CompactSparseMatrix<V, I>;                                                      \
+    template void CompactSparseMatrix<V, I>::spmv(const double*, double*) const;                  \
+    template void CompactSparseMatrix<V, I>::spmv(const double*, float*) const;                   \
+    template void CompactSparseMatrix<V, I>::spmv(const float*, double*) const;                   \
+    template void CompactSparseMatrix<V, I>::spmv(const float*, float*) const;                    \
+    template void CompactSparseMatrix<V, I>::spmm(const double*, double*, Size) const;            \
+    template void CompactSparseMatrix<V, I>::spmm(const double*, float*, Size) const;             \
+    template void CompactSparseMatrix<V, I>::spmm(const float*, double*, Size) const;             \
+    template void CompactSparseMatrix<V, I>::spmm(const float*, float*, Size) const;
+
+ECKIT_LINALG_COMPACT_SPARSE_MATRIX(double, std::int32_t)
+ECKIT_LINALG_COMPACT_SPARSE_MATRIX(double, std::int64_t)
+ECKIT_LINALG_COMPACT_SPARSE_MATRIX(float, std::int32_t)
+ECKIT_LINALG_COMPACT_SPARSE_MATRIX(float, std::int64_t)
+
+#undef ECKIT_LINALG_COMPACT_SPARSE_MATRIX
+
+}  // namespace eckit::linalg
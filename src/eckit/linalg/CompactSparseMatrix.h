@@ -0,0 +1,136 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <type_traits>
+#include <vector>
+
+#include "eckit/linalg/types.h"
+
+
+namespace eckit {
+class PathName;
+class Stream;
+}  // namespace eckit
+
+namespace eckit::linalg {
+
+class Triplet;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Sparse matrix in CRS (compressed row storage) format, with a choice of value and index types:
+///   * float values halve the memory traffic of the (bandwidth bound) products,
+///   * 64-bit indices allow for more than 2^31 columns or 2^32 non-zeros.
+///
+/// Products take double or float operands and accumulate in double, whatever the type of the values. With 32-bit
+/// indices, spmv uses the instruction set of the "optimised" sparse backend (see LinearAlgebraOptimised).
+///
+/// save() writes the SparseMatrix stream format, which records the size of values and indices; dump() writes a
+/// versioned header recording them. Either can be read back with any value and index types, including SparseMatrix,
+/// converting where needed (OutOfRange if an index does not fit).
+template <typename V, typename I>
+class CompactSparseMatrix {
+    static_assert(std::is_floating_point_v<V>, "CompactSparseMatrix: floating point values");
+    static_assert(std::is_integral_v<I> && std::is_signed_v<I>, "CompactSparseMatrix: signed integer indices");
+
+public:  // types
+
+    using Value  = V;
+    using Index  = I;
+    using UIndex = std::make_unsigned_t<I>;
+
+public:  // methods
+
+    /// Default constructor, empty matrix
+    CompactSparseMatrix() = default;
+
+    /// Constructor from a SparseMatrix, converting values and indices
+    explicit CompactSparseMatrix(const SparseMatrix&);
+
+    /// Constructor from triplets (ordered by row)
+    CompactSparseMatrix(Size rows, Size cols, const std::vector<Triplet>&);
+
+    /// Constructor from Stream
+    explicit CompactSparseMatrix(Stream&);
+
+    /// SparseMatrix with the same entries, converting values and indices
+    SparseMatrix sparseMatrix() const;
+
+    /// y = A x
+    template <typename X, typename Y>
+    void spmv(const X* x, Y* y) const;
+    void spmv(const Vector& x, Vector& y) const;
+
+    /// C = A B, for column-major B (cols x k) and C (rows x k)
+    template <typename X, typename Y>
+    void spmm(const X* B, Y* C, Size k) const;
+    void spmm(const Matrix& B, Matrix& C) const;
+
+    void save(const PathName&) const;
+    void load(const PathName&);
+
+    void encode(Stream&) const;
+    void decode(Stream&);
+
+    /// Bytes needed by dump()
+    size_t dumpSize() const;
+
+    /// Versioned dump (sections aligned to 64 bytes)
+    void dump(void* buffer, size_t size) const;
+
+    /// From dump() of a CompactSparseMatrix or a SparseMatrix
+    void load(const void* buffer, size_t size);
+
+    Size rows() const { return rows_; }
+    Size cols() const { return cols_; }
+    Size nonZeros() const { return inner_.size(); }
+    bool empty() const { return nonZeros() == 0; }
+
+    const UIndex* outer() const { return outer_.data(); }
+    const Index* inner() const { return inner_.data(); }
+    const Value* data() const { return data_.data(); }
+
+    size_t footprint() const;
+
+    void print(std::ostream&) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const CompactSparseMatrix& m) {
+        m.print(os);
+        return os;
+    }
+
+private:  // methods
+
+    void reserve(Size rows, Size cols, Size nnz);
+
+private:  // members
+
+    Size rows_ = 0;
+    Size cols_ = 0;
+
+    std::vector<UIndex> outer_;
+    std::vector<Index> inner_;
+    std::vector<Value> data_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+using SparseMatrixFloat      = CompactSparseMatrix<float, std::int32_t>;
+using SparseMatrixLarge      = CompactSparseMatrix<double, std::int64_t>;
+using SparseMatrixFloatLarge = CompactSparseMatrix<float, std::int64_t>;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::linalg
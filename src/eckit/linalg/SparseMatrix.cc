@@ -25,6 +25,7 @@
 #include "eckit/io/MemoryHandle.h"
 #include "eckit/linalg/allocator/BufferAllocator.h"
 #include "eckit/linalg/allocator/StandardAllocator.h"
+#include "eckit/linalg/detail/SparseFormat.h"
 #include "eckit/log/Log.h"
 #include "eckit/memory/MemoryBuffer.h"
 #include "eckit/serialisation/FileStream.h"
@@ -190,24 +191,19 @@ void SparseMatrix::load(const PathName& path) {
 }
 
 
-struct SPMInfo {
-    size_t size_;  ///< non-zeros
-    size_t rows_;  ///< rows
-    size_t cols_;  ///< columns
-    ptrdiff_t data_;
-    ptrdiff_t outer_;
-    ptrdiff_t inner_;
-};
-
-
 void SparseMatrix::load(const void* buffer, size_t bufferSize, Layout& layout, Shape& shape) {
     const auto* b = static_cast<const char*>(buffer);
 
+    if (detail::SPMInfoVersioned::versioned(buffer, bufferSize)) {
+        loadVersioned(buffer, bufferSize, layout, shape);
+        return;
+    }
+
     MemoryHandle mh(buffer, bufferSize);
     mh.openForRead();
 
-    struct SPMInfo info;
-    mh.read(&info, sizeof(SPMInfo));
+    detail::SPMInfo info;
+    mh.read(&info, sizeof(info));
 
     ASSERT(info.size_ && info.rows_ && info.cols_);
     ASSERT(info.data_ > 0 && info.outer_ > 0 && info.inner_ > 0);
@@ -222,7 +218,7 @@ void SparseMatrix::load(const void* buffer, size_t bufferSize, Layout& layout, S
                            << " rows " << shape.rows_ << " cols " << shape.cols_ << " nnzs " << shape.size_
                            << " allocSize " << shape.allocSize() << std::endl;
 
-    ASSERT(bufferSize >= sizeof(SPMInfo) + shape.sizeofData() + shape.sizeofOuter() + shape.sizeofInner());
+    ASSERT(bufferSize >= sizeof(info) + shape.sizeofData() + shape.sizeofOuter() + shape.sizeofInner());
 
     auto* addr = const_cast<char*>(b);
 
@@ -238,25 +234,60 @@ void SparseMatrix::load(const void* buffer, size_t bufferSize, Layout& layout, S
 }
 
 
+void SparseMatrix::loadVersioned(const void* buffer, size_t bufferSize, Layout& layout, Shape& shape) {
+    detail::SPMInfoVersioned info;
+    ASSERT(bufferSize >= sizeof(info));
+    std::memcpy(&info, buffer, sizeof(info));
+
+    if (info.version_ != detail::SPMInfoVersioned::VERSION) {
+        throw BadValue("SparseMatrix: unsupported dump version " + std::to_string(info.version_), Here());
+    }
+
+    // the buffer is used in place, there is no conversion
+    if (info.valueSize_ != sizeof(Scalar) || info.indexSize_ != sizeof(Index)) {
+        throw BadValue("SparseMatrix: dump with values of " + std::to_string(info.valueSize_) +
+                           " bytes and indices of " + std::to_string(info.indexSize_) +
+                           " bytes, use CompactSparseMatrix",
+                       Here());
+    }
+
+    ASSERT(info.size_ && info.rows_ && info.cols_);
+
+    shape.size_ = info.size_;
+    shape.rows_ = info.rows_;
+    shape.cols_ = info.cols_;
+
+    ASSERT(info.data_ + shape.sizeofData() <= bufferSize);
+    ASSERT(info.outer_ + shape.sizeofOuter() <= bufferSize);
+    ASSERT(info.inner_ + shape.sizeofInner() <= bufferSize);
+
+    auto* addr = const_cast<char*>(static_cast<const char*>(buffer));
+
+    layout.data_  = reinterpret_cast<Scalar*>(addr + info.data_);
+    layout.outer_ = reinterpret_cast<UIndex*>(addr + info.outer_);
+    layout.inner_ = reinterpret_cast<Index*>(addr + info.inner_);
+}
+
+
 void SparseMatrix::dump(MemoryBuffer& buffer) const {
     SparseMatrix::dump(buffer.data(), buffer.size());
 }
 
 
 void SparseMatrix::dump(void* buffer, size_t size) const {
-    size_t minimum = sizeof(SPMInfo) + shape_.sizeofData() + shape_.sizeofOuter() + shape_.sizeofInner();
+    size_t minimum = sizeof(detail::SPMInfo) + shape_.sizeofData() + shape_.sizeofOuter() + shape_.sizeofInner();
     ASSERT(size >= minimum);
 
     MemoryHandle mh(buffer, size);
     mh.openForWrite(size);
 
-    SPMInfo info;
+    detail::SPMInfo info;
 
     info.size_ = nonZeros();
     info.rows_ = rows();
     info.cols_ = cols();
 
-    info.data_  = sizeof(SPMInfo);
+    info.data_  = sizeof(info);
     info.outer_ = info.data_ + shape_.sizeofData();
     info.inner_ = info.outer_ + shape_.sizeofOuter();
 
@@ -266,7 +297,7 @@ void SparseMatrix::dump(void* buffer, size_t size) const {
 
     /// @todo we should try to get these memory aligned (to say 64 bytes)
 
-    mh.write(&info, sizeof(SPMInfo));
+    mh.write(&info, sizeof(info));
 
     ASSERT(mh.write(spm_.data_, shape_.sizeofData()) == static_cast<long>(shape_.sizeofData()));
     ASSERT(mh.write(spm_.outer_, shape_.sizeofOuter()) == static_cast<long>(shape_.sizeofOuter()));
@@ -468,13 +499,12 @@ void SparseMatrix::decode(Stream& s) {
     s >> little_endian;
     ASSERT(littleEndian == little_endian);
 
+    // other sizes are written by CompactSparseMatrix
     size_t index_size = 0;
     s >> index_size;
-    ASSERT(index_size == sizeof(Index));
 
     size_t scalar_size = 0;
     s >> scalar_size;
-    ASSERT(scalar_size == sizeof(Scalar));
 
     size_t size_size = 0;
     s >> size_size;
@@ -490,9 +520,9 @@ void SparseMatrix::decode(Stream& s) {
                            << " rows " << rows << " cols " << cols << " nnz " << nnz << " footprint " << footprint()
                            << std::endl;
 
-    s.readLargeBlob(spm_.outer_, shape_.outerSize() * sizeof(UIndex));
-    s.readLargeBlob(spm_.inner_, shape_.innerSize() * sizeof(Index));
-    s.readLargeBlob(spm_.data_, shape_.dataSize() * sizeof(Scalar));
+    detail::readLargeBlob(s, spm_.outer_, shape_.outerSize(), index_size);
+    detail::readLargeBlob(s, spm_.inner_, shape_.innerSize(), index_size);
+    detail::readLargeBlob(s, spm_.data_, shape_.dataSize(), scalar_size);
 }
 
 
@@ -179,7 +179,7 @@ public:
     void dump(eckit::MemoryBuffer&) const;
     void dump(void* buffer, size_t size) const;
 
-    static void load(const void* buffer, size_t bufferSize, Layout&, Shape&);  ///< from dump()
+    static void load(const void* buffer, size_t bufferSize, Layout&, Shape&);  ///< from dump(), or versioned with the same sizes
 
     void swap(SparseMatrix&);
 
@@ -301,9 +301,12 @@ private:
     /// Serialise to a Stream
     void encode(Stream&) const;
 
-    /// Deserialise from a Stream
+    /// Deserialise from a Stream (converting from other value and index sizes)
     void decode(Stream&);
 
+    /// From a versioned dump of the same value and index sizes
+    static void loadVersioned(const void* buffer, size_t bufferSize, Layout&, Shape&);
+
 private:
 
     Layout spm_;  ///< Matrix layout
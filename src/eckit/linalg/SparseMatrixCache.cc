@@ -0,0 +1,156 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#include "eckit/linalg/SparseMatrixCache.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "eckit/config/LibEcKit.h"
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/linalg/allocator/MappedAllocator.h"
+#include "eckit/log/Log.h"
+#include "eckit/utils/MD5.h"
+
+
+namespace eckit::linalg {
+
+namespace {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Appended to the matrix, so that the matrix layout (and alignment) is the one of MappedAllocator::save()
+struct Trailer {
+    static constexpr char MAGIC[] = "ECKITMD5";
+
+    char magic_[8];
+    char digest_[MD5_DIGEST_LENGTH * 2];
+    std::uint64_t size_;  ///< bytes before the trailer
+    char reserved_[16];
+};
+
+static_assert(sizeof(Trailer) == 64, "SparseMatrixCache: Trailer is 64 bytes");
+
+
+struct InvalidEntry : BadValue {
+    InvalidEntry(const PathName& path, const CodeLocation& loc) :
+        BadValue("SparseMatrixCache: invalid entry " + path.asString(), loc) {}
+};
+
+
+bool validate() {
+    static const bool validate = Resource<bool>("sparseMatrixCacheValidate;$ECKIT_SPARSE_MATRIX_CACHE_VALIDATE", false);
+    return validate;
+}
+
+
+struct CreatorAdapter final : SparseMatrixCache::CacheContentCreator {
+    explicit CreatorAdapter(const SparseMatrixCache::Creator& creator) : creator_(creator) {}
+
+    void create(const PathName&, SparseMatrix& value, bool& saved) override {
+        creator_(value);
+        saved = false;
+    }
+
+    const SparseMatrixCache::Creator& creator_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace
+
+
+void SparseMatrixCacheTraits::save(const CacheManagerBase&, const value_type& value, const PathName& path) {
+    allocator::MappedAllocator::save(value, path);
+
+    Trailer trailer{};
+    std::memcpy(trailer.magic_, Trailer::MAGIC, sizeof(trailer.magic_));
+
+    {
+        allocator::MappedAllocator mapped(path);
+        trailer.size_ = mapped.size();
+
+        auto digest = MD5(mapped.address(), mapped.size()).digest();
+        ASSERT(digest.size() == sizeof(trailer.digest_));
+        std::memcpy(trailer.digest_, digest.data(), sizeof(trailer.digest_));
+    }
+
+    FileHandle out(path);
+    out.openForAppend(0);
+    auto c = closer(out);
+    ASSERT(out.write(&trailer, sizeof(trailer)) == static_cast<long>(sizeof(trailer)));
+}
+
+
+void SparseMatrixCacheTraits::load(const CacheManagerBase&, value_type& value, const PathName& path) {
+    auto mapped = std::make_unique<allocator::MappedAllocator>(path);
+
+    if (!SparseMatrixCache::valid(*mapped, validate())) {
+        mapped.reset();
+        Log::warning() << "SparseMatrixCache: invalid entry " << path << ", removing" << std::endl;
+        path.unlink();
+        throw InvalidEntry(path, Here());
+    }
+
+    value = SparseMatrix(mapped.release());
+}
+
+
+SparseMatrixCache::SparseMatrixCache() :
+    SparseMatrixCache(Resource<std::string>("sparseMatrixCacheRoots;$ECKIT_SPARSE_MATRIX_CACHE_ROOTS", "/tmp/cache"),
+                      Resource<size_t>("sparseMatrixCacheSize;$ECKIT_SPARSE_MATRIX_CACHE_SIZE", 0)) {}
+
+
+SparseMatrixCache::SparseMatrixCache(const std::string& roots, size_t maxCacheSize, bool throwOnCacheMiss) :
+    CacheManager("SparseMatrixCache", roots, throwOnCacheMiss, maxCacheSize) {}
+
+
+SparseMatrix SparseMatrixCache::getOrCreate(const key_t& key, const Creator& creator) const {
+    CreatorAdapter adapter(creator);
+    SparseMatrix value;
+
+    try {
+        CacheManager::getOrCreate(key, adapter, value);
+    }
+    catch (InvalidEntry& e) {
+        // the entry was removed, create it again (once)
+        Log::debug<LibEcKit>() << "SparseMatrixCache: " << e.what() << ", creating key=" << key << std::endl;
+        CacheManager::getOrCreate(key, adapter, value);
+    }
+
+    return value;
+}
+
+
+bool SparseMatrixCache::valid(const allocator::MappedAllocator& mapped, bool digest) {
+    if (mapped.size() < sizeof(Trailer)) {
+        return false;
+    }
+
+    Trailer trailer;
+    const auto* end = static_cast<const char*>(mapped.address()) + mapped.size();
+    std::memcpy(&trailer, end - sizeof(Trailer), sizeof(Trailer));
+
+    if (std::memcmp(trailer.magic_, Trailer::MAGIC, sizeof(trailer.magic_)) != 0 ||
+        trailer.size_ != mapped.size() - sizeof(Trailer)) {
+        return false;
+    }
+
+    return !digest || MD5(mapped.address(), trailer.size_).digest() ==
+                          std::string(trailer.digest_, trailer.digest_ + sizeof(trailer.digest_));
+}
+
+
+}  // namespace eckit::linalg
@@ -0,0 +1,73 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+#include "eckit/container/CacheManager.h"
+#include "eckit/linalg/SparseMatrix.h"
+
+
+namespace eckit::linalg {
+
+namespace allocator {
+class MappedAllocator;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct SparseMatrixCacheTraits {
+    using value_type = SparseMatrix;
+    using Locker     = CacheManagerFileFlock;
+
+    static const char* name() { return "sparse-matrix"; }
+    static const char* extension() { return ".spm"; }
+    static int version() { return 1; }
+
+    static void save(const CacheManagerBase&, const value_type&, const PathName&);
+    static void load(const CacheManagerBase&, value_type&, const PathName&);
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// File-backed cache of sparse matrices (e.g. interpolation weights), keyed by the caller. Entries are written once
+/// and then mapped read-only (see MappedAllocator), so that processes on a node share the same pages and nothing is
+/// deserialised; an entry removed from the cache stays valid for the processes that have it mapped.
+///
+/// Entries end with an MD5 digest of their content. Their size is always checked, their content only with
+/// sparseMatrixCacheValidate;$ECKIT_SPARSE_MATRIX_CACHE_VALIDATE (as it reads the whole entry). Invalid entries are
+/// removed and created again.
+///
+/// Defaults: roots from sparseMatrixCacheRoots;$ECKIT_SPARSE_MATRIX_CACHE_ROOTS (separated by ':'), size limit in
+/// bytes from sparseMatrixCacheSize;$ECKIT_SPARSE_MATRIX_CACHE_SIZE (0 for no limit, otherwise least recently used
+/// entries are removed).
+class SparseMatrixCache : public CacheManager<SparseMatrixCacheTraits> {
+public:
+
+    using Creator = std::function<void(SparseMatrix&)>;
+
+    SparseMatrixCache();
+    SparseMatrixCache(const std::string& roots, size_t maxCacheSize, bool throwOnCacheMiss = false);
+
+    using CacheManager::getOrCreate;
+
+    /// Matrix mapped from the entry for key, the creator filling it in first if missing (or invalid)
+    SparseMatrix getOrCreate(const key_t&, const Creator&) const;
+
+    /// Entry size and trailer, and content if digest is set
+    static bool valid(const allocator::MappedAllocator&, bool digest);
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::linalg
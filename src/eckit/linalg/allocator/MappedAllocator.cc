@@ -0,0 +1,124 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#include "eckit/linalg/allocator/MappedAllocator.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <ostream>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/linalg/detail/SparseFormat.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/memory/MMap.h"
+
+
+namespace eckit::linalg::allocator {
+
+
+MappedAllocator::MappedAllocator(const PathName& path) : path_(path), address_(nullptr), size_(path.size()) {
+    ASSERT(size_ > 0);
+
+    int fd;
+    SYSCALL2(fd = ::open(path_.localPath(), O_RDONLY), path_);
+
+    address_ = MMap::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (address_ == MAP_FAILED) {
+        Log::error() << "MappedAllocator path=" << path_ << " size=" << size_ << " fails to mmap" << Log::syserr
+                     << std::endl;
+        throw FailedSystemCall("mmap", Here());
+    }
+}
+
+
+MappedAllocator::~MappedAllocator() {
+    if (MMap::munmap(address_, size_) != 0) {
+        Log::error() << "MappedAllocator path=" << path_ << " fails to munmap" << Log::syserr << std::endl;
+    }
+}
+
+
+SparseMatrix::Layout MappedAllocator::allocate(SparseMatrix::Shape& shape) {
+    SparseMatrix::Layout layout;
+    SparseMatrix::load(address_, size_, layout, shape);
+    return layout;
+}
+
+
+void MappedAllocator::deallocate(SparseMatrix::Layout, SparseMatrix::Shape) {}
+
+
+bool MappedAllocator::inSharedMemory() const {
+    return true;
+}
+
+
+void MappedAllocator::print(std::ostream& out) const {
+    out << "MappedAllocator[path=" << path_ << "," << Bytes{static_cast<double>(size_)} << "]";
+}
+
+
+void MappedAllocator::save(const SparseMatrix& A, const PathName& path) {
+    using detail::SPMInfoVersioned;
+    ASSERT(!A.empty());
+
+    const auto sizeofData  = A.nonZeros() * sizeof(Scalar);
+    const auto sizeofOuter = (A.rows() + 1) * sizeof(SparseMatrix::UIndex);
+    const auto sizeofInner = A.nonZeros() * sizeof(Index);
+
+    SPMInfoVersioned info{};
+
+    info.magic_     = SPMInfoVersioned::MAGIC;
+    info.version_   = SPMInfoVersioned::VERSION;
+    info.valueSize_ = sizeof(Scalar);
+    info.indexSize_ = sizeof(Index);
+
+    info.size_ = A.nonZeros();
+    info.rows_ = A.rows();
+    info.cols_ = A.cols();
+
+    info.data_  = SPMInfoVersioned::align(sizeof(SPMInfoVersioned));
+    info.outer_ = SPMInfoVersioned::align(info.data_ + sizeofData);
+    info.inner_ = SPMInfoVersioned::align(info.outer_ + sizeofOuter);
+
+    const std::vector<char> padding(SPMInfoVersioned::ALIGNMENT, 0);
+    size_t position = 0;
+
+    FileHandle out(path);
+    out.openForWrite(0);
+    auto c = closer(out);
+
+    auto write = [&](const void* buffer, size_t length, ptrdiff_t offset) {
+        ASSERT(position <= static_cast<size_t>(offset));
+        if (position < static_cast<size_t>(offset)) {
+            const auto n = static_cast<long>(offset - position);
+            ASSERT(out.write(padding.data(), n) == n);
+        }
+        ASSERT(out.write(buffer, static_cast<long>(length)) == static_cast<long>(length));
+        position = offset + length;
+    };
+
+    write(&info, sizeof(info), 0);
+    write(A.data(), sizeofData, info.data_);
+    write(A.outerIndex(), sizeofOuter, info.outer_);
+    write(A.inner(), sizeofInner, info.inner_);
+}
+
+
+}  // namespace eckit::linalg::allocator
@@ -0,0 +1,52 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/linalg/SparseMatrix.h"
+
+
+namespace eckit::linalg::allocator {
+
+
+/// Matrix used in place from a read-only, shared mapping of a file written by save(): processes mapping the same
+/// file share its pages, and nothing is read until used
+class MappedAllocator : public SparseMatrix::Allocator {
+public:
+
+    explicit MappedAllocator(const PathName&);
+    ~MappedAllocator() override;
+
+    MappedAllocator(const MappedAllocator&)            = delete;
+    MappedAllocator& operator=(const MappedAllocator&) = delete;
+
+    SparseMatrix::Layout allocate(SparseMatrix::Shape&) override;
+
+    void deallocate(SparseMatrix::Layout, SparseMatrix::Shape) override;
+    bool inSharedMemory() const override;
+    void print(std::ostream&) const override;
+
+    const void* address() const { return address_; }
+    size_t size() const { return size_; }
+
+    /// Write in the versioned dump layout, with sections aligned to 64 bytes
+    static void save(const SparseMatrix&, const PathName&);
+
+private:
+
+    PathName path_;
+    void* address_;
+    size_t size_;
+};
+
+
+}  // namespace eckit::linalg::allocator
@@ -0,0 +1,145 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/linalg/types.h"
+#include "eckit/serialisation/Stream.h"
+
+
+namespace eckit::linalg::detail {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Header of SparseMatrix::dump(), which holds Scalar values and Index/UIndex indices (version 1, no magic)
+struct SPMInfo {
+    size_t size_;  ///< non-zeros
+    size_t rows_;  ///< rows
+    size_t cols_;  ///< columns
+    ptrdiff_t data_;
+    ptrdiff_t outer_;
+    ptrdiff_t inner_;
+};
+
+
+/// Header of versioned dumps, recording the size of values and indices. The magic number is where version 1 holds the
+/// number of non-zeros, a value no matrix reaches.
+struct SPMInfoVersioned {
+    static constexpr std::uint64_t MAGIC   = 0x4d505354494b4345ULL;  // "ECKITSPM" in memory, little-endian
+    static constexpr std::uint32_t VERSION = 2;
+    static constexpr size_t ALIGNMENT      = 64;
+
+    static bool versioned(const void* buffer, size_t size) {
+        std::uint64_t magic = 0;
+        if (size >= sizeof(magic)) {
+            std::memcpy(&magic, buffer, sizeof(magic));
+        }
+        return magic == MAGIC;
+    }
+
+    static size_t align(size_t offset) { return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+    std::uint64_t magic_;
+    std::uint32_t version_;
+    std::uint32_t valueSize_;
+    std::uint32_t indexSize_;
+    std::uint32_t reserved_;
+    size_t size_;  ///< non-zeros
+    size_t rows_;  ///< rows
+    size_t cols_;  ///< columns
+    ptrdiff_t data_;
+    ptrdiff_t outer_;
+    ptrdiff_t inner_;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename To, typename From>
+void convert(const void* from, To* to, Size n) {
+    const auto* f = static_cast<const From*>(from);
+    for (Size i = 0; i < n; ++i) {
+        if constexpr (std::is_integral_v<To>) {
+            using Common = std::conditional_t<std::is_signed_v<From>, long long, unsigned long long>;
+            if (static_cast<Common>(f[i]) < static_cast<Common>(std::numeric_limits<To>::min()) ||
+                static_cast<Common>(f[i]) > static_cast<Common>(std::numeric_limits<To>::max())) {
+                throw OutOfRange("SparseMatrix: index " + std::to_string(f[i]) + " does not fit in " +
+                                     std::to_string(sizeof(To)) + " bytes",
+                                 Here());
+            }
+        }
+        to[i] = static_cast<To>(f[i]);
+    }
+}
+
+
+/// Copy n values stored with 'stored' bytes each (floating point or integer, same signedness as To), converting
+template <typename To>
+void convert(const void* from, To* to, Size n, size_t stored) {
+    if (stored == sizeof(To)) {
+        std::memcpy(to, from, n * sizeof(To));
+        return;
+    }
+
+    if constexpr (std::is_floating_point_v<To>) {
+        if (stored == sizeof(float)) {
+            return convert<To, float>(from, to, n);
+        }
+        if (stored == sizeof(double)) {
+            return convert<To, double>(from, to, n);
+        }
+    }
+    else if constexpr (std::is_signed_v<To>) {
+        if (stored == sizeof(std::int32_t)) {
+            return convert<To, std::int32_t>(from, to, n);
+        }
+        if (stored == sizeof(std::int64_t)) {
+            return convert<To, std::int64_t>(from, to, n);
+        }
+    }
+    else {
+        if (stored == sizeof(std::uint32_t)) {
+            return convert<To, std::uint32_t>(from, to, n);
+        }
+        if (stored == sizeof(std::uint64_t)) {
+            return convert<To, std::uint64_t>(from, to, n);
+        }
+    }
+
+    throw BadValue("SparseMatrix: unsupported element size " + std::to_string(stored), Here());
+}
+
+
+/// Read a large blob of n values stored with 'stored' bytes each, converting
+template <typename To>
+void readLargeBlob(Stream& s, To* to, Size n, size_t stored) {
+    if (stored == sizeof(To)) {
+        s.readLargeBlob(to, n * sizeof(To));
+        return;
+    }
+
+    std::vector<char> buffer(n * stored);
+    s.readLargeBlob(buffer.data(), buffer.size());
+    convert(buffer.data(), to, n, stored);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::linalg::detail
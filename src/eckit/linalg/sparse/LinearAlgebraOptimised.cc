@@ -0,0 +1,217 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#include "eckit/linalg/sparse/LinearAlgebraOptimised.h"
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "eckit/eckit.h"
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/linalg/Matrix.h"
+#include "eckit/linalg/SparseMatrix.h"
+#include "eckit/linalg/Vector.h"
+#include "eckit/linalg/sparse/detail/Kernels.h"
+
+
+namespace eckit::linalg::sparse {
+
+static const LinearAlgebraOptimised __la_optimised("optimised");
+
+namespace {
+
+using UIndex = SparseMatrix::UIndex;
+
+using detail::BLOCK;
+using detail::forEachPart;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Rows {
+    const UIndex* outer;
+    const Index* inner;
+    const Scalar* val;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Columns [k0, k0 + K) of C for rows [begin, end), accumulated in registers; panel holds the same columns of B
+/// stored by row so that each non-zero reads K contiguous values (C is column-major)
+template <Size K>
+void spmmPanel(const Rows& A, const Scalar* panel, Scalar* C, Size ldc, Size k0, Size begin, Size end) {
+    for (Size i = begin; i < end; ++i) {
+        Scalar sum[K] = {};
+
+        for (auto c = A.outer[i]; c < A.outer[i + 1]; ++c) {
+            const auto* b = panel + static_cast<Size>(A.inner[c]) * K;
+            const auto v  = A.val[c];
+            for (Size k = 0; k < K; ++k) {
+                sum[k] += v * b[k];
+            }
+        }
+
+        for (Size k = 0; k < K; ++k) {
+            C[(k0 + k) * ldc + i] = sum[k];
+        }
+    }
+}
+
+using PanelKernel = void (*)(const Rows&, const Scalar*, Scalar*, Size, Size, Size, Size);
+
+const PanelKernel panelKernels[BLOCK + 1] = {
+    nullptr, spmmPanel<1>, spmmPanel<2>, spmmPanel<3>, spmmPanel<4>, spmmPanel<5>, spmmPanel<6>, spmmPanel<7>, spmmPanel<8>,
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+LinearAlgebraOptimised::SIMD LinearAlgebraOptimised::supported() {
+#if ECKIT_LINALG_X86_SIMD
+    static const SIMD cpu = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return SIMD::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return SIMD::AVX2;
+        }
+        return SIMD::None;
+    }();
+    return cpu;
+#else
+    return SIMD::None;
+#endif
+}
+
+
+LinearAlgebraOptimised::SIMD LinearAlgebraOptimised::simd() const {
+    return simd_ == SIMD::Auto ? detail::simd() : std::min(simd_, supported());
+}
+
+
+LinearAlgebraOptimised::SIMD detail::simd() {
+    static const auto cpu = [] {
+        const std::string simd =
+            Resource<std::string>("linearAlgebraSparseSIMD;$ECKIT_LINEAR_ALGEBRA_SPARSE_SIMD", "avx512");
+        const auto configured = simd == "none"   ? LinearAlgebraOptimised::SIMD::None
+                                : simd == "avx2" ? LinearAlgebraOptimised::SIMD::AVX2
+                                                 : LinearAlgebraOptimised::SIMD::AVX512;
+        return std::min(configured, LinearAlgebraOptimised::supported());
+    }();
+    return cpu;
+}
+
+
+void LinearAlgebraOptimised::print(std::ostream& out) const {
+    static const char* names[] = {"auto", "none", "avx2", "avx512"};
+    out << "LinearAlgebraOptimised[simd=" << names[static_cast<int>(simd())] << "]";
+}
+
+
+void LinearAlgebraOptimised::spmv(const SparseMatrix& A, const Vector& x, Vector& y) const {
+    const auto Ni = A.rows();
+    const auto Nj = A.cols();
+
+    ASSERT(y.rows() == Ni);
+    ASSERT(x.rows() == Nj);
+
+    if (A.empty()) {
+        return;
+    }
+
+    const Rows rows{A.outerIndex(), A.inner(), A.data()};
+    ASSERT(rows.outer[0] == 0);  // expect indices to be 0-based
+
+    const auto kernel = detail::spmvKernel<UIndex, Index, Scalar, Scalar, Scalar>(simd());
+
+    const auto* const xp = x.data();
+    auto* const yp       = y.data();
+
+    forEachPart(rows.outer, Ni,
+                [&](Size begin, Size end) { kernel(rows.outer, rows.inner, rows.val, xp, yp, begin, end); });
+}
+
+
+void LinearAlgebraOptimised::spmm(const SparseMatrix& A, const Matrix& B, Matrix& C) const {
+    const auto Ni = A.rows();
+    const auto Nj = A.cols();
+    const auto Nk = B.cols();
+
+    ASSERT(C.rows() == Ni);
+    ASSERT(B.rows() == Nj);
+    ASSERT(C.cols() == Nk);
+
+    if (A.empty()) {
+        return;
+    }
+
+    const Rows rows{A.outerIndex(), A.inner(), A.data()};
+    ASSERT(rows.outer[0] == 0);  // expect indices to be 0-based
+
+    auto* const Cp = C.data();
+
+    // Blocks of columns of B are copied by row, the copy being much smaller than the matrix for skinny B
+    std::vector<Scalar> panel(Nj * std::min(Nk, BLOCK));
+
+    for (Size k0 = 0; k0 < Nk; k0 += BLOCK) {
+        const auto K      = std::min(BLOCK, Nk - k0);
+        auto* const P     = panel.data();
+        const auto kernel = panelKernels[K];
+
+#if eckit_HAVE_OMP
+#pragma omp parallel for
+#endif
+        for (long j = 0; j < static_cast<long>(Nj); ++j) {
+            for (Size k = 0; k < K; ++k) {
+                P[j * K + k] = B(static_cast<Size>(j), k0 + k);
+            }
+        }
+
+        forEachPart(rows.outer, Ni, [&](Size begin, Size end) { kernel(rows, P, Cp, Ni, k0, begin, end); });
+    }
+}
+
+
+void LinearAlgebraOptimised::dsptd(const Vector& x, const SparseMatrix& A, const Vector& y, SparseMatrix& B) const {
+    const auto Ni = A.rows();
+    const auto Nj = A.cols();
+
+    ASSERT(x.size() == Ni);
+    ASSERT(y.size() == Nj);
+
+    B = A;
+    if (A.empty()) {
+        return;
+    }
+
+    const auto* const outer = B.outerIndex();
+    const auto* const inner = B.inner();
+    auto* const val         = const_cast<Scalar*>(B.data());
+
+    ASSERT(outer[0] == 0);  // expect indices to be 0-based
+
+    forEachPart(outer, Ni, [&](Size begin, Size end) {
+        for (Size i = begin; i < end; ++i) {
+            for (auto k = outer[i]; k < outer[i + 1]; ++k) {
+                const auto j = static_cast<Size>(inner[k]);
+                ASSERT(j < Nj);
+                val[k] *= x[i] * y[j];
+            }
+        }
+    });
+}
+
+}  // namespace eckit::linalg::sparse
@@ -0,0 +1,53 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include "eckit/linalg/LinearAlgebraSparse.h"
+
+namespace eckit::linalg::sparse {
+
+/// Generic sparse backend with optimised kernels:
+/// - rows are shared between threads by number of non-zeros, not by number of rows,
+/// - spmv gathers x with AVX2 or AVX-512 when the processor supports it (chosen at runtime),
+/// - spmm accumulates blocks of columns of skinny right-hand sides in registers.
+///
+/// The instruction set can be capped with linearAlgebraSparseSIMD;$ECKIT_LINEAR_ALGEBRA_SPARSE_SIMD
+/// (none, avx2 or avx512).
+struct LinearAlgebraOptimised final : public LinearAlgebraSparse {
+    enum class SIMD {
+        Auto,
+        None,
+        AVX2,
+        AVX512,
+    };
+
+    explicit LinearAlgebraOptimised(SIMD simd = SIMD::Auto) : simd_(simd) {}
+    LinearAlgebraOptimised(const std::string& name, SIMD simd = SIMD::Auto) :
+        LinearAlgebraSparse(name), simd_(simd) {}
+
+    void spmv(const SparseMatrix&, const Vector&, Vector&) const override;
+    void spmm(const SparseMatrix&, const Matrix&, Matrix&) const override;
+    void dsptd(const Vector&, const SparseMatrix&, const Vector&, SparseMatrix&) const override;
+    void print(std::ostream&) const override;
+
+    /// Instruction set used, never more than the processor supports
+    SIMD simd() const;
+
+    /// Best instruction set supported by the processor
+    static SIMD supported();
+
+private:
+
+    SIMD simd_;
+};
+
+}  // namespace eckit::linalg::sparse
@@ -0,0 +1,230 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "eckit/eckit.h"
+
+#include "eckit/linalg/sparse/LinearAlgebraOptimised.h"
+#include "eckit/linalg/types.h"
+
+#if eckit_HAVE_OMP
+#include <omp.h>
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ECKIT_LINALG_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define ECKIT_LINALG_X86_SIMD 0
+#endif
+
+
+/// Kernels shared by LinearAlgebraOptimised and CompactSparseMatrix, on CSR arrays (outer, inner, val) of any
+/// index and value types. Values and operands are accumulated in double.
+
+namespace eckit::linalg::sparse::detail {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Instruction set of the spmv kernels: linearAlgebraSparseSIMD, capped by the processor (probed once)
+LinearAlgebraOptimised::SIMD simd();
+
+
+/// Columns of skinny right-hand sides accumulated in registers by the spmm kernels
+constexpr Size BLOCK = 8;
+
+
+/// First row of each part, parts holding about the same number of non-zeros (rows [first[t], first[t + 1]))
+template <typename U>
+std::vector<Size> partition(const U* outer, Size rows) {
+#if eckit_HAVE_OMP
+    const auto parts = static_cast<Size>(omp_get_max_threads());
+#else
+    const Size parts = 1;
+#endif
+
+    std::vector<Size> first(parts + 1, rows);
+    first[0] = 0;
+
+    const auto nnz = static_cast<unsigned long long>(outer[rows]);
+    for (Size t = 1; t < parts; ++t) {
+        const auto target = static_cast<U>(nnz * t / parts);
+        first[t]          = static_cast<Size>(std::lower_bound(outer, outer + rows, target) - outer);
+    }
+
+    return first;
+}
+
+
+/// Call kernel(begin, end) on the rows of each part, in parallel
+template <typename U, typename Kernel>
+void forEachPart(const U* outer, Size rows, Kernel kernel) {
+    const auto first = partition(outer, rows);
+    const auto parts = static_cast<long>(first.size() - 1);
+
+#if eckit_HAVE_OMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+    for (long t = 0; t < parts; ++t) {
+        kernel(first[t], first[t + 1]);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename U, typename I, typename V, typename X, typename Y>
+void spmvScalar(const U* outer, const I* inner, const V* val, const X* x, Y* y, Size begin, Size end) {
+    for (Size i = begin; i < end; ++i) {
+        double sum = 0.;
+        for (auto c = outer[i]; c < outer[i + 1]; ++c) {
+            sum += static_cast<double>(val[c]) * static_cast<double>(x[static_cast<Size>(inner[c])]);
+        }
+        y[i] = static_cast<Y>(sum);
+    }
+}
+
+#if ECKIT_LINALG_X86_SIMD
+
+// Values and gathered operands are widened to double in registers, memory traffic stays at their own precision.
+// Gathers take 32-bit column indices.
+
+__attribute__((target("avx2,fma"))) inline __m256d load4(const double* p) {
+    return _mm256_loadu_pd(p);
+}
+
+__attribute__((target("avx2,fma"))) inline __m256d load4(const float* p) {
+    return _mm256_cvtps_pd(_mm_loadu_ps(p));
+}
+
+__attribute__((target("avx2,fma"))) inline __m256d gather4(const double* x, __m128i j) {
+    return _mm256_i32gather_pd(x, j, 8);
+}
+
+__attribute__((target("avx2,fma"))) inline __m256d gather4(const float* x, __m128i j) {
+    return _mm256_cvtps_pd(_mm_i32gather_ps(x, j, 4));
+}
+
+template <typename U, typename I, typename V, typename X, typename Y>
+__attribute__((target("avx2,fma"))) void spmvAVX2(const U* outer, const I* inner, const V* val, const X* x, Y* y,
+                                                  Size begin, Size end) {
+    static_assert(sizeof(I) == sizeof(std::int32_t), "spmvAVX2: 32-bit column indices");
+
+    for (Size i = begin; i < end; ++i) {
+        auto c       = outer[i];
+        const auto e = outer[i + 1];
+
+        __m256d acc = _mm256_setzero_pd();
+        for (; c + 4 <= e; c += 4) {
+            const __m128i j = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inner + c));
+            acc             = _mm256_fmadd_pd(load4(val + c), gather4(x, j), acc);
+        }
+
+        __m128d s  = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+        double sum = _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+
+        for (; c < e; ++c) {
+            sum += static_cast<double>(val[c]) * static_cast<double>(x[static_cast<Size>(inner[c])]);
+        }
+        y[i] = static_cast<Y>(sum);
+    }
+}
+
+
+__attribute__((target("avx512f"))) inline __m512d load8(const double* p) {
+    return _mm512_loadu_pd(p);
+}
+
+__attribute__((target("avx512f"))) inline __m512d load8(const float* p) {
+    return _mm512_cvtps_pd(_mm256_loadu_ps(p));
+}
+
+__attribute__((target("avx512f"))) inline __m512d load8(const double* p, __mmask8 mask) {
+    return _mm512_maskz_loadu_pd(mask, p);
+}
+
+__attribute__((target("avx512f"))) inline __m512d load8(const float* p, __mmask8 mask) {
+    return _mm512_cvtps_pd(_mm512_castps512_ps256(_mm512_maskz_loadu_ps(mask, p)));
+}
+
+__attribute__((target("avx512f"))) inline __m512d gather8(const double* x, __m256i j) {
+    return _mm512_i32gather_pd(j, x, 8);
+}
+
+__attribute__((target("avx512f"))) inline __m512d gather8(const float* x, __m256i j) {
+    return _mm512_cvtps_pd(_mm256_i32gather_ps(x, j, 4));
+}
+
+__attribute__((target("avx512f"))) inline __m512d gather8(const double* x, __m256i j, __mmask8 mask) {
+    return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, j, x, 8);
+}
+
+__attribute__((target("avx512f"))) inline __m512d gather8(const float* x, __m256i j, __mmask8 mask) {
+    return _mm512_cvtps_pd(_mm512_castps512_ps256(
+        _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, _mm512_zextsi256_si512(j), x, 4)));
+}
+
+template <typename U, typename I, typename V, typename X, typename Y>
+__attribute__((target("avx512f"))) void spmvAVX512(const U* outer, const I* inner, const V* val, const X* x, Y* y,
+                                                   Size begin, Size end) {
+    static_assert(sizeof(I) == sizeof(std::int32_t), "spmvAVX512: 32-bit column indices");
+
+    for (Size i = begin; i < end; ++i) {
+        auto c       = outer[i];
+        const auto e = outer[i + 1];
+
+        __m512d acc = _mm512_setzero_pd();
+        for (; c + 8 <= e; c += 8) {
+            const __m256i j = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inner + c));
+            acc             = _mm512_fmadd_pd(load8(val + c), gather8(x, j), acc);
+        }
+
+        // Rows of interpolation matrices are short: finish with a masked gather rather than a scalar loop
+        if (c < e) {
+            const auto mask = static_cast<__mmask8>((1U << (e - c)) - 1);
+            const __m256i j = _mm512_castsi512_si256(_mm512_maskz_loadu_epi32(mask, inner + c));
+            acc             = _mm512_fmadd_pd(load8(val + c, mask), gather8(x, j, mask), acc);
+        }
+
+        y[i] = static_cast<Y>(_mm512_reduce_add_pd(acc));
+    }
+}
+
+#endif
+
+/// spmv kernel for an instruction set (scalar if the column indices are not 32-bit)
+template <typename U, typename I, typename V, typename X, typename Y>
+auto spmvKernel(LinearAlgebraOptimised::SIMD simd) {
+    auto kernel = spmvScalar<U, I, V, X, Y>;
+#if ECKIT_LINALG_X86_SIMD
+    if constexpr (sizeof(I) == sizeof(std::int32_t)) {
+        switch (simd) {
+            case LinearAlgebraOptimised::SIMD::AVX512:
+                kernel = spmvAVX512<U, I, V, X, Y>;
+                break;
+            case LinearAlgebraOptimised::SIMD::AVX2:
+                kernel = spmvAVX2<U, I, V, X, Y>;
+                break;
+            default:
+                break;
+        }
+    }
+#endif
+    return kernel;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::linalg::sparse::detail
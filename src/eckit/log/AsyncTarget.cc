@@ -0,0 +1,419 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/AsyncTarget.h"
+#include "eckit/os/SignalHandler.h"
+#include "eckit/utils/StringTools.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+constexpr size_t slotSize = 256;
+
+/// A line, or part of a line, in the queue. The lines longer than a slot are stored in consecutive slots.
+struct alignas(64) Slot {
+    std::atomic<uint64_t> sequence;
+    LogTarget* target;
+    uint32_t size;
+    bool flush;
+    char data[slotSize - 24];
+};
+
+static_assert(sizeof(Slot) == slotSize, "Slot should fill a number of cache lines");
+
+
+/// A bounded multiple-producer single-consumer queue of slots. Producers reserve consecutive slots with a CAS on the
+/// head, and publish each slot by setting its sequence (as in a Vyukov queue). The single consumer releases the slots
+/// in order, once written, so that the last slot of a range being free implies that the whole range is, and that the
+/// lines not yet written are still in the queue if the process crashes.
+
+class Queue {
+public:
+
+    static Queue& instance() {
+        // n.b. never deleted, the writer thread being detached (the lines are written at exit)
+        static Queue* queue = new Queue();
+        return *queue;
+    }
+
+    /// Copy a line in the queue, returning false if it is full and @param wait is false. @param last is set to the
+    /// position following the line.
+    bool push(LogTarget* target, const char* start, const char* end, bool flush, bool wait, uint64_t& last) {
+        const size_t length = end - start;
+        const size_t n      = std::max<size_t>(1, (length + payload - 1) / payload);
+        ASSERT(n <= maxSlots());
+
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint64_t seq = slots_[(pos + n - 1) & mask_].sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(seq - (pos + n - 1));
+
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                if (!wait) {
+                    return false;
+                }
+                wakeup(true);
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                pos = head_.load(std::memory_order_relaxed);
+            }
+            else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            Slot& slot        = slots_[(pos + i) & mask_];
+            const size_t size = std::min(payload, length - std::min(length, i * payload));
+
+            slot.target = target;
+            slot.size   = static_cast<uint32_t>(size);
+            slot.flush  = flush && i == n - 1;
+            if (size) {
+                ::memcpy(slot.data, start + i * payload, size);
+            }
+            slot.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+
+        last = pos + n;
+        wakeup(false);
+        return true;
+    }
+
+    /// Wait until the lines before @param position are written and flushed
+    void waitFor(uint64_t position) {
+        while (written_.load(std::memory_order_acquire) < position) {
+            wakeup(true);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    void drain() { waitFor(head_.load(std::memory_order_acquire)); }
+
+    size_t size() const {
+        return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    size_t maxSlots() const { return capacity() / 4; }
+
+    size_t maxBytes() const { return maxSlots() * payload; }
+
+    std::atomic<size_t> dropped{0};
+    size_t sampling;
+
+private:
+
+    static constexpr size_t payload = sizeof(Slot::data);
+
+    Queue() : sampling(std::max<size_t>(1, Resource<size_t>("asyncLogSampling;$ECKIT_ASYNC_LOG_SAMPLING", 10))) {
+        size_t requested = Resource<size_t>("asyncLogCapacity;$ECKIT_ASYNC_LOG_CAPACITY", 16384);
+        size_t capacity  = 16;
+        while (capacity < requested) {
+            capacity *= 2;
+        }
+
+        slots_.reset(new Slot[capacity]);
+        mask_ = capacity - 1;
+
+        reset(0);
+        start();
+
+        std::atexit(atExit);
+        ::pthread_atfork(nullptr, nullptr, afterForkInChild);
+    }
+
+public:
+
+    void writeOnCrash(int fd) {
+        static std::once_flag once;
+        std::call_once(once, [this] { SignalHandler::addCrashHook(crash, this); });
+        crashFd_.store(fd);
+    }
+
+private:
+
+    void reset(uint64_t position) {
+        for (size_t i = 0; i < capacity(); ++i) {
+            slots_[(position + i) & mask_].sequence.store(position + i, std::memory_order_relaxed);
+        }
+        head_.store(position);
+        tail_.store(position);
+        released_.store(position);
+        written_.store(position);
+    }
+
+    void start() {
+        mutex_.reset(new std::mutex);
+        cond_.reset(new std::condition_variable);
+        sleeping_ = false;
+        std::thread([this] { run(); }).detach();
+    }
+
+    void run() {
+        for (;;) {
+            if (!consume()) {
+                std::unique_lock<std::mutex> lock(*mutex_);
+                sleeping_.store(true);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!ready()) {
+                    cond_->wait_for(lock, std::chrono::milliseconds(100));
+                }
+                sleeping_.store(false);
+            }
+        }
+    }
+
+    bool ready() const {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        return slots_[tail & mask_].sequence.load(std::memory_order_acquire) == tail + 1;
+    }
+
+    /// Write the lines ready, batching the consecutive lines of a target
+    bool consume() {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        bool some     = false;
+
+        for (;;) {
+            Slot& slot = slots_[tail & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+                break;
+            }
+
+            if (slot.target != current_ || batch_.size() >= 64 * 1024) {
+                write(tail);
+            }
+
+            current_ = slot.target;
+            batch_.append(slot.data, slot.size);
+            if (slot.flush && std::find(flush_.begin(), flush_.end(), slot.target) == flush_.end()) {
+                flush_.push_back(slot.target);
+            }
+
+            tail_.store(++tail, std::memory_order_release);
+            some = true;
+        }
+
+        write(tail);
+
+        for (LogTarget* target : flush_) {
+            try {
+                target->flush();
+            }
+            catch (...) {
+                // Nowhere to report it
+            }
+        }
+        flush_.clear();
+
+        written_.store(tail, std::memory_order_release);
+        return some;
+    }
+
+    /// Write the batch, and release the slots before @param position
+    void write(uint64_t position) {
+        if (!batch_.empty()) {
+            try {
+                current_->write(batch_.data(), batch_.data() + batch_.size());
+            }
+            catch (...) {
+                // Nowhere to report it
+            }
+            batch_.clear();
+        }
+
+        for (uint64_t r = released_.load(std::memory_order_relaxed); r < position; ++r) {
+            slots_[r & mask_].sequence.store(r + capacity(), std::memory_order_release);
+            released_.store(r + 1, std::memory_order_release);
+        }
+    }
+
+    void wakeup(bool force) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (force || sleeping_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(*mutex_);
+            cond_->notify_one();
+        }
+    }
+
+    static void atExit() { instance().drain(); }
+
+    /// Write the bytes of the lines not yet written to the crash descriptor. As it runs in a signal handler, it only
+    /// reads the slots and calls write(2): no allocation, and no call to the targets (that may hold locks).
+    static void crash(void* data) {
+        Queue& queue = *static_cast<Queue*>(data);
+
+        const int fd = queue.crashFd_.load();
+        if (fd < 0) {
+            return;
+        }
+
+        const uint64_t head = queue.head_.load(std::memory_order_acquire);
+        for (uint64_t pos = queue.released_.load(std::memory_order_acquire); pos < head; ++pos) {
+            const Slot& slot = queue.slots_[pos & queue.mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+                break;  // not published yet, or released meanwhile
+            }
+
+            const char* p = slot.data;
+            size_t left   = slot.size;
+            while (left > 0) {
+                ssize_t n = ::write(fd, p, left);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    return;
+                }
+                p += n;
+                left -= n;
+            }
+        }
+    }
+
+    /// The writer thread is not forked, and the lines queued by the parent are written by the parent
+    static void afterForkInChild() {
+        Queue& queue = instance();
+        queue.current_ = nullptr;
+        queue.batch_.clear();
+        queue.flush_.clear();
+        queue.reset(queue.head_.load());
+        queue.mutex_.release();  // n.b. may be locked by a thread of the parent
+        queue.cond_.release();
+        queue.start();
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+
+    alignas(64) std::atomic<uint64_t> head_;
+    alignas(64) std::atomic<uint64_t> tail_;
+    std::atomic<uint64_t> released_;
+    std::atomic<uint64_t> written_;
+
+    std::unique_ptr<std::mutex> mutex_;
+    std::unique_ptr<std::condition_variable> cond_;
+    std::atomic<bool> sleeping_;
+    std::atomic<int> crashFd_{-1};
+
+    // Used by the writer thread only
+
+    LogTarget* current_ = nullptr;
+    std::string batch_;
+    std::vector<LogTarget*> flush_;
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+AsyncTarget::AsyncTarget(LogTarget* target) : AsyncTarget(target, defaultPolicy()) {}
+
+AsyncTarget::AsyncTarget(LogTarget* target, Policy policy) : target_(target), policy_(policy) {
+    ASSERT(target_);
+    target_->attach();
+    Queue::instance();
+}
+
+AsyncTarget::~AsyncTarget() {
+    Queue::instance().waitFor(last_);
+    target_->detach();
+}
+
+void AsyncTarget::write(const char* start, const char* end) {
+    Queue& queue = Queue::instance();
+
+    if (policy_ == Policy::Sample && queue.size() * 2 >= queue.capacity() && (sample_++ % queue.sampling) != 0) {
+        dropped_++;
+        queue.dropped++;
+        return;
+    }
+
+    uint64_t last = 0;
+    while (start < end) {
+        const char* stop = std::min(end, start + queue.maxBytes());
+        if (!queue.push(target_, start, stop, false, policy_ == Policy::Block, last)) {
+            dropped_++;
+            queue.dropped++;
+            return;
+        }
+        last_  = last;
+        start = stop;
+    }
+}
+
+void AsyncTarget::flush() {
+    uint64_t last = 0;
+    if (Queue::instance().push(target_, nullptr, nullptr, true, policy_ == Policy::Block, last)) {
+        last_ = last;
+    }
+}
+
+void AsyncTarget::drain() {
+    Queue::instance().drain();
+}
+
+void AsyncTarget::writeOnCrash(int fd) {
+    Queue::instance().writeOnCrash(fd);
+}
+
+size_t AsyncTarget::droppedLines() {
+    return Queue::instance().dropped;
+}
+
+AsyncTarget::Policy AsyncTarget::defaultPolicy() {
+    static std::string policy =
+        StringTools::lower(Resource<std::string>("asyncLogPolicy;$ECKIT_ASYNC_LOG_POLICY", "block"));
+
+    if (policy == "block") {
+        return Policy::Block;
+    }
+    if (policy == "drop") {
+        return Policy::Drop;
+    }
+    if (policy == "sample") {
+        return Policy::Sample;
+    }
+    throw UserError("AsyncTarget: unknown policy '" + policy + "', expected block, drop or sample");
+}
+
+void AsyncTarget::print(std::ostream& s) const {
+    s << "AsyncTarget(target=" << *target_ << ", dropped=" << dropped_ << ")";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
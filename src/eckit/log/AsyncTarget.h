@@ -0,0 +1,103 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file AsyncTarget.h
+/// @date Oct 2026
+
+#ifndef eckit_log_AsyncTarget_h
+#define eckit_log_AsyncTarget_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "eckit/log/LogTarget.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Writes to a target in a background thread, so that logging threads do not wait on the target (e.g. on disk I/O
+/// or on the lock of a RotationTarget).
+///
+/// The lines written are copied into a bounded lock-free queue, shared by all the AsyncTargets of the process, and
+/// written in batches by a single background thread. When the queue is full, the policy decides if the threads
+/// logging wait for space (Block), or if their lines are dropped (Drop). With Sample, once the queue is half full
+/// only one in asyncLogSampling lines is kept, and lines are dropped when it is full. The dropped lines are counted.
+///
+/// As the lines are written later, prefixes such as time stamps should be added before: AsyncTarget should wrap the
+/// final target, e.g. new TimeStampTarget("(I)", new AsyncTarget(new RotationTarget())).
+///
+/// The lines queued are written at exit, when the AsyncTarget is deleted, and by drain(). When the process crashes,
+/// they are lost, unless writeOnCrash() was called.
+///
+/// Configuration:
+/// \arg **asyncLogCapacity** (*size_t*): size of the queue in lines of up to 232 bytes (a power of 2)
+/// \arg **asyncLogPolicy** (*string*): block, drop or sample
+/// \arg **asyncLogSampling** (*size_t*): lines kept with the sample policy
+
+class AsyncTarget : public LogTarget {
+public:  // types
+
+    enum class Policy {
+        Block,
+        Drop,
+        Sample,
+    };
+
+public:  // methods
+
+    /// @param target  written by the background thread (n.b. should not be shared with synchronous writers)
+    explicit AsyncTarget(LogTarget* target);
+    AsyncTarget(LogTarget* target, Policy);
+
+    /// Waits until the lines written are written to the target
+    ~AsyncTarget() override;
+
+    void write(const char* start, const char* end) override;
+
+    /// Request the target to be flushed, once the lines before were written (n.b. does not wait)
+    void flush() override;
+
+    size_t dropped() const { return dropped_; }
+
+public:  // class methods
+
+    /// Wait until all the lines queued (by all the AsyncTargets) are written and flushed
+    static void drain();
+
+    /// When the process crashes, write the lines not yet written (by all the AsyncTargets, unformatted) to @param fd,
+    /// e.g. 2 or a file opened beforehand, from the signal handler (see SignalHandler::addCrashHook). -1 disables it.
+    static void writeOnCrash(int fd);
+
+    /// Lines dropped by all the AsyncTargets
+    static size_t droppedLines();
+
+    static Policy defaultPolicy();
+
+protected:  // methods
+
+    void print(std::ostream& s) const override;
+
+private:  // members
+
+    LogTarget* target_;
+    Policy policy_;
+
+    std::atomic<uint64_t> last_{0};
+    std::atomic<size_t> dropped_{0};
+    size_t sample_ = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
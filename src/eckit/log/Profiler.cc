@@ -0,0 +1,519 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/log/Profiler.h"
+
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/JSON.h"
+#include "eckit/log/Statistics.h"
+#include "eckit/system/ResourceUsage.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/StaticMutex.h"
+#include "eckit/utils/Translator.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// A clock read at the cost of rdtsc where available
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+// n.b. read with getenv(), as regions can be profiled before main()
+
+bool configured(const char* name, bool value) {
+    const char* env = ::getenv(name);
+    return env ? Translator<std::string, bool>()(env) : value;
+}
+
+size_t configured(const char* name, size_t value) {
+    const char* env = ::getenv(name);
+    return env ? Translator<std::string, size_t>()(env) : value;
+}
+
+/// A region in the call tree of a thread
+struct Node {
+    size_t region;
+    Node* parent;
+    std::vector<std::unique_ptr<Node>> children;
+
+    uint64_t calls     = 0;
+    uint64_t inclusive = 0;  // ticks
+    uint64_t nested    = 0;  // ticks, in the children
+    double squares     = 0;  // of the inclusive ticks of each call
+    size_t memory      = 0;
+
+    Node(size_t region, Node* parent) : region(region), parent(parent) {}
+
+    Node* child(size_t r) {
+        for (auto& c : children) {
+            if (c->region == r) {
+                return c.get();
+            }
+        }
+        children.emplace_back(new Node(r, this));
+        return children.back().get();
+    }
+
+    void clear() {
+        calls = inclusive = nested = 0;
+        squares                    = 0;
+        memory                     = 0;
+        for (auto& c : children) {
+            c->clear();
+        }
+    }
+
+    void add(const Node& other) {
+        calls += other.calls;
+        inclusive += other.inclusive;
+        nested += other.nested;
+        squares += other.squares;
+        memory += other.memory;
+        for (const auto& c : other.children) {
+            child(c->region)->add(*c);
+        }
+    }
+};
+
+struct Frame {
+    Node* node;
+    uint64_t start;
+    size_t memory;
+    bool traced;
+};
+
+struct Event {
+    uint64_t ticks;
+    uint32_t region;
+    bool begin;
+};
+
+/// The profile of a thread, locked by the thread when recording (uncontended) and when reported
+struct ThreadProfile {
+    size_t id;
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+
+    Node root{size_t(-1), nullptr};
+    Node* current = &root;
+    std::vector<Frame> stack;
+
+    std::vector<Event> events;
+    size_t capacity;
+    size_t lost = 0;
+
+    ThreadProfile(size_t id, size_t capacity) : id(id), capacity(capacity) {
+        stack.reserve(64);
+        events.reserve(capacity);
+    }
+
+    void acquire() {
+        while (lock.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+
+    void release() { lock.clear(std::memory_order_release); }
+};
+
+/// Merged call tree, for the report
+struct Merged {
+    uint64_t calls     = 0;
+    uint64_t inclusive = 0;
+    uint64_t nested    = 0;
+    double squares     = 0;
+    size_t memory      = 0;
+    std::map<std::string, Merged> children;
+};
+
+class Registry {
+public:
+
+    static Registry& instance() {
+        // n.b. never deleted, threads may still be profiled at exit
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    size_t region(const std::string& name) {
+        AutoLock<StaticMutex> lock(mutex_);
+        auto j = regions_.find(name);
+        if (j != regions_.end()) {
+            return j->second;
+        }
+        names_.push_back(name);
+        return regions_[name] = names_.size() - 1;
+    }
+
+    std::string name(size_t region) {
+        AutoLock<StaticMutex> lock(mutex_);
+        return names_.at(region);
+    }
+
+    ThreadProfile& thread() {
+        thread_local ThreadProfile* profile = nullptr;
+        if (!profile) {
+            {
+                AutoLock<StaticMutex> lock(mutex_);
+                threads_.emplace_back(new ThreadProfile(threads_.size(), events_));
+                profile = threads_.back().get();
+            }
+
+            // n.b. a profile retired still records the regions profiled later (e.g. by other thread_local destructors)
+            thread_local Retire retire{profile};
+        }
+        return *profile;
+    }
+
+    /// Call f on the profile of each thread, locked
+    template <typename F>
+    void each(F f) {
+        AutoLock<StaticMutex> lock(mutex_);
+        for (auto& t : threads_) {
+            t->acquire();
+            f(*t);
+            t->release();
+        }
+    }
+
+    /// Call f on the call trees of the threads exited, merged, locked
+    template <typename F>
+    void retired(F f) {
+        AutoLock<StaticMutex> lock(mutex_);
+        f(retired_);
+    }
+
+    /// Seconds per tick, measured since the profiler started
+    double seconds() {
+        using clock = std::chrono::steady_clock;
+
+        // Wait long enough for a precise ratio
+
+        while (clock::now() - start_ < std::chrono::milliseconds(10)) {
+        }
+
+        const uint64_t now   = ticks();
+        const double elapsed = std::chrono::duration<double>(clock::now() - start_).count();
+        return elapsed / double(now - startTicks_);
+    }
+
+    uint64_t startTicks() const { return startTicks_; }
+
+    bool memory() const { return memory_; }
+
+private:
+
+    /// Releases the profile of a thread when it exits, keeping its call tree and the events recorded
+    struct Retire {
+        ThreadProfile* profile;
+
+        ~Retire() { instance().retire(*profile); }
+    };
+
+    void retire(ThreadProfile& t) {
+        AutoLock<StaticMutex> lock(mutex_);
+        t.acquire();
+
+        retired_.add(t.root);
+
+        t.root.children.clear();
+        t.root.clear();
+        t.current = &t.root;
+        std::vector<Frame>().swap(t.stack);
+
+        t.events.shrink_to_fit();
+        t.capacity = t.events.size();
+
+        t.release();
+    }
+
+    Registry() :
+        memory_(configured("ECKIT_PROFILER_MEMORY", false)),
+        events_(configured("ECKIT_PROFILER_EVENTS", size_t(64 * 1024))),
+        start_(std::chrono::steady_clock::now()),
+        startTicks_(ticks()) {
+        if (const char* path = ::getenv("ECKIT_PROFILER_TRACE")) {
+            path_ = path;
+            std::atexit(atExit);
+        }
+    }
+
+    static void atExit() {
+        std::ofstream out(instance().path_.c_str());
+        Profiler::trace(out);
+    }
+
+    StaticMutex mutex_;
+    std::map<std::string, size_t> regions_;
+    std::vector<std::string> names_;
+    std::vector<std::unique_ptr<ThreadProfile>> threads_;
+    Node retired_{size_t(-1), nullptr};
+
+    bool memory_;
+    size_t events_;
+    std::string path_;
+
+    std::chrono::steady_clock::time_point start_;
+    uint64_t startTicks_;
+};
+
+size_t memoryUsage() {
+    return system::ResourceUsage().maxResidentSetSize();
+}
+
+void merge(Merged& merged, const Node& node) {
+    merged.calls += node.calls;
+    merged.inclusive += node.inclusive;
+    merged.nested += node.nested;
+    merged.squares += node.squares;
+    merged.memory += node.memory;
+
+    for (const auto& c : node.children) {
+        merge(merged.children[Registry::instance().name(c->region)], *c);
+    }
+}
+
+/// Whether no call of a region, or of its children, ended (e.g. since a reset)
+bool empty(const Merged& node) {
+    if (node.calls) {
+        return false;
+    }
+    for (const auto& c : node.children) {
+        if (!empty(c.second)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void report(std::ostream& out, const std::string& name, const Merged& node, double seconds, bool memory,
+            const std::string& indent) {
+    out << indent << name << std::endl;
+
+    std::string inner = indent + "  ";
+    Statistics::reportCount(out, "Calls", node.calls, inner.c_str(), true);
+    Statistics::reportTimeStats(out, "Inclusive", node.calls, node.inclusive * seconds,
+                                node.squares * seconds * seconds, inner.c_str());
+    Statistics::reportTime(out, "Exclusive", (node.inclusive - node.nested) * seconds, inner.c_str(), true);
+    if (memory) {
+        Statistics::reportBytes(out, "Memory growth", node.memory, inner.c_str());
+    }
+
+    // Slowest first
+
+    std::vector<const std::pair<const std::string, Merged>*> children;
+    for (const auto& c : node.children) {
+        if (!empty(c.second)) {
+            children.push_back(&c);
+        }
+    }
+    std::sort(children.begin(), children.end(),
+              [](const auto* a, const auto* b) { return a->second.inclusive > b->second.inclusive; });
+
+    for (const auto* c : children) {
+        report(out, c->first, c->second, seconds, memory, inner);
+    }
+}
+
+bool enabledByDefault() {
+    return configured("ECKIT_PROFILER", false);
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+std::atomic<bool> Profiler::enabled_{enabledByDefault()};
+
+void Profiler::enable(bool on) {
+    Registry::instance();
+    enabled_ = on;
+}
+
+size_t Profiler::region(const std::string& name) {
+    return Registry::instance().region(name);
+}
+
+void Profiler::begin(size_t region) {
+    Registry& registry = Registry::instance();
+    ThreadProfile& t   = registry.thread();
+
+    const size_t memory = registry.memory() ? memoryUsage() : 0;
+
+    t.acquire();
+
+    // Trace the entry if there is space left for its exit, and for the exits of the regions open
+
+    const bool traced = t.events.size() + t.stack.size() + 2 <= t.capacity;
+    if (!traced) {
+        t.lost++;
+    }
+
+    t.current = t.current->child(region);
+    t.stack.push_back(Frame{t.current, 0, memory, traced});
+
+    const uint64_t now    = ticks();
+    t.stack.back().start = now;
+    if (traced) {
+        t.events.push_back(Event{now, uint32_t(region), true});
+    }
+
+    t.release();
+}
+
+void Profiler::end() {
+    const uint64_t now = ticks();
+
+    Registry& registry = Registry::instance();
+    ThreadProfile& t   = registry.thread();
+
+    const size_t memory = registry.memory() ? memoryUsage() : 0;
+
+    t.acquire();
+
+    ASSERT(!t.stack.empty());
+    const Frame frame = t.stack.back();
+    t.stack.pop_back();
+
+    const uint64_t elapsed = now - frame.start;
+
+    Node* node = frame.node;
+    node->calls++;
+    node->inclusive += elapsed;
+    node->squares += double(elapsed) * double(elapsed);
+    node->memory += memory > frame.memory ? memory - frame.memory : 0;
+    node->parent->nested += elapsed;
+
+    t.current = node->parent;
+
+    if (frame.traced) {
+        t.events.push_back(Event{now, uint32_t(node->region), false});
+    }
+
+    t.release();
+}
+
+void Profiler::report(std::ostream& out, const char* indent) {
+    Registry& registry = Registry::instance();
+
+    Merged merged;
+    size_t threads = 0;
+    registry.each([&](ThreadProfile& t) {
+        merge(merged, t.root);
+        threads++;
+    });
+    registry.retired([&](const Node& retired) { merge(merged, retired); });
+
+    const double seconds = registry.seconds();
+
+    Statistics::reportCount(out, "Threads profiled", threads, indent, true);
+
+    std::vector<const std::pair<const std::string, Merged>*> children;
+    for (const auto& c : merged.children) {
+        if (!empty(c.second)) {
+            children.push_back(&c);
+        }
+    }
+    std::sort(children.begin(), children.end(),
+              [](const auto* a, const auto* b) { return a->second.inclusive > b->second.inclusive; });
+
+    for (const auto* c : children) {
+        eckit::report(out, c->first, c->second, seconds, registry.memory(), indent);
+    }
+}
+
+void Profiler::trace(std::ostream& out) {
+    Registry& registry = Registry::instance();
+
+    const double micro = registry.seconds() * 1e6;
+    const long pid     = ::getpid();
+
+    JSON json(out);
+    json.startObject();
+    json << "displayTimeUnit" << "ms";
+    json << "traceEvents";
+    json.startList();
+
+    size_t lost = 0;
+    registry.each([&](ThreadProfile& t) {
+        for (const Event& e : t.events) {
+            json.startObject();
+            json << "name" << registry.name(e.region);
+            json << "ph" << (e.begin ? "B" : "E");
+            json << "ts" << double(e.ticks - registry.startTicks()) * micro;
+            json << "pid" << pid;
+            json << "tid" << t.id;
+            json.endObject();
+        }
+
+        // The regions still open are closed at the time of the trace
+
+        const uint64_t now = ticks();
+        for (auto f = t.stack.rbegin(); f != t.stack.rend(); ++f) {
+            if (f->traced) {
+                json.startObject();
+                json << "name" << registry.name(f->node->region);
+                json << "ph" << "E";
+                json << "ts" << double(now - registry.startTicks()) * micro;
+                json << "pid" << pid;
+                json << "tid" << t.id;
+                json.endObject();
+            }
+        }
+
+        lost += t.lost;
+    });
+
+    json.endList();
+    json << "otherData";
+    json.startObject();
+    json << "lostEvents" << lost;
+    json.endObject();
+    json.endObject();
+}
+
+void Profiler::reset() {
+    Registry& registry = Registry::instance();
+    registry.each([](ThreadProfile& t) {
+        t.root.clear();
+        t.events.clear();
+        t.lost = 0;
+        for (auto& f : t.stack) {
+            f.traced = false;
+        }
+    });
+    registry.retired([](Node& retired) { retired.clear(); });
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,127 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   Profiler.h
+/// @date   Oct 2026
+
+#ifndef eckit_log_Profiler_h
+#define eckit_log_Profiler_h
+
+#include <atomic>
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Profiles nested regions of code, per thread, with a clock read at the cost of rdtsc.
+///
+/// Each thread aggregates its regions in a call tree (calls, inclusive and exclusive times, and optionally the growth
+/// of the maximum resident set size), and records the entries and exits of the regions in a preallocated buffer for
+/// the trace (the events not fitting in the buffer are not traced, but still aggregated).
+///
+/// report() prints the call trees of all the threads, merged, and trace() writes the events as Chrome trace-event
+/// JSON (to load in chrome://tracing or Perfetto).
+///
+/// When a thread exits, its call tree is merged into that of the threads exited before, and its buffer is shrunk to
+/// the events recorded.
+///
+/// The profiler is disabled by default, the regions then costing a test.
+///
+/// Configuration:
+/// \arg **$ECKIT_PROFILER** (*bool*): enable the profiler
+/// \arg **$ECKIT_PROFILER_MEMORY** (*bool*): record the growth of the maximum resident set size (a getrusage() per
+///   region)
+/// \arg **$ECKIT_PROFILER_EVENTS** (*size_t*): events traced per thread
+/// \arg **$ECKIT_PROFILER_TRACE** (*path*): where to write the trace at exit
+
+class Profiler {
+public:  // types
+
+    /// Profiles the enclosing scope as a region
+    class Scope {
+    public:
+
+        explicit Scope(size_t region) : active_(enabled()) {
+            if (active_) {
+                begin(region);
+            }
+        }
+
+        explicit Scope(const std::string& name) : active_(enabled()) {
+            if (active_) {
+                begin(region(name));
+            }
+        }
+
+        /// n.b. no string is built unless the profiler is enabled
+        explicit Scope(const char* name) : active_(enabled()) {
+            if (active_) {
+                begin(region(name));
+            }
+        }
+
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope() {
+            if (active_) {
+                end();
+            }
+        }
+
+    private:
+
+        bool active_;
+    };
+
+public:  // methods
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void enable(bool on = true);
+
+    /// The identifier of a region
+    static size_t region(const std::string& name);
+
+    static void begin(size_t region);
+    static void end();
+
+    /// Print the call tree of the regions, merged for all the threads
+    static void report(std::ostream&, const char* indent = "");
+
+    /// Write the events traced as Chrome trace-event JSON
+    static void trace(std::ostream&);
+
+    /// Forget the regions profiled so far (the regions being profiled are still closed)
+    static void reset();
+
+private:  // members
+
+    static std::atomic<bool> enabled_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define ECKIT_PROFILE_CAT_(a, b) a##b
+#define ECKIT_PROFILE_CAT(a, b) ECKIT_PROFILE_CAT_(a, b)
+
+/// Profile the enclosing scope as the region @param name
+#define ECKIT_PROFILE(name)                                                                                   \
+    static const size_t ECKIT_PROFILE_CAT(eckit_profile_region_, __LINE__) = ::eckit::Profiler::region(name); \
+    ::eckit::Profiler::Scope ECKIT_PROFILE_CAT(eckit_profile_scope_, __LINE__)(                               \
+        ECKIT_PROFILE_CAT(eckit_profile_region_, __LINE__))
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
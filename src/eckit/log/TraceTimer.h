@@ -15,6 +15,7 @@
 #define eckit_TraceTimer_h
 
 #include "eckit/log/Log.h"
+#include "eckit/log/Profiler.h"
 #include "eckit/log/Timer.h"
 
 //-----------------------------------------------------------------------------
@@ -27,9 +28,14 @@ template <class T>
 class TraceTimer : public Timer {
 public:
 
-    explicit TraceTimer(const char* name) : Timer(name, eckit::Log::debug<T>()) {}
+    explicit TraceTimer(const char* name) : Timer(name, eckit::Log::debug<T>()), scope_(name) {}
 
-    explicit TraceTimer(const std::string& name) : Timer(name, eckit::Log::debug<T>()) {}
+    explicit TraceTimer(const std::string& name) : Timer(name, eckit::Log::debug<T>()), scope_(name) {}
+
+private:
+
+    /// n.b. the timers are also regions of the Profiler, when enabled
+    Profiler::Scope scope_;
 };
 
 //-----------------------------------------------------------------------------
@@ -9,14 +9,29 @@
  */
 
 
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <vector>
+
 #include "eckit/net/NetService.h"
 #include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
 #include "eckit/io/Select.h"
 #include "eckit/log/Log.h"
 #include "eckit/net/NetUser.h"
+#include "eckit/net/Reactor.h"
 #include "eckit/runtime/Monitor.h"
 #include "eckit/runtime/ProcessControler.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Mutex.h"
 #include "eckit/thread/ThreadControler.h"
+#include "eckit/thread/WorkStealingPool.h"
 
 namespace eckit::net {
 
@@ -57,6 +72,11 @@ void NetService::run() {
     Monitor::instance().name(name());
     Monitor::instance().kind(name());
 
+    if (runInReactor()) {
+        runReactor();
+        return;
+    }
+
     std::ostringstream oss;
     oss << "Waiting on port " << port();
 
@@ -85,6 +105,162 @@ void NetService::run() {
     }
 }
 
+void NetService::runReactor() {
+
+    // The connections waiting for a request, closed if idle for too long
+
+    struct Parked {
+        std::shared_ptr<NetUser> user;
+        int fd;
+        time_t deadline;
+    };
+
+    Mutex mutex;
+    std::map<NetUser*, Parked> parked;
+
+    const long idle = idleTimeout();
+
+    // n.b. the reactor is stopped before the pool completes the connections being served
+
+    WorkStealingPool pool(name(), Resource<size_t>(name() + "NetServiceReactorWorkers", 8));
+    Reactor reactor(name(), Resource<size_t>(name() + "NetServiceReactorThreads", 1));
+
+    int listen = server_.socket();
+
+    // The connections handed to the pool stop waiting for their request after a while, so that stalled clients
+    // cannot hold on to all the workers
+
+    timeval wait{static_cast<time_t>(readTimeout()), 0};
+
+    auto park = [this, &reactor, &pool, &mutex, &parked, idle, wait] {
+        std::shared_ptr<NetUser> user(newUser(server_));
+        NetUser* key = user.get();
+        int fd       = user->protocol_.socket();
+
+        if (wait.tv_sec > 0) {
+            SYSCALL(::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait)));
+        }
+
+        // Locked until watched, so that the callback finds the connection parked
+
+        AutoLock<Mutex> lock(mutex);
+        parked[key] = Parked{user, fd, idle > 0 ? ::time(nullptr) + idle : 0};
+
+        reactor.add(fd, [user, key, fd, &reactor, &pool, &mutex, &parked] {
+            {
+                AutoLock<Mutex> lock(mutex);
+                if (parked.erase(key) == 0) {
+                    return;  // closed for being idle
+                }
+            }
+
+            reactor.remove(fd);
+            pool.submit([user] {
+                try {
+                    user->run();
+                }
+                catch (std::exception& e) {
+                    Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+                    Log::error() << "** Exception is ignored" << std::endl;
+                }
+            });
+        });
+    };
+
+    // The listening socket is always rearmed, or the service would stop accepting connections. After a failed
+    // accept (e.g. out of descriptors) it is rearmed by the loop below, rather than called back again at once
+
+    std::atomic<bool> retry{false};
+
+    reactor.add(listen, [this, &reactor, &retry, park, listen] {
+        bool failed = false;
+        for (;;) {
+            try {
+                if (!server_.tryAccept()) {
+                    break;
+                }
+            }
+            catch (std::exception& e) {
+                Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+                Log::error() << "** Exception is ignored" << std::endl;
+                failed = true;
+                break;
+            }
+
+            try {
+                park();
+            }
+            catch (std::exception& e) {
+                Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+                Log::error() << "** Exception is ignored" << std::endl;
+            }
+        }
+
+        if (failed) {
+            retry = true;
+        }
+        else {
+            reactor.rearm(listen);
+        }
+    });
+
+    auto closeIdle = [&reactor, &mutex, &parked] {
+        std::vector<Parked> expired;
+        {
+            AutoLock<Mutex> lock(mutex);
+            const time_t now = ::time(nullptr);
+            for (auto j = parked.begin(); j != parked.end();) {
+                if (j->second.deadline && j->second.deadline <= now) {
+                    expired.push_back(j->second);
+                    j = parked.erase(j);
+                }
+                else {
+                    ++j;
+                }
+            }
+        }
+
+        // n.b. the sockets are closed when the last copy of their user is released
+
+        for (const auto& p : expired) {
+            Log::status() << "Closing idle connection from " << p.user->protocol_.remoteHost() << std::endl;
+            reactor.remove(p.fd);
+        }
+    };
+
+    std::ostringstream oss;
+    oss << "Waiting on port " << port() << " (reactor)";
+
+    // This will allow to check stopped() again, to close the idle connections and to accept again
+
+    int timeout = this->timeout() ? this->timeout() * 1000 : -1;
+    timeout     = timeout < 0 ? 1000 : std::min(timeout, 1000);
+
+    while (!stopped()) {
+        Log::status() << oss.str() << std::endl;
+        reactor.poll(timeout);
+
+        if (retry.exchange(false)) {
+            reactor.rearm(listen);
+        }
+
+        if (idle > 0) {
+            closeIdle();
+        }
+    }
+
+    reactor.remove(listen);
+}
+
+bool NetService::runInReactor() const {
+    return Reactor::available() && !runAsProcess() &&
+           Resource<bool>(name() + "NetServiceReactor", preferToRunInReactor());
+}
+
+bool NetService::preferToRunInReactor() const {
+    return false;
+}
+
 bool NetService::runAsProcess() const {
     return Resource<bool>(name() + "NetServiceForkProcess", preferToRunAsProcess());
 }
@@ -97,6 +273,14 @@ long NetService::timeout() const {
     return 0;
 }
 
+long NetService::idleTimeout() const {
+    return Resource<long>(name() + "NetServiceIdleTimeout", 300);
+}
+
+long NetService::readTimeout() const {
+    return Resource<long>(name() + "NetServiceReadTimeout", 60);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 NetServiceProcessControler::NetServiceProcessControler(const std::string& name, NetUser* user, TCPServer& server,
@@ -45,13 +45,26 @@ private:
 
 private:
 
+    /// Waits on the connections with a Reactor, and serves them in a pool of threads
+    void runReactor();
+
     virtual NetUser* newUser(net::TCPSocket&) const = 0;
     virtual std::string name() const                = 0;
 
     virtual bool preferToRunAsProcess() const;
     virtual bool runAsProcess() const;
 
+    /// Rather than a thread (or a process) per connection, waiting on their socket until a request is sent
+    virtual bool preferToRunInReactor() const;
+    virtual bool runInReactor() const;
+
     virtual long timeout() const;
+
+    /// Seconds after which a connection waiting in the Reactor without sending a request is closed (0 for never)
+    virtual long idleTimeout() const;
+
+    /// Seconds a connection served from the Reactor may wait for data before it is closed (0 for never)
+    virtual long readTimeout() const;
 };
 
 }  // namespace eckit::net
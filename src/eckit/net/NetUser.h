@@ -39,6 +39,7 @@ private:
     void run() override;
 
     friend class NetServiceProcessControler;
+    friend class NetService;
 };
 
 
@@ -0,0 +1,219 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/net/Reactor.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+
+#include "eckit/eckit.h"
+
+#if eckit_HAVE_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+#include "eckit/runtime/Monitor.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Thread.h"
+#include "eckit/thread/ThreadControler.h"
+
+namespace eckit::net {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+class ReactorThread : public Thread {
+public:
+
+    ReactorThread(Reactor& owner, const std::string& name) : owner_(owner), name_(name) {}
+
+private:
+
+    Reactor& owner_;
+    std::string name_;
+
+    void run() override {
+        Monitor::instance().name(name_);
+        while (owner_.poll(-1)) {
+        }
+    }
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool Reactor::available() {
+    return eckit_HAVE_EPOLL;
+}
+
+#if eckit_HAVE_EPOLL
+
+Reactor::Reactor(const std::string& name, size_t threads) : epoll_(-1), wakeup_(-1), name_(name) {
+    epoll_  = SYSCALL(::epoll_create1(EPOLL_CLOEXEC));
+    wakeup_ = SYSCALL(::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK));
+
+    // Level-triggered, so that once written, the eventfd wakes up all the threads
+
+    epoll_event event{};
+    event.events  = EPOLLIN;
+    event.data.fd = wakeup_;
+    SYSCALL(::epoll_ctl(epoll_, EPOLL_CTL_ADD, wakeup_, &event));
+
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back(new ThreadControler(new ReactorThread(*this, name), false));
+        threads_.back()->start();
+    }
+}
+
+Reactor::~Reactor() {
+    stop();
+
+    for (auto& t : threads_) {
+        t->wait();
+    }
+
+    ::close(wakeup_);
+    ::close(epoll_);
+}
+
+void Reactor::add(int fd, Callback callback) {
+    ASSERT(fd >= 0 && fd != wakeup_);
+
+    {
+        AutoLock<Mutex> lock(mutex_);
+        ASSERT(callbacks_.find(fd) == callbacks_.end());
+        callbacks_[fd] = std::make_shared<Callback>(std::move(callback));
+    }
+
+    epoll_event event{};
+    event.events  = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.fd = fd;
+    SYSCALL(::epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &event));
+}
+
+void Reactor::rearm(int fd) {
+    epoll_event event{};
+    event.events  = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.fd = fd;
+    SYSCALL(::epoll_ctl(epoll_, EPOLL_CTL_MOD, fd, &event));
+}
+
+void Reactor::remove(int fd) {
+    SYSCALL(::epoll_ctl(epoll_, EPOLL_CTL_DEL, fd, nullptr));
+
+    AutoLock<Mutex> lock(mutex_);
+    callbacks_.erase(fd);
+}
+
+bool Reactor::poll(int timeout) {
+    if (stopped_) {
+        return false;
+    }
+
+    epoll_event events[64];
+    int n = ::epoll_wait(epoll_, events, 64, timeout);
+    if (n < 0) {
+        if (errno != EINTR) {
+            throw FailedSystemCall("epoll_wait");
+        }
+        return !stopped_;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const int fd = events[i].data.fd;
+
+        // n.b. the other events of the batch are still processed, as their descriptors are not watched anymore
+
+        if (fd == wakeup_) {
+            continue;
+        }
+
+        // A copy, as the callback may remove its descriptor
+
+        std::shared_ptr<Callback> callback;
+        {
+            AutoLock<Mutex> lock(mutex_);
+            auto j = callbacks_.find(fd);
+            if (j != callbacks_.end()) {
+                callback = j->second;
+            }
+        }
+
+        if (callback) {
+            try {
+                (*callback)();
+            }
+            catch (std::exception& e) {
+                Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+                Log::error() << "** Exception is ignored" << std::endl;
+            }
+        }
+    }
+
+    return !stopped_;
+}
+
+void Reactor::stop() {
+    if (!stopped_.exchange(true)) {
+        wakeup();
+    }
+}
+
+void Reactor::wakeup() {
+    uint64_t one = 1;
+    if (::write(wakeup_, &one, sizeof(one)) != sizeof(one)) {
+        throw FailedSystemCall("write eventfd");
+    }
+}
+
+#else
+
+Reactor::Reactor(const std::string&, size_t) : epoll_(-1), wakeup_(-1) {
+    NOTIMP;
+}
+
+Reactor::~Reactor() {}
+
+void Reactor::add(int, Callback) {
+    NOTIMP;
+}
+
+void Reactor::rearm(int) {
+    NOTIMP;
+}
+
+void Reactor::remove(int) {
+    NOTIMP;
+}
+
+bool Reactor::poll(int) {
+    NOTIMP;
+}
+
+void Reactor::stop() {}
+
+void Reactor::wakeup() {}
+
+#endif
+
+size_t Reactor::size() const {
+    AutoLock<Mutex> lock(mutex_);
+    return callbacks_.size();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::net
@@ -0,0 +1,101 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#ifndef eckit_net_Reactor_h
+#define eckit_net_Reactor_h
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/thread/Mutex.h"
+
+namespace eckit {
+
+class ThreadControler;
+
+namespace net {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Waits on many file descriptors with epoll, and calls back when one of them is ready for reading.
+///
+/// The descriptors are watched one-shot: once its callback was called, a descriptor is not watched again until it
+/// is rearm()'ed, so that a callback is never run by two threads at the same time. The events are processed by a
+/// fixed number of event-loop threads, and by any thread calling poll().
+///
+/// The callbacks should not block: longer work (e.g. serving a connection) is better handed to a thread pool.
+/// Where epoll is not available, available() is false and the constructor throws.
+
+class Reactor {
+public:  // types
+
+    using Callback = std::function<void()>;
+
+public:  // methods
+
+    /// @param[in]  name     of the event-loop threads, on the Monitor
+    /// @param[in]  threads  number of event-loop threads started (poll() can also be called by other threads)
+    Reactor(const std::string& name, size_t threads);
+
+    Reactor(const Reactor&)            = delete;
+    Reactor& operator=(const Reactor&) = delete;
+
+    /// Stops and joins the event-loop threads
+    ~Reactor();
+
+    /// Watch @param fd for reading (n.b. the descriptor is not owned, and should be removed before being closed)
+    void add(int fd, Callback);
+
+    /// Watch again a descriptor, whose callback was called
+    void rearm(int fd);
+
+    void remove(int fd);
+
+    /// Process the events ready within @param timeout milliseconds (-1 to wait until there is one). Returns false
+    /// once the reactor is stopped.
+    bool poll(int timeout);
+
+    /// Wake up and stop the event-loop threads
+    void stop();
+
+    size_t size() const;
+
+    static bool available();
+
+private:  // methods
+
+    void wakeup();
+
+private:  // members
+
+    int epoll_;
+    int wakeup_;
+
+    mutable Mutex mutex_;
+    std::map<int, std::shared_ptr<Callback>> callbacks_;
+
+    std::vector<std::unique_ptr<ThreadControler>> threads_;
+
+    std::string name_;
+    std::atomic<bool> stopped_{false};
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace net
+}  // namespace eckit
+
+#endif
@@ -78,6 +78,48 @@ TCPSocket& TCPServer::accept(const std::string& message, int timeout, bool* conn
         }
     }
 
+    accepted(from);
+
+    if (connected) {
+        *connected = true;
+    }
+
+    return *this;
+}
+
+bool TCPServer::tryAccept() {
+
+    int fd = socket();
+
+    int flags = SYSCALL(fcntl(fd, F_GETFL));
+    if (!(flags & O_NONBLOCK)) {
+        SYSCALL(fcntl(fd, F_SETFL, flags | O_NONBLOCK));
+    }
+
+    sockaddr_in from;
+    socklen_t fromlen = sizeof(from);
+
+    while ((socket_ = ::accept(fd, reinterpret_cast<sockaddr*>(&from), &fromlen)) < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+        }
+        if (errno != EINTR && errno != ECONNABORTED) {
+            throw FailedSystemCall("accept");
+        }
+    }
+
+    // The accepted socket may inherit O_NONBLOCK (not on Linux), but is used for blocking i/o
+
+    flags = SYSCALL(fcntl(socket_, F_GETFL));
+    if (flags & O_NONBLOCK) {
+        SYSCALL(fcntl(socket_, F_SETFL, flags & ~O_NONBLOCK));
+    }
+
+    accepted(from);
+    return true;
+}
+
+void TCPServer::accepted(const sockaddr_in& from) {
     remoteAddr_ = from.sin_addr;
     remoteHost_ = addrToHost(from.sin_addr);
     remotePort_ = ntohs(from.sin_port);
@@ -91,12 +133,6 @@ TCPSocket& TCPServer::accept(const std::string& message, int timeout, bool* conn
     register_ignore_sigpipe();
 
     Log::status() << "Get connection from " << remoteHost() << std::endl;
-
-    if (connected) {
-        *connected = true;
-    }
-
-    return *this;
 }
 
 void TCPServer::close() {
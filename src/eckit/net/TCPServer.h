@@ -39,6 +39,10 @@ public:
     virtual TCPSocket& accept(const std::string& message = "Waiting for connection", int timeout = 0,
                               bool* connected = nullptr);
 
+    /// Accept a pending client without waiting, returning false if there is none. The listening socket is made
+    /// non-blocking (e.g. to be watched by a Reactor), the accepted socket is blocking.
+    bool tryAccept();
+
     void closeExec(bool on) { closeExec_ = on; }
 
     int socket() override;
@@ -64,6 +68,8 @@ private:  // methods
 
     std::string bindingAddress() const override;
 
+    void accepted(const sockaddr_in&);
+
 private:  // members
 
     bool closeExec_;
@@ -10,7 +10,12 @@
 
 
 #include "eckit/os/SignalHandler.h"
+
+#include <atomic>
+
 #include "eckit/log/Log.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/StaticMutex.h"
 
 
 namespace eckit {
@@ -71,4 +76,85 @@ void SignalHandler::checkInterrupt() {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+struct CrashHook {
+    std::atomic<void (*)(void*)> function{nullptr};
+    std::atomic<void*> data{nullptr};
+};
+
+constexpr int crashSignals[] = {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT};
+constexpr size_t maxCrashHooks = 16;
+
+CrashHook crashHooks[maxCrashHooks];
+struct sigaction crashSaved[sizeof(crashSignals) / sizeof(crashSignals[0])];
+volatile sig_atomic_t crashing = 0;
+
+StaticMutex crashMutex;
+bool crashInstalled = false;
+
+}  // namespace
+
+void SignalHandler::addCrashHook(void (*function)(void*), void* data) {
+    AutoLock<StaticMutex> lock(crashMutex);
+
+    if (!crashInstalled) {
+        struct sigaction a;
+        a.sa_flags   = 0;
+        a.sa_handler = crash;
+        sigemptyset(&a.sa_mask);
+
+        for (size_t i = 0; i < sizeof(crashSignals) / sizeof(crashSignals[0]); ++i) {
+            ::sigaction(crashSignals[i], &a, &crashSaved[i]);
+        }
+        crashInstalled = true;
+    }
+
+    for (auto& hook : crashHooks) {
+        if (!hook.function) {
+            hook.data     = data;
+            hook.function = function;
+            return;
+        }
+    }
+
+    throw SeriousBug("SignalHandler: too many crash hooks");
+}
+
+void SignalHandler::removeCrashHook(void (*function)(void*), void* data) {
+    AutoLock<StaticMutex> lock(crashMutex);
+
+    for (auto& hook : crashHooks) {
+        if (hook.function == function && hook.data == data) {
+            hook.function = nullptr;
+            hook.data     = nullptr;
+            return;
+        }
+    }
+}
+
+void SignalHandler::crash(int sig) {
+
+    // Hooks are called once, even if they crash themselves
+
+    if (!crashing) {
+        crashing = 1;
+        for (auto& hook : crashHooks) {
+            if (auto function = hook.function.load()) {
+                function(hook.data.load());
+            }
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(crashSignals) / sizeof(crashSignals[0]); ++i) {
+        if (crashSignals[i] == sig) {
+            ::sigaction(sig, &crashSaved[i], nullptr);
+        }
+    }
+
+    ::raise(sig);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 }  // namespace eckit
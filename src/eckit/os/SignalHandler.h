@@ -49,9 +49,17 @@ public:  // methods
 
     static void checkInterrupt();
 
+    /// Register a function called when the process crashes (SIGSEGV, SIGBUS, SIGILL, SIGFPE or SIGABRT), before
+    /// the signal is raised again with its previous handler. As it runs in the signal handler, the function must be
+    /// async-signal-safe: no allocation, no locks, no streams (e.g. write(2) of data already in memory). At most 16
+    /// functions can be registered.
+    static void addCrashHook(void (*)(void*), void* data = nullptr);
+    static void removeCrashHook(void (*)(void*), void* data = nullptr);
+
 private:  // methods
 
     static void interrupt(int);
+    static void crash(int);
 
 private:  // members
 
@@ -0,0 +1,272 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/runtime/MetricsRegistry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/JSON.h"
+#include "eckit/log/Log.h"
+#include "eckit/runtime/Metrics.h"
+#include "eckit/runtime/Telemetry.h"
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/StaticMutex.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+class Registry {
+public:
+
+    static Registry& instance() {
+        // n.b. never deleted, the metrics may be updated at exit
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    template <typename T>
+    T& get(std::map<std::string, std::unique_ptr<T>>& metrics, const std::string& name) {
+        AutoLock<StaticMutex> lock(mutex_);
+        auto& m = metrics[name];
+        if (!m) {
+            m.reset(new T());
+        }
+        return *m;
+    }
+
+    /// Call f on a copy of the metrics, so that the registry is not locked while writing
+    template <typename T, typename F>
+    void each(const std::map<std::string, std::unique_ptr<T>>& metrics, F f) {
+        std::vector<std::pair<std::string, const T*>> copy;
+        {
+            AutoLock<StaticMutex> lock(mutex_);
+            for (const auto& m : metrics) {
+                copy.emplace_back(m.first, m.second.get());
+            }
+        }
+        for (const auto& m : copy) {
+            f(m.first, *m.second);
+        }
+    }
+
+    std::map<std::string, std::unique_ptr<MetricsRegistry::Counter>> counters;
+    std::map<std::string, std::unique_ptr<MetricsRegistry::Gauge>> gauges;
+    std::map<std::string, std::unique_ptr<MetricsRegistry::Histogram>> histograms;
+
+private:
+
+    Registry() {
+        static long period = Resource<long>("metricsSnapshotPeriod;$ECKIT_METRICS_SNAPSHOT_PERIOD", 0);
+        if (period > 0) {
+            std::thread([] {
+                for (;;) {
+                    std::this_thread::sleep_for(std::chrono::seconds(period));
+
+                    // n.b. an exception escaping the thread would terminate the process
+                    try {
+                        MetricsRegistry::report();
+                    }
+                    catch (std::exception& e) {
+                        Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+                        Log::error() << "** Exception is ignored" << std::endl;
+                    }
+                }
+            }).detach();
+        }
+    }
+
+    StaticMutex mutex_;
+};
+
+class SnapshotReport : public runtime::Report {
+public:
+
+    void json(JSON& j) const override { MetricsRegistry::json(j); }
+};
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint64_t MetricsRegistry::Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& s : shards_) {
+        total += s.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+size_t MetricsRegistry::Counter::shard() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t shard = next.fetch_add(1, std::memory_order_relaxed) % shards;
+    return shard;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t MetricsRegistry::Histogram::bucket(uint64_t v) {
+    if (v < subSize) {
+        return v;
+    }
+    const size_t e = 63 - __builtin_clzll(v);
+    return (e - subBits + 1) * subSize + ((v >> (e - subBits)) & (subSize - 1));
+}
+
+uint64_t MetricsRegistry::Histogram::upper(size_t bucket) {
+    if (bucket < subSize) {
+        return bucket;
+    }
+    const size_t e     = bucket / subSize + subBits - 1;
+    const uint64_t sub = bucket % subSize;
+    const uint64_t low = (subSize + sub) << (e - subBits);
+    return low + ((uint64_t(1) << (e - subBits)) - 1);
+}
+
+void MetricsRegistry::Histogram::record(uint64_t v) {
+    buckets_[bucket(v)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(v, std::memory_order_relaxed);
+
+    uint64_t m = min_.load(std::memory_order_relaxed);
+    while (v < m && !min_.compare_exchange_weak(m, v, std::memory_order_relaxed)) {
+    }
+
+    m = max_.load(std::memory_order_relaxed);
+    while (v > m && !max_.compare_exchange_weak(m, v, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t MetricsRegistry::Histogram::min() const {
+    uint64_t m = min_.load(std::memory_order_relaxed);
+    return m == UINT64_MAX ? 0 : m;
+}
+
+uint64_t MetricsRegistry::Histogram::percentile(double q) const {
+
+    // Count from the buckets, as count_ may be updated concurrently
+
+    uint64_t total = 0;
+    for (const auto& b : buckets_) {
+        total += b.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(q * double(total))));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(upper(i), max());
+        }
+    }
+    return max();
+}
+
+void MetricsRegistry::Histogram::json(JSON& j) const {
+    const uint64_t n = count();
+
+    j.startObject();
+    j << "count" << n;
+    j << "sum" << sum();
+    j << "min" << min();
+    j << "max" << max();
+    j << "mean" << (n ? double(sum()) / double(n) : 0.);
+    j << "p50" << percentile(0.5);
+    j << "p90" << percentile(0.9);
+    j << "p99" << percentile(0.99);
+    j << "p999" << percentile(0.999);
+    j.endObject();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+MetricsRegistry::Counter& MetricsRegistry::counter(const std::string& name) {
+    Registry& r = Registry::instance();
+    return r.get(r.counters, name);
+}
+
+MetricsRegistry::Gauge& MetricsRegistry::gauge(const std::string& name) {
+    Registry& r = Registry::instance();
+    return r.get(r.gauges, name);
+}
+
+MetricsRegistry::Histogram& MetricsRegistry::histogram(const std::string& name) {
+    Registry& r = Registry::instance();
+    return r.get(r.histograms, name);
+}
+
+void MetricsRegistry::json(JSON& j) {
+    Registry& r = Registry::instance();
+
+    j << "counters";
+    j.startObject();
+    r.each(r.counters, [&](const std::string& name, const Counter& c) { j << name << c.value(); });
+    j.endObject();
+
+    j << "gauges";
+    j.startObject();
+    r.each(r.gauges, [&](const std::string& name, const Gauge& g) { j << name << g.value(); });
+    j.endObject();
+
+    j << "histograms";
+    j.startObject();
+    r.each(r.histograms, [&](const std::string& name, const Histogram& h) {
+        j << name;
+        h.json(j);
+    });
+    j.endObject();
+}
+
+void MetricsRegistry::collect() {
+    Registry& r = Registry::instance();
+
+    r.each(r.counters, [](const std::string& name, const Counter& c) {
+        Metrics::set("counters." + name, static_cast<unsigned long long>(c.value()), true);
+    });
+
+    r.each(r.gauges, [](const std::string& name, const Gauge& g) {
+        Metrics::set("gauges." + name, static_cast<long long>(g.value()), true);
+    });
+
+    r.each(r.histograms, [](const std::string& name, const Histogram& h) {
+        const std::string prefix = "histograms." + name + ".";
+        Metrics::set(prefix + "count", static_cast<unsigned long long>(h.count()), true);
+        Metrics::set(prefix + "sum", static_cast<unsigned long long>(h.sum()), true);
+        Metrics::set(prefix + "min", static_cast<unsigned long long>(h.min()), true);
+        Metrics::set(prefix + "max", static_cast<unsigned long long>(h.max()), true);
+        Metrics::set(prefix + "p50", static_cast<unsigned long long>(h.percentile(0.5)), true);
+        Metrics::set(prefix + "p90", static_cast<unsigned long long>(h.percentile(0.9)), true);
+        Metrics::set(prefix + "p99", static_cast<unsigned long long>(h.percentile(0.99)), true);
+        Metrics::set(prefix + "p999", static_cast<unsigned long long>(h.percentile(0.999)), true);
+    });
+}
+
+std::string MetricsRegistry::report() {
+    SnapshotReport r;
+    return runtime::Telemetry::report(runtime::Report::METER, r);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
@@ -0,0 +1,176 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @file   MetricsRegistry.h
+/// @date   Oct 2026
+
+#ifndef eckit_runtime_MetricsRegistry_h
+#define eckit_runtime_MetricsRegistry_h
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace eckit {
+
+class JSON;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Counters, gauges and histograms cheap enough to update on hot paths (per I/O operation or per message), unlike
+/// Metrics::set(). They are registered once by name, and the references returned stay valid until exit:
+///
+///     static auto& reads = MetricsRegistry::counter("io.file.reads");
+///     reads.add();
+///
+/// Updates are lock-free. The values are cumulative, and snapshots of all of them are written as JSON, set in the
+/// current Metrics collector (collect()), or sent as a Telemetry METER report (report()), periodically if
+/// metricsSnapshotPeriod is set.
+///
+/// Configuration:
+/// \arg **metricsSnapshotPeriod** (*seconds*): period of the Telemetry reports, none if 0
+
+class MetricsRegistry {
+public:  // types
+
+    /// A monotonic count, sharded so that threads do not contend on a cache line
+    class Counter {
+    public:
+
+        Counter() = default;
+
+        Counter(const Counter&)            = delete;
+        Counter& operator=(const Counter&) = delete;
+
+        void add(uint64_t n = 1) { shards_[shard()].value.fetch_add(n, std::memory_order_relaxed); }
+
+        uint64_t value() const;
+
+    private:
+
+        static constexpr size_t shards = 16;
+
+        struct alignas(64) Shard {
+            std::atomic<uint64_t> value{0};
+        };
+
+        static size_t shard();
+
+        std::array<Shard, shards> shards_;
+    };
+
+    /// A value that goes up and down (e.g. a number of connections)
+    class Gauge {
+    public:
+
+        Gauge() = default;
+
+        Gauge(const Gauge&)            = delete;
+        Gauge& operator=(const Gauge&) = delete;
+
+        void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+        void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+
+        int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+    private:
+
+        std::atomic<int64_t> value_{0};
+    };
+
+    /// Distribution of non-negative values (e.g. latencies in nanoseconds, or sizes in bytes) in log-linear buckets
+    /// as in HdrHistogram: 16 buckets per power of 2, i.e. values recorded to within 1/16 (6.25%)
+    class Histogram {
+    public:
+
+        Histogram() = default;
+
+        Histogram(const Histogram&)            = delete;
+        Histogram& operator=(const Histogram&) = delete;
+
+        void record(uint64_t v);
+
+        uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+        uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+        uint64_t min() const;
+        uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+        /// Upper bound of the bucket of the value at @param q (between 0 and 1), at most max()
+        uint64_t percentile(double q) const;
+
+        void json(JSON&) const;
+
+    private:
+
+        static constexpr size_t subBits = 4;
+        static constexpr size_t subSize = size_t(1) << subBits;
+        static constexpr size_t buckets = (64 - subBits + 1) * subSize;
+
+        static size_t bucket(uint64_t v);
+        static uint64_t upper(size_t bucket);
+
+        std::array<std::atomic<uint64_t>, buckets> buckets_{};
+        std::atomic<uint64_t> count_{0};
+        std::atomic<uint64_t> sum_{0};
+        std::atomic<uint64_t> min_{UINT64_MAX};
+        std::atomic<uint64_t> max_{0};
+
+        friend class MetricsRegistry;
+    };
+
+    /// Records the duration of the enclosing scope, in nanoseconds, in a histogram
+    class Latency {
+    public:
+
+        explicit Latency(Histogram& histogram) : histogram_(histogram), start_(now()) {}
+
+        Latency(const Latency&)            = delete;
+        Latency& operator=(const Latency&) = delete;
+
+        ~Latency() { histogram_.record(now() - start_); }
+
+        static uint64_t now() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+    private:
+
+        Histogram& histogram_;
+        uint64_t start_;
+    };
+
+public:  // methods
+
+    MetricsRegistry() = delete;
+
+    static Counter& counter(const std::string& name);
+    static Gauge& gauge(const std::string& name);
+    static Histogram& histogram(const std::string& name);
+
+    /// Write a snapshot of all the metrics, as {"counters": {...}, "gauges": {...}, "histograms": {...}}
+    static void json(JSON&);
+
+    /// Set a snapshot of all the metrics in the current Metrics collector (see CollectMetrics)
+    static void collect();
+
+    /// Send a snapshot of all the metrics as a Telemetry METER report, returning the message sent (if any)
+    static std::string report();
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
+
+#endif
@@ -0,0 +1,98 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/sql/SQLBlock.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/sql/SQLTable.h"
+
+namespace eckit::sql {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SQLBlock::SQLBlock(const std::vector<ValueLookup*>& values, size_t capacity) :
+    size_(0), capacity_(capacity), interrupted_(false) {
+    ASSERT(capacity_ > 0);
+
+    columns_.reserve(values.size());
+    for (ValueLookup* value : values) {
+        ASSERT(value);
+        columns_.push_back(Column{value, {}, std::vector<char>(capacity_), 0, 0, false, 0});
+    }
+}
+
+SQLBlock::~SQLBlock() {}
+
+const SQLBlock::Column* SQLBlock::column(const ValueLookup& value) const {
+    for (const Column& c : columns_) {
+        if (c.value == &value) {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+void SQLBlock::seek(size_t row) const {
+    ASSERT(row < size_);
+    for (const Column& c : columns_) {
+        c.value->first  = c.data.data() + row * c.width;
+        c.value->second = c.missing[row] != 0;
+    }
+}
+
+void SQLBlock::clear() {
+    size_        = 0;
+    interrupted_ = false;
+}
+
+void SQLBlock::append(const SQLTableIterator& cursor) {
+    ASSERT(size_ < capacity_);
+
+    if (size_ == 0) {
+        const std::vector<size_t> offsets(cursor.columnOffsets());
+        const std::vector<size_t> doublesSizes(cursor.doublesDataSizes());
+        const std::vector<char> hasMissing(cursor.columnsHaveMissing());
+        const std::vector<double> missingValues(cursor.missingValues());
+
+        ASSERT(offsets.size() == columns_.size());
+        for (size_t i = 0; i < columns_.size(); ++i) {
+            Column& c(columns_[i]);
+            c.offset       = offsets[i];
+            c.width        = doublesSizes[i];
+            c.hasMissing   = hasMissing[i];
+            c.missingValue = missingValues[i];
+            if (c.data.size() < capacity_ * c.width) {
+                c.data.resize(capacity_ * c.width);
+            }
+        }
+    }
+
+    const double* data = cursor.data();
+    for (Column& c : columns_) {
+        const double* value = data + c.offset;
+        ::memcpy(c.data.data() + size_ * c.width, value, c.width * sizeof(double));
+
+        // n.b. compare the bit patterns, as SQLColumn::isMissingValue
+        uint64_t v;
+        uint64_t m;
+        ::memcpy(&v, value, sizeof(v));
+        ::memcpy(&m, &c.missingValue, sizeof(m));
+        c.missing[size_] = c.hasMissing && v == m;
+    }
+
+    ++size_;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::sql
@@ -0,0 +1,83 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_sql_SQLBlock_H
+#define eckit_sql_SQLBlock_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace eckit::sql {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class SQLTableIterator;
+
+/// A block of rows of one table, stored column by column, so that expressions can be evaluated for all the rows
+/// at once (see SQLExpression::evalBlock). Expressions evaluating rows one by one position the row values (the
+/// ValueLookups of SQLSelect) on a row of the block with seek().
+
+class SQLBlock {
+public:
+
+    using ValueLookup = std::pair<const double*, bool>;
+
+    struct Column {
+        ValueLookup* value;
+        std::vector<double> data;   // width doubles per row
+        std::vector<char> missing;  // n.b. not std::vector<bool>, to be addressable
+        size_t width;
+        size_t offset;
+        bool hasMissing;
+        double missingValue;
+    };
+
+    /// The columns are identified by the row values they are fetched into (see SQLSelect::column)
+    SQLBlock(const std::vector<ValueLookup*>& values, size_t capacity);
+    ~SQLBlock();
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool full() const { return size_ == capacity_; }
+
+    /// Column fetched into a row value, or nullptr if the value is not fetched in this block
+    const Column* column(const ValueLookup&) const;
+
+    /// Position the row values on a row of the block
+    void seek(size_t row) const;
+
+    void clear();
+
+    /// Append the current row of the iterator (the first row of the block determines the column layout)
+    void append(const SQLTableIterator&);
+
+    /// A block is interrupted when the column metadata changes while it is being filled: its rows are processed
+    /// with the previous metadata, and the row announcing the change starts the next block
+    void interrupt() { interrupted_ = true; }
+    bool interrupted() const { return interrupted_; }
+
+private:
+
+    // No copy allowed
+    SQLBlock(const SQLBlock&);
+    SQLBlock& operator=(const SQLBlock&);
+
+    std::vector<Column> columns_;
+    size_t size_;
+    size_t capacity_;
+    bool interrupted_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::sql
+
+#endif
@@ -9,6 +9,10 @@
  */
 
 #include "eckit/sql/SQLDistinctOutput.h"
+
+#include <algorithm>
+#include <cstring>
+
 #include "eckit/sql/SQLSelect.h"
 #include "eckit/sql/expression/SQLExpressions.h"
 
@@ -53,8 +57,7 @@ bool SQLDistinctOutput::output(const expression::Expressions& results) {
         // What do we do with missing? Or has it been already evaluated somewhere before and it doesn't matter???...
     }
 
-    if (seen_.find(tmp_) == seen_.end()) {
-        seen_.insert(tmp_);
+    if (seen_.insert(tmp_)) {
         return output_.output(results);
     }
 
@@ -95,6 +98,69 @@ void SQLDistinctOutput::cleanup(SQLSelect& sql) {
     output_.cleanup(sql);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+
+SQLDistinctOutput::RowSet::RowSet() : offsets_(1, 0) {}
+
+bool SQLDistinctOutput::RowSet::insert(const std::vector<double>& row) {
+    uint64_t hash = row.size();
+    for (double d : row) {
+        uint64_t bits;
+        ::memcpy(&bits, &d, sizeof(bits));
+        hash = (hash ^ bits) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 32;
+    }
+
+    // n.b. at most half full
+    if (2 * offsets_.size() > slots_.size()) {
+        grow();
+    }
+
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots_[i];
+        if (slot.row == 0) {
+            data_.insert(data_.end(), row.begin(), row.end());
+            offsets_.push_back(data_.size());
+            slot = Slot{hash, offsets_.size() - 1};
+            return true;
+        }
+        if (slot.hash == hash && equal(slot.row - 1, row)) {
+            return false;
+        }
+    }
+}
+
+void SQLDistinctOutput::RowSet::clear() {
+    data_.clear();
+    offsets_.assign(1, 0);
+    slots_.clear();
+}
+
+bool SQLDistinctOutput::RowSet::equal(size_t row, const std::vector<double>& other) const {
+    const size_t size = offsets_[row + 1] - offsets_[row];
+    return size == other.size() && ::memcmp(data_.data() + offsets_[row], other.data(), size * sizeof(double)) == 0;
+}
+
+void SQLDistinctOutput::RowSet::grow() {
+    std::vector<Slot> slots(std::max<size_t>(64, 2 * slots_.size()), Slot{0, 0});
+    const size_t mask = slots.size() - 1;
+
+    for (const Slot& slot : slots_) {
+        if (slot.row != 0) {
+            size_t i = slot.hash & mask;
+            while (slots[i].row != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+
+    slots_.swap(slots);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 // Direct output functions removed in distinct output
 
 void SQLDistinctOutput::outputReal(double, bool) {
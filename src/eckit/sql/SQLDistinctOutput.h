@@ -16,6 +16,8 @@
 #ifndef eckit_sql_SQLDistinctOutput_H
 #define eckit_sql_SQLDistinctOutput_H
 
+#include <cstdint>
+#include <vector>
 
 #include "eckit/sql/SQLOutput.h"
 
@@ -25,25 +27,31 @@ namespace eckit::sql {
 
 class SQLDistinctOutput : public SQLOutput {
 
-    // Comparator to ensure that all cases are well defined, even if we are representing non-double
-    // data as doubles
-
-    struct DoubleBitwiseLessComparator {
-        bool operator()(const std::vector<double>& lhs, const std::vector<double>& rhs) const {
-            if (lhs.size() != rhs.size()) {
-                return lhs.size() < rhs.size();
-            }
-            for (int i = 0; i < lhs.size(); ++i) {
-                const void* p1          = &lhs[i];
-                const void* p2          = &rhs[i];
-                const uint64_t& punned1 = *reinterpret_cast<const uint64_t*>(p1);
-                const uint64_t& punned2 = *reinterpret_cast<const uint64_t*>(p2);
-                if (punned1 != punned2) {
-                    return punned1 < punned2;
-                }
-            }
-            return false;
-        }
+    // Rows already output, stored one after the other, in an open-addressing hash set. Rows are compared bitwise,
+    // to ensure that all cases are well defined, even if we are representing non-double data as doubles
+
+    class RowSet {
+    public:
+
+        RowSet();
+
+        /// Insert a row, or return false if it is already in the set
+        bool insert(const std::vector<double>&);
+        void clear();
+
+    private:
+
+        struct Slot {
+            uint64_t hash;
+            size_t row;  // index + 1, or 0 if the slot is empty
+        };
+
+        bool equal(size_t row, const std::vector<double>&) const;
+        void grow();
+
+        std::vector<double> data_;
+        std::vector<size_t> offsets_;  // row i is data_[offsets_[i], offsets_[i + 1])
+        std::vector<Slot> slots_;
     };
 
 public:  // methods
@@ -58,7 +66,7 @@ private:  // methods
     // -- Members
 
     SQLOutput& output_;
-    std::set<std::vector<double>, DoubleBitwiseLessComparator> seen_;
+    RowSet seen_;
     std::vector<double> tmp_;
     std::vector<size_t> offsets_;
 
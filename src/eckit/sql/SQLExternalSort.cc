@@ -0,0 +1,240 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/sql/SQLExternalSort.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "eckit/config/LibEcKit.h"
+#include "eckit/exception/Exceptions.h"
+#include "eckit/filesystem/TmpFile.h"
+#include "eckit/io/StdFile.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+
+namespace eckit::sql {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+// Rows are stored (in the arena and in the runs) as a header, the key and the payload
+
+struct Header {
+    uint64_t sequence;
+    uint32_t keySize;
+    uint32_t payloadSize;
+};
+
+Header header(const char* record) {
+    Header h;
+    ::memcpy(&h, record, sizeof(h));
+    return h;
+}
+
+uint64_t prefix(const std::string& key) {
+    uint64_t p = 0;
+    for (size_t i = 0; i < sizeof(p); ++i) {
+        p = (p << 8) | (i < key.size() ? static_cast<unsigned char>(key[i]) : 0);
+    }
+    return p;
+}
+
+bool less(const char* a, const Header& ha, const char* b, const Header& hb) {
+    if (int c = ::memcmp(a, b, std::min(ha.keySize, hb.keySize)); c != 0) {
+        return c < 0;
+    }
+    if (ha.keySize != hb.keySize) {
+        return ha.keySize < hb.keySize;
+    }
+    return ha.sequence < hb.sequence;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A sorted run, spilled to a temporary file
+
+class SQLExternalSort::Run {
+public:
+
+    Run() : path_(false) {}
+
+    void write(const std::vector<char>& arena, const std::vector<Entry>& entries) {
+        AutoStdFile file(path_, "w");
+        for (const Entry& e : entries) {
+            const char* record = arena.data() + e.offset;
+            const Header h     = header(record);
+            const size_t size  = sizeof(h) + h.keySize + h.payloadSize;
+            if (::fwrite(record, 1, size, file) != size) {
+                throw WriteError(path_, Here());
+            }
+        }
+    }
+
+    void open() { file_.reset(new AutoStdFile(path_, "r")); }
+
+    /// Read the next row, or return false at the end of the run
+    bool read() {
+        size_t n = ::fread(&header_, 1, sizeof(header_), *file_);
+        if (n == 0) {
+            file_.reset();
+            return false;
+        }
+
+        key_.resize(header_.keySize);
+        payload_.resize(header_.payloadSize);
+        if (n != sizeof(header_) || ::fread(&key_[0], 1, key_.size(), *file_) != key_.size() ||
+            ::fread(&payload_[0], 1, payload_.size(), *file_) != payload_.size()) {
+            throw ReadError(path_, Here());
+        }
+        return true;
+    }
+
+    /// Order of the heap (the smallest row on top)
+    static bool greater(const Run* a, const Run* b) {
+        return less(b->key_.data(), b->header_, a->key_.data(), a->header_);
+    }
+
+    std::string& payload() { return payload_; }
+
+private:
+
+    TmpFile path_;
+    std::unique_ptr<AutoStdFile> file_;
+
+    Header header_;
+    std::string key_;
+    std::string payload_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SQLExternalSort::SQLExternalSort(size_t budget) : budget_(budget), sequence_(0), position_(0), reading_(false) {}
+
+SQLExternalSort::~SQLExternalSort() {}
+
+void SQLExternalSort::add(const std::string& key, const std::string& payload) {
+    ASSERT(!reading_);
+
+    const Header h{sequence_++, static_cast<uint32_t>(key.size()), static_cast<uint32_t>(payload.size())};
+    ASSERT(h.keySize == key.size() && h.payloadSize == payload.size());
+
+    const size_t offset = arena_.size();
+    arena_.resize(offset + sizeof(h) + key.size() + payload.size());
+
+    char* record = arena_.data() + offset;
+    ::memcpy(record, &h, sizeof(h));
+    ::memcpy(record + sizeof(h), key.data(), key.size());
+    ::memcpy(record + sizeof(h) + key.size(), payload.data(), payload.size());
+
+    entries_.push_back(Entry{prefix(key), offset});
+
+    if (arena_.size() + entries_.size() * sizeof(Entry) > budget_) {
+        spill();
+    }
+}
+
+bool SQLExternalSort::next(std::string& payload) {
+    if (!reading_) {
+        reading_ = true;
+        if (runs_.empty()) {
+            sort();
+        }
+        else {
+            spill();
+            merge();
+        }
+    }
+
+    if (runs_.empty()) {
+        if (position_ == entries_.size()) {
+            return false;
+        }
+
+        const char* record = arena_.data() + entries_[position_++].offset;
+        const Header h     = header(record);
+        payload.assign(record + sizeof(h) + h.keySize, h.payloadSize);
+        return true;
+    }
+
+    if (heap_.empty()) {
+        return false;
+    }
+
+    std::pop_heap(heap_.begin(), heap_.end(), Run::greater);
+    Run* run = heap_.back();
+    payload.swap(run->payload());
+
+    if (run->read()) {
+        std::push_heap(heap_.begin(), heap_.end(), Run::greater);
+    }
+    else {
+        heap_.pop_back();
+    }
+    return true;
+}
+
+void SQLExternalSort::clear() {
+    arena_.clear();
+    entries_.clear();
+    heap_.clear();
+    runs_.clear();
+    sequence_ = 0;
+    position_ = 0;
+    reading_  = false;
+}
+
+void SQLExternalSort::sort() {
+    const char* arena = arena_.data();
+    std::sort(entries_.begin(), entries_.end(), [arena](const Entry& a, const Entry& b) {
+        if (a.prefix != b.prefix) {
+            return a.prefix < b.prefix;
+        }
+        const char* ra = arena + a.offset;
+        const char* rb = arena + b.offset;
+        return less(ra + sizeof(Header), header(ra), rb + sizeof(Header), header(rb));
+    });
+    position_ = 0;
+}
+
+void SQLExternalSort::spill() {
+    if (entries_.empty()) {
+        return;
+    }
+
+    sort();
+
+    Log::debug<LibEcKit>() << "SQLExternalSort: spilling " << entries_.size() << " rows ("
+                           << Bytes(static_cast<double>(arena_.size())) << ")" << std::endl;
+
+    runs_.emplace_back(new Run);
+    runs_.back()->write(arena_, entries_);
+
+    arena_.clear();
+    entries_.clear();
+}
+
+void SQLExternalSort::merge() {
+    heap_.clear();
+    for (auto& run : runs_) {
+        run->open();
+        if (run->read()) {
+            heap_.push_back(run.get());
+        }
+    }
+    std::make_heap(heap_.begin(), heap_.end(), Run::greater);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::sql
@@ -0,0 +1,80 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_sql_SQLExternalSort_H
+#define eckit_sql_SQLExternalSort_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace eckit::sql {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Sorts rows (opaque payloads) by normalised keys, compared bytewise. Rows with equal keys are returned in the
+/// order they were added.
+///
+/// The rows are stored in a contiguous arena, and sorted on the first bytes of their keys (a prefix compared as an
+/// integer) before the whole keys. When the memory budget is exceeded, the sorted rows are spilled as a run to a
+/// temporary file, the runs being merged back (k-way) when the rows are read.
+
+class SQLExternalSort {
+public:
+
+    explicit SQLExternalSort(size_t budget);
+    ~SQLExternalSort();
+
+    void add(const std::string& key, const std::string& payload);
+
+    /// The payload of the next row in order, or false when all the rows were read (n.b. no row can be added once
+    /// reading started, until clear())
+    bool next(std::string& payload);
+
+    void clear();
+
+    size_t runs() const { return runs_.size(); }
+
+private:
+
+    // No copy allowed
+    SQLExternalSort(const SQLExternalSort&);
+    SQLExternalSort& operator=(const SQLExternalSort&);
+
+    struct Entry {
+        uint64_t prefix;
+        size_t offset;
+    };
+
+    class Run;
+
+    void sort();
+    void spill();
+    void merge();
+
+    size_t budget_;
+    uint64_t sequence_;
+
+    std::vector<char> arena_;
+    std::vector<Entry> entries_;
+    size_t position_;
+    bool reading_;
+
+    std::vector<std::unique_ptr<Run>> runs_;
+    std::vector<Run*> heap_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::sql
+
+#endif
@@ -9,7 +9,13 @@
  */
 
 #include "eckit/sql/SQLOrderOutput.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "eckit/config/Resource.h"
 #include "eckit/sql/expression/SQLExpressionEvaluated.h"
+#include "eckit/utils/StringTools.h"
 
 using namespace eckit::sql::expression;
 
@@ -25,8 +31,67 @@ namespace eckit::sql {
 
 //----------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+/// Append a value to a sort key, such that the keys compare bytewise as OrderByExpressions: missing values first,
+/// strings compared once trimmed. The encodings are prefix-free, so that descending values are complemented.
+void encode(std::string& key, const SQLExpression& e, bool ascending) {
+    const size_t start = key.size();
+    bool missing       = false;
+
+    if (e.type()->getKind() == type::SQLType::stringType) {
+        std::string v(StringTools::trim(e.evalAsString(missing), "\t\n\v\f\r "));
+        key.push_back(missing ? 0 : 1);
+        for (char c : v) {
+            key.push_back(c);
+            if (c == 0) {
+                key.push_back('\xff');  // escaped, as 0 0 terminates the string
+            }
+        }
+        key.push_back(0);
+        key.push_back(0);
+    }
+    else {
+        double v = e.eval(missing);
+        key.push_back(missing ? 0 : 1);
+
+        // Order-preserving bits (n.b. -0 == 0)
+        uint64_t bits = 0;
+        if (!missing) {
+            v = v == 0 ? 0 : v;
+            ::memcpy(&bits, &v, sizeof(bits));
+            bits = (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+        }
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            key.push_back(static_cast<char>(bits >> shift));
+        }
+    }
+
+    if (!ascending) {
+        for (size_t i = start; i < key.size(); ++i) {
+            key[i] = ~key[i];
+        }
+    }
+}
+
+bool sameLayout(const Expressions& layout, const Expressions& results) {
+    if (layout.size() != results.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < layout.size(); ++i) {
+        if (layout[i]->type() != results[i]->type() || layout[i]->hasMissingValue() != results[i]->hasMissingValue()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
 SQLOrderOutput::SQLOrderOutput(SQLOutput& output, const std::pair<Expressions, std::vector<bool>>& by) :
-    output_(output), by_(by) {}
+    output_(output), by_(by), sorted_(Resource<size_t>("$ECKIT_SQL_SORT_MEMORY", 256 * 1024 * 1024)) {}
 
 SQLOrderOutput::~SQLOrderOutput() {}
 
@@ -44,6 +109,8 @@ unsigned long long SQLOrderOutput::count() {
 
 void SQLOrderOutput::reset() {
     output_.reset();
+    sorted_.clear();
+    layouts_.clear();
 }
 
 void SQLOrderOutput::flush() {
@@ -52,49 +119,65 @@ void SQLOrderOutput::flush() {
 
 bool SQLOrderOutput::cachedNext() {
 
-    while (true) {
-
-        auto it = sortedResults_.begin();
+    // Given identical sorted keys, the rows are in the order they were appended
 
-        // If there are no more results, we are done
-
-        if (it == sortedResults_.end()) {
-            return false;
-        }
+    Expressions row;
+    while (sorted_.next(row_)) {
+        uint32_t index;
+        ::memcpy(&index, row_.data(), sizeof(index));
+        ASSERT(index < layouts_.size());
 
-        // Given identical sorted keys, we use the order that rows are appended
+        const Expressions& layout(layouts_[index]);
+        size_t offset = sizeof(index);
 
-        std::queue<Expressions>& rows = it->second;
-        ASSERT(rows.size() >= 1);
-        bool success = output_.output(rows.front());
+        row.clear();
+        for (const auto& column : layout) {
+            const size_t n = column->type()->size() / sizeof(double);
+            value_.resize(n);
 
-        // Remove entries that have been output
+            const bool missing = row_[offset++] != 0;
+            ::memcpy(value_.data(), row_.data() + offset, n * sizeof(double));
+            offset += n * sizeof(double);
 
-        rows.pop();
-        if (rows.empty()) {
-            sortedResults_.erase(it);
+            row.push_back(std::make_shared<SQLExpressionEvaluated>(*column, value_.data(), missing));
         }
+        ASSERT(offset == row_.size());
 
-        if (success) {
+        if (output_.output(row)) {
             return true;
         }
     }
+
+    return false;
 }
 
 bool SQLOrderOutput::output(const Expressions& results) {
-    OrderByExpressions byValues(by_.second);
+    key_.clear();
     Expressions& byExpressions(by_.first);
     for (size_t i = 0; i < byExpressions.size(); ++i) {
-        byValues.push_back(
-            std::make_shared<SQLExpressionEvaluated>(byIndices_[i] ? *results[byIndices_[i] - 1] : *byExpressions[i]));
+        encode(key_, byIndices_[i] ? *results[byIndices_[i] - 1] : *byExpressions[i], by_.second[i]);
+    }
+
+    if (layouts_.empty() || !sameLayout(layouts_.back(), results)) {
+        Expressions& layout = layouts_.emplace_back();
+        for (const auto& r : results) {
+            layout.push_back(std::make_shared<SQLExpressionEvaluated>(*r));
+        }
     }
 
-    Expressions resultValues;
-    for (size_t i = 0; i < results.size(); ++i) {
-        resultValues.push_back(std::make_shared<SQLExpressionEvaluated>(*results[i]));
+    const uint32_t index = layouts_.size() - 1;
+    row_.assign(reinterpret_cast<const char*>(&index), sizeof(index));
+
+    for (const auto& r : results) {
+        value_.resize(r->type()->size() / sizeof(double));
+        bool missing = false;
+        r->eval(value_.data(), missing);
+
+        row_.push_back(missing ? 1 : 0);
+        row_.append(reinterpret_cast<const char*>(value_.data()), value_.size() * sizeof(double));
     }
 
-    sortedResults_[byValues].push(resultValues);
+    sorted_.add(key_, row_);
     return false;
 }
 
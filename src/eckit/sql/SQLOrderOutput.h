@@ -16,10 +16,10 @@
 #ifndef eckit_sql_SQLOrderOutput_H
 #define eckit_sql_SQLOrderOutput_H
 
-#include <queue>
+#include <string>
 
+#include "eckit/sql/SQLExternalSort.h"
 #include "eckit/sql/SQLOutput.h"
-#include "eckit/sql/expression/OrderByExpressions.h"
 #include "eckit/sql/expression/SQLExpressions.h"
 
 namespace eckit::sql {
@@ -41,16 +41,21 @@ private:  // methods
     SQLOutput& output_;
     std::pair<expression::Expressions, std::vector<bool>> by_;
 
-    using SortedResults = std::map<expression::OrderByExpressions, std::queue<Expressions>>;
+    // The rows are sorted on their ORDER BY values, encoded as keys comparable bytewise. The rows themselves are
+    // stored by value, with the types of their columns (a layout, described by evaluated expressions)
 
-    SortedResults sortedResults_;
+    SQLExternalSort sorted_;
+    std::vector<Expressions> layouts_;
     std::vector<size_t> byIndices_;
+    std::string key_;
+    std::string row_;
+    std::vector<double> value_;
 
     // -- Overridden methods
     void reset() override;
     void flush() override;
 
-    /// OrderBy builds a std::map of sorted results. Now we start outputting them.
+    /// OrderBy sorts the results. Now we start outputting them.
     bool cachedNext() override;
 
     bool output(const expression::Expressions&) override;
@@ -0,0 +1,368 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/sql/SQLProgram.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/sql/expression/SQLExpressions.h"
+#include "eckit/sql/expression/function/FunctionAND.h"
+#include "eckit/sql/expression/function/FunctionOR.h"
+
+using namespace eckit::sql::expression;
+
+namespace eckit::sql {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SQLProgram::SQLProgram(const Expressions& checks) {
+    for (const auto& check : checks) {
+        size_t r = compile(*check);
+        emit(Opcode::Check, r, {r});
+    }
+}
+
+SQLProgram::~SQLProgram() {}
+
+bool SQLProgram::eval() {
+
+    // n.b. local copies, as the stores to the missing flags (char) could alias the members
+
+    const Instruction* code = code_.data();
+    const size_t* operands  = operands_.data();
+    double* values          = values_.data();
+    char* missing           = missing_.data();
+    const size_t n          = code_.size();
+    bool m                  = false;
+
+    for (size_t pc = 0; pc < n;) {
+        const Instruction& i = code[pc++];
+        const size_t* a      = i.args;
+        double& result       = values[i.result];
+
+        switch (i.opcode) {
+            case Opcode::Load:
+                result            = *i.lookup->first;
+                missing[i.result] = i.lookup->second;
+                break;
+
+            case Opcode::LoadBits:
+                result            = (static_cast<unsigned long>(*i.lookup->first) & a[0]) >> a[1];
+                missing[i.result] = i.lookup->second;
+                break;
+
+            case Opcode::Eval: {
+                bool missingArgs = m;
+                result           = i.expression->eval(missingArgs);
+                m                = missingArgs;
+                break;
+            }
+
+            case Opcode::Call1:
+                m      = m || missing[a[0]];
+                result = m ? i.value : i.unary(values[a[0]]);
+                break;
+
+            case Opcode::Call2:
+                m      = m || missing[a[0]] || missing[a[1]];
+                result = m ? i.value : i.binary(values[a[0]], values[a[1]]);
+                break;
+
+            case Opcode::Call3:
+                m      = m || missing[a[0]] || missing[a[1]] || missing[a[2]];
+                result = m ? i.value : i.ternary(values[a[0]], values[a[1]], values[a[2]]);
+                break;
+
+            case Opcode::Call4:
+                m      = m || missing[a[0]] || missing[a[1]] || missing[a[2]] || missing[a[3]];
+                result = m ? i.value : i.quaternary(values[a[0]], values[a[1]], values[a[2]], values[a[3]]);
+                break;
+
+            case Opcode::Call5: {
+                const size_t* b = operands + a[0];
+                for (size_t k = 0; k < 5; ++k) {
+                    m = m || missing[b[k]];
+                }
+                result = m ? i.value : i.quinary(values[b[0]], values[b[1]], values[b[2]], values[b[3]], values[b[4]]);
+                break;
+            }
+
+            // The arguments of a multiplication are evaluated with their own missing flags (see MultiplyFunction)
+
+            case Opcode::Save:
+                missing[i.result] = m;
+                m                 = false;
+                break;
+
+            case Opcode::Mark:
+                missing[i.result] = m || missing[a[0]];
+                m                 = false;
+                break;
+
+            case Opcode::Multiply: {
+                const bool m0  = missing[a[1]];
+                const bool m1  = m || missing[a[2]];
+                const double x = values[a[0]];
+                const double y = values[a[2]];
+
+                m = missing[a[3]];
+                if ((x == 0 || y == 0) && !(m0 && m1)) {
+                    result = 0;
+                }
+                else if (m0 || m1) {
+                    m      = true;
+                    result = i.value;
+                }
+                else {
+                    result = x * y;
+                }
+                break;
+            }
+
+            case Opcode::Equal:
+                m      = m || missing[a[0]] || missing[a[1]];
+                result = values[a[0]] == values[a[1]];
+                break;
+
+            case Opcode::In: {
+                const size_t* b = operands + a[0];
+                result          = 0;
+                for (size_t k = 1; k < a[1]; ++k) {
+                    m = m || missing[b[0]];
+                    if (values[b[0]] == values[b[k]]) {
+                        result = 1;
+                        break;
+                    }
+                }
+                break;
+            }
+
+            case Opcode::And:
+                m = m || missing[a[0]];
+                if (values[a[0]] == 0) {
+                    result = 0;
+                    pc     = i.target;
+                }
+                break;
+
+            case Opcode::Or:
+                m = m || missing[a[0]];
+                if (values[a[0]] != 0) {
+                    result = 1;
+                    pc     = i.target;
+                }
+                break;
+
+            case Opcode::Set:
+                result = i.value;
+                break;
+
+            case Opcode::Check:
+                if (m || missing[a[0]] || values[a[0]] == 0) {
+                    return false;
+                }
+                break;
+        }
+    }
+
+    return true;
+}
+
+size_t SQLProgram::compile(const SQLExpression& e) {
+    if (e.isConstant() && e.type()->getKind() != type::SQLType::stringType) {
+        bool missing = false;
+        double value = e.eval(missing);
+        return constant(value, missing);
+    }
+    return e.compile(*this);
+}
+
+size_t SQLProgram::eval(const SQLExpression& e) {
+    size_t r = allocate();
+    emit(Opcode::Eval, r, {}).expression = &e;
+    return r;
+}
+
+size_t SQLProgram::load(const ValueLookup& value) {
+    return load(LoadKey(&value, false, 0, 0));
+}
+
+size_t SQLProgram::load(const ValueLookup& value, unsigned long mask, unsigned long shift) {
+    return load(LoadKey(&value, true, mask, shift));
+}
+
+size_t SQLProgram::load(const LoadKey& key) {
+    auto j = loaded_.find(key);
+    if (j != loaded_.end()) {
+        return j->second;
+    }
+
+    const auto& [value, bits, mask, shift] = key;
+
+    size_t r = allocate();
+    if (bits) {
+        emit(Opcode::LoadBits, r, {mask, shift}).lookup = value;
+    }
+    else {
+        emit(Opcode::Load, r, {}).lookup = value;
+    }
+    return loaded_[key] = r;
+}
+
+size_t SQLProgram::call(Unary fn, double missingValue, const std::vector<size_t>& args) {
+    ASSERT(args.size() == 1);
+    size_t r = allocate();
+    emit(Opcode::Call1, r, args, missingValue).unary = fn;
+    return r;
+}
+
+size_t SQLProgram::call(Binary fn, double missingValue, const std::vector<size_t>& args) {
+    ASSERT(args.size() == 2);
+    size_t r = allocate();
+    emit(Opcode::Call2, r, args, missingValue).binary = fn;
+    return r;
+}
+
+size_t SQLProgram::call(Ternary fn, double missingValue, const std::vector<size_t>& args) {
+    ASSERT(args.size() == 3);
+    size_t r = allocate();
+    emit(Opcode::Call3, r, args, missingValue).ternary = fn;
+    return r;
+}
+
+size_t SQLProgram::call(Quaternary fn, double missingValue, const std::vector<size_t>& args) {
+    ASSERT(args.size() == 4);
+    size_t r = allocate();
+    emit(Opcode::Call4, r, args, missingValue).quaternary = fn;
+    return r;
+}
+
+size_t SQLProgram::call(Quinary fn, double missingValue, const std::vector<size_t>& args) {
+    ASSERT(args.size() == 5);
+    size_t r = allocate();
+    emit(Opcode::Call5, r, {operands_.size(), args.size()}, missingValue).quinary = fn;
+    operands_.insert(operands_.end(), args.begin(), args.end());
+    return r;
+}
+
+size_t SQLProgram::multiply(const SQLExpression& left, const SQLExpression& right, double missingValue) {
+    size_t saved = allocate();
+    emit(Opcode::Save, saved, {});
+
+    size_t x    = compile(left);
+    size_t mark = allocate();
+    emit(Opcode::Mark, mark, {x});
+
+    size_t y = compile(right);
+    size_t r = allocate();
+    emit(Opcode::Multiply, r, {x, mark, y, saved}, missingValue);
+    return r;
+}
+
+size_t SQLProgram::equal(size_t left, size_t right) {
+    size_t r = allocate();
+    emit(Opcode::Equal, r, {left, right});
+    return r;
+}
+
+size_t SQLProgram::in(size_t value, const std::vector<size_t>& list) {
+    for (size_t k : list) {
+        ASSERT(isConstant(k));
+    }
+
+    size_t r = allocate();
+    emit(Opcode::In, r, {operands_.size(), list.size() + 1});
+    operands_.push_back(value);
+    operands_.insert(operands_.end(), list.begin(), list.end());
+    return r;
+}
+
+size_t SQLProgram::logical(const SQLExpression& e, bool conjunction) {
+    size_t r = allocate();
+    emit(Opcode::Set, r, {}, conjunction ? 1 : 0);
+
+    // The operands of nested ANDs (or ORs) jump straight to the end of the whole chain. The columns loaded after
+    // the first jump are not loaded on all the paths, and are loaded again if used after the chain.
+
+    std::vector<size_t> jumps;
+    std::map<LoadKey, size_t> loaded;
+    flatten(e, conjunction, r, jumps, loaded);
+
+    for (size_t j : jumps) {
+        code_[j].target = code_.size();
+    }
+
+    loaded_.swap(loaded);
+    return r;
+}
+
+void SQLProgram::flatten(const SQLExpression& e, bool conjunction, size_t result, std::vector<size_t>& jumps,
+                         std::map<LoadKey, size_t>& loaded) {
+    const function::FunctionExpression* f =
+        conjunction ? static_cast<const function::FunctionExpression*>(dynamic_cast<const function::FunctionAND*>(&e))
+                    : static_cast<const function::FunctionExpression*>(dynamic_cast<const function::FunctionOR*>(&e));
+
+    if (f && !f->isConstant()) {
+        for (const auto& arg : f->args()) {
+            flatten(*arg, conjunction, result, jumps, loaded);
+        }
+        return;
+    }
+
+    size_t r = compile(e);
+    emit(conjunction ? Opcode::And : Opcode::Or, result, {r});
+    if (jumps.empty()) {
+        loaded = loaded_;
+    }
+    jumps.push_back(code_.size() - 1);
+}
+
+bool SQLProgram::isConstant(size_t reg) const {
+    ASSERT(reg < constants_.size());
+    return constants_[reg];
+}
+
+size_t SQLProgram::allocate() {
+    values_.push_back(0);
+    missing_.push_back(false);
+    constants_.push_back(false);
+    return values_.size() - 1;
+}
+
+size_t SQLProgram::constant(double value, bool missing) {
+    size_t r      = allocate();
+    values_[r]    = value;
+    missing_[r]   = missing;
+    constants_[r] = !missing;
+    return r;
+}
+
+SQLProgram::Instruction& SQLProgram::emit(Opcode opcode, size_t result, const std::vector<size_t>& operands,
+                                          double value) {
+    ASSERT(operands.size() <= 4);
+
+    Instruction i;
+    i.opcode     = opcode;
+    i.result     = result;
+    i.value      = value;
+    i.expression = nullptr;
+
+    std::fill(std::begin(i.args), std::end(i.args), 0);
+    std::copy(operands.begin(), operands.end(), i.args);
+
+    code_.push_back(i);
+    return code_.back();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::sql
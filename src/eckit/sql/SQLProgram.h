@@ -0,0 +1,147 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#ifndef eckit_sql_SQLProgram_H
+#define eckit_sql_SQLProgram_H
+
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace eckit::sql {
+
+namespace expression {
+class Expressions;
+class SQLExpression;
+}  // namespace expression
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// The validation conditions of a table (see SelectOneTable::check_), lowered into a flat list of instructions on
+/// registers, evaluated for each row without walking the expression trees.
+///
+/// Expressions lower themselves with SQLExpression::compile(). The program folds the constant expressions, loads
+/// each column once per row (where first used, whichever expressions use it next), and fuses chains of AND/OR into
+/// conditional jumps. As with eval(), a single missing flag is accumulated while evaluating: the registers of the
+/// columns and constants carry their own missing flag, added to it when they are used. Expressions that are not
+/// lowered are evaluated by the program with eval().
+
+class SQLProgram {
+public:
+
+    using ValueLookup = std::pair<const double*, bool>;
+
+    using Unary      = double (*)(double);
+    using Binary     = double (*)(double, double);
+    using Ternary    = double (*)(double, double, double);
+    using Quaternary = double (*)(double, double, double, double);
+    using Quinary    = double (*)(double, double, double, double, double);
+
+    explicit SQLProgram(const expression::Expressions& checks);
+    ~SQLProgram();
+
+    /// If the current row validates all the conditions (as SQLSelect::processNextTableRow)
+    bool eval();
+
+    size_t size() const { return code_.size(); }
+
+    // For SQLExpression::compile(), returning the register of the value
+
+    size_t compile(const expression::SQLExpression&);
+    size_t eval(const expression::SQLExpression&);
+    size_t load(const ValueLookup&);
+    size_t load(const ValueLookup&, unsigned long mask, unsigned long shift);
+
+    size_t call(Unary, double missingValue, const std::vector<size_t>& args);
+    size_t call(Binary, double missingValue, const std::vector<size_t>& args);
+    size_t call(Ternary, double missingValue, const std::vector<size_t>& args);
+    size_t call(Quaternary, double missingValue, const std::vector<size_t>& args);
+    size_t call(Quinary, double missingValue, const std::vector<size_t>& args);
+
+    size_t multiply(const expression::SQLExpression&, const expression::SQLExpression&, double missingValue);
+    size_t equal(size_t, size_t);
+    size_t in(size_t value, const std::vector<size_t>& list);
+    size_t logical(const expression::SQLExpression&, bool conjunction);
+
+    /// If the register holds a constant, which is not missing
+    bool isConstant(size_t reg) const;
+
+private:
+
+    // No copy allowed
+    SQLProgram(const SQLProgram&);
+    SQLProgram& operator=(const SQLProgram&);
+
+    enum class Opcode : unsigned char {
+        Load,
+        LoadBits,
+        Eval,
+        Call1,
+        Call2,
+        Call3,
+        Call4,
+        Call5,
+        Save,
+        Mark,
+        Multiply,
+        Equal,
+        In,
+        And,
+        Or,
+        Set,
+        Check,
+    };
+
+    /// The registers of the operands are stored in the instruction, or for In and Call5 in operands_ (args[0] being
+    /// the first, args[1] their number). LoadBits stores the mask and the shift in args.
+
+    struct Instruction {
+        Opcode opcode;
+        size_t result;
+        size_t args[4];
+        double value;  // missing value of the functions, initial value of Set
+        union {
+            const ValueLookup* lookup;
+            const expression::SQLExpression* expression;
+            Unary unary;
+            Binary binary;
+            Ternary ternary;
+            Quaternary quaternary;
+            Quinary quinary;
+            size_t target;  // of the jumps
+        };
+    };
+
+    using LoadKey = std::tuple<const ValueLookup*, bool, unsigned long, unsigned long>;
+
+    size_t allocate();
+    size_t load(const LoadKey&);
+    size_t constant(double value, bool missing);
+    Instruction& emit(Opcode, size_t result, const std::vector<size_t>& operands, double value = 0);
+    void flatten(const expression::SQLExpression&, bool conjunction, size_t result, std::vector<size_t>& jumps,
+                 std::map<LoadKey, size_t>& loaded);
+
+    std::vector<Instruction> code_;
+    std::vector<size_t> operands_;
+
+    std::vector<double> values_;
+    std::vector<char> missing_;  // n.b. not std::vector<bool>, to be addressable
+    std::vector<char> constants_;
+
+    std::map<LoadKey, size_t> loaded_;  // columns loaded on all the paths reaching the current instruction
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::sql
+
+#endif
@@ -11,19 +11,26 @@
 #include "eckit/sql/SQLSelect.h"
 
 #include <algorithm>
+#include <exception>
+#include <functional>
 
 #include "eckit/config/LibEcKit.h"
+#include "eckit/config/Resource.h"
 #include "eckit/log/BigNum.h"
 #include "eckit/log/Log.h"
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/SQLColumn.h"
 #include "eckit/sql/SQLDatabase.h"
 #include "eckit/sql/SQLOutput.h"
+#include "eckit/sql/SQLProgram.h"
 #include "eckit/sql/SQLTable.h"
 #include "eckit/sql/expression/ColumnExpression.h"
 #include "eckit/sql/expression/ConstantExpression.h"
 #include "eckit/sql/expression/OrderByExpressions.h"
 #include "eckit/sql/expression/SQLExpressionEvaluated.h"
 #include "eckit/sql/expression/SQLExpressions.h"
+#include "eckit/sql/expression/function/FunctionExpression.h"
+#include "eckit/thread/WorkStealingPool.h"
 
 namespace eckit::sql {
 
@@ -45,7 +52,16 @@ SQLSelect::SQLSelect(const Expressions& columns, const std::vector<std::referenc
     skips_(0),
     aggregate_(false),
     mixedAggregatedAndScalar_(false),
-    doOutputCached_(false) {
+    doOutputCached_(false),
+    block_(nullptr),
+    filling_(nullptr),
+    current_(0),
+    batch_(0),
+    blockRow_(0),
+    blockStart_(0),
+    aggregateBlocks_(false),
+    groupBlocks_(false),
+    compile_(false) {
     // TODO: Convert tables_, allTables_ to use references rather than pointers.
     for (const SQLTable& t : tables) {
         tables_.push_back(&t);
@@ -182,8 +198,14 @@ void SQLSelect::prepareExecute() {
         // n.b. tablePair.first is only const to enable other functions to be const. But
         //      it belongs to this structure, and we are a non-const fn, so this is ok.
         SQLTable* sqlTable = const_cast<SQLTable*>(tablePair.first);
-        cursors_.emplace_back(tbl.table_->iterator(
-            tbl.fetch_, [this, sqlTable](SQLTableIterator& cursor) { refreshCursorMetadata(sqlTable, cursor); }));
+        cursors_.emplace_back(tbl.table_->iterator(tbl.fetch_, [this, sqlTable](SQLTableIterator& cursor) {
+            if (filling_ && (batch_ > 0 || filling_->size() > 0)) {
+                // The rows already in the batch are processed first (see fetchBatch)
+                filling_->interrupt();
+                return;
+            }
+            refreshCursorMetadata(sqlTable, cursor);
+        }));
         cursors_.back()->rewind();
 
         refreshCursorMetadata(sqlTable, *cursors_.back());
@@ -414,6 +436,92 @@ void SQLSelect::prepareExecute() {
             Log::debug<LibEcKit>() << "    QUICK CHECK " << *((*k)->check_[i]) << std::endl;
         }
     }
+
+    programs_.resize(sortedTables_.size());
+    compile_ = Resource<bool>("$ECKIT_SQL_COMPILE", true);
+
+    // Batched execution, for a single table (and expressions that can be evaluated a block of rows at a time)
+
+    size_t blockSize = Resource<size_t>("$ECKIT_SQL_BLOCK_SIZE", 1024);
+    size_t threads   = Resource<size_t>("$ECKIT_SQL_THREADS", 1);
+    if (blockSize > 0 && cursors_.size() == 1 && sortedTables_.size() == 1) {
+        auto batchable = [](const Expressions& e) {
+            return std::all_of(e.begin(), e.end(), [](const auto& x) { return x->isBatchable(); });
+        };
+
+        auto vectorised = [](const Expressions& e) {
+            return std::all_of(e.begin(), e.end(), [](const auto& x) { return x->isVectorised(); });
+        };
+
+        auto numeric = [](const Expressions& e) {
+            return std::all_of(e.begin(), e.end(), [](const auto& x) {
+                return x->type()->size() == sizeof(double) && x->type()->getKind() != type::SQLType::stringType;
+            });
+        };
+
+        // Aggregates of one vectorised argument, accumulated separately by each thread
+        auto mergeable = [](const Expressions& e) {
+            return std::all_of(e.begin(), e.end(), [](const auto& x) {
+                auto* f = dynamic_cast<function::FunctionExpression*>(x.get());
+                return x->isMergeable() && f && f->args().size() == 1 && f->args()[0]->isVectorised();
+            });
+        };
+
+        SelectOneTable& tbl(*sortedTables_.front());
+        if (batchable(tbl.check_)) {
+            aggregateBlocks_ = aggregate_ && !mixedAggregatedAndScalar_ && batchable(select_);
+
+            bool parallel = threads > 1 && vectorised(tbl.check_);
+            if (parallel && aggregateBlocks_) {
+                parallel = mergeable(select_);
+            }
+            else if (parallel && mixedAggregatedAndScalar_) {
+                groupBlocks_ = vectorised(nonAggregated_) && numeric(nonAggregated_) && mergeable(aggregated_);
+                parallel     = groupBlocks_;
+            }
+            else if (parallel && aggregate_) {
+                parallel = false;
+            }
+
+            if (!parallel) {
+                threads = 1;
+            }
+
+            blocks_.resize(threads);
+            selections_.resize(threads);
+            for (auto& block : blocks_) {
+                block.reset(new SQLBlock(tbl.values_, blockSize));
+            }
+            block_ = blocks_.front().get();
+
+            partials_.assign(1, select_);
+
+            if (threads > 1) {
+                // n.b. the calling thread processes the first block of each batch
+                pool_.reset(new WorkStealingPool("sql", threads - 1));
+
+                if (aggregateBlocks_) {
+                    for (size_t i = 1; i < threads; ++i) {
+                        Expressions& partial = partials_.emplace_back();
+                        for (const auto& e : select_) {
+                            partial.emplace_back(e->clone());
+                        }
+                    }
+                }
+
+                if (groupBlocks_) {
+                    groups_.resize(threads);
+                    for (const auto& e : aggregated_) {
+                        aggregatedArgs_.push_back(dynamic_cast<function::FunctionExpression&>(*e).args()[0]);
+                    }
+                }
+            }
+
+            Log::debug<LibEcKit>() << "SQLSelect:prepareExecute: blocks of " << blockSize << " rows"
+                                   << (aggregateBlocks_ ? " (aggregated)" : groupBlocks_ ? " (grouped)" : "")
+                                   << (threads > 1 ? ", " + std::to_string(threads) + " threads" : "") << std::endl;
+        }
+    }
 }
 
 unsigned long long SQLSelect::execute() {
@@ -486,6 +594,11 @@ void SQLSelect::refreshCursorMetadata(SQLTable* table, SQLTableIterator& cursor)
     }
 
     output_.updateTypes(*this);
+
+    // The programs depend on the column types (e.g. the masks of the bitfields)
+    for (auto& program : programs_) {
+        program.reset();
+    }
 }
 
 void SQLSelect::reset() {
@@ -511,6 +624,24 @@ void SQLSelect::reset() {
     output_.reset();
     cursors_.clear();
     count_ = 0;
+
+    pool_.reset();
+    blocks_.clear();
+    selections_.clear();
+    block_           = nullptr;
+    filling_         = nullptr;
+    current_         = 0;
+    batch_           = 0;
+    blockRow_        = 0;
+    blockStart_      = 0;
+    aggregateBlocks_ = false;
+    groupBlocks_     = false;
+    partials_.clear();
+    groups_.clear();
+    aggregatedArgs_.clear();
+
+    programs_.clear();
+    compile_ = false;
 }
 
 
@@ -522,8 +653,9 @@ bool SQLSelect::writeOutput() {
     bool newRow  = false;
     bool missing = false;
     double value;
-    if (!where || (((value = where->eval(missing)) || !value)  // !value for the 'WHERE 0' case, ODB-106
-                   && !missing)) {
+    if (block_ || !where  // rows in blocks are already filtered
+        || (((value = where->eval(missing)) || !value)  // !value for the 'WHERE 0' case, ODB-106
+            && !missing)) {
         if (!aggregate_) {
             newRow = resultsOut();
         }
@@ -583,6 +715,10 @@ bool SQLSelect::processNextTableRow(size_t tableIndex) {
 
     /// For one table, obtain the next row that also validates, or return false if there is not one.
 
+    if (block_) {
+        return processNextBlockRow();
+    }
+
     SelectOneTable& fetchTable(*sortedTables_[tableIndex]);
 
     total_++;
@@ -599,11 +735,22 @@ bool SQLSelect::processNextTableRow(size_t tableIndex) {
 
         bool ok = true;
 
-        for (auto& check : fetchTable.check_) {
-            bool missing = false;
-            if (!check->eval(missing) || missing) {
-                ok = false;
-                break;
+        if (compile_) {
+            std::unique_ptr<SQLProgram>& program(programs_[tableIndex]);
+            if (!program) {
+                program.reset(new SQLProgram(fetchTable.check_));
+                Log::debug<LibEcKit>() << "SQLSelect: conditions of " << fetchTable.table_->fullName()
+                                       << " compiled into " << program->size() << " instructions" << std::endl;
+            }
+            ok = program->eval();
+        }
+        else {
+            for (auto& check : fetchTable.check_) {
+                bool missing = false;
+                if (!check->eval(missing) || missing) {
+                    ok = false;
+                    break;
+                }
             }
         }
 
@@ -622,6 +769,266 @@ bool SQLSelect::processNextTableRow(size_t tableIndex) {
 }
 
 
+bool SQLSelect::processNextBlockRow() {
+
+    /// As processNextTableRow, for the rows of the current block (fetching the next block when exhausted)
+
+    for (;;) {
+        const std::vector<char>& selection(selections_[current_]);
+        for (; blockRow_ < block_->size(); ++blockRow_) {
+            if (selection[blockRow_]) {
+                block_->seek(blockRow_);
+                total_ = blockStart_ + ++blockRow_;
+                return true;
+            }
+        }
+
+        if (!fetchBlock()) {
+            return false;
+        }
+    }
+}
+
+
+bool SQLSelect::fetchBlock() {
+
+    /// Move to the next block of rows of the batch (fetching the next batch when exhausted), or return false if there
+    /// is none
+
+    blockStart_ += block_->size();
+    blockRow_ = 0;
+
+    if (++current_ >= batch_ && !fetchBatch()) {
+        total_ = blockStart_;
+        return false;
+    }
+
+    block_ = blocks_[current_].get();
+    return true;
+}
+
+
+bool SQLSelect::fetchBatch() {
+
+    /// Fetch the next batch of blocks, and filter (and aggregate) them concurrently, or return false if there is none
+
+    SelectOneTable& fetchTable(*sortedTables_.front());
+    SQLTableIterator& cursor(*cursors_.front());
+
+    // A batch ends with the block interrupted by a change of the column metadata, which starts the next batch
+    for (auto& block : blocks_) {
+        if (block->interrupted()) {
+            std::swap(blocks_.front(), block);
+        }
+    }
+
+    if (blocks_.front()->interrupted()) {
+        refreshCursorMetadata(const_cast<SQLTable*>(fetchTable.table_), cursor);
+    }
+
+    current_ = 0;
+    for (batch_ = 0; batch_ < blocks_.size(); ++batch_) {
+        filling_ = blocks_[batch_].get();
+        if (!cursor.nextBlock(*filling_)) {
+            break;
+        }
+        if (filling_->interrupted()) {
+            ++batch_;
+            break;
+        }
+    }
+
+    filling_ = nullptr;
+    block_   = blocks_.front().get();
+
+    if (batch_ == 0) {
+        return false;
+    }
+
+    auto process = [this](size_t i) {
+        filterBlock(i);
+        if (aggregateBlocks_) {
+            aggregateBlock(i);
+        }
+        if (groupBlocks_) {
+            groupBlock(i);
+        }
+    };
+
+    if (pool_ && batch_ > 1) {
+        std::vector<TaskFuture<void>> futures;
+        for (size_t i = 1; i < batch_; ++i) {
+            futures.emplace_back(pool_->submit([&process, i] { process(i); }));
+        }
+
+        // n.b. wait for all the blocks before rethrowing
+        std::exception_ptr error;
+        try {
+            process(0);
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        for (auto& future : futures) {
+            try {
+                future.get();
+            }
+            catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    else {
+        for (size_t i = 0; i < batch_; ++i) {
+            process(i);
+        }
+    }
+
+    for (size_t i = 0; i < batch_; ++i) {
+        skips_ += std::count(selections_[i].begin(), selections_[i].end(), 0);
+    }
+    return true;
+}
+
+
+void SQLSelect::filterBlock(size_t i) {
+
+    /// Evaluate the validation conditions on a block of the batch
+
+    const SQLBlock& block(*blocks_[i]);
+    std::vector<char>& selection(selections_[i]);
+
+    const size_t n = block.size();
+    selection.assign(n, 1);
+
+    std::vector<double> values(n);
+    std::vector<char> missing(n);
+
+    for (auto& check : sortedTables_.front()->check_) {
+        check->evalBlock(block, selection.data(), values.data(), missing.data());
+        for (size_t j = 0; j < n; ++j) {
+            selection[j] = selection[j] && values[j] != 0 && !missing[j];
+        }
+    }
+}
+
+
+void SQLSelect::aggregateBlock(size_t i) {
+
+    /// Accumulate the selected rows of a block of the batch, into the partial results of the thread
+
+    const std::vector<char>& selection(selections_[i]);
+    if (std::find(selection.begin(), selection.end(), 1) == selection.end()) {
+        return;
+    }
+
+    for (auto& e : partials_[i]) {
+        e->partialResultBlock(*blocks_[i], selection.data());
+    }
+}
+
+
+void SQLSelect::groupBlock(size_t i) {
+
+    /// As aggregateBlock, for each set of non-aggregated values (see writeOutput)
+
+    const SQLBlock& block(*blocks_[i]);
+    const char* selection = selections_[i].data();
+
+    const size_t n  = block.size();
+    const size_t nk = nonAggregated_.size();
+    const size_t na = aggregated_.size();
+
+    std::vector<double> values((nk + na) * n);
+    std::vector<char> missing((nk + na) * n);
+
+    for (size_t k = 0; k < nk; ++k) {
+        nonAggregated_[k]->evalBlock(block, selection, &values[k * n], &missing[k * n]);
+    }
+    for (size_t a = 0; a < na; ++a) {
+        aggregatedArgs_[a]->evalBlock(block, selection, &values[(nk + a) * n], &missing[(nk + a) * n]);
+    }
+
+    Groups& groups(groups_[i]);
+    std::vector<double> key(2 * nk);
+
+    for (size_t j = 0; j < n; ++j) {
+        if (!selection[j]) {
+            continue;
+        }
+
+        for (size_t k = 0; k < nk; ++k) {
+            const bool m   = missing[k * n + j];
+            key[2 * k]     = m ? 0 : values[k * n + j];
+            key[2 * k + 1] = m;
+        }
+
+        auto group = groups.find(key);
+        if (group == groups.end()) {
+            group = groups.emplace(key, Expressions()).first;
+            for (const auto& e : aggregated_) {
+                group->second.emplace_back(e->clone());
+            }
+        }
+
+        Expressions& aggregated(group->second);
+        for (size_t a = 0; a < na; ++a) {
+            aggregated[a]->accumulate(values[(nk + a) * n + j], missing[(nk + a) * n + j]);
+        }
+    }
+}
+
+
+void SQLSelect::mergePartialResults() {
+
+    /// Merge the partial results of the threads, at the end of the scan
+
+    for (size_t i = 1; i < partials_.size(); ++i) {
+        for (size_t j = 0; j < select_.size(); ++j) {
+            select_[j]->mergePartialResult(*partials_[i][j]);
+        }
+    }
+    partials_.resize(std::min<size_t>(partials_.size(), 1));
+
+    for (Groups& groups : groups_) {
+        for (const auto& [key, aggregated] : groups) {
+            OrderByExpressions nonAggregatedValues;
+            for (size_t k = 0; k < nonAggregated_.size(); ++k) {
+                const bool missing = key[2 * k + 1] != 0;
+                const double value = missing ? nonAggregated_[k]->missingValue() : key[2 * k];
+                nonAggregatedValues.emplace_back(
+                    std::make_shared<SQLExpressionEvaluated>(*nonAggregated_[k], &value, missing));
+            }
+
+            AggregatedResults::iterator results = aggregatedResults_.find(nonAggregatedValues);
+            if (results == aggregatedResults_.end()) {
+                aggregatedResults_.emplace(nonAggregatedValues, aggregated);
+                continue;
+            }
+
+            for (size_t a = 0; a < aggregated.size(); ++a) {
+                results->second[a]->mergePartialResult(*aggregated[a]);
+            }
+        }
+        groups.clear();
+    }
+}
+
+
+size_t SQLSelect::GroupHash::operator()(const std::vector<double>& key) const {
+    size_t h = 0;
+    for (double v : key) {
+        h ^= std::hash<double>()(v) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+
 bool SQLSelect::processOneRow() {
 
     // n.b. it is acceptable for fromTables.size() == 0, if the expressions
@@ -643,16 +1050,41 @@ bool SQLSelect::processOneRow() {
     // If this is the first retrieve, we need to initialise all tables
 
     if (count_ == 0) {
-        for (size_t idx = 0; idx < cursors_.size(); idx++) {
-            if (!processNextTableRow(idx)) {
+
+        // If only aggregating (or grouping the aggregates in several threads), do so a block at a time (see
+        // fetchBatch), the grouped results are output below
+
+        if (aggregateBlocks_ || groupBlocks_) {
+            bool found = false;
+            while (fetchBlock()) {
+                const std::vector<char>& selection(selections_[current_]);
+                found = found || std::find(selection.begin(), selection.end(), 1) != selection.end();
+            }
+
+            if (!found) {
                 return false;  // If false, there is no data
             }
+
+            mergePartialResults();
+
+            if (aggregateBlocks_) {
+                resultsOut();
+                count_++;
+                return true;
+            }
         }
+        else {
+            for (size_t idx = 0; idx < cursors_.size(); idx++) {
+                if (!processNextTableRow(idx)) {
+                    return false;  // If false, there is no data
+                }
+            }
 
-        if (writeOutput()) {
-            count_++;
-            return true;
-            ;
+            if (writeOutput()) {
+                count_++;
+                return true;
+                ;
+            }
         }
     }
 
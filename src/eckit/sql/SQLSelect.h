@@ -16,6 +16,7 @@
 #define eckit_sql_SQLSelect_H
 
 #include <memory>
+#include <unordered_map>
 
 #include "eckit/filesystem/PathName.h"
 
@@ -26,7 +27,13 @@
 #include "eckit/sql/SelectOneTable.h"
 #include "eckit/sql/expression/OrderByExpressions.h"
 
+namespace eckit {
+class WorkStealingPool;
+}
+
 namespace eckit::sql {
+class SQLBlock;
+class SQLProgram;
 class SQLTableIterator;
 namespace expression::function {
 class FunctionROWNUMBER;
@@ -128,6 +135,36 @@ private:
     std::vector<bool> mixedResultColumnIsAggregated_;
     std::vector<eckit::PathName> outputFiles_;
 
+    // Batched execution (single table), the rows are fetched and filtered a block at a time. With several threads,
+    // a batch of blocks (one per thread) is fetched, then filtered and aggregated concurrently, each thread
+    // accumulating partial results merged at the end of the scan
+
+    struct GroupHash {
+        size_t operator()(const std::vector<double>&) const;
+    };
+    using Groups = std::unordered_map<std::vector<double>, Expressions, GroupHash>;
+
+    std::vector<std::unique_ptr<SQLBlock>> blocks_;
+    std::vector<std::vector<char>> selections_;
+    SQLBlock* block_;    // current block (of the batch)
+    SQLBlock* filling_;  // block being fetched
+    size_t current_;
+    size_t batch_;
+    size_t blockRow_;
+    unsigned long long blockStart_;
+    bool aggregateBlocks_;
+    bool groupBlocks_;
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::vector<Expressions> partials_;  // per thread, the first being select_
+    std::vector<Groups> groups_;         // per thread, aggregated_ for each set of nonAggregated_ values
+    Expressions aggregatedArgs_;
+
+    // Row by row execution, the validation conditions of each table (as sortedTables_) are lowered into programs,
+    // compiled for the first row and again whenever the column metadata changes
+
+    std::vector<std::unique_ptr<SQLProgram>> programs_;
+    bool compile_;
+
     // -- Methods
 
     void reset();
@@ -136,6 +173,13 @@ private:
     std::shared_ptr<SQLExpression> findAliasedExpression(const std::string& alias);
 
     bool processNextTableRow(size_t tableIndex);
+    bool processNextBlockRow();
+    bool fetchBlock();
+    bool fetchBatch();
+    void filterBlock(size_t);
+    void aggregateBlock(size_t);
+    void groupBlock(size_t);
+    void mergePartialResults();
 
     friend class expression::function::FunctionROWNUMBER;  // needs access to count_
     friend class expression::function::FunctionTHIN;       // needs access to count_
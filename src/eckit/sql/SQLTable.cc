@@ -13,12 +13,29 @@
 #include "eckit/config/LibEcKit.h"
 #include "eckit/exception/Exceptions.h"
 #include "eckit/sql/SQLBitColumn.h"
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/SQLColumn.h"
 #include "eckit/sql/SQLDatabase.h"
 #include "eckit/utils/Tokenizer.h"
 
 namespace eckit::sql {
 
+bool SQLTableIterator::nextBlock(SQLBlock& block) {
+    // An interrupted block continues with the row announcing the change of metadata (which is already fetched)
+    bool fetched = block.interrupted();
+    block.clear();
+
+    while (!block.full() && (fetched || next())) {
+        if (block.interrupted()) {
+            break;
+        }
+        fetched = false;
+        block.append(*this);
+    }
+
+    return block.size() > 0;
+}
+
 SQLTable::SQLTable(SQLDatabase& owner, const std::string& path, const std::string& name) :
     path_(path), name_(name), owner_(owner) {
     Log::debug<LibEcKit>() << "new SQLTable[path=" << path_ << ",name=" << name << "]" << std::endl;
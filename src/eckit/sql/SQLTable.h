@@ -27,6 +27,7 @@ namespace eckit::sql {
 //----------------------------------------------------------------------------------------------------------------------
 
 // class SQLFile;
+class SQLBlock;
 class SQLColumn;
 class SQLDatabase;
 
@@ -41,6 +42,10 @@ public:
     virtual std::vector<size_t> doublesDataSizes() const = 0;
     virtual std::vector<char> columnsHaveMissing() const = 0;  // n.b. don't use std::vector<bool> ...
     virtual std::vector<double> missingValues() const    = 0;
+
+    /// Fetch the next rows into the block (up to its capacity), returning false if there are none. The default
+    /// copies the rows one by one, iterators holding columnar data can do better.
+    virtual bool nextBlock(SQLBlock&);
 };
 
 using ColumnNames = std::vector<std::string>;
@@ -14,7 +14,9 @@
 
 #include "eckit/filesystem/PathName.h"
 #include "eckit/os/BackTrace.h"
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/SQLColumn.h"
+#include "eckit/sql/SQLProgram.h"
 #include "eckit/sql/SQLSelect.h"
 #include "eckit/sql/SQLTable.h"
 #include "eckit/sql/expression/ShiftedColumnExpression.h"
@@ -95,6 +97,24 @@ double BitColumnExpression::eval(bool& missing) const {
     return (x & mask_) >> bitShift_;
 }
 
+size_t BitColumnExpression::compile(SQLProgram& program) const {
+    return program.load(*value_, mask_, bitShift_);
+}
+
+void BitColumnExpression::evalBlock(const SQLBlock& block, const char* selection, double* values,
+                                    char* missing) const {
+    if (!block.column(*value_)) {
+        SQLExpression::evalBlock(block, selection, values, missing);
+        return;
+    }
+
+    ColumnExpression::evalBlock(block, selection, values, missing);
+    for (size_t i = 0; i < block.size(); ++i) {
+        unsigned long x = static_cast<unsigned long>(values[i]);
+        values[i]       = (x & mask_) >> bitShift_;
+    }
+}
+
 void BitColumnExpression::expandStars(const std::vector<std::reference_wrapper<const SQLTable>>& tables,
                                       expression::Expressions& e) {
     using namespace eckit;
@@ -53,6 +53,8 @@ protected:
     void eval(double* out, bool& missing) const override { SQLExpression::eval(out, missing); }
 
     double eval(bool& missing) const override;
+    void evalBlock(const SQLBlock&, const char* selection, double* values, char* missing) const override;
+    size_t compile(SQLProgram&) const override;
     virtual void expandStars(const std::vector<std::reference_wrapper<const SQLTable>>&,
                              expression::Expressions&) override;
     const eckit::sql::type::SQLType* type() const override;
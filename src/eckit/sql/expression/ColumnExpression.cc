@@ -13,7 +13,9 @@
 #include <cstring>
 #include <ostream>
 
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/SQLColumn.h"
+#include "eckit/sql/SQLProgram.h"
 #include "eckit/sql/SQLSelect.h"
 #include "eckit/sql/SQLTable.h"
 #include "eckit/sql/expression/ShiftedColumnExpression.h"
@@ -69,6 +71,26 @@ void ColumnExpression::eval(double* out, bool& missing) const {
     ::memcpy(out, value_->first, type_->size());
 }
 
+size_t ColumnExpression::compile(SQLProgram& program) const {
+    return program.load(*value_);
+}
+
+void ColumnExpression::evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+    const SQLBlock::Column* column = block.column(*value_);
+    if (!column) {
+        SQLExpression::evalBlock(block, selection, values, missing);
+        return;
+    }
+
+    // n.b. as eval(), only the first double of (wider) string values
+    const double* data = column->data.data();
+    const size_t width = column->width;
+    for (size_t i = 0; i < block.size(); ++i) {
+        values[i] = data[i * width];
+    }
+    ::memcpy(missing, column->missing.data(), block.size());
+}
+
 std::string ColumnExpression::evalAsString(bool& missing) const {
     if (value_->second) {
         missing = true;
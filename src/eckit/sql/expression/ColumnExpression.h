@@ -66,6 +66,9 @@ protected:
     double eval(bool& missing) const override;
     void eval(double* out, bool& missing) const override;
     std::string evalAsString(bool& missing) const override;
+    void evalBlock(const SQLBlock&, const char* selection, double* values, char* missing) const override;
+    bool isVectorised() const override { return true; }
+    size_t compile(SQLProgram&) const override;
     bool isConstant() const override { return false; }
     void output(SQLOutput& s) const override;
 
@@ -10,8 +10,11 @@
 
 #include "eckit/sql/expression/NumberExpression.h"
 
+#include <algorithm>
 #include <ostream>
 
+#include "eckit/sql/SQLBlock.h"
+
 namespace eckit::sql::expression {
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -38,6 +41,11 @@ double NumberExpression::eval(bool& missing) const {
     return value_;
 }
 
+void NumberExpression::evalBlock(const SQLBlock& block, const char*, double* values, char* missing) const {
+    std::fill_n(values, block.size(), value_);
+    std::fill_n(missing, block.size(), 0);
+}
+
 void NumberExpression::prepare(SQLSelect& sql) {}
 
 void NumberExpression::cleanup(SQLSelect& sql) {}
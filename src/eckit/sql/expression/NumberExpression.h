@@ -48,6 +48,8 @@ private:
     const type::SQLType* type() const override;
     using SQLExpression::eval;
     double eval(bool& missing) const override;
+    void evalBlock(const SQLBlock&, const char* selection, double* values, char* missing) const override;
+    bool isVectorised() const override { return true; }
     bool isConstant() const override { return true; }
     bool isNumber() const override { return true; }
 };
@@ -12,7 +12,9 @@
 
 #include "eckit/config/LibEcKit.h"
 #include "eckit/exception/Exceptions.h"
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/SQLOutput.h"
+#include "eckit/sql/SQLProgram.h"
 #include "eckit/sql/expression/NumberExpression.h"
 #include "eckit/sql/expression/SQLExpressions.h"
 
@@ -34,6 +36,38 @@ void SQLExpression::eval(double* out, bool& missing) const {
     *out = eval(missing);
 }
 
+void SQLExpression::evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+    for (size_t i = 0; i < block.size(); ++i) {
+        if (selection[i]) {
+            block.seek(i);
+            bool m     = false;
+            values[i]  = eval(m);
+            missing[i] = m;
+        }
+    }
+}
+
+void SQLExpression::partialResultBlock(const SQLBlock& block, const char* selection) {
+    for (size_t i = 0; i < block.size(); ++i) {
+        if (selection[i]) {
+            block.seek(i);
+            partialResult();
+        }
+    }
+}
+
+size_t SQLExpression::compile(SQLProgram& program) const {
+    return program.eval(*this);
+}
+
+void SQLExpression::accumulate(double, bool) {
+    NOTIMP;
+}
+
+void SQLExpression::mergePartialResult(const SQLExpression&) {
+    NOTIMP;
+}
+
 std::shared_ptr<SQLExpression> SQLExpression::number(double value) {
     return std::make_shared<NumberExpression>(value);
 }
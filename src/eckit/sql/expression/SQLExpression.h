@@ -23,6 +23,8 @@
 namespace eckit::sql {
 // Forward declarations
 
+class SQLBlock;
+class SQLProgram;
 class SQLSelect;
 class SQLTable;
 class SQLOutput;
@@ -55,6 +57,32 @@ public:
     virtual void eval(double* out, bool& missing) const;
     virtual std::string evalAsString(bool& missing) const;
 
+    // Batched evaluation of the rows of a block: values and missing flags are computed for the selected rows
+    // (selection[i] != 0), and are undefined for the others. By default, the selected rows are evaluated one by
+    // one, expressions can override this to evaluate whole columns at once.
+
+    virtual void evalBlock(const SQLBlock&, const char* selection, double* values, char* missing) const;
+    virtual void partialResultBlock(const SQLBlock&, const char* selection);
+
+    /// If a block of rows can be evaluated before any of its rows is output (not the case for expressions depending
+    /// on the previous rows or on the output)
+    virtual bool isBatchable() const { return true; }
+
+    /// If evalBlock() only reads the block (and does not position the row values on its rows), so that different
+    /// blocks can be evaluated concurrently
+    virtual bool isVectorised() const { return false; }
+
+    /// Lower the expression into a program evaluating rows (see SQLProgram), returning the register of its value. By
+    /// default, the program calls eval().
+    virtual size_t compile(SQLProgram&) const;
+
+    // Aggregates whose partial results can be accumulated separately (e.g. by different threads) and merged. The
+    // argument is then evaluated by the caller, and its values passed to accumulate() (as partialResult() would).
+
+    virtual bool isMergeable() const { return false; }
+    virtual void accumulate(double value, bool missing);
+    virtual void mergePartialResult(const SQLExpression&);
+
     virtual bool andSplit(expression::Expressions&) { return false; }
     virtual void tables(std::set<const SQLTable*>&) {}
 
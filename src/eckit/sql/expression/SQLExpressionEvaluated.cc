@@ -29,6 +29,16 @@ SQLExpressionEvaluated::SQLExpressionEvaluated(SQLExpression& e) :
     hasMissingValue_ = e.hasMissingValue();
 }
 
+SQLExpressionEvaluated::SQLExpressionEvaluated(const SQLExpression& e, const double* value, bool missing) :
+    type_(e.type()), missing_(missing), missingValue_(e.missingValue()) {
+
+    size_t byteSize = type_->size();
+    ASSERT(byteSize % sizeof(double) == 0);
+    value_.assign(value, value + byteSize / sizeof(double));
+
+    hasMissingValue_ = e.hasMissingValue();
+}
+
 SQLExpressionEvaluated::~SQLExpressionEvaluated() {}
 
 void SQLExpressionEvaluated::print(std::ostream& o) const {
@@ -26,6 +26,8 @@ class SQLExpressionEvaluated : public SQLExpression {
 public:
 
     SQLExpressionEvaluated(SQLExpression&);
+    /// A value of the expression (of the size of its type), evaluated already (e.g. for a block of rows)
+    SQLExpressionEvaluated(const SQLExpression&, const double* value, bool missing);
     ~SQLExpressionEvaluated() override;
 
     // Overriden
@@ -69,6 +69,14 @@ protected:
     void cleanup(SQLSelect& sql) override;
     using T::eval;
     double eval(bool& missing) const override;
+
+    // Values depend on the previous rows (evaluated one by one, in order)
+    void evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const override {
+        SQLExpression::evalBlock(block, selection, values, missing);
+    }
+    bool isBatchable() const override { return false; }
+    bool isVectorised() const override { return false; }
+    size_t compile(SQLProgram& program) const override { return SQLExpression::compile(program); }
     void output(SQLOutput& s) const override;
 
 private:
@@ -14,6 +14,10 @@
 #include <cfloat>
 #include <climits>
 #include <cmath>
+#include <vector>
+
+#include "eckit/sql/SQLBlock.h"
+#include "eckit/sql/SQLProgram.h"
 
 namespace eckit::sql::expression::function {
 
@@ -27,6 +31,25 @@ public:
 
     using FunctionExpression::FunctionExpression;
     static int arity() { return ARITY; }
+
+    bool isVectorised() const override { return this->vectorisedArgs(); }
+
+protected:
+
+    /// Evaluate the arguments for a block of rows, missing where any of them is
+    void evalArgs(const SQLBlock& block, const char* selection, std::vector<double> (&args)[ARITY],
+                  char* missing) const {
+        const size_t n = block.size();
+        std::vector<char> m(n);
+
+        for (int a = 0; a < ARITY; ++a) {
+            args[a].resize(n);
+            args_[a]->evalBlock(block, selection, args[a].data(), a == 0 ? missing : m.data());
+            for (size_t i = 0; a > 0 && i < n; ++i) {
+                missing[i] = missing[i] || m[i];
+            }
+        }
+    }
 };
 
 
@@ -44,6 +67,19 @@ class UnaryFunction : public ArityFunction<UnaryFunction<FN>, 1> {
         return FN(a0);
     }
 
+    void evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+        std::vector<double> a[1];
+        this->evalArgs(block, selection, a, missing);
+
+        for (size_t i = 0; i < block.size(); ++i) {
+            values[i] = missing[i] ? this->missingValue_ : FN(a[0][i]);
+        }
+    }
+
+    size_t compile(SQLProgram& program) const {
+        return program.call(FN, this->missingValue_, this->compileArgs(program));
+    }
+
 public:
 
     using ArityFunction<UnaryFunction<FN>, 1>::ArityFunction;
@@ -67,6 +103,19 @@ class BinaryFunction : public ArityFunction<BinaryFunction<FN>, 2> {
         return FN(a0, a1);
     }
 
+    void evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+        std::vector<double> a[2];
+        this->evalArgs(block, selection, a, missing);
+
+        for (size_t i = 0; i < block.size(); ++i) {
+            values[i] = missing[i] ? this->missingValue_ : FN(a[0][i], a[1][i]);
+        }
+    }
+
+    size_t compile(SQLProgram& program) const {
+        return program.call(FN, this->missingValue_, this->compileArgs(program));
+    }
+
 public:
 
     using ArityFunction<BinaryFunction<FN>, 2>::ArityFunction;
@@ -94,6 +143,19 @@ class TertiaryFunction : public ArityFunction<TertiaryFunction<FN>, 3> {
         return FN(a0, a1, a2);
     }
 
+    void evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+        std::vector<double> a[3];
+        this->evalArgs(block, selection, a, missing);
+
+        for (size_t i = 0; i < block.size(); ++i) {
+            values[i] = missing[i] ? this->missingValue_ : FN(a[0][i], a[1][i], a[2][i]);
+        }
+    }
+
+    size_t compile(SQLProgram& program) const {
+        return program.call(FN, this->missingValue_, this->compileArgs(program));
+    }
+
 public:
 
     using ArityFunction<TertiaryFunction<FN>, 3>::ArityFunction;
@@ -125,6 +187,19 @@ class QuaternaryFunction : public ArityFunction<QuaternaryFunction<FN>, 4> {
         return FN(a0, a1, a2, a3);
     }
 
+    void evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+        std::vector<double> a[4];
+        this->evalArgs(block, selection, a, missing);
+
+        for (size_t i = 0; i < block.size(); ++i) {
+            values[i] = missing[i] ? this->missingValue_ : FN(a[0][i], a[1][i], a[2][i], a[3][i]);
+        }
+    }
+
+    size_t compile(SQLProgram& program) const {
+        return program.call(FN, this->missingValue_, this->compileArgs(program));
+    }
+
 public:
 
     using ArityFunction<QuaternaryFunction<FN>, 4>::ArityFunction;
@@ -160,6 +235,19 @@ class QuinaryFunction : public ArityFunction<QuinaryFunction<FN>, 5> {
         return FN(a0, a1, a2, a3, a4);
     }
 
+    void evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+        std::vector<double> a[5];
+        this->evalArgs(block, selection, a, missing);
+
+        for (size_t i = 0; i < block.size(); ++i) {
+            values[i] = missing[i] ? this->missingValue_ : FN(a[0][i], a[1][i], a[2][i], a[3][i], a[4][i]);
+        }
+    }
+
+    size_t compile(SQLProgram& program) const {
+        return program.call(FN, this->missingValue_, this->compileArgs(program));
+    }
+
 public:
 
     using ArityFunction<QuinaryFunction<FN>, 5>::ArityFunction;
@@ -398,6 +486,34 @@ class MultiplyFunction : public ArityFunction<MultiplyFunction, 2> {
         return a0 * a1;
     }
 
+    void evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+        const size_t n = block.size();
+        std::vector<double> a1(n);
+        std::vector<char> m1(n);
+
+        args_[0]->evalBlock(block, selection, values, missing);
+        args_[1]->evalBlock(block, selection, a1.data(), m1.data());
+
+        for (size_t i = 0; i < n; ++i) {
+            const bool m0 = missing[i];
+            if ((values[i] == 0 || a1[i] == 0) && !(m0 && m1[i])) {
+                values[i]  = 0;
+                missing[i] = false;
+            }
+            else if (m0 || m1[i]) {
+                values[i]  = this->missingValue_;
+                missing[i] = true;
+            }
+            else {
+                values[i] *= a1[i];
+            }
+        }
+    }
+
+    size_t compile(SQLProgram& program) const {
+        return program.multiply(*args_[0], *args_[1], this->missingValue_);
+    }
+
 public:
 
     using ArityFunction<MultiplyFunction, 2>::ArityFunction;
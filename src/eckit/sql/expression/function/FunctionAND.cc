@@ -10,6 +10,10 @@
 
 #include "eckit/sql/expression/function/FunctionAND.h"
 
+#include <vector>
+
+#include "eckit/sql/SQLBlock.h"
+#include "eckit/sql/SQLProgram.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 
 namespace eckit::sql::expression::function {
@@ -38,6 +42,31 @@ double FunctionAND::eval(bool& missing) const {
     return args_[0]->eval(missing) && args_[1]->eval(missing);
 }
 
+size_t FunctionAND::compile(SQLProgram& program) const {
+    return program.logical(*this, true);
+}
+
+void FunctionAND::evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+    const size_t n = block.size();
+
+    // As eval(), the second argument is only evaluated where the first one is true
+    args_[0]->evalBlock(block, selection, values, missing);
+
+    std::vector<char> both(n);
+    for (size_t i = 0; i < n; ++i) {
+        both[i] = selection[i] && values[i] != 0;
+    }
+
+    std::vector<double> right(n);
+    std::vector<char> rightMissing(n);
+    args_[1]->evalBlock(block, both.data(), right.data(), rightMissing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        values[i]  = both[i] && right[i] != 0;
+        missing[i] = missing[i] || (both[i] && rightMissing[i]);
+    }
+}
+
 bool FunctionAND::andSplit(expression::Expressions& e) {
     bool ok = false;
 
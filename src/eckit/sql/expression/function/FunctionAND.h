@@ -42,6 +42,9 @@ private:
     const eckit::sql::type::SQLType* type() const override;
     using FunctionExpression::eval;
     double eval(bool& missing) const override;
+    void evalBlock(const SQLBlock&, const char* selection, double* values, char* missing) const override;
+    bool isVectorised() const override { return vectorisedArgs(); }
+    size_t compile(SQLProgram& program) const override;
     std::shared_ptr<SQLExpression> simplify(bool&) override;
     bool andSplit(expression::Expressions&) override;
 
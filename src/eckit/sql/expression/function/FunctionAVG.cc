@@ -10,6 +10,10 @@
 
 #include "eckit/sql/expression/function/FunctionAVG.h"
 
+#include <vector>
+
+
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 
 namespace eckit::sql::expression::function {
@@ -61,11 +65,34 @@ void FunctionAVG::cleanup(SQLSelect& sql) {
 void FunctionAVG::partialResult() {
     bool missing = false;
     double value = args_[0]->eval(missing);
+    accumulate(value, missing);
+}
+
+void FunctionAVG::accumulate(double value, bool missing) {
     if (!missing) {
         value_ += value;
         count_++;
     }
-    //	else cout << "missing" << std::endl;
+}
+
+void FunctionAVG::mergePartialResult(const SQLExpression& other) {
+    const auto& o = dynamic_cast<const FunctionAVG&>(other);
+    value_ += o.value_;
+    count_ += o.count_;
+}
+
+void FunctionAVG::partialResultBlock(const SQLBlock& block, const char* selection) {
+    const size_t n = block.size();
+    std::vector<double> values(n);
+    std::vector<char> missing(n);
+    args_[0]->evalBlock(block, selection, values.data(), missing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        if (selection[i] && !missing[i]) {
+            value_ += values[i];
+            count_++;
+        }
+    }
 }
 
 }  // namespace eckit::sql::expression::function
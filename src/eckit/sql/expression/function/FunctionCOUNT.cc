@@ -10,6 +10,9 @@
 
 #include "eckit/sql/expression/function/FunctionCOUNT.h"
 
+#include <vector>
+
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 
 namespace eckit::sql::expression::function {
@@ -51,11 +54,30 @@ void FunctionCOUNT::cleanup(SQLSelect& sql) {
 
 void FunctionCOUNT::partialResult() {
     bool missing = false;
-    args_[0]->eval(missing);
+    double value = args_[0]->eval(missing);
+    accumulate(value, missing);
+}
+
+void FunctionCOUNT::accumulate(double, bool missing) {
     if (!missing) {
         count_++;
     }
-    // cout << "FunctionCOUNT::partialResult " << count_ << std::endl;
+}
+
+void FunctionCOUNT::mergePartialResult(const SQLExpression& other) {
+    const auto& o = dynamic_cast<const FunctionCOUNT&>(other);
+    count_ += o.count_;
+}
+
+void FunctionCOUNT::partialResultBlock(const SQLBlock& block, const char* selection) {
+    const size_t n = block.size();
+    std::vector<double> values(n);
+    std::vector<char> missing(n);
+    args_[0]->evalBlock(block, selection, values.data(), missing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        count_ += selection[i] && !missing[i];
+    }
 }
 
 }  // namespace eckit::sql::expression::function
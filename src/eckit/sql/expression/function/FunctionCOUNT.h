@@ -42,6 +42,10 @@ private:
     void prepare(SQLSelect&) override;
     void cleanup(SQLSelect&) override;
     void partialResult() override;
+    void partialResultBlock(const SQLBlock&, const char* selection) override;
+    void accumulate(double value, bool missing) override;
+    void mergePartialResult(const SQLExpression&) override;
+    bool isMergeable() const override { return true; }
     using FunctionExpression::eval;
     double eval(bool& missing) const override;
 
@@ -9,6 +9,11 @@
  */
 
 #include "eckit/sql/expression/function/FunctionEQ.h"
+
+#include <vector>
+
+#include "eckit/sql/SQLBlock.h"
+#include "eckit/sql/SQLProgram.h"
 #include "eckit/sql/expression/ColumnExpression.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 #include "eckit/sql/type/SQLType.h"
@@ -78,6 +83,39 @@ double FunctionEQ::eval(bool& missing) const {
     return equal(*args_[0], *args_[1], missing);
 }
 
+void FunctionEQ::evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+    if (args_[0]->type()->getKind() == SQLType::stringType) {
+        FunctionExpression::evalBlock(block, selection, values, missing);
+        return;
+    }
+
+    const size_t n = block.size();
+    std::vector<double> right(n);
+    std::vector<char> rightMissing(n);
+
+    args_[0]->evalBlock(block, selection, values, missing);
+    args_[1]->evalBlock(block, selection, right.data(), rightMissing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        values[i]  = values[i] == right[i];
+        missing[i] = missing[i] || rightMissing[i];
+    }
+}
+
+bool FunctionEQ::isVectorised() const {
+    return args_[0]->type()->getKind() != SQLType::stringType && vectorisedArgs();
+}
+
+size_t FunctionEQ::compile(SQLProgram& program) const {
+    if (args_[0]->type()->getKind() == SQLType::stringType) {
+        return SQLExpression::compile(program);
+    }
+
+    size_t l = program.compile(*args_[0]);
+    size_t r = program.compile(*args_[1]);
+    return program.equal(l, r);
+}
+
 std::shared_ptr<SQLExpression> FunctionEQ::simplify(bool& changed) {
     std::shared_ptr<SQLExpression> x = FunctionExpression::simplify(changed);
     if (x) {
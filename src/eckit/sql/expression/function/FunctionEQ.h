@@ -43,6 +43,9 @@ private:
     const eckit::sql::type::SQLType* type() const override;
     using FunctionExpression::eval;
     double eval(bool& missing) const override;
+    void evalBlock(const SQLBlock&, const char* selection, double* values, char* missing) const override;
+    bool isVectorised() const override;
+    size_t compile(SQLProgram&) const override;
     std::shared_ptr<SQLExpression> simplify(bool&) override;
 
     // -- Friends
@@ -10,6 +10,8 @@
 
 #include "eckit/sql/expression/function/FunctionExpression.h"
 
+#include "eckit/sql/SQLProgram.h"
+
 namespace eckit::sql::expression::function {
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -91,6 +93,32 @@ bool FunctionExpression::isConstant() const {
     return true;
 }
 
+bool FunctionExpression::isBatchable() const {
+    for (const auto& arg : args_) {
+        if (!arg->isBatchable()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<size_t> FunctionExpression::compileArgs(SQLProgram& program) const {
+    std::vector<size_t> regs;
+    for (const auto& arg : args_) {
+        regs.push_back(program.compile(*arg));
+    }
+    return regs;
+}
+
+bool FunctionExpression::vectorisedArgs() const {
+    for (const auto& arg : args_) {
+        if (!arg->isVectorised()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool FunctionExpression::isAggregate() const {
     for (expression::Expressions::const_iterator j = args_.begin(); j != args_.end(); ++j) {
         if ((*j)->isAggregate()) {
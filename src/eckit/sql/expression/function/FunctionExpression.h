@@ -34,6 +34,7 @@ public:
     void updateType(SQLSelect& sql) override;
     void cleanup(SQLSelect& sql) override;
     bool isConstant() const override;
+    bool isBatchable() const override;
     std::shared_ptr<SQLExpression> simplify(bool&) override;
 
     // double eval() const override;
@@ -45,11 +46,18 @@ public:
 
     // For SQLSelectFactory (maybe it should just friend SQLSelectFactory).
     expression::Expressions& args() { return args_; }
+    const expression::Expressions& args() const { return args_; }
 
     static const char* help() { return ""; }
 
 protected:
 
+    /// If all the arguments are vectorised (see SQLExpression::isVectorised)
+    bool vectorisedArgs() const;
+
+    /// The registers of the arguments, lowered in order (see SQLExpression::compile)
+    std::vector<size_t> compileArgs(SQLProgram&) const;
+
     std::string name_;
     expression::Expressions args_;
     // void print(std::ostream&) const override;
@@ -9,6 +9,12 @@
  */
 
 #include "eckit/sql/expression/function/FunctionIN.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "eckit/sql/SQLBlock.h"
+#include "eckit/sql/SQLProgram.h"
 #include "eckit/sql/expression/function/FunctionEQ.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 
@@ -44,4 +50,69 @@ double FunctionIN::eval(bool& missing) const {
     return false;
 }
 
+void FunctionIN::evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+    const SQLExpression& x = *args_[size_];
+    if (x.type()->getKind() == type::SQLType::stringType) {
+        FunctionExpression::evalBlock(block, selection, values, missing);
+        return;
+    }
+
+    const size_t n = block.size();
+    std::fill_n(values, n, 0);
+    std::fill_n(missing, n, 0);
+    if (size_ == 0) {
+        return;
+    }
+
+    std::vector<double> xv(n);
+    x.evalBlock(block, selection, xv.data(), missing);
+
+    // As eval(), the values are compared in turn until one is equal
+    std::vector<char> rest(selection, selection + n);
+    std::vector<double> v(n);
+    std::vector<char> m(n);
+
+    for (size_t j = 0; j < size_; ++j) {
+        args_[j]->evalBlock(block, rest.data(), v.data(), m.data());
+        for (size_t i = 0; i < n; ++i) {
+            if (rest[i]) {
+                missing[i] = missing[i] || m[i];
+                if (xv[i] == v[i]) {
+                    values[i] = 1;
+                    rest[i]   = 0;
+                }
+            }
+        }
+    }
+}
+
+bool FunctionIN::isVectorised() const {
+    return args_[size_]->type()->getKind() != type::SQLType::stringType && vectorisedArgs();
+}
+
+size_t FunctionIN::compile(SQLProgram& program) const {
+
+    // The list is compared one value at a time, and only up to the first match: it is lowered if made of constants
+    // (which cannot be missing), the value being compared once
+
+    const SQLExpression& x = *args_[size_];
+    if (size_ == 0 || x.type()->getKind() == type::SQLType::stringType) {
+        return SQLExpression::compile(program);
+    }
+
+    std::vector<size_t> list;
+    for (size_t i = 0; i < size_; ++i) {
+        if (!args_[i]->isConstant() || args_[i]->type()->getKind() == type::SQLType::stringType) {
+            return SQLExpression::compile(program);
+        }
+
+        list.push_back(program.compile(*args_[i]));
+        if (!program.isConstant(list.back())) {
+            return SQLExpression::compile(program);
+        }
+    }
+
+    return program.in(program.compile(x), list);
+}
+
 }  // namespace eckit::sql::expression::function
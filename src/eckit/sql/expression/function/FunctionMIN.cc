@@ -10,7 +10,9 @@
 
 #include <cfloat>
 #include <climits>
+#include <vector>
 
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 #include "eckit/sql/expression/function/FunctionMIN.h"
 
@@ -63,6 +65,10 @@ void FunctionMIN::output(SQLOutput& s) const {
 void FunctionMIN::partialResult() {
     bool missing = false;
     double value = args_[0]->eval(missing);
+    accumulate(value, missing);
+}
+
+void FunctionMIN::accumulate(double value, bool missing) {
     if (!missing) {
         if (value < value_) {
             value_ = value;
@@ -70,4 +76,24 @@ void FunctionMIN::partialResult() {
     }
 }
 
+void FunctionMIN::mergePartialResult(const SQLExpression& other) {
+    const auto& o = dynamic_cast<const FunctionMIN&>(other);
+    if (o.value_ < value_) {
+        value_ = o.value_;
+    }
+}
+
+void FunctionMIN::partialResultBlock(const SQLBlock& block, const char* selection) {
+    const size_t n = block.size();
+    std::vector<double> values(n);
+    std::vector<char> missing(n);
+    args_[0]->evalBlock(block, selection, values.data(), missing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        if (selection[i] && !missing[i] && values[i] < value_) {
+            value_ = values[i];
+        }
+    }
+}
+
 }  // namespace eckit::sql::expression::function
@@ -9,6 +9,11 @@
  */
 
 #include "eckit/sql/expression/function/FunctionOR.h"
+
+#include <vector>
+
+#include "eckit/sql/SQLBlock.h"
+#include "eckit/sql/SQLProgram.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 
 namespace eckit::sql::expression::function {
@@ -35,6 +40,31 @@ double FunctionOR::eval(bool& missing) const {
     return args_[0]->eval(missing) || args_[1]->eval(missing);
 }
 
+size_t FunctionOR::compile(SQLProgram& program) const {
+    return program.logical(*this, false);
+}
+
+void FunctionOR::evalBlock(const SQLBlock& block, const char* selection, double* values, char* missing) const {
+    const size_t n = block.size();
+
+    // As eval(), the second argument is only evaluated where the first one is false
+    args_[0]->evalBlock(block, selection, values, missing);
+
+    std::vector<char> rest(n);
+    for (size_t i = 0; i < n; ++i) {
+        rest[i] = selection[i] && values[i] == 0;
+    }
+
+    std::vector<double> right(n);
+    std::vector<char> rightMissing(n);
+    args_[1]->evalBlock(block, rest.data(), right.data(), rightMissing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        values[i]  = values[i] != 0 || (rest[i] && right[i] != 0);
+        missing[i] = missing[i] || (rest[i] && rightMissing[i]);
+    }
+}
+
 std::shared_ptr<SQLExpression> FunctionOR::simplify(bool& changed) {
     std::shared_ptr<SQLExpression> x = FunctionExpression::simplify(changed);
     if (x) {
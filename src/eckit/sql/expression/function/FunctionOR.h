@@ -30,6 +30,9 @@ public:
 
     using FunctionExpression::eval;
     double eval(bool& missing) const override;
+    void evalBlock(const SQLBlock&, const char* selection, double* values, char* missing) const override;
+    bool isVectorised() const override { return vectorisedArgs(); }
+    size_t compile(SQLProgram& program) const override;
     const eckit::sql::type::SQLType* type() const override;
     std::shared_ptr<SQLExpression> simplify(bool&) override;
 
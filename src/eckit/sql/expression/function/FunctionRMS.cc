@@ -9,7 +9,9 @@
  */
 
 #include <cmath>
+#include <vector>
 
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 #include "eckit/sql/expression/function/FunctionRMS.h"
 
@@ -60,11 +62,33 @@ void FunctionRMS::cleanup(SQLSelect& sql) {
 void FunctionRMS::partialResult() {
     bool missing = false;
     double value = args_[0]->eval(missing);
+    accumulate(value, missing);
+}
+
+void FunctionRMS::accumulate(double value, bool missing) {
     if (!missing) {
         squares_ += value * value;
         count_++;
     }
-    //	else cout << "missing" << std::endl;
+}
+
+void FunctionRMS::mergePartialResult(const SQLExpression& other) {
+    const auto& o = dynamic_cast<const FunctionRMS&>(other);
+    squares_ += o.squares_;
+    count_ += o.count_;
+}
+
+void FunctionRMS::partialResultBlock(const SQLBlock& block, const char* selection) {
+    const size_t n = block.size();
+    std::vector<double> values(n);
+    std::vector<char> missing(n);
+    args_[0]->evalBlock(block, selection, values.data(), missing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        if (selection[i]) {
+            accumulate(values[i], missing[i]);
+        }
+    }
 }
 
 }  // namespace eckit::sql::expression::function
@@ -46,6 +46,10 @@ private:
     void prepare(SQLSelect&) override;
     void cleanup(SQLSelect&) override;
     void partialResult() override;
+    void partialResultBlock(const SQLBlock&, const char* selection) override;
+    void accumulate(double value, bool missing) override;
+    void mergePartialResult(const SQLExpression&) override;
+    bool isMergeable() const override { return true; }
 
     bool isAggregate() const override { return true; }
 
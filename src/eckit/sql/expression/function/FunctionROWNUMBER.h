@@ -39,6 +39,7 @@ protected:
     void prepare(SQLSelect&) override;
     void cleanup(SQLSelect&) override;
     bool isConstant() const override;
+    bool isBatchable() const override { return false; }  // depends on the rows fetched
     void partialResult() override;
     using FunctionIntegerExpression::eval;
     double eval(bool& missing) const override;
@@ -9,6 +9,10 @@
  */
 
 #include "eckit/sql/expression/function/FunctionSUM.h"
+
+#include <vector>
+
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 
 namespace eckit::sql::expression::function {
@@ -53,10 +57,34 @@ void FunctionSUM::cleanup(SQLSelect& sql) {
 void FunctionSUM::partialResult() {
     bool missing = false;
     double value = args_[0]->eval(missing);
+    accumulate(value, missing);
+}
+
+void FunctionSUM::accumulate(double value, bool missing) {
     if (!missing) {
         value_ += value;
         resultNULL_ = false;
     }
 }
 
+void FunctionSUM::mergePartialResult(const SQLExpression& other) {
+    const auto& o = dynamic_cast<const FunctionSUM&>(other);
+    value_ += o.value_;
+    resultNULL_ = resultNULL_ && o.resultNULL_;
+}
+
+void FunctionSUM::partialResultBlock(const SQLBlock& block, const char* selection) {
+    const size_t n = block.size();
+    std::vector<double> values(n);
+    std::vector<char> missing(n);
+    args_[0]->evalBlock(block, selection, values.data(), missing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        if (selection[i] && !missing[i]) {
+            value_ += values[i];
+            resultNULL_ = false;
+        }
+    }
+}
+
 }  // namespace eckit::sql::expression::function
@@ -39,6 +39,7 @@ protected:
     void prepare(SQLSelect&) override;
     void cleanup(SQLSelect&) override;
     bool isConstant() const override;
+    bool isBatchable() const override { return false; }  // depends on the rows output
     using FunctionIntegerExpression::eval;
     double eval(bool& missing) const override;
     std::shared_ptr<SQLExpression> simplify(bool&) override;
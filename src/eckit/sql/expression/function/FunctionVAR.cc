@@ -9,6 +9,10 @@
  */
 
 #include "eckit/sql/expression/function/FunctionVAR.h"
+
+#include <vector>
+
+#include "eckit/sql/SQLBlock.h"
 #include "eckit/sql/expression/function/FunctionFactory.h"
 
 namespace eckit::sql::expression::function {
@@ -69,12 +73,35 @@ void FunctionVAR::cleanup(SQLSelect& sql) {
 void FunctionVAR::partialResult() {
     bool missing = false;
     double value = args_[0]->eval(missing);
+    accumulate(value, missing);
+}
+
+void FunctionVAR::accumulate(double value, bool missing) {
     if (!missing) {
         value_ += value;
         squares_ += value * value;
         count_++;
     }
-    //	else cout << "missing" << std::endl;
+}
+
+void FunctionVAR::mergePartialResult(const SQLExpression& other) {
+    const auto& o = dynamic_cast<const FunctionVAR&>(other);
+    value_ += o.value_;
+    squares_ += o.squares_;
+    count_ += o.count_;
+}
+
+void FunctionVAR::partialResultBlock(const SQLBlock& block, const char* selection) {
+    const size_t n = block.size();
+    std::vector<double> values(n);
+    std::vector<char> missing(n);
+    args_[0]->evalBlock(block, selection, values.data(), missing.data());
+
+    for (size_t i = 0; i < n; ++i) {
+        if (selection[i]) {
+            accumulate(values[i], missing[i]);
+        }
+    }
 }
 
 }  // namespace eckit::sql::expression::function
@@ -0,0 +1,416 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include "eckit/thread/WorkStealingPool.h"
+
+#include <fstream>
+#include <sstream>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/log/Log.h"
+#include "eckit/runtime/Monitor.h"
+#include "eckit/thread/Thread.h"
+#include "eckit/thread/ThreadControler.h"
+
+namespace eckit {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+thread_local WorkStealingPool* currentPool_ = nullptr;
+thread_local size_t currentIndex_           = 0;
+
+
+#if defined(__linux__)
+
+/// CPUs listed as "0-3,8,10-11" in /sys/devices/system/node/node*/cpulist
+std::vector<int> parseCPUList(const std::string& list) {
+    std::vector<int> cpus;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        auto dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+
+std::vector<int> placement(WorkStealingPool::Affinity affinity) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return {};
+    }
+
+    std::vector<int> allowed;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+            allowed.push_back(cpu);
+        }
+    }
+
+    if (affinity != WorkStealingPool::Affinity::Spread) {
+        return allowed;
+    }
+
+    // Interleave the allowed CPUs of each NUMA node
+    std::vector<std::vector<int>> nodes;
+    for (size_t node = 0;; ++node) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!in) {
+            break;
+        }
+        std::string list;
+        std::getline(in, list);
+
+        std::vector<int> cpus;
+        for (int cpu : parseCPUList(list)) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(cpus);
+        }
+    }
+
+    if (nodes.size() < 2) {
+        return allowed;
+    }
+
+    std::vector<int> spread;
+    for (size_t i = 0; spread.size() < allowed.size(); ++i) {
+        for (const auto& cpus : nodes) {
+            if (i < cpus.size()) {
+                spread.push_back(cpus[i]);
+            }
+        }
+    }
+    return spread;
+}
+
+
+void pin(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) != 0) {
+        Log::warning() << "WorkStealingPool: cannot pin thread to CPU " << cpu << std::endl;
+    }
+}
+
+#else
+
+std::vector<int> placement(WorkStealingPool::Affinity) {
+    return {};
+}
+
+void pin(int) {}
+
+#endif
+
+}  // namespace
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool detail::TaskStateBase::ready() const {
+    AutoLock<MutexCond> lock(cond_);
+    return ready_;
+}
+
+void detail::TaskStateBase::wait() const {
+    if (WorkStealingPool::current() == &pool_) {
+        // Help the pool rather than blocking one of its workers
+        while (!ready()) {
+            if (!pool_.tryRunOne()) {
+                AutoLock<MutexCond> lock(cond_);
+                if (!ready_) {
+                    cond_.wait(1);
+                }
+            }
+        }
+        return;
+    }
+
+    AutoLock<MutexCond> lock(cond_);
+    while (!ready_) {
+        cond_.wait();
+    }
+}
+
+void detail::TaskStateBase::onReady(std::function<void()> continuation) {
+    {
+        AutoLock<MutexCond> lock(cond_);
+        if (!ready_) {
+            continuations_.emplace_back(std::move(continuation));
+            return;
+        }
+    }
+    continuation();
+}
+
+void detail::TaskStateBase::complete(std::exception_ptr error) {
+    std::vector<std::function<void()>> continuations;
+    {
+        AutoLock<MutexCond> lock(cond_);
+        ASSERT(!ready_);
+        error_ = error;
+        ready_ = true;
+        std::swap(continuations, continuations_);
+        cond_.broadcast();
+    }
+    for (auto& c : continuations) {
+        c();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class WorkStealingThread : public Thread {
+public:
+
+    WorkStealingThread(WorkStealingPool& owner, size_t index, int cpu) : owner_(owner), index_(index), cpu_(cpu) {}
+
+private:
+
+    WorkStealingPool& owner_;
+    size_t index_;
+    int cpu_;
+
+    void run() override {
+        Monitor::instance().name(owner_.name());
+
+        if (cpu_ >= 0) {
+            pin(cpu_);
+        }
+
+        currentPool_  = &owner_;
+        currentIndex_ = index_;
+
+        while (ThreadPoolTask* task = owner_.next(index_)) {
+            owner_.run(task);
+        }
+
+        currentPool_ = nullptr;
+    }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+WorkStealingPool::WorkStealingPool(const std::string& name, size_t count, size_t stack, Affinity affinity) :
+    name_(name) {
+    ASSERT(count > 0);
+
+    std::vector<int> cpus = affinity == Affinity::None ? std::vector<int>{} : placement(affinity);
+
+    workers_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers_.emplace_back(new Worker);
+    }
+
+    threads_.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+        threads_.emplace_back(new ThreadControler(new WorkStealingThread(*this, i, cpu), false, stack));
+        threads_.back()->start();
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    try {
+        wait();
+    }
+    catch (std::exception& e) {
+        Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+        Log::error() << "** Exception is ignored" << std::endl;
+    }
+
+    stop();
+
+    for (auto& t : threads_) {
+        t->wait();
+    }
+}
+
+WorkStealingPool* WorkStealingPool::current() {
+    return currentPool_;
+}
+
+void WorkStealingPool::push(ThreadPoolTask* task) {
+    ASSERT(task);
+
+    pending_++;
+
+    // Tasks pushed by a worker of this pool stay local to that worker
+    size_t index = currentPool_ == this ? currentIndex_ : roundRobin_++ % workers_.size();
+    enqueue(index, task);
+}
+
+void WorkStealingPool::push(std::list<ThreadPoolTask*>& tasks) {
+    for (auto* task : tasks) {
+        push(task);
+    }
+    tasks.clear();
+}
+
+void WorkStealingPool::enqueue(size_t index, ThreadPoolTask* task) {
+    {
+        Worker& w = *workers_[index];
+        AutoLock<Mutex> lock(w.mutex_);
+        w.tasks_.push_back(task);
+    }
+
+    queued_++;
+
+    // Only take the idle lock if a worker may be asleep
+    if (sleepers_ > 0) {
+        AutoLock<MutexCond> lock(idle_);
+        idle_.signal();
+    }
+}
+
+ThreadPoolTask* WorkStealingPool::pop(size_t index) {
+    Worker& w = *workers_[index];
+    AutoLock<Mutex> lock(w.mutex_);
+    if (w.tasks_.empty()) {
+        return nullptr;
+    }
+    ThreadPoolTask* task = w.tasks_.back();
+    w.tasks_.pop_back();
+    queued_--;
+    return task;
+}
+
+ThreadPoolTask* WorkStealingPool::steal(size_t thief) {
+    const size_t n = workers_.size();
+    for (size_t i = 1; i <= n; ++i) {
+        Worker& w = *workers_[(thief + i) % n];
+        AutoLock<Mutex> lock(w.mutex_);
+        if (!w.tasks_.empty()) {
+            ThreadPoolTask* task = w.tasks_.front();
+            w.tasks_.pop_front();
+            queued_--;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+ThreadPoolTask* WorkStealingPool::next(size_t index) {
+    for (;;) {
+        if (ThreadPoolTask* task = pop(index)) {
+            return task;
+        }
+
+        if (ThreadPoolTask* task = steal(index)) {
+            return task;
+        }
+
+        AutoLock<MutexCond> lock(idle_);
+        sleepers_++;
+        while (queued_ == 0 && !stop_) {
+            idle_.wait();
+        }
+        sleepers_--;
+
+        if (queued_ == 0 && stop_) {
+            return nullptr;
+        }
+    }
+}
+
+bool WorkStealingPool::tryRunOne() {
+    size_t index = currentPool_ == this ? currentIndex_ : 0;
+
+    ThreadPoolTask* task = pop(index);
+    if (!task) {
+        task = steal(index);
+    }
+    if (!task) {
+        return false;
+    }
+
+    run(task);
+    return true;
+}
+
+void WorkStealingPool::run(ThreadPoolTask* task) {
+    try {
+        task->execute();
+    }
+    catch (std::exception& e) {
+        Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+        Log::error() << "** Exception is reported" << std::endl;
+        error(e.what());
+    }
+
+    try {
+        delete task;
+    }
+    catch (std::exception& e) {
+        Log::error() << "** " << e.what() << " Caught in " << Here() << std::endl;
+        Log::error() << "** Exception is reported" << std::endl;
+        error(e.what());
+    }
+
+    if (--pending_ == 0) {
+        AutoLock<MutexCond> lock(done_);
+        done_.broadcast();
+    }
+}
+
+void WorkStealingPool::error(const std::string& msg) {
+    AutoLock<MutexCond> lock(done_);
+    if (error_) {
+        errorMessage_ += " | ";
+    }
+    error_ = true;
+    errorMessage_ += msg;
+}
+
+void WorkStealingPool::wait() {
+    ASSERT_MSG(currentPool_ != this, "WorkStealingPool::wait() called from one of its own workers");
+
+    AutoLock<MutexCond> lock(done_);
+    while (pending_ > 0) {
+        done_.wait();
+    }
+
+    if (error_) {
+        error_ = false;
+        std::string msg;
+        std::swap(msg, errorMessage_);
+        throw SeriousBug("WorkStealingPool::wait: " + msg);
+    }
+}
+
+void WorkStealingPool::stop() {
+    AutoLock<MutexCond> lock(idle_);
+    stop_ = true;
+    idle_.broadcast();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
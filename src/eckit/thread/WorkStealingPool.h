@@ -0,0 +1,340 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+/// @date   Oct 2026
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "eckit/thread/AutoLock.h"
+#include "eckit/thread/Mutex.h"
+#include "eckit/thread/MutexCond.h"
+#include "eckit/thread/ThreadPool.h"
+
+namespace eckit {
+
+class ThreadControler;
+class WorkStealingPool;
+
+template <typename T>
+class TaskFuture;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace detail {
+
+/// Shared state between a task submitted to a WorkStealingPool and its TaskFuture(s)
+class TaskStateBase {
+public:  // methods
+
+    explicit TaskStateBase(WorkStealingPool& pool) : pool_(pool) {}
+
+    TaskStateBase(const TaskStateBase&)            = delete;
+    TaskStateBase& operator=(const TaskStateBase&) = delete;
+
+    virtual ~TaskStateBase() = default;
+
+    bool ready() const;
+    void wait() const;
+
+    /// Run @param continuation once the state is ready (immediately, if it already is)
+    void onReady(std::function<void()> continuation);
+
+    void rethrow() const {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+    WorkStealingPool& pool() const { return pool_; }
+
+protected:  // methods
+
+    void complete(std::exception_ptr error);
+
+private:  // members
+
+    WorkStealingPool& pool_;
+    mutable MutexCond cond_;
+    std::vector<std::function<void()>> continuations_;
+    std::exception_ptr error_;
+    bool ready_ = false;
+};
+
+
+template <typename T>
+class TaskState : public TaskStateBase {
+public:  // methods
+
+    using TaskStateBase::TaskStateBase;
+
+    template <typename F>
+    void run(F& f) {
+        try {
+            value_.emplace(f());
+        }
+        catch (...) {
+            complete(std::current_exception());
+            return;
+        }
+        complete(nullptr);
+    }
+
+    void fail(std::exception_ptr error) { complete(error); }
+
+    const T& get() const {
+        wait();
+        rethrow();
+        return *value_;
+    }
+
+private:  // members
+
+    std::optional<T> value_;
+};
+
+
+template <>
+class TaskState<void> : public TaskStateBase {
+public:  // methods
+
+    using TaskStateBase::TaskStateBase;
+
+    template <typename F>
+    void run(F& f) {
+        try {
+            f();
+        }
+        catch (...) {
+            complete(std::current_exception());
+            return;
+        }
+        complete(nullptr);
+    }
+
+    void fail(std::exception_ptr error) { complete(error); }
+
+    void get() const {
+        wait();
+        rethrow();
+    }
+};
+
+
+template <typename F, typename T>
+struct ContinuationResult {
+    using type = std::invoke_result_t<F, const T&>;
+};
+
+template <typename F>
+struct ContinuationResult<F, void> {
+    using type = std::invoke_result_t<F>;
+};
+
+}  // namespace detail
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Handle on the result of a function submitted to a WorkStealingPool.
+/// Futures are cheap to copy and all copies share the same result.
+template <typename T>
+class TaskFuture {
+public:  // methods
+
+    TaskFuture() = default;
+
+    bool valid() const { return static_cast<bool>(state_); }
+
+    bool ready() const { return state_->ready(); }
+
+    /// Block until the task completed. When called from a worker of the same pool,
+    /// the calling thread executes other queued tasks while it waits.
+    void wait() const { state_->wait(); }
+
+    /// Wait and return the result, rethrowing any exception raised by the task
+    decltype(auto) get() const { return state_->get(); }
+
+    /// Schedule @param f on the pool once this task completed. @param f receives the result
+    /// of this task (or no argument for TaskFuture<void>). Exceptions propagate along the chain.
+    template <typename F>
+    auto then(F&& f) const;
+
+private:  // methods
+
+    explicit TaskFuture(std::shared_ptr<detail::TaskState<T>> state) : state_(std::move(state)) {}
+
+private:  // members
+
+    std::shared_ptr<detail::TaskState<T>> state_;
+
+private:  // friends
+
+    friend class WorkStealingPool;
+
+    template <typename>
+    friend class TaskFuture;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// A thread pool where each worker owns a task deque. Workers pop their own tasks in LIFO order
+/// and steal from the front of the other workers' deques when they run out of work, so that there is
+/// no single lock shared between all the workers (as the ready queue of ThreadPool).
+///
+/// The push()/wait() interface matches ThreadPool so that existing ThreadPoolTask code can move over.
+/// Note that ThreadPoolTask::pool() is not available for tasks run by this pool; use
+/// WorkStealingPool::current() instead.
+class WorkStealingPool {
+
+public:  // types
+
+    /// Pinning of worker threads to CPUs
+    enum class Affinity {
+        None,     ///< leave the placement to the OS
+        Compact,  ///< worker i is pinned to the i-th CPU available to the process
+        Spread,   ///< workers are pinned round-robin across NUMA nodes (Linux only, Compact otherwise)
+    };
+
+public:  // methods
+
+    WorkStealingPool(const std::string& name, size_t count, size_t stack = 0, Affinity = Affinity::None);
+
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    WorkStealingPool(WorkStealingPool&&)                 = delete;
+    WorkStealingPool& operator=(WorkStealingPool&&)      = delete;
+
+    /// Executes the remaining tasks, then stops the workers
+    ~WorkStealingPool();
+
+    /// Takes ownership of the task
+    void push(ThreadPoolTask*);
+    void push(std::list<ThreadPoolTask*>&);
+
+    /// Submit a function, returning a future on its result
+    template <typename F>
+    auto submit(F&& f) {
+        using R    = std::invoke_result_t<std::decay_t<F>>;
+        auto state = std::make_shared<detail::TaskState<R>>(*this);
+        auto run   = [state, f = std::forward<F>(f)]() mutable { state->run(f); };
+        push(new FunctionTask<decltype(run)>(std::move(run)));
+        return TaskFuture<R>(state);
+    }
+
+    /// Block until all pushed tasks completed; throws if any ThreadPoolTask failed
+    void wait();
+    bool done() const { return pending_ == 0; }
+
+    const std::string& name() const { return name_; }
+    size_t size() const { return workers_.size(); }
+    void error(const std::string&);
+
+    /// Execute one queued task in the calling thread, if any
+    bool tryRunOne();
+
+    /// Pool of the calling worker thread, or nullptr
+    static WorkStealingPool* current();
+
+private:  // types
+
+    template <typename F>
+    class FunctionTask : public ThreadPoolTask {
+    public:
+
+        explicit FunctionTask(F&& f) : f_(std::move(f)) {}
+        void execute() override { f_(); }
+
+    private:
+
+        F f_;
+    };
+
+    struct alignas(64) Worker {
+        Mutex mutex_;
+        std::deque<ThreadPoolTask*> tasks_;
+    };
+
+private:  // methods
+
+    ThreadPoolTask* next(size_t index);
+    ThreadPoolTask* pop(size_t index);
+    ThreadPoolTask* steal(size_t thief);
+    void run(ThreadPoolTask*);
+    void enqueue(size_t index, ThreadPoolTask*);
+    void stop();
+
+    friend class WorkStealingThread;
+
+private:  // members
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::unique_ptr<ThreadControler>> threads_;
+
+    MutexCond idle_;
+    MutexCond done_;
+
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> sleepers_{0};
+    std::atomic<size_t> roundRobin_{0};
+
+    std::string name_;
+    std::string errorMessage_;
+
+    bool stop_  = false;
+    bool error_ = false;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+template <typename F>
+auto TaskFuture<T>::then(F&& f) const {
+    using U = typename detail::ContinuationResult<std::decay_t<F>, T>::type;
+
+    auto parent = state_;
+    auto child  = std::make_shared<detail::TaskState<U>>(parent->pool());
+
+    parent->onReady([parent, child, f = std::forward<F>(f)]() mutable {
+        parent->pool().submit([parent, child, f = std::move(f)]() mutable {
+            try {
+                parent->rethrow();
+            }
+            catch (...) {
+                child->fail(std::current_exception());
+                return;
+            }
+            if constexpr (std::is_void_v<T>) {
+                child->run(f);
+            }
+            else {
+                auto g = [&parent, &f]() -> U { return f(parent->get()); };
+                child->run(g);
+            }
+        });
+    });
+
+    return TaskFuture<U>(child);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit
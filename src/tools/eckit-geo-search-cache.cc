@@ -0,0 +1,137 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <ctime>
+#include <memory>
+#include <regex>
+#include <string>
+
+#include "eckit/geo/Grid.h"
+#include "eckit/geo/Search.h"
+#include "eckit/geo/search/TreeCache.h"
+#include "eckit/log/Bytes.h"
+#include "eckit/log/Log.h"
+#include "eckit/option/CmdArgs.h"
+#include "eckit/option/EckitTool.h"
+#include "eckit/option/SimpleOption.h"
+#include "eckit/spec/Custom.h"
+#include "eckit/utils/StringTools.h"
+
+
+namespace eckit::tools {
+
+
+struct EckitGeoSearchCache final : EckitTool {
+    EckitGeoSearchCache(int argc, char** argv) : EckitTool(argc, argv) {
+        options_.push_back(
+            new option::SimpleOption<std::string>("trees", "search tree type to build (default: mapped-cache-file)"));
+        options_.push_back(new option::SimpleOption<bool>("match", "match instead of search (default: false)"));
+        options_.push_back(new option::SimpleOption<bool>("dryrun", "dry run (default: false)"));
+        options_.push_back(new option::SimpleOption<bool>("list", "list cached search trees (default: false)"));
+        options_.push_back(new option::SimpleOption<bool>(
+            "prune", "evict least recently used search trees above the budget (default: false)"));
+        options_.push_back(new option::SimpleOption<size_t>(
+            "budget", "cache budget [B] (default: eckit-geo-search-cache-budget, 0 for unlimited)"));
+    }
+
+    void usage(const std::string& tool) const override {
+        Log::info() << "\n"
+                       "Usage: "
+                    << tool << " [options] [grid name, regular expression or uid] ..." << std::endl;
+    }
+
+    int minimumPositionalArguments() const override { return 0; }
+
+    void execute(const option::CmdArgs& args) override {
+        const auto match  = args.getBool("match", false);
+        const auto dryrun = args.getBool("dryrun", false);
+        const auto trees  = args.getString("trees", "mapped-cache-file");
+
+        // pre-warm
+        auto build = [dryrun, &trees](const spec::Spec& spec) {
+            if (dryrun) {
+                Log::info() << spec << std::endl;
+                return;
+            }
+
+            std::unique_ptr<const geo::Grid> grid(geo::GridFactory::build(spec));
+            geo::Search search(*grid, spec::Custom{{"eckit-geo-search-trees", trees}});
+            Log::info() << grid->uid() << ": " << spec << std::endl;
+        };
+
+        for (const auto& arg : args) {
+            if (const auto uid = StringTools::lower(arg); geo::Grid::is_uid(uid)) {
+                build(spec::Custom{{"uid", uid}});
+                continue;
+            }
+
+            bool found = false;
+
+            const std::regex pattern(arg, std::regex::icase);
+            for (auto& [grid, _] : geo::GridSpecByName::instance().store()) {
+                if (match ? std::regex_match(grid, pattern) : std::regex_search(grid, pattern)) {
+                    build(spec::Custom{{"grid", grid}});
+                    found = true;
+                }
+            }
+
+            if (!found) {
+                build(spec::Custom{{"grid", arg}});  // not a named grid (e.g. O1280, 0.1/0.1)
+            }
+        }
+
+        // prune
+        if (args.getBool("prune", false)) {
+            const auto budget = args.getUnsigned("budget", geo::search::TreeCache::budget());
+
+            // as for the library, 0 is unlimited (and not evicting all)
+            if (budget == 0) {
+                Log::warning() << "--prune: no budget (see --budget), not pruning" << std::endl;
+            }
+            else {
+                for (const auto& cache : geo::search::TreeCache::caches()) {
+                    if (dryrun) {
+                        Log::info() << cache << std::endl;
+                        continue;
+                    }
+
+                    for (const auto& entry : cache.prune(budget)) {
+                        Log::info() << "evicted " << entry.path << " (" << Bytes(static_cast<double>(entry.bytes))
+                                    << ")" << std::endl;
+                    }
+                }
+            }
+        }
+
+        // list
+        if (args.getBool("list", false)) {
+            for (const auto& cache : geo::search::TreeCache::caches()) {
+                Log::info() << cache << std::endl;
+
+                for (const auto& entry : cache.entries()) {
+                    char used[32];
+                    std::strftime(used, sizeof(used), "%Y-%m-%d %H:%M:%S", std::localtime(&entry.used));
+                    Log::info() << "  " << entry.path << " " << Bytes(static_cast<double>(entry.bytes)) << " " << used
+                                << std::endl;
+                }
+            }
+        }
+    }
+};
+
+
+}  // namespace eckit::tools
+
+
+int main(int argc, char** argv) {
+    eckit::tools::EckitGeoSearchCache app(argc, argv);
+    return app.start();
+}
@@ -0,0 +1,224 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/URingHandle.h"
+#include "eckit/log/Log.h"
+#include "eckit/testing/Test.h"
+
+using namespace std;
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// size is prime number 89
+const char tbuf[] = "74e1feb8d0b1d328cbea63832c2dcfb2b4fa1adfeb8d0b1d328cb53d50e63a50fba73f0151028a695a238ff0";
+
+class TestURing {
+public:
+
+    TestURing() {
+        std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+        path_            = PathName::unique(base + "/file") + ".dat";
+        reference_       = PathName::unique(base + "/reference") + ".dat";
+
+        std::unique_ptr<DataHandle> fh(reference_.fileHandle());
+        writeTo(*fh);
+    }
+
+    size_t writeTo(DataHandle& dh, size_t nblocks = 10 * 1024 * 1024 / sizeof(tbuf)) {
+        long sz = sizeof(tbuf);
+
+        dh.openForWrite(0);
+
+        size_t total = 0;
+        for (size_t i = 0; i < nblocks; ++i) {
+            total += dh.write(tbuf, sz);
+        }
+
+        dh.close();
+
+        return total;
+    }
+
+    bool verify(DataHandle& dh) {
+        std::unique_ptr<DataHandle> rh(reference_.fileHandle());
+        return rh->compare(dh);
+    }
+
+    bool verify() {
+        std::unique_ptr<DataHandle> fh(path_.fileHandle());
+        return verify(*fh);
+    }
+
+    ~TestURing() {
+        if (path_.exists()) {
+            path_.unlink();
+        }
+        reference_.unlink();
+    }
+
+    PathName path_;
+    PathName reference_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Write to a new file") {
+
+    Log::info() << "io_uring available: " << URingHandle::available() << std::endl;
+
+    TestURing test;
+
+    SECTION("Single write") {
+        std::unique_ptr<DataHandle> rh(test.reference_.fileHandle());
+        URingHandle h(test.path_);
+        rh->saveInto(h);
+        EXPECT(test.verify());
+        EXPECT(h.position() == Offset(test.reference_.size()));
+    }
+
+    SECTION("Multiple writes, small buffers") {
+        URingHandle h(test.path_, 4, 4096);
+        test.writeTo(h);
+        EXPECT(test.verify());
+    }
+
+    SECTION("Flush in the middle of a stream") {
+        URingHandle h(test.path_, 4, 64 * 1024, true);
+        h.openForWrite(0);
+        std::unique_ptr<DataHandle> rh(test.reference_.fileHandle());
+        Buffer buffer(test.reference_.size());
+        rh->openForRead();
+        long len = rh->read(buffer, buffer.size());
+        rh->close();
+        EXPECT(len == long(buffer.size()));
+        EXPECT(h.write(buffer, 1000) == 1000);
+        h.flush();
+        EXPECT(h.write(buffer + 1000, len - 1000) == len - 1000);
+        h.close();
+        EXPECT(test.verify());
+    }
+
+    SECTION("O_DIRECT") {
+        URingHandle h(test.path_, 8, 1024 * 1024, false, true);
+        test.writeTo(h);
+        EXPECT(test.verify());
+    }
+}
+
+CASE("Append") {
+    TestURing test;
+
+    size_t half = 5 * 1024 * 1024 / sizeof(tbuf);
+    {
+        URingHandle h(test.path_);
+        test.writeTo(h, half);
+    }
+    {
+        URingHandle h(test.path_, 16, 1024 * 1024, false, true);
+        h.openForAppend(0);
+        for (size_t i = half; i < 10 * 1024 * 1024 / sizeof(tbuf); ++i) {
+            h.write(tbuf, sizeof(tbuf));
+        }
+        h.close();
+    }
+    EXPECT(test.verify());
+}
+
+CASE("Read with read-ahead") {
+    TestURing test;
+
+    SECTION("Compare") {
+        URingHandle h(test.reference_, 4, 64 * 1024);
+        EXPECT(test.verify(h));
+    }
+
+    SECTION("Small reads and rewind") {
+        URingHandle h(test.reference_, 3, 4096, false, true);
+        Length len = h.openForRead();
+        EXPECT(len == test.reference_.size());
+
+        char buf[sizeof(tbuf)];
+        size_t total = 0;
+        long n;
+        while ((n = h.read(buf, sizeof(tbuf))) > 0) {
+            EXPECT(::memcmp(buf, tbuf, n) == 0);
+            total += n;
+        }
+        EXPECT(Length(total) == len);
+        EXPECT(h.position() == Offset(len));
+
+        h.rewind();
+        EXPECT(h.read(buf, sizeof(tbuf)) == long(sizeof(tbuf)));
+        EXPECT(::memcmp(buf, tbuf, sizeof(tbuf)) == 0);
+        h.close();
+    }
+
+    SECTION("File truncated while read with O_DIRECT") {
+        {
+            URingHandle w(test.path_);
+            test.writeTo(w, 64 * 1024 / sizeof(tbuf));
+        }
+
+        // One slot: the blocks after the first are read after the truncation, the last one short and unaligned
+        URingHandle h(test.path_, 1, 8192, false, true);
+        h.openForRead();
+
+        const size_t size = 8192 + 5000;
+        EXPECT(::truncate(test.path_.localPath(), size) == 0);
+
+        Buffer buffer(64 * 1024);
+        size_t total = 0;
+        long n;
+        while ((n = h.read(buffer + total, 1000)) > 0) {
+            total += n;
+        }
+        h.close();
+
+        EXPECT(total == size);
+        for (size_t i = 0; i < size; i += sizeof(tbuf)) {
+            const size_t len = std::min(sizeof(tbuf), size - i);
+            EXPECT(::memcmp(buffer + i, tbuf, len) == 0);
+        }
+    }
+
+    SECTION("Empty file") {
+        URingHandle w(test.path_);
+        w.openForWrite(0);
+        w.close();
+
+        URingHandle h(test.path_);
+        EXPECT(h.openForRead() == Length(0));
+        char buf[16];
+        EXPECT(h.read(buf, sizeof(buf)) == 0);
+        h.close();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,104 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/geo/Grid.h"
+#include "eckit/geo/projection/Composer.h"
+#include "eckit/geo/projection/LambertConformalConic.h"
+#include "eckit/geo/projection/Mercator.h"
+#include "eckit/geo/projection/PolarStereographic.h"
+#include "eckit/geo/projection/Rotation.h"
+#include "eckit/log/Timer.h"
+#include "eckit/spec/Custom.h"
+#include "eckit/testing/Test.h"
+#include "eckit/utils/Tokenizer.h"
+
+
+namespace eckit::geo::test {
+
+
+void benchmark(const std::string& name, const Projection& projection, const std::vector<double>& lon,
+               const std::vector<double>& lat) {
+    const auto n = lon.size();
+
+    std::vector<double> x(n);
+    std::vector<double> y(n);
+
+    {
+        Timer timer(name + " fwd, point by point");
+        for (size_t i = 0; i < n; ++i) {
+            auto p = projection.fwd(Point{PointLonLat{lon[i], lat[i]}});
+            x[i]   = std::holds_alternative<PointXY>(p) ? std::get<PointXY>(p).X() : std::get<PointLonLat>(p).lon();
+        }
+    }
+
+    {
+        Timer timer(name + " fwd, batch");
+        projection.fwd(lon.data(), lat.data(), x.data(), y.data(), n);
+    }
+
+    {
+        Timer timer(name + " inv, batch");
+        projection.inv(x.data(), y.data(), x.data(), y.data(), n);
+    }
+}
+
+
+CASE("benchmark_projection") {
+    // Grids, separated by ':'
+    std::string grids = Resource<std::string>("$ECKIT_GEO_BENCHMARK_GRIDS", "O320:0.25/0.25");
+
+    std::vector<std::string> names;
+    Tokenizer(":")(grids, names);
+
+    std::vector<std::pair<std::string, std::unique_ptr<Projection>>> projections;
+    projections.emplace_back("rotation", new projection::Rotation({-20., -40.}, 10.));
+    projections.emplace_back("mercator", new projection::Mercator({0., 14.}, {0., 0.}));
+    projections.emplace_back("lambert_conformal_conic", new projection::LambertConformalConic(30., 10., 45., 60.));
+    projections.emplace_back("polar_stereographic", new projection::PolarStereographic({0., 90.}, {-30., 60.}));
+    projections.emplace_back("rotation + mercator",
+                             new projection::Composer{new projection::Rotation({-20., -40.}, 10.),
+                                                      new projection::Mercator({0., 14.}, {0., 0.})});
+
+    for (const auto& name : names) {
+        std::unique_ptr<const Grid> grid(GridFactory::build(spec::Custom{{"grid", name}}));
+
+        auto [lat, lon] = grid->to_latlons();
+
+        // away from the poles, for mercator
+        for (auto& l : lat) {
+            l = std::max(-89., std::min(89., l));
+        }
+
+        std::cout << "-------------------------------------------------------------" << std::endl;
+        std::cout << name << ": " << lon.size() << " points" << std::endl;
+
+        for (const auto& [label, projection] : projections) {
+            benchmark(label, *projection, lon, lat);
+        }
+    }
+}
+
+
+}  // namespace eckit::geo::test
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,170 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/geo/cache/LatitudeLongitude.h"
+#include "eckit/geo/cache/MemoryCache.h"
+#include "eckit/geo/cache/SharedMemory.h"
+#include "eckit/testing/Test.h"
+
+
+namespace eckit::geo::test {
+
+
+using cache::SharedMemory;
+
+
+struct Loader final : SharedMemory::Loader {
+    explicit Loader(size_t n, bool fail = false) : values(n), fail(fail) {}
+
+    SharedMemory::bytes_size_t load() override {
+        ++loads;
+        if (fail) {
+            throw SeriousBug("Loader: failed");
+        }
+
+        std::iota(values.begin(), values.end(), 1.);
+        return values.size() * sizeof(double);
+    }
+
+    void fill(void* data) const override { std::copy(values.begin(), values.end(), static_cast<double*>(data)); }
+
+    bool equals(const SharedMemory& shm) const {
+        const auto* data = static_cast<const double*>(shm.data());
+        return shm.size() == values.size() * sizeof(double) && std::equal(values.begin(), values.end(), data);
+    }
+
+    std::vector<double> values;
+    const bool fail;
+    size_t loads = 0;
+};
+
+
+CASE("SharedMemory") {
+    const std::string name = "test-" + std::to_string(::getpid());
+    SharedMemory::remove(name);
+
+    const auto footprint = SharedMemory::total_footprint();
+
+    SECTION("publish, attach") {
+        Loader loader(1000);
+        {
+            const SharedMemory a(name, loader);
+            EXPECT(a.published());
+            EXPECT(loader.equals(a));
+
+            const SharedMemory b(name, loader);
+            EXPECT_NOT(b.published());
+            EXPECT(loader.equals(b));
+            EXPECT(a.data() != b.data());
+
+            EXPECT_EQUAL(loader.loads, 1);
+            EXPECT_EQUAL(SharedMemory::total_footprint(), footprint + 2 * 1000 * sizeof(double));
+            EXPECT_EQUAL(cache::MemoryCache::total_footprint_shared(), SharedMemory::total_footprint());
+        }
+
+        // last to detach unlinks
+        EXPECT_EQUAL(SharedMemory::total_footprint(), footprint);
+
+        const SharedMemory c(name, loader);
+        EXPECT(c.published());
+        EXPECT_EQUAL(loader.loads, 2);
+    }
+
+    SECTION("publish (failing), publish") {
+        Loader failing(1000, true);
+        EXPECT_THROWS_AS(SharedMemory(name, failing), SeriousBug);
+        EXPECT_EQUAL(SharedMemory::total_footprint(), footprint);
+
+        Loader loader(10);
+        const SharedMemory a(name, loader);
+        EXPECT(a.published());
+        EXPECT(loader.equals(a));
+    }
+
+    SECTION("attach (other process)") {
+        Loader loader(100000);
+        const SharedMemory a(name, loader);
+        EXPECT(a.published());
+
+        if (auto pid = ::fork(); pid == 0) {
+            int status = 1;
+            {
+                Loader other(100000);
+                const SharedMemory b(name, other);
+                status = !b.published() && other.loads == 0 && loader.equals(b) ? 0 : 1;
+            }
+            ::_exit(status);
+        }
+        else {
+            EXPECT(pid > 0);
+
+            int status = 0;
+            EXPECT_EQUAL(::waitpid(pid, &status, 0), pid);
+            EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        }
+
+        EXPECT(loader.equals(a));
+    }
+
+    SharedMemory::remove(name);
+}
+
+
+CASE("LatitudeLongitude (shared memory)") {
+    const std::string name = "test-latlon-" + std::to_string(::getpid());
+    SharedMemory::remove(name);
+
+    const std::vector<double> lat{-10., 0., 10., 20.};
+    const std::vector<double> lon{0., 90., 180., 270.};
+
+    const PathName path = PathName::unique(PathName(".") / "latlon") + ".ek";
+    cache::LatitudeLongitude(lat, lon).write(path);
+
+    cache::LatitudeLongitude a;
+    cache::LatitudeLongitude b;
+    a.read_shared(path, name);
+    b.read_shared(path, name);
+
+    for (const auto* ll : {&a, &b}) {
+        EXPECT_EQUAL(ll->size(), lat.size());
+        EXPECT(std::equal(lat.begin(), lat.end(), ll->latitude().begin()));
+        EXPECT(std::equal(lon.begin(), lon.end(), ll->longitude().begin()));
+        EXPECT_EQUAL(ll->footprint(), 2 * lat.size() * sizeof(double));
+    }
+
+    EXPECT(a.latitude().data() != b.latitude().data());
+
+    // private copy
+    b.read(path);
+    EXPECT(std::equal(lat.begin(), lat.end(), b.latitude().begin()));
+    EXPECT(std::equal(lon.begin(), lon.end(), b.longitude().begin()));
+
+    path.unlink();
+}
+
+
+}  // namespace eckit::geo::test
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,64 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "eckit/geo/Grid.h"
+#include "eckit/spec/Custom.h"
+#include "eckit/testing/Test.h"
+
+
+namespace eckit::geo::test {
+
+
+CASE("Grid::to_latlons") {
+    // grid coordinates match the iterator's, exactly
+    for (const auto* spec : {
+             R"({grid: [1, 1]})",
+             R"({grid: [0.25, 0.5], area: [10, -20, -30, 40]})",
+             R"({grid: [2, 3], area: [10, -20, -30, 40], order: i-j+})",
+             R"({grid: F16})",
+             R"({grid: F16, area: [50, 10, -10, 60]})",
+             R"({grid: O16})",
+             R"({grid: N16})",
+             R"({grid: O32, area: [50, 10, -10, 60]})",
+             R"({grid: H8})",
+             R"({grid: H8, order: nested})",
+             R"({grid: [1, 1], rotation: [-20, 40]})",
+             R"({grid: O16, rotation: [-20, 40]})",
+         }) {
+        std::unique_ptr<const Grid> grid(GridFactory::make_from_string(spec));
+
+        std::vector<double> lat;
+        std::vector<double> lon;
+        for (const auto& p : *grid) {
+            auto q = std::get<PointLonLat>(p);
+            lat.push_back(q.lat());
+            lon.push_back(q.lon());
+        }
+
+        const auto [lats, lons] = grid->to_latlons();
+        EXPECT_EQUAL(lats.size(), grid->size());
+        EXPECT(lats == lat);
+        EXPECT(lons == lon);
+    }
+}
+
+
+}  // namespace eckit::geo::test
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
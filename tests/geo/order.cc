@@ -10,14 +10,20 @@
  */
 
 
+#include <cstdlib>
 #include <map>
 #include <numeric>
 #include <string>
 #include <vector>
 
+#include "eckit/filesystem/PathName.h"
+#include "eckit/filesystem/TmpDir.h"
 #include "eckit/geo/Exceptions.h"
+#include "eckit/geo/LibEcKitGeo.h"
 #include "eckit/geo/order/HEALPix.h"
 #include "eckit/geo/order/Scan.h"
+#include "eckit/io/AutoCloser.h"
+#include "eckit/io/FileHandle.h"
 #include "eckit/spec/Custom.h"
 #include "eckit/testing/Test.h"
 
@@ -97,6 +103,72 @@ CASE("healpix") {
     }
 
 
+    SECTION("reorder values") {
+        for (size_t Nside : {1, 2, 16, 64}) {
+            const auto& ring_to_nested = HEALPix(HEALPix::RING).renumbering(HEALPix::NESTED, Nside);
+            const auto& nested_to_ring = HEALPix(HEALPix::NESTED).renumbering(HEALPix::RING, Nside);
+            EXPECT(ring_to_nested.size() == 12 * Nside * Nside);
+
+            std::vector<double> values(ring_to_nested.size());
+            std::vector<float> valuesf(ring_to_nested.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                EXPECT(nested_to_ring[ring_to_nested[i]] == i);
+                values[i] = valuesf[i] = static_cast<float>(i);
+            }
+
+            HEALPix(HEALPix::RING).reorder(HEALPix::NESTED, Nside, values.data());
+            HEALPix(HEALPix::RING).reorder(HEALPix::NESTED, Nside, valuesf.data());
+            for (size_t i = 0; i < values.size(); ++i) {
+                EXPECT(values[ring_to_nested[i]] == static_cast<double>(i));
+                EXPECT(valuesf[ring_to_nested[i]] == static_cast<float>(i));
+            }
+
+            HEALPix(HEALPix::NESTED).reorder(HEALPix::RING, Nside, values.data());
+            for (size_t i = 0; i < values.size(); ++i) {
+                EXPECT(values[i] == static_cast<double>(i));
+            }
+        }
+    }
+
+
+    SECTION("invalid cached renumbering") {
+        EXPECT(LibEcKitGeo::caching());
+
+        // a cache entry of the right size, but not a permutation (n.b. Nside not renumbered by any other section)
+        size_t Nside    = 32;
+        const auto size = 12 * Nside * Nside;
+
+        const auto path = PathName{LibEcKitGeo::cacheDir(), true} / "eckit/geo/order/healpix/1" /
+                          (HEALPix::RING + "-" + HEALPix::NESTED + "-" + std::to_string(Nside) + ".bin");
+        path.dirName().mkdir();
+        {
+            std::vector<size_t> garbage(size, size);
+            FileHandle out(path);
+            out.openForWrite(0);
+            auto c = closer(out);
+            out.write(garbage.data(), static_cast<long>(size * sizeof(size_t)));
+        }
+
+        const auto& ren = HEALPix(HEALPix::RING).renumbering(HEALPix::NESTED, Nside);
+        const auto& inv = HEALPix(HEALPix::NESTED).renumbering(HEALPix::RING, Nside);
+        EXPECT(ren.size() == size);
+        for (size_t i = 0; i < size; ++i) {
+            EXPECT(inv[ren[i]] == i);
+        }
+
+        // the entry is replaced by the renumbering recomputed
+        {
+            std::vector<size_t> cached(size);
+            FileHandle in(path);
+            in.openForRead();
+            auto c = closer(in);
+            EXPECT(in.read(cached.data(), static_cast<long>(size * sizeof(size_t))) ==
+                   static_cast<long>(size * sizeof(size_t)));
+            EXPECT(cached == ren);
+        }
+    }
+
+
     SECTION("exceptions") {
         EXPECT_THROWS_AS(HEALPix(spec::Custom{{"order", "?"}}), exception::OrderError);
 
@@ -116,5 +188,10 @@ CASE("healpix") {
 
 
 int main(int argc, char** argv) {
+    // The renumberings are cached in a directory of their own, not shared with other tests or processes
+    eckit::TmpDir cache(".");
+    ::setenv("ECKIT_GEO_CACHE_PATH", cache.localPath(), 1);
+    ::setenv("ECKIT_GEO_CACHING", "1", 1);
+
     return eckit::testing::run_tests(argc, argv);
 }
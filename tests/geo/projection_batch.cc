@@ -0,0 +1,145 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "eckit/geo/Exceptions.h"
+#include "eckit/geo/projection/AlbersEqualArea.h"
+#include "eckit/geo/projection/Composer.h"
+#include "eckit/geo/projection/EquidistantCylindrical.h"
+#include "eckit/geo/projection/LambertAzimuthalEqualArea.h"
+#include "eckit/geo/projection/LambertConformalConic.h"
+#include "eckit/geo/projection/LonLatToXYZ.h"
+#include "eckit/geo/projection/Mercator.h"
+#include "eckit/geo/projection/None.h"
+#include "eckit/geo/projection/PolarStereographic.h"
+#include "eckit/geo/projection/Reverse.h"
+#include "eckit/geo/projection/Rotation.h"
+#include "eckit/geo/projection/Stretch.h"
+#include "eckit/testing/Test.h"
+
+
+namespace eckit::geo::test {
+
+
+struct Coordinates {
+    explicit Coordinates(size_t n) : x(n), y(n) {}
+    std::vector<double> x;
+    std::vector<double> y;
+};
+
+
+bool same(double a, double b) {
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+
+bool same(const Point& p, double x, double y) {
+    if (std::holds_alternative<PointXY>(p)) {
+        const auto& q = std::get<PointXY>(p);
+        return same(q.X(), x) && same(q.Y(), y);
+    }
+
+    const auto& q = std::get<PointLonLat>(p);
+    return same(q.lon(), x) && same(q.lat(), y);
+}
+
+
+Coordinates lonlat() {
+    Coordinates c(0);
+    for (double lat = -80.; lat <= 80.; lat += 5.) {
+        for (double lon = -180.; lon < 360.; lon += 7.) {
+            c.x.push_back(lon);
+            c.y.push_back(lat);
+        }
+    }
+    return c;
+}
+
+
+/// Batch transformations give the same results as the single point methods (also in place)
+void check(const Projection& projection, bool lonlat_in_lonlat_out) {
+    const auto in = lonlat();
+    const auto n  = in.x.size();
+
+    Coordinates out(n);
+    projection.fwd(in.x.data(), in.y.data(), out.x.data(), out.y.data(), n);
+
+    for (size_t i = 0; i < n; ++i) {
+        const auto p = projection.fwd(Point{PointLonLat{in.x[i], in.y[i]}});
+        EXPECT(same(p, out.x[i], out.y[i]));
+    }
+
+    auto inplace = in;
+    projection.fwd(inplace.x.data(), inplace.y.data(), inplace.x.data(), inplace.y.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT(same(inplace.x[i], out.x[i]) && same(inplace.y[i], out.y[i]));
+    }
+
+    Coordinates back(n);
+    projection.inv(out.x.data(), out.y.data(), back.x.data(), back.y.data(), n);
+
+    for (size_t i = 0; i < n; ++i) {
+        if (std::isnan(out.x[i]) || std::isnan(out.y[i])) {
+            continue;
+        }
+        const auto q = lonlat_in_lonlat_out ? projection.inv(Point{PointLonLat{out.x[i], out.y[i]}})
+                                            : projection.inv(Point{PointXY{out.x[i], out.y[i]}});
+        EXPECT(same(q, back.x[i], back.y[i]));
+    }
+}
+
+
+CASE("batch transformations") {
+    SECTION("lon/lat to x/y") {
+        check(projection::Mercator({0., 14.}, {0., 0.}), false);
+        check(projection::LambertConformalConic(30., 10., 45., 60.), false);
+        check(projection::PolarStereographic({0., 90.}, {-30., 60.}), false);
+        check(projection::AlbersEqualArea(-96., 23., 29.5, 45.5), false);
+        check(projection::LambertAzimuthalEqualArea({10., 52.}, {-35., 67.}), false);
+        check(projection::EquidistantCylindrical(), false);
+    }
+
+    SECTION("lon/lat to lon/lat") {
+        check(projection::Rotation({-20., -40.}, 10.), true);
+        check(projection::Rotation({0., -90.}, 10.), true);
+        check(projection::Rotation(), true);
+        check(projection::Stretch(2.), true);
+        check(projection::None(), true);
+        check(projection::Reverse<projection::Rotation>(PointLonLat{-20., -40.}, 10.), true);
+    }
+
+    SECTION("Composer") {
+        projection::Composer composer{new projection::Rotation({-20., -40.}, 10.),
+                                      new projection::Mercator({0., 14.}, {0., 0.})};
+        check(composer, false);
+
+        check(projection::Composer{}, true);
+    }
+
+    SECTION("unsupported") {
+        projection::LonLatToXYZ projection(1.);
+
+        std::vector<double> x{0.}, y{0.};
+        EXPECT_THROWS_AS(projection.fwd(x.data(), y.data(), x.data(), y.data(), 1), exception::ProjectionError);
+    }
+}
+
+
+}  // namespace eckit::geo::test
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,112 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <utime.h>
+
+#include <memory>
+#include <string>
+
+#include "eckit/geo/Grid.h"
+#include "eckit/geo/Search.h"
+#include "eckit/geo/search/TreeCache.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/spec/Custom.h"
+#include "eckit/testing/Test.h"
+
+
+namespace eckit::geo::test {
+
+
+using search::TreeCache;
+
+
+CASE("TreeCache") {
+    const PathName root = PathName::unique(PathName(".") / "search_cache");
+
+    // a file of given size and modification (use) time
+    auto make = [&root](const std::string& name, size_t bytes, time_t used) {
+        PathName path = root / name;
+        path.dirName().mkdir();
+
+        FileHandle out(path);
+        out.openForWrite(0);
+        out.write(std::string(bytes, 'x').data(), static_cast<long>(bytes));
+        out.close();
+
+        utimbuf times{used, used};
+        ::utime(path.localPath(), &times);
+        return path;
+    };
+
+    auto a = make("2/a.kdtree", 100, 1000);
+    auto b = make("2/b.kdtree", 200, 3000);
+    auto c = make("flat/1/c.kdtree", 300, 2000);
+    make("2/d.kdtree.lock", 10, 4000);
+    make("2/e.kdtree.20000101.000000.host.1", 1000, 4000);
+
+    TreeCache cache(root);
+
+    SECTION("entries") {
+        auto entries = cache.entries();
+        EXPECT(entries.size() == 3);
+        EXPECT(entries[0].path == b);
+        EXPECT(entries[1].path == c);
+        EXPECT(entries[2].path == a);
+        EXPECT(cache.footprint() == 600);
+    }
+
+    SECTION("prune") {
+        EXPECT(cache.prune(1000).empty());
+
+        // least recently used first, except the kept one
+        auto evicted = cache.prune(400, c);
+        EXPECT(evicted.size() == 2);
+        EXPECT(evicted[0].path == a);
+        EXPECT(evicted[1].path == b);
+        EXPECT(!a.exists() && !b.exists() && c.exists());
+        EXPECT(cache.footprint() == 300);
+
+        TreeCache::use(c);
+        EXPECT(cache.entries().front().used > 2000);
+
+        EXPECT(cache.prune(0).size() == 1);
+        EXPECT(cache.entries().empty());
+    }
+
+    cache.rm_cache_root();
+}
+
+
+CASE("TreeCache (search)") {
+    std::unique_ptr<const Grid> grid(GridFactory::build(spec::Custom{{{"grid", "10/10"}}}));
+
+    for (const std::string trees : {"mapped-cache-file", "flat-cache-file"}) {
+        const Search search(*grid, spec::Custom{{{"eckit-geo-search-trees", trees}}});
+
+        bool found = false;
+        for (const auto& cache : TreeCache::caches()) {
+            for (const auto& entry : cache.entries()) {
+                found = found || entry.path.baseName(false) == grid->uid();
+            }
+        }
+
+        EXPECT(found);
+    }
+}
+
+
+}  // namespace eckit::geo::test
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
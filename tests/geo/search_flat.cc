@@ -0,0 +1,180 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ *
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "eckit/geo/Exceptions.h"
+#include "eckit/geo/Grid.h"
+#include "eckit/geo/Search.h"
+#include "eckit/geo/projection/LonLatToXYZ.h"
+#include "eckit/geo/search/KDTreeFlat.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/spec/Custom.h"
+#include "eckit/testing/Test.h"
+
+
+namespace eckit::geo::test {
+
+
+using search::KDTreeFlat;
+using Point = KDTreeFlat::Point;
+using Value = KDTreeFlat::PointValueType;
+
+
+std::vector<Value> random_points(size_t n, unsigned seed,
+                                 const projection::LonLatToXYZ& to_xyz = projection::LonLatToXYZ(1.)) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> lon(0., 360.);
+    std::uniform_real_distribution<double> z(-1., 1.);
+
+    std::vector<Value> points;
+    points.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto q = to_xyz.fwd(PointLonLat{lon(gen), std::asin(z(gen)) * 180. / M_PI});
+        points.emplace_back(Point{q.X(), q.Y(), q.Z()}, i);
+    }
+    return points;
+}
+
+
+/// Distances to the closest points, by brute force
+std::vector<double> brute_force(const std::vector<Value>& points, const Point& p, size_t k) {
+    std::vector<double> d;
+    d.reserve(points.size());
+    for (const auto& v : points) {
+        d.push_back(Point::distance(p, v.point()));
+    }
+    std::sort(d.begin(), d.end());
+    d.resize(std::min(k, d.size()));
+    return d;
+}
+
+
+std::vector<double> distances(const std::vector<Value>& values, const Point& p) {
+    std::vector<double> d;
+    for (const auto& v : values) {
+        d.push_back(Point::distance(p, v.point()));
+    }
+    return d;
+}
+
+
+CASE("KDTreeFlat") {
+    const auto points  = random_points(5000, 1);
+    const auto queries = random_points(200, 2);
+
+    KDTreeFlat tree;
+    tree.build(points, 8);
+
+    EXPECT(tree.size() == points.size());
+    EXPECT(tree.depth() > 0);
+
+    auto check = [&points, &queries](const KDTreeFlat& tree) {
+        for (const auto& q : queries) {
+            const auto& p = q.point();
+
+            // nearest neighbour is a point of the tree, with its payload
+            auto nn = tree.nearestNeighbour(p);
+            EXPECT(Point::distance(p, nn.point()) == brute_force(points, p, 1).front());
+            EXPECT(Point::distance(nn.point(), points[nn.payload()].point()) == 0.);
+
+            for (size_t k : {1, 4, 10}) {
+                EXPECT(distances(tree.kNearestNeighbours(p, k), p) == brute_force(points, p, k));
+            }
+
+            const double radius = 0.05;
+            auto all            = brute_force(points, p, points.size());
+            auto inside = std::vector<double>(all.begin(), std::upper_bound(all.begin(), all.end(), radius));
+            EXPECT(distances(tree.findInSphere(p, radius), p) == inside);
+        }
+    };
+
+    SECTION("queries") {
+        check(tree);
+
+        KDTreeFlat small;
+        small.build(random_points(3, 3));
+        EXPECT(small.depth() == 0);
+        EXPECT(small.kNearestNeighbours(Point{0., 0., 1.}, 5).size() == 3);
+    }
+
+    SECTION("save and load") {
+        PathName path = PathName::unique(PathName(".") / "kdtree") + ".flat";
+        tree.save(path);
+
+        KDTreeFlat mapped;
+        mapped.load(path);
+        EXPECT(mapped.size() == tree.size());
+        check(mapped);
+
+        // truncated
+        {
+            FileHandle out(path);
+            out.openForWrite(0);
+            out.write("ECKITKDF", 8);
+            out.close();
+        }
+
+        KDTreeFlat truncated;
+        EXPECT_THROWS_AS(truncated.load(path), exception::SearchError);
+        EXPECT(truncated.empty());
+
+        path.unlink();
+    }
+}
+
+
+CASE("Search (flat, batched)") {
+    std::unique_ptr<const Grid> grid(GridFactory::build(spec::Custom{{{"grid", "10/10"}}}));
+
+    const auto queries = random_points(100, 4, projection::LonLatToXYZ());
+
+    std::vector<Search::PointType> points;
+    for (const auto& q : queries) {
+        points.push_back(q.point());
+    }
+
+    const Search reference(*grid, spec::Custom{{{"eckit-geo-search-trees", "memory"}}});
+
+    for (const std::string trees : {"flat", "flat-cache-file", "flat-cache-file"}) {
+        const Search search(*grid, spec::Custom{{{"eckit-geo-search-trees", trees}}});
+
+        std::vector<std::vector<Search::PointValueType>> closest;
+        search.closestNPoints(points, 4, closest);
+        EXPECT(closest.size() == points.size());
+
+        std::vector<std::vector<Search::PointValueType>> within;
+        search.closestWithinRadius(points, 1.e6, within);
+        EXPECT(within.size() == points.size());
+
+        std::vector<Search::PointValueType> one;
+        for (size_t i = 0; i < points.size(); ++i) {
+            reference.closestNPoints(points[i], 4, one);
+            EXPECT(distances(closest[i], points[i]) == distances(one, points[i]));
+
+            reference.closestWithinRadius(points[i], 1.e6, one);
+            EXPECT(distances(within[i], points[i]) == distances(one, points[i]));
+        }
+    }
+}
+
+
+}  // namespace eckit::geo::test
+
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
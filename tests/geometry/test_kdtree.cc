@@ -8,7 +8,11 @@
  * does it submit to any jurisdiction.
  */
 
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <list>
+#include <random>
 
 #include "eckit/container/KDTree.h"
 #include "eckit/geometry/Point2.h"
@@ -358,6 +362,49 @@ CASE("test_kdtree_mapped") {
     }
 }
 
+CASE("test_kdtree_build_parallel") {
+    using Tree  = KDTreeMapped<TestTreeTrait>;
+    using Point = Tree::PointType;
+
+    // large enough to be ordered in parallel (if OpenMP is available)
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dist(0., 1.);
+
+    std::vector<Tree::Value> points;
+    for (size_t i = 0; i < 200000; i++) {
+        points.emplace_back(Point(dist(gen), dist(gen)), double(i));
+    }
+
+    eckit::PathName path1("test_kdtree_build_parallel_1.kdtree");
+    eckit::PathName path2("test_kdtree_build_parallel_2.kdtree");
+
+    // Tree::build (parallel) builds the same tree (file) as KDNode::build (serial)
+    auto points1 = points;
+    {
+        Tree kd(path1, points1.size(), 0);
+        kd.build(points1);
+        EXPECT_EQUAL(kd.size(), points1.size());
+    }
+
+    auto points2 = points;
+    {
+        KDMapped alloc(path2, points2.size(), sizeof(Tree::Node), 0);
+        alloc.root(alloc.convert(Tree::Node::build(alloc, points2.begin(), points2.end())));
+    }
+
+    for (size_t i = 0; i < points.size(); i++) {
+        EXPECT(points1[i].payload() == points2[i].payload());
+    }
+
+    std::ifstream file1(path1.localPath(), std::ios::binary);
+    std::ifstream file2(path2.localPath(), std::ios::binary);
+    EXPECT(std::equal(std::istreambuf_iterator<char>(file1), std::istreambuf_iterator<char>(),
+                      std::istreambuf_iterator<char>(file2), std::istreambuf_iterator<char>()));
+
+    path1.unlink();
+    path2.unlink();
+}
+
 CASE("test_kdtree_iterate_empty") {
     using Tree = KDTreeMemory<TestTreeTrait>;
 
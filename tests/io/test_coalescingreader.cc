@@ -0,0 +1,192 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/CoalescingReader.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/MultiHandle.h"
+#include "eckit/io/PartFileHandle.h"
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const char buf1[] = "abcdefghijklmnopqrstuvwxyz01234";
+const char buf2[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ56789";
+
+class Tester {
+public:
+
+    Tester() {
+        std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+
+        path1_ = PathName::unique(base + "/path1");
+        path1_ += ".dat";
+
+        path2_ = PathName::unique(base + "/path2");
+        path2_ += ".dat";
+
+        FileHandle f1(path1_);
+        f1.openForWrite(0);
+        f1.write(buf1, sizeof(buf1) - 1);
+        f1.close();
+
+        FileHandle f2(path2_);
+        f2.openForWrite(0);
+        f2.write(buf2, sizeof(buf2) - 1);
+        f2.close();
+    }
+
+    ~Tester() {
+        bool verbose = false;
+        path1_.unlink(verbose);
+        path2_.unlink(verbose);
+    }
+
+    PathName path1_;
+    PathName path2_;
+};
+
+std::string readAll(CoalescingReader& reader, long chunk) {
+    std::string result;
+    std::vector<char> buffer(chunk);
+    long n;
+    while ((n = reader.read(buffer.data(), chunk)) > 0) {
+        result.append(buffer.data(), n);
+    }
+    return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Fragments are delivered in logical order") {
+
+    Tester test;
+
+    // window of 8 bytes, holes of up to 3 bytes are read through
+    CoalescingReader reader(8, 3);
+
+    reader.add(test.path1_, 20, 3);  // uvw
+    reader.add(test.path2_, 0, 2);   // AB
+    reader.add(test.path1_, 4, 2);   // ef
+    reader.add(test.path1_, 0, 2);   // ab
+    reader.add(test.path1_, 10, 0);  // empty
+    reader.add(test.path2_, 3, 4);   // DEFG
+    reader.add(test.path1_, 2, 4);   // cdef, overlaps
+
+    EXPECT(reader.size() == Length(17));
+
+    EXPECT_EQUAL(readAll(reader, 5), "uvwABefabDEFGcdef");
+    EXPECT(reader.position() == Offset(17));
+
+    // Every fragment was read, some of them with a single read
+    EXPECT(reader.fragmentsRead() >= 6);
+    EXPECT(reader.readsIssued() < reader.fragmentsRead());
+    EXPECT(reader.gapBytes() > 0);
+
+    SECTION("seek") {
+        reader.seek(5);
+        char b[6];
+        EXPECT(reader.read(b, 6) == 6);
+        EXPECT_EQUAL(std::string(b, 6), "efabDE");
+
+        EXPECT_THROWS_AS(reader.seek(18), AssertionFailed);
+        EXPECT(reader.position() == Offset(11));
+
+        reader.seek(17);
+        EXPECT(reader.read(b, 6) == 0);
+    }
+
+    SECTION("read larger than the window") {
+        reader.seek(1);
+        std::string all = readAll(reader, 64);
+        EXPECT_EQUAL(all, "vwABefabDEFGcdef");
+    }
+
+    reader.close();
+}
+
+CASE("Holes larger than the gap are not read") {
+
+    Tester test;
+
+    CoalescingReader reader(64, 2);
+
+    reader.add(test.path1_, 10, 2);  // kl
+    reader.add(test.path1_, 0, 2);   // ab
+    reader.add(test.path1_, 3, 2);   // de
+    reader.add(test.path1_, 20, 2);  // uv
+
+    EXPECT_EQUAL(readAll(reader, 64), "klabdeuv");
+
+    EXPECT(reader.fragmentsRead() == 4);
+    EXPECT(reader.readsIssued() == 3);
+    EXPECT(reader.gapBytes() == 1);
+}
+
+CASE("MultiHandle of PartFileHandles") {
+
+    Tester test;
+
+    MultiHandle mh;
+    mh += new PartFileHandle(test.path2_, OffsetList{23, 0}, LengthList{3, 3});
+    mh += new PartFileHandle(test.path1_, OffsetList{25, 0, 13}, LengthList{6, 3, 6});
+    mh += new PartFileHandle(test.path2_, 6, 4);
+
+    const std::string expected = "XYZABCz01234abcnopqrsGHIJ";
+
+    SECTION("saveInto") {
+        Buffer buffer(64);
+        MemoryHandle out(buffer);
+        EXPECT(mh.saveInto(out) == Length(expected.size()));
+        EXPECT_EQUAL(std::string(buffer, expected.size()), expected);
+    }
+
+    SECTION("seek and restart") {
+        mh.openForRead();
+
+        char b[10];
+        EXPECT(mh.read(b, 4) == 4);
+        EXPECT_EQUAL(std::string(b, 4), "XYZA");
+
+        mh.seek(15);
+        EXPECT(mh.position() == Offset(15));
+        EXPECT(mh.read(b, 10) == 10);
+        EXPECT_EQUAL(std::string(b, 10), "nopqrsGHIJ");
+
+        mh.restartReadFrom(9);
+        EXPECT(mh.read(b, 3) == 3);
+        EXPECT_EQUAL(std::string(b, 3), "234");
+
+        mh.rewind();
+        EXPECT(mh.read(b, 2) == 2);
+        EXPECT_EQUAL(std::string(b, 2), "XY");
+
+        mh.close();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,226 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <cstdlib>
+#include <string>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/DblBuffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/TransferWatcher.h"
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Tester {
+public:
+
+    Tester() {
+        std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+
+        in_ = PathName::unique(base + "/dblbuffer_in");
+        in_ += ".dat";
+
+        out_ = PathName::unique(base + "/dblbuffer_out");
+        out_ += ".dat";
+
+        // Not a multiple of the buffer size
+        for (size_t i = 0; i < 100003; ++i) {
+            data_ += char('a' + (i * 11) % 26);
+        }
+
+        FileHandle f(in_);
+        f.openForWrite(0);
+        f.write(data_.data(), data_.size());
+        f.close();
+    }
+
+    ~Tester() {
+        bool verbose = false;
+        in_.unlink(verbose);
+        if (out_.exists()) {
+            out_.unlink(verbose);
+        }
+    }
+
+    std::string output() const {
+        std::string result(size_t(out_.size()), ' ');
+        FileHandle f(out_);
+        f.openForRead();
+        EXPECT(f.read(&result[0], result.size()) == long(result.size()));
+        f.close();
+        return result;
+    }
+
+    PathName in_;
+    PathName out_;
+    std::string data_;
+};
+
+class Counter : public TransferWatcher {
+public:
+
+    explicit Counter(bool needsData) : needsData_(needsData) {}
+
+    void watch(const void* p, long n) override {
+        bytes_ += n;
+        if (p) {
+            seen_.append(static_cast<const char*>(p), n);
+        }
+    }
+
+    bool needsData() const override { return needsData_; }
+
+    bool needsData_;
+    long long bytes_ = 0;
+    std::string seen_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Several readers and writers") {
+
+    Tester test;
+
+    SECTION("positional writes") {
+        Counter watcher(false);
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+
+        DblBuffer buffer(4, 4096, watcher, 3, 2);
+        EXPECT(buffer.copy(in, out) == Length(test.data_.size()));
+        EXPECT(test.output() == test.data_);
+        EXPECT(watcher.bytes_ == (long long)test.data_.size());
+    }
+
+    SECTION("watcher looking at the data") {
+        Counter watcher(true);
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+
+        DblBuffer buffer(4, 4096, watcher, 3, 2);
+        EXPECT(buffer.copy(in, out) == Length(test.data_.size()));
+        EXPECT(test.output() == test.data_);
+        EXPECT(watcher.seen_ == test.data_);
+    }
+
+    SECTION("single stream") {
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+
+        DblBuffer buffer(4, 4096, TransferWatcher::dummy(), 1, 1);
+        EXPECT(buffer.copy(in, out) == Length(test.data_.size()));
+        EXPECT(test.output() == test.data_);
+    }
+}
+
+CASE("Streams between opened handles") {
+
+    Tester test;
+
+    Buffer memory(test.data_.size());
+    MemoryHandle out(memory);
+    FileHandle in(test.in_);
+
+    in.openForRead();
+    out.openForWrite(0);
+
+    char head[7];
+    EXPECT(in.read(head, sizeof(head)) == long(sizeof(head)));
+    EXPECT(out.write(head, sizeof(head)) == long(sizeof(head)));
+
+    Length rest = Length(test.data_.size() - sizeof(head));
+
+    DblBuffer single(4, 4096, TransferWatcher::dummy(), 1, 1);
+    EXPECT(single.copyStreams(in, out, rest) == Length(0));
+
+    // MemoryHandle has no positional writes, the chunks are written in order
+    DblBuffer streams(3, 1000, TransferWatcher::dummy(), 4, 4);
+    EXPECT(streams.copyStreams(in, out, rest) == rest);
+
+    EXPECT(in.position() == Offset(test.data_.size()));
+    EXPECT(out.position() == Offset(test.data_.size()));
+
+    in.close();
+    out.close();
+
+    EXPECT(std::string(memory, test.data_.size()) == test.data_);
+}
+
+CASE("Streams to a file written to before") {
+
+    Tester test;
+
+    FileHandle in(test.in_);
+    FileHandle out(test.out_);
+
+    in.openForRead();
+    out.openForWrite(0);
+
+    char head[7];
+    EXPECT(in.read(head, sizeof(head)) == long(sizeof(head)));
+    EXPECT(out.write(head, sizeof(head)) == long(sizeof(head)));
+
+    Length rest = Length(test.data_.size() - sizeof(head));
+
+    // The rest is written with pwrite(), after the head
+    DblBuffer streams(3, 1000, TransferWatcher::dummy(), 4, 4);
+    EXPECT(streams.copyStreams(in, out, rest) == rest);
+
+    in.close();
+    out.close();
+
+    EXPECT(test.output() == test.data_);
+}
+
+CASE("Seekable handles without positional reads use a single stream") {
+
+    Tester test;
+
+    Buffer memory(test.data_.data(), test.data_.size());
+    MemoryHandle in(memory);
+    FileHandle out(test.out_);
+
+    // MemoryHandle can seek, but would pread by seeking back and forth
+    EXPECT(in.canSeek());
+    EXPECT(!in.canPread());
+
+    in.openForRead();
+    out.openForWrite(0);
+
+    DblBuffer streams(3, 1000, TransferWatcher::dummy(), 4, 4);
+    EXPECT(streams.copyStreams(in, out, Length(test.data_.size())) == Length(0));
+    EXPECT(in.position() == Offset(0));
+
+    in.close();
+    out.close();
+
+    DblBuffer buffer(3, 1000, TransferWatcher::dummy(), 4, 4);
+    EXPECT(buffer.copy(in, out) == Length(test.data_.size()));
+    EXPECT(test.output() == test.data_);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    // Exercise the threads rather than the kernel copy
+    ::setenv("ECKIT_ZERO_COPY", "0", 1);
+    return run_tests(argc, argv);
+}
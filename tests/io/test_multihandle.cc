@@ -318,6 +318,35 @@ CASE("Multihandle") {
         }
     }
 
+    SECTION("Multihandle positional reads") {
+
+        MultiHandle mh;
+        mh += new FileHandle(test.path1_);
+        mh += new PartFileHandle(test.path2_, ol1, ll1);
+        mh += new FileHandle(test.path1_);
+
+        // abcdefghijklmnopqrstuvwxyz01234 + ACDGHIJNOPQRSXYZ56789 + abcdefghijklmnopqrstuvwxyz01234
+
+        Buffer buff = Tester::makeBuffer();
+        EXPECT(mh.pread(buff, 10, 26) == 10);
+        EXPECT_EQUAL(std::string(buff), "01234ACDGH");
+
+        buff.zero();
+        EXPECT(mh.pread(buff, 20, 45) == 20);
+        EXPECT_EQUAL(std::string(buff), "YZ56789abcdefghijklm");
+
+        buff.zero();
+        EXPECT(mh.pread(buff, 10, 80) == 3);
+        EXPECT_EQUAL(std::string(buff), "234");
+
+        Buffer b1 = Tester::makeBuffer();
+        Buffer b2 = Tester::makeBuffer();
+        std::vector<ReadRange> ranges{{b1, 3, 29}, {b2, 4, 52}};
+        EXPECT(mh.readv(ranges) == Length(7));
+        EXPECT_EQUAL(std::string(b1), "34A");
+        EXPECT_EQUAL(std::string(b2), "abcd");
+    }
+
     SECTION("Multihandle seek in FileHandle") {
 
         MultiHandle mh;
@@ -8,7 +8,10 @@
  * does it submit to any jurisdiction.
  */
 
+#include <atomic>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 #include "eckit/config/Resource.h"
 #include "eckit/filesystem/PathName.h"
@@ -187,6 +190,136 @@ CASE("PartFileHandle with multiple parts") {
     ph.close();
 }
 
+CASE("PartFileHandle positional reads") {
+
+    Tester test;
+
+    OffsetList ol1 = {0, 2, 6, 13, 23};
+    LengthList ll1 = {1, 2, 4, 6, 8};
+
+    PartFileHandle ph(test.path1_, ol1, ll1);
+
+    // acdghijnopqrsxyz01234, the handle does not need to be opened
+
+    SECTION("pread") {
+        Buffer buff = Tester::makeBuffer();
+        EXPECT(ph.pread(buff, 12, 5) == 12);
+        EXPECT_EQUAL(std::string(buff), "ijnopqrsxyz0");
+
+        buff.zero();
+        EXPECT(ph.pread(buff, 10, 17) == 4);
+        EXPECT_EQUAL(std::string(buff), "1234");
+
+        EXPECT(ph.pread(buff, 10, 21) == 0);
+    }
+
+    SECTION("pread does not move the position") {
+        ph.openForRead();
+        ph.seek(3);
+
+        Buffer buff = Tester::makeBuffer();
+        EXPECT(ph.pread(buff, 3, 13) == 3);
+        EXPECT_EQUAL(std::string(buff), "xyz");
+
+        buff.zero();
+        EXPECT(ph.position() == Offset(3));
+        EXPECT(ph.read(buff, 4) == 4);
+        EXPECT_EQUAL(std::string(buff), "ghij");
+
+        ph.close();
+    }
+
+    SECTION("readv") {
+        Buffer b1 = Tester::makeBuffer();
+        Buffer b2 = Tester::makeBuffer();
+        Buffer b3 = Tester::makeBuffer();
+
+        std::vector<ReadRange> ranges{{b1, 4, 0}, {b2, 5, 4}, {b3, 20, 15}};
+        EXPECT(ph.readv(ranges) == Length(4 + 5 + 6));
+        EXPECT_EQUAL(std::string(b1), "acdg");
+        EXPECT_EQUAL(std::string(b2), "hijno");
+        EXPECT_EQUAL(std::string(b3), "z01234");
+    }
+
+    SECTION("readv past the end of the file") {
+        PartFileHandle truncated(test.path1_, OffsetList{20, 29}, LengthList{2, 10});
+
+        Buffer b1 = Tester::makeBuffer();
+        Buffer b2 = Tester::makeBuffer();
+
+        std::vector<ReadRange> ranges{{b1, 2, 0}, {b2, 10, 2}};
+        EXPECT(truncated.readv(ranges) == Length(2 + 2));
+        EXPECT_EQUAL(std::string(b1), "uv");
+        EXPECT_EQUAL(std::string(b2), "34");
+    }
+
+    SECTION("concurrent pread") {
+        const std::string expected = "acdghijnopqrsxyz01234";
+
+        std::vector<std::thread> threads;
+        std::vector<int> errors(8, 0);
+        for (size_t t = 0; t < errors.size(); ++t) {
+            threads.emplace_back([&, t] {
+                for (long i = 0; i < 1000; ++i) {
+                    long from = (t + i) % 21;
+                    long len  = 1 + (i % 7);
+                    char buff[8];
+                    long n = ph.pread(buff, len, from);
+                    if (std::string(buff, n) != expected.substr(from, len)) {
+                        errors[t]++;
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (int e : errors) {
+            EXPECT(e == 0);
+        }
+    }
+
+    SECTION("pread while the handle is opened and closed") {
+        const std::string expected = "acdghijnopqrsxyz01234";
+
+        std::atomic<bool> done{false};
+        std::vector<std::thread> threads;
+        std::vector<int> errors(4, 0);
+        for (size_t t = 0; t < errors.size(); ++t) {
+            threads.emplace_back([&, t] {
+                for (long i = 0; !done; ++i) {
+                    long from = (t + i) % 21;
+                    long len  = 1 + (i % 7);
+                    char buff[8];
+                    try {
+                        long n = ph.pread(buff, len, from);
+                        if (std::string(buff, n) != expected.substr(from, len)) {
+                            errors[t]++;
+                        }
+                    }
+                    catch (std::exception&) {
+                        errors[t]++;
+                    }
+                }
+            });
+        }
+
+        // n.b. closing the handle closes the descriptor once the reads using it complete
+        for (size_t i = 0; i < 10000; ++i) {
+            ph.openForRead();
+            ph.close();
+        }
+        done = true;
+
+        for (auto& t : threads) {
+            t.join();
+        }
+        for (int e : errors) {
+            EXPECT(e == 0);
+        }
+    }
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 }  // namespace eckit::test
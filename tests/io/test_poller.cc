@@ -0,0 +1,176 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <unistd.h>
+
+#include <array>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/io/Poller.h"
+#include "eckit/io/Select.h"
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Pipes {
+public:
+
+    explicit Pipes(size_t n) : fds_(n) {
+        for (auto& p : fds_) {
+            SYSCALL(::pipe(p.data()));
+        }
+    }
+
+    ~Pipes() {
+        for (auto& p : fds_) {
+            ::close(p[0]);
+            ::close(p[1]);
+        }
+    }
+
+    int in(size_t i) const { return fds_[i][0]; }
+    int out(size_t i) const { return fds_[i][1]; }
+
+    void write(size_t i) const { ASSERT(::write(out(i), "x", 1) == 1); }
+
+    void read(size_t i) const {
+        char c;
+        ASSERT(::read(in(i), &c, 1) == 1);
+    }
+
+private:
+
+    std::vector<std::array<int, 2>> fds_;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Poller reports reads and writes") {
+    if (!Poller::available()) {
+        return;
+    }
+
+    Pipes pipes(2);
+    Poller poller;
+
+    poller.add(pipes.in(0));
+    poller.add(pipes.in(1));
+    poller.add(pipes.out(0), Poller::Write);
+
+    EXPECT(poller.wait(0) == 1);
+    EXPECT(poller.writable(pipes.out(0)));
+    EXPECT(!poller.readable(pipes.in(0)));
+
+    pipes.write(1);
+
+    EXPECT(poller.wait(1000) == 2);
+    EXPECT(poller.readable(pipes.in(1)));
+    EXPECT(!poller.readable(pipes.in(0)));
+
+    poller.remove(pipes.out(0));
+    pipes.read(1);
+
+    EXPECT(poller.wait(0) == 0);
+    EXPECT(poller.size() == 2);
+}
+
+CASE("Poller edge-triggered") {
+    if (!Poller::available()) {
+        return;
+    }
+
+    Pipes pipes(2);
+    Poller poller;
+
+    poller.add(pipes.in(0), Poller::Read, true);
+    poller.add(pipes.in(1), Poller::Read);
+
+    pipes.write(0);
+    pipes.write(1);
+
+    EXPECT(poller.wait(1000) == 2);
+
+    // The data is still pending, but only reported again when more arrives
+
+    EXPECT(poller.wait(0) == 1);
+    EXPECT(poller.readable(pipes.in(1)));
+
+    pipes.write(0);
+    EXPECT(poller.wait(1000) == 2);
+    EXPECT(poller.readable(pipes.in(0)));
+}
+
+CASE("Poller timers") {
+    if (!Poller::available()) {
+        return;
+    }
+
+    Pipes pipes(1);
+    Poller poller;
+
+    poller.add(pipes.in(0));
+    int once   = poller.addTimer(10);
+    int repeat = poller.addTimer(20, true);
+
+    EXPECT(poller.wait(1000) == 1);
+    EXPECT(poller.expired(once));
+    EXPECT(!poller.readable(once));
+
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT(poller.wait(1000) == 1);
+        EXPECT(poller.expired(repeat));
+    }
+
+    poller.removeTimer(repeat);
+    EXPECT(poller.wait(50) == 0);
+}
+
+CASE("Select on many descriptors") {
+
+    // Below and above the threshold to switch to a Poller
+
+    for (size_t n : {4, 200}) {
+        Pipes pipes(n);
+        Select select;
+
+        for (size_t i = 0; i < n; ++i) {
+            select.add(pipes.in(i));
+        }
+
+        EXPECT(!select.ready(0));
+
+        pipes.write(1);
+        pipes.write(n - 1);
+
+        EXPECT(select.ready(1));
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT(select.set(pipes.in(i)) == (i == 1 || i == n - 1));
+        }
+
+        select.remove(pipes.in(1));
+        pipes.read(n - 1);
+
+        EXPECT(!select.ready(0));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,295 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/io/Buffer.h"
+#include "eckit/io/DblBuffer.h"
+#include "eckit/io/FileHandle.h"
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/PooledHandle.h"
+#include "eckit/io/TransferWatcher.h"
+#include "eckit/io/ZeroCopy.h"
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Tester {
+public:
+
+    Tester() {
+        std::string base = Resource<std::string>("$TMPDIR", "/tmp");
+
+        in_ = PathName::unique(base + "/zerocopy_in");
+        in_ += ".dat";
+
+        out_ = PathName::unique(base + "/zerocopy_out");
+        out_ += ".dat";
+
+        for (size_t i = 0; i < 300000; ++i) {
+            data_ += char('a' + (i * 7) % 26);
+        }
+
+        FileHandle f(in_);
+        f.openForWrite(0);
+        f.write(data_.data(), data_.size());
+        f.close();
+    }
+
+    ~Tester() {
+        bool verbose = false;
+        in_.unlink(verbose);
+        if (out_.exists()) {
+            out_.unlink(verbose);
+        }
+    }
+
+    std::string output() const {
+        std::string result(size_t(out_.size()), ' ');
+        FileHandle f(out_);
+        f.openForRead();
+        EXPECT(f.read(&result[0], result.size()) == long(result.size()));
+        f.close();
+        return result;
+    }
+
+    PathName in_;
+    PathName out_;
+    std::string data_;
+};
+
+/// Counts the bytes, and optionally asks to see them
+class Counter : public TransferWatcher {
+public:
+
+    explicit Counter(bool needsData) : needsData_(needsData) {}
+
+    void watch(const void* p, long n) override {
+        bytes_ += n;
+        calls_++;
+        nulls_ += (p == nullptr && n > 0);
+    }
+
+    bool needsData() const override { return needsData_; }
+
+    bool needsData_;
+    long long bytes_ = 0;
+    size_t calls_    = 0;
+    size_t nulls_    = 0;
+};
+
+/// Reads from a pipe, so that zeroCopy() splices
+class PipeHandle : public DataHandle {
+public:
+
+    explicit PipeHandle(int fd) : fd_(fd) {}
+
+    void print(std::ostream& s) const override { s << "PipeHandle[fd=" << fd_ << "]"; }
+
+    Length openForRead() override { return 0; }
+    long read(void* buffer, long length) override { return ::read(fd_, buffer, length); }
+    void close() override {}
+
+    int fileDescriptor() override { return fd_; }
+
+private:
+
+    int fd_;
+};
+
+/// Counts the bytes written through write(), rather than through the descriptor
+class CountingFileHandle : public FileHandle {
+public:
+
+    using FileHandle::FileHandle;
+
+    long write(const void* buffer, long length) override {
+        written_ += length;
+        return FileHandle::write(buffer, length);
+    }
+
+    long long written_ = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("saveInto between files") {
+
+    Tester test;
+
+    SECTION("watcher without data") {
+        Counter watcher(false);
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+
+        EXPECT(in.saveInto(out, watcher) == Length(test.data_.size()));
+        EXPECT(test.output() == test.data_);
+        EXPECT(watcher.bytes_ == (long long)test.data_.size());
+    }
+
+    SECTION("watcher with data") {
+        Counter watcher(true);
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+
+        EXPECT(in.saveInto(out, watcher) == Length(test.data_.size()));
+        EXPECT(test.output() == test.data_);
+        EXPECT(watcher.bytes_ == (long long)test.data_.size());
+        EXPECT(watcher.nulls_ == 0);
+    }
+}
+
+CASE("Transfer resumes from the position of the handles") {
+
+    Tester test;
+
+    FileHandle in(test.in_);
+    FileHandle out(test.out_);
+
+    in.openForRead();
+    out.openForWrite(0);
+
+    char head[10];
+    EXPECT(in.read(head, sizeof(head)) == long(sizeof(head)));
+    EXPECT(out.write(head, sizeof(head)) == long(sizeof(head)));
+
+    Counter watcher(false);
+    Length moved = zeroCopy(in, out, 100000, 4096, watcher);
+
+    EXPECT(moved == Length(100000));
+    EXPECT(in.position() == Offset(100010));
+    EXPECT(out.position() == Offset(100010));
+    EXPECT(watcher.nulls_ == watcher.calls_);
+
+    // The buffered path carries on from there
+    char buffer[8192];
+    long n;
+    while ((n = in.read(buffer, sizeof(buffer))) > 0) {
+        EXPECT(out.write(buffer, n) == n);
+    }
+
+    in.close();
+    out.close();
+
+    EXPECT(test.output() == test.data_);
+}
+
+CASE("Handles without a file descriptor use buffers") {
+
+    Tester test;
+
+    Buffer buffer(test.data_.size());
+    MemoryHandle out(buffer);
+    FileHandle in(test.in_);
+
+    in.openForRead();
+    out.openForWrite(0);
+
+    Counter watcher(false);
+    EXPECT(zeroCopy(in, out, 0, 4096, watcher) == Length(0));
+    EXPECT(watcher.calls_ == 0);
+
+    in.close();
+    out.close();
+
+    EXPECT(in.saveInto(out) == Length(test.data_.size()));
+    EXPECT(std::string(buffer, test.data_.size()) == test.data_);
+}
+
+CASE("PooledHandle and DblBuffer") {
+
+    Tester test;
+
+    SECTION("PooledHandle") {
+        PooledHandle in(test.in_);
+        FileHandle out(test.out_);
+
+        EXPECT(in.saveInto(out) == Length(test.data_.size()));
+        EXPECT(test.output() == test.data_);
+    }
+
+    SECTION("DblBuffer") {
+        FileHandle in(test.in_);
+        FileHandle out(test.out_);
+
+        DblBuffer buffer(2, 4096);
+        EXPECT(buffer.copy(in, out) == Length(test.data_.size()));
+        EXPECT(test.output() == test.data_);
+    }
+}
+
+CASE("Bytes spliced but not accepted by the target are drained to its descriptor") {
+
+    Tester test;
+
+    int fds[2];
+    EXPECT(::pipe(fds) == 0);
+
+    std::thread writer([&] {
+        const char* p = test.data_.data();
+        size_t left   = test.data_.size();
+        while (left > 0) {
+            ssize_t n = ::write(fds[1], p, left);
+            ASSERT(n > 0);
+            p += n;
+            left -= n;
+        }
+        ::close(fds[1]);
+    });
+
+    // The kernel does not splice to files opened for append: the second splice fails, for each chunk
+
+    {
+        FileHandle out(test.out_);
+        out.openForWrite(0);
+        EXPECT(out.write("head", 4) == 4);
+        out.close();
+    }
+
+    PipeHandle in(fds[0]);
+    CountingFileHandle out(test.out_);
+    out.openForAppend(0);
+    EXPECT(out.write("more", 4) == 4);
+
+    Counter watcher(false);
+    Length moved = zeroCopy(in, out, test.data_.size(), 4096, watcher);
+
+    writer.join();
+    ::close(fds[0]);
+
+    EXPECT(moved == Length(test.data_.size()));
+    EXPECT(out.position() == Offset(test.data_.size() + 8));
+
+    // Not through the buffer of the handle, where transferred() would overwrite them in a file not opened for append
+    EXPECT(out.written_ == 4);
+
+    EXPECT(out.write("tail", 4) == 4);
+    out.close();
+
+    EXPECT(test.output() == "headmore" + test.data_ + "tail");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,129 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "eckit/config/Resource.h"
+#include "eckit/filesystem/PathName.h"
+#include "eckit/linalg/LinearAlgebraSparse.h"
+#include "eckit/linalg/Matrix.h"
+#include "eckit/linalg/SparseMatrix.h"
+#include "eckit/linalg/Triplet.h"
+#include "eckit/linalg/Vector.h"
+#include "eckit/log/Timer.h"
+#include "eckit/utils/Tokenizer.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+using linalg::Matrix;
+using linalg::Scalar;
+using linalg::Size;
+using linalg::SparseMatrix;
+using linalg::Triplet;
+using linalg::Vector;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define REPEAT 10
+
+/// Interpolation-like matrix: each row weights the stencil x stencil points of a source grid around its position
+SparseMatrix interpolation_matrix(Size nx, Size ny, Size stencil) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<Scalar> pos(0., 1.);
+
+    const Size rows = nx * ny * 2;
+
+    std::vector<Triplet> triplets;
+    triplets.reserve(rows * stencil * stencil);
+
+    for (Size i = 0; i < rows; ++i) {
+        auto x0 = std::min(static_cast<Size>(pos(gen) * Scalar(nx - stencil)), nx - stencil);
+        auto y0 = std::min(static_cast<Size>(pos(gen) * Scalar(ny - stencil)), ny - stencil);
+        for (Size y = 0; y < stencil; ++y) {
+            for (Size x = 0; x < stencil; ++x) {
+                triplets.emplace_back(i, (y0 + y) * nx + x0 + x, 1. / Scalar(stencil * stencil));
+            }
+        }
+    }
+
+    return {rows, nx * ny, triplets};
+}
+
+void benchmark(const std::string& name, const SparseMatrix& A) {
+    std::cout << "-------------------------------------------------------------" << std::endl;
+    std::cout << name << ": " << A.rows() << " x " << A.cols() << ", " << A.nonZeros() << " non-zeros" << std::endl;
+
+    Vector x(A.cols());
+    for (Size j = 0; j < A.cols(); ++j) {
+        x[j] = Scalar(j % 17);
+    }
+    Vector y(A.rows());
+
+    for (const std::string backend : {"generic", "optimised"}) {
+        const auto& la = linalg::LinearAlgebraSparse::getBackend(backend);
+
+        {
+            Timer timer(backend + " spmv");
+            for (size_t r = 0; r < REPEAT; ++r) {
+                la.spmv(A, x, y);
+            }
+        }
+
+        for (Size Nk : {3, 10}) {
+            Matrix B(A.cols(), Nk);
+            B.setZero();
+            Matrix C(A.rows(), Nk);
+
+            Timer timer(backend + " spmm " + std::to_string(Nk) + " columns");
+            for (size_t r = 0; r < REPEAT; ++r) {
+                la.spmm(A, B, C);
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("benchmark_la_sparse") {
+
+    // Interpolation matrices saved with SparseMatrix::save(), separated by ':'
+    std::string matrices = Resource<std::string>("$ECKIT_LINALG_BENCHMARK_MATRICES", "");
+
+    std::vector<std::string> paths;
+    Tokenizer(":")(matrices, paths);
+
+    for (const auto& path : paths) {
+        SparseMatrix A;
+        A.load(path);
+        benchmark(path, A);
+    }
+
+    if (paths.empty()) {
+        benchmark("bilinear", interpolation_matrix(500, 250, 2));
+        benchmark("bicubic", interpolation_matrix(500, 250, 4));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,223 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/linalg/CompactSparseMatrix.h"
+#include "eckit/linalg/LinearAlgebraSparse.h"
+#include "eckit/linalg/Triplet.h"
+#include "eckit/memory/MemoryBuffer.h"
+#include "util.h"
+
+namespace eckit::test {
+
+using linalg::Matrix;
+using linalg::Scalar;
+using linalg::Size;
+using linalg::SparseMatrix;
+using linalg::SparseMatrixFloat;
+using linalg::SparseMatrixFloatLarge;
+using linalg::SparseMatrixLarge;
+using linalg::Triplet;
+using linalg::Vector;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Interpolation-like weights, exactly representable in float
+SparseMatrix random_matrix(Size Ni, Size Nj) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<Size> nnz(0, 16);
+    std::uniform_int_distribution<Size> col(0, Nj - 1);
+    std::uniform_int_distribution<int> val(1, 64);
+
+    std::vector<Triplet> triplets;
+    for (Size i = 0; i < Ni; ++i) {
+        std::vector<bool> used(Nj, false);
+        for (Size n = nnz(gen); n > 0; --n) {
+            auto j = col(gen);
+            if (!used[j]) {
+                used[j] = true;
+                triplets.emplace_back(i, j, Scalar(val(gen)) / 64.);
+            }
+        }
+    }
+
+    return {Ni, Nj, triplets};
+}
+
+template <typename T>
+bool approximately_equal(const T* a, const Scalar* b, Size size, double eps) {
+    for (Size i = 0; i < size; ++i) {
+        if (std::abs(double(a[i]) - b[i]) > eps * (1. + std::abs(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename M>
+bool same_entries(const M& A, const SparseMatrix& B) {
+    if (A.rows() != B.rows() || A.cols() != B.cols() || A.nonZeros() != B.nonZeros()) {
+        return false;
+    }
+    for (Size i = 0; i <= A.rows(); ++i) {
+        if (Size(A.outer()[i]) != Size(B.outerIndex()[i])) {
+            return false;
+        }
+    }
+    for (Size n = 0; n < A.nonZeros(); ++n) {
+        if (Size(A.inner()[n]) != Size(B.inner()[n]) || Scalar(A.data()[n]) != B.data()[n]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("products match the generic backend") {
+    const Size Ni = 1000;
+    const Size Nj = 300;
+
+    const auto A = random_matrix(Ni, Nj);
+    const SparseMatrixFloat F(A);
+    const SparseMatrixFloatLarge L(A);
+
+    EXPECT(same_entries(F, A));
+    EXPECT(same_entries(L, A));
+
+    const auto& generic = linalg::LinearAlgebraSparse::getBackend("generic");
+
+    SECTION("spmv") {
+        Vector x(Nj);
+        std::vector<float> xf(Nj);
+        for (Size j = 0; j < Nj; ++j) {
+            x[j] = xf[j] = float(std::sin(Scalar(j)));
+        }
+
+        Vector y(Ni);
+        generic.spmv(A, x, y);
+
+        Vector z(Ni);
+        F.spmv(x, z);
+        EXPECT(approximately_equal(z.data(), y.data(), Ni, 1e-12));
+
+        std::vector<float> zf(Ni);
+        F.spmv(xf.data(), zf.data());
+        EXPECT(approximately_equal(zf.data(), y.data(), Ni, 1e-6));
+
+        std::vector<double> zd(Ni);
+        L.spmv(xf.data(), zd.data());
+        EXPECT(approximately_equal(zd.data(), y.data(), Ni, 1e-12));
+    }
+
+    SECTION("spmm") {
+        for (Size Nk : {1, 3, 8, 13}) {
+            Matrix B(Nj, Nk);
+            std::vector<float> Bf(Nj * Nk);
+            for (Size k = 0; k < Nk; ++k) {
+                for (Size j = 0; j < Nj; ++j) {
+                    B(j, k) = Bf[k * Nj + j] = float(std::cos(Scalar(j + 7 * k)));
+                }
+            }
+
+            Matrix C(Ni, Nk);
+            generic.spmm(A, B, C);
+
+            Matrix D(Ni, Nk);
+            L.spmm(B, D);
+            EXPECT(approximately_equal(D.data(), C.data(), Ni * Nk, 1e-12));
+
+            std::vector<float> Df(Ni * Nk);
+            F.spmm(Bf.data(), Df.data(), Nk);
+            EXPECT(approximately_equal(Df.data(), C.data(), Ni * Nk, 1e-6));
+        }
+    }
+}
+
+
+CASE("conversions") {
+    const auto A = random_matrix(200, 100);
+
+    SparseMatrixFloat F(A);
+    EXPECT(same_entries(F, F.sparseMatrix()));
+    EXPECT(same_entries(SparseMatrixLarge(A), A));
+    EXPECT(F.footprint() < SparseMatrixLarge(A).footprint());
+
+    std::vector<Triplet> triplets{{0, 1, 0.5}, {0, 3, 0.25}, {2, 0, 1.}};
+    EXPECT(same_entries(SparseMatrixFloatLarge(3, 4, triplets), SparseMatrix(3, 4, triplets)));
+}
+
+
+CASE("save and load, recording the precision") {
+    const auto A = random_matrix(200, 100);
+
+    PathName path = PathName::unique(PathName(".") / "compact_sparse") + ".mat";
+
+    SECTION("stream") {
+        SparseMatrixFloat(A).save(path);
+
+        SparseMatrix B;
+        B.load(path);
+        EXPECT(same_entries(SparseMatrixFloat(B), A));
+
+        SparseMatrixLarge C;
+        C.load(path);
+        EXPECT(same_entries(C, A));
+
+        A.save(path);
+
+        SparseMatrixFloatLarge D;
+        D.load(path);
+        EXPECT(same_entries(D, A));
+
+        path.unlink();
+    }
+
+    SECTION("dump") {
+        SparseMatrixFloatLarge L(A);
+
+        MemoryBuffer buffer(L.dumpSize());
+        L.dump(buffer.data(), buffer.size());
+
+        SparseMatrixFloat F;
+        F.load(buffer.data(), buffer.size());
+        EXPECT(same_entries(F, A));
+
+        // SparseMatrix uses dumps in place, without conversion
+        SparseMatrix::Layout layout;
+        SparseMatrix::Shape shape;
+        EXPECT_THROWS_AS(SparseMatrix::load(buffer.data(), buffer.size(), layout, shape), BadValue);
+
+        linalg::CompactSparseMatrix<Scalar, linalg::Index> S(A);
+        MemoryBuffer same(S.dumpSize());
+        S.dump(same.data(), same.size());
+        SparseMatrix::load(same.data(), same.size(), layout, shape);
+        EXPECT(shape.nonZeros() == A.nonZeros());
+        EXPECT(equal_array(static_cast<const Scalar*>(layout.data_), A.data(), A.nonZeros()));
+
+        // unversioned dumps of SparseMatrix
+        MemoryBuffer old(A.footprint() + 1024);
+        A.dump(old);
+        F.load(old.data(), old.size());
+        EXPECT(same_entries(F, A));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,129 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "eckit/io/FileHandle.h"
+#include "eckit/linalg/SparseMatrixCache.h"
+#include "eckit/linalg/Triplet.h"
+#include "eckit/linalg/allocator/MappedAllocator.h"
+#include "eckit/testing/Filesystem.h"
+#include "util.h"
+
+namespace eckit::test {
+
+using linalg::Scalar;
+using linalg::Size;
+using linalg::SparseMatrix;
+using linalg::SparseMatrixCache;
+using linalg::SparseMatrixCacheTraits;
+using linalg::Triplet;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+SparseMatrix matrix(Size N) {
+    std::vector<Triplet> triplets;
+    for (Size i = 0; i < N; ++i) {
+        triplets.emplace_back(i, (i * 7) % N, Scalar(i) + 0.5);
+        triplets.emplace_back(i, N, 1.);
+    }
+    return {N, N + 1, triplets};
+}
+
+bool same(const SparseMatrix& A, const SparseMatrix& B) {
+    return A.rows() == B.rows() && A.cols() == B.cols() && A.nonZeros() == B.nonZeros() &&
+           equal_array(A.outerIndex(), B.outerIndex(), A.rows() + 1) &&
+           equal_array(A.inner(), B.inner(), A.nonZeros()) && equal_array(A.data(), B.data(), A.nonZeros());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("MappedAllocator") {
+    const auto A = matrix(1000);
+
+    PathName path = PathName::unique(PathName(".") / "mapped") + ".spm";
+    linalg::allocator::MappedAllocator::save(A, path);
+
+    {
+        SparseMatrix B(new linalg::allocator::MappedAllocator(path));
+        EXPECT(B.inSharedMemory());
+        EXPECT(same(A, B));
+
+        // sections are aligned
+        EXPECT(reinterpret_cast<uintptr_t>(B.data()) % 64 == 0);
+        EXPECT(reinterpret_cast<uintptr_t>(B.outerIndex()) % 64 == 0);
+        EXPECT(reinterpret_cast<uintptr_t>(B.inner()) % 64 == 0);
+    }
+
+    path.unlink();
+}
+
+
+CASE("SparseMatrixCache") {
+    PathName root("la_sparse_cache.dir");
+    if (root.exists()) {
+        testing::deldir(root);
+    }
+    root.mkdir();
+
+    const SparseMatrixCache cache(root, 0);
+    const auto A = matrix(1000);
+
+    size_t created = 0;
+    auto creator   = [&](SparseMatrix& value) {
+        ++created;
+        value = A;
+    };
+
+    SECTION("create once, then map") {
+        for (size_t n = 0; n < 3; ++n) {
+            auto B = cache.getOrCreate("key", creator);
+            EXPECT(B.inSharedMemory());
+            EXPECT(same(A, B));
+        }
+        EXPECT(created == 1);
+
+        cache.getOrCreate("other", creator);
+        EXPECT(created == 2);
+    }
+
+    SECTION("invalid entries are created again") {
+        PathName entry = root / SparseMatrixCacheTraits::name() / std::to_string(SparseMatrixCacheTraits::version()) /
+                         "truncated" + SparseMatrixCacheTraits::extension();
+
+        cache.getOrCreate("truncated", creator);
+        EXPECT(created == 1);
+        EXPECT(entry.exists());
+
+        // drop the trailer
+        auto size = entry.size();
+        SYSCALL(::chmod(entry.localPath(), 0644));
+        SYSCALL(::truncate(entry.localPath(), static_cast<off_t>(size) - 64));
+
+        auto B = cache.getOrCreate("truncated", creator);
+        EXPECT(created == 2);
+        EXPECT(same(A, B));
+        EXPECT(entry.size() == size);
+    }
+
+    testing::deldir(root);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,137 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation
+ * nor does it submit to any jurisdiction.
+ */
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "eckit/linalg/LinearAlgebraSparse.h"
+#include "eckit/linalg/Triplet.h"
+#include "eckit/linalg/sparse/LinearAlgebraOptimised.h"
+#include "util.h"
+
+namespace eckit::test {
+
+using linalg::Matrix;
+using linalg::Scalar;
+using linalg::Size;
+using linalg::SparseMatrix;
+using linalg::Triplet;
+using linalg::Vector;
+using linalg::sparse::LinearAlgebraOptimised;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Rows of 0 to 20 non-zeros, covering the vector kernels and their remainders
+SparseMatrix random_matrix(Size Ni, Size Nj) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<Size> nnz(0, 20);
+    std::uniform_int_distribution<Size> col(0, Nj - 1);
+    std::uniform_real_distribution<Scalar> val(-1., 1.);
+
+    std::vector<Triplet> triplets;
+    for (Size i = 0; i < Ni; ++i) {
+        std::vector<bool> used(Nj, false);
+        for (Size n = nnz(gen); n > 0; --n) {
+            auto j = col(gen);
+            if (!used[j]) {
+                used[j] = true;
+                triplets.emplace_back(i, j, val(gen));
+            }
+        }
+    }
+
+    return {Ni, Nj, triplets};
+}
+
+bool approximately_equal(const Scalar* a, const Scalar* b, Size size) {
+    for (Size i = 0; i < size; ++i) {
+        if (std::abs(a[i] - b[i]) > 1e-12 * (1. + std::abs(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("optimised backend matches the generic backend") {
+    const Size Ni = 1000;
+    const Size Nj = 300;
+
+    const auto A = random_matrix(Ni, Nj);
+
+    const auto& generic = linalg::LinearAlgebraSparse::getBackend("generic");
+
+    for (auto simd : {LinearAlgebraOptimised::SIMD::None, LinearAlgebraOptimised::SIMD::AVX2,
+                      LinearAlgebraOptimised::SIMD::AVX512}) {
+        const LinearAlgebraOptimised optimised(simd);
+        Log::info() << optimised << std::endl;
+
+        SECTION("spmv") {
+            Vector x(Nj);
+            for (Size j = 0; j < Nj; ++j) {
+                x[j] = std::sin(Scalar(j));
+            }
+
+            Vector y(Ni);
+            Vector z(Ni);
+            generic.spmv(A, x, y);
+            optimised.spmv(A, x, z);
+
+            EXPECT(approximately_equal(z.data(), y.data(), Ni));
+        }
+
+        SECTION("spmm") {
+            for (Size Nk : {1, 3, 8, 13, 16}) {
+                Matrix B(Nj, Nk);
+                for (Size k = 0; k < Nk; ++k) {
+                    for (Size j = 0; j < Nj; ++j) {
+                        B(j, k) = std::cos(Scalar(j + 7 * k));
+                    }
+                }
+
+                Matrix C(Ni, Nk);
+                Matrix D(Ni, Nk);
+                generic.spmm(A, B, C);
+                optimised.spmm(A, B, D);
+
+                EXPECT(approximately_equal(D.data(), C.data(), Ni * Nk));
+            }
+        }
+
+        SECTION("dsptd") {
+            Vector x(Ni);
+            Vector y(Nj);
+            for (Size i = 0; i < Ni; ++i) {
+                x[i] = Scalar(i % 7);
+            }
+            for (Size j = 0; j < Nj; ++j) {
+                y[j] = Scalar(j % 5);
+            }
+
+            SparseMatrix B;
+            SparseMatrix C;
+            generic.dsptd(x, A, y, B);
+            optimised.dsptd(x, A, y, C);
+
+            EXPECT(B.nonZeros() == C.nonZeros());
+            EXPECT(equal_array(B.data(), C.data(), B.nonZeros()));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return eckit::testing::run_tests(argc, argv);
+}
@@ -0,0 +1,179 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/filesystem/PathName.h"
+#include "eckit/log/AsyncTarget.h"
+#include "eckit/log/Channel.h"
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Records the lines written (by the writer thread of the AsyncTargets)
+class RecordingTarget : public LogTarget {
+public:
+
+    explicit RecordingTarget(int delay = 0) : delay_(delay) {}
+
+    void write(const char* start, const char* end) override {
+        if (delay_) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_));
+        }
+        out_.append(start, end);
+    }
+
+    void flush() override { flushes_++; }
+
+    std::vector<std::string> lines() const {
+        std::vector<std::string> result;
+        std::istringstream in(out_);
+        std::string line;
+        while (std::getline(in, line)) {
+            result.push_back(line);
+        }
+        return result;
+    }
+
+    size_t flushes() const { return flushes_; }
+
+private:
+
+    int delay_;
+    std::string out_;
+    size_t flushes_ = 0;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Lines from several threads are written in order") {
+    RecordingTarget* target = new RecordingTarget;
+    target->attach();
+
+    const size_t threads = 4;
+    const size_t lines   = 10000;
+
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; ++t) {
+        writers.emplace_back([target, t] {
+            Channel channel(new AsyncTarget(target, AsyncTarget::Policy::Block));
+            for (size_t i = 0; i < lines; ++i) {
+                channel << t << " " << i << std::string(i % 500, '.') << std::endl;
+            }
+        });
+    }
+    for (auto& w : writers) {
+        w.join();
+    }
+
+    AsyncTarget::drain();
+
+    std::vector<size_t> next(threads, 0);
+    for (const auto& line : target->lines()) {
+        std::istringstream in(line);
+        size_t t, i;
+        in >> t >> i;
+        EXPECT(t < threads);
+        EXPECT(i == next[t]);
+        EXPECT(line.size() == std::to_string(t).size() + 1 + std::to_string(i).size() + i % 500);
+        next[t]++;
+    }
+
+    for (size_t t = 0; t < threads; ++t) {
+        EXPECT(next[t] == lines);
+    }
+    EXPECT(target->flushes() > 0);
+
+    target->detach();
+}
+
+CASE("Lines are dropped when the queue is full") {
+    for (auto policy : {AsyncTarget::Policy::Drop, AsyncTarget::Policy::Sample}) {
+        RecordingTarget* target = new RecordingTarget(20);
+        target->attach();
+
+        const size_t lines = 100000;
+        size_t dropped     = 0;
+        {
+            AsyncTarget async(target, policy);
+            for (size_t i = 0; i < lines; ++i) {
+                std::string line = std::to_string(i) + "\n";
+                async.write(line.data(), line.data() + line.size());
+            }
+            dropped = async.dropped();
+        }
+
+        EXPECT(dropped > 0);
+        EXPECT(target->lines().size() + dropped == lines);
+
+        target->detach();
+    }
+
+    EXPECT(AsyncTarget::droppedLines() > 0);
+}
+
+CASE("Lines not yet written are written to the crash descriptor") {
+    PathName path = PathName::unique("test_log_async");
+
+    pid_t pid = ::fork();
+    ASSERT(pid >= 0);
+
+    if (pid == 0) {
+        int fd = ::open(path.localPath(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ASSERT(fd >= 0);
+        AsyncTarget::writeOnCrash(fd);
+
+        // The target never returns, so that no line is written
+        AsyncTarget* async = new AsyncTarget(new RecordingTarget(3600 * 1000));
+        for (size_t i = 0; i < 1000; ++i) {
+            std::string line = std::to_string(i) + "\n";
+            async->write(line.data(), line.data() + line.size());
+        }
+        std::abort();
+    }
+
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    EXPECT(WIFSIGNALED(status));
+
+    std::ifstream in(path.localPath());
+    std::string line;
+    size_t count = 0;
+    while (std::getline(in, line)) {
+        EXPECT(line == std::to_string(count));
+        count++;
+    }
+    EXPECT(count == 1000);
+
+    path.unlink();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,164 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/log/Profiler.h"
+#include "eckit/parser/JSONParser.h"
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void inner() {
+    ECKIT_PROFILE("inner");
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void outer() {
+    ECKIT_PROFILE("outer");
+    for (size_t i = 0; i < 3; ++i) {
+        inner();
+    }
+}
+
+/// The value reported for a title, in the section of a region
+std::string reported(const std::string& report, const std::string& region, const std::string& title) {
+    std::istringstream in(report);
+    std::string line;
+    bool found = false;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(' ') != std::string::npos && line.substr(line.find_first_not_of(' ')) == region) {
+            found = true;
+        }
+        else if (found && line.find(title) != std::string::npos) {
+            return line.substr(line.find(':') + 1);
+        }
+    }
+    return "";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Nested regions are aggregated") {
+    Profiler::enable();
+    Profiler::reset();
+
+    for (size_t i = 0; i < 2; ++i) {
+        outer();
+    }
+
+    std::ostringstream out;
+    Profiler::report(out);
+    std::string report = out.str();
+
+    EXPECT(report.find("outer\n") != std::string::npos);
+    EXPECT(report.find("  inner\n") != std::string::npos);
+    EXPECT(reported(report, "outer", "Calls").find(" 2") != std::string::npos);
+    EXPECT(reported(report, "inner", "Calls").find(" 6") != std::string::npos);
+
+    Profiler::enable(false);
+}
+
+CASE("Regions are not profiled when the profiler is disabled") {
+    Profiler::enable(false);
+    Profiler::reset();
+
+    outer();
+
+    std::ostringstream out;
+    Profiler::report(out);
+    EXPECT(out.str().find("inner") == std::string::npos);
+}
+
+CASE("Regions of several threads are merged") {
+    Profiler::enable();
+    Profiler::reset();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([] { outer(); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::ostringstream out;
+    Profiler::report(out);
+    std::string report = out.str();
+
+    EXPECT(reported(report, "outer", "Calls").find(" 4") != std::string::npos);
+    EXPECT(reported(report, "inner", "Calls").find(" 12") != std::string::npos);
+
+    // The events of the threads exited are still traced
+
+    std::ostringstream trace;
+    Profiler::trace(trace);
+    EXPECT(JSONParser::decodeString(trace.str())["traceEvents"].size() == 4 * (1 + 3) * 2);
+
+    Profiler::enable(false);
+}
+
+CASE("Regions are traced as Chrome trace events") {
+    Profiler::enable();
+    Profiler::reset();
+
+    {
+        Profiler::Scope scope("open");
+        outer();
+
+        std::ostringstream out;
+        Profiler::trace(out);
+
+        Value trace  = JSONParser::decodeString(out.str());
+        Value events = trace["traceEvents"];
+
+        std::map<std::string, int> open;
+        double last = 0;
+        for (size_t i = 0; i < events.size(); ++i) {
+            Value e          = events[int(i)];
+            std::string name = e["name"];
+            std::string ph   = e["ph"];
+            double ts        = e["ts"];
+
+            EXPECT(ph == "B" || ph == "E");
+            EXPECT(ts >= last);
+            open[name] += ph == "B" ? 1 : -1;
+            EXPECT(open[name] >= 0);
+            last = ts;
+        }
+
+        // The regions still open are closed in the trace
+
+        EXPECT(open.size() == 3);
+        for (const auto& o : open) {
+            EXPECT(o.second == 0);
+        }
+    }
+
+    Profiler::enable(false);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
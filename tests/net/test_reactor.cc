@@ -0,0 +1,349 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/net/NetService.h"
+#include "eckit/net/NetUser.h"
+#include "eckit/net/Reactor.h"
+#include "eckit/net/TCPClient.h"
+#include "eckit/net/TCPServer.h"
+#include "eckit/thread/ThreadControler.h"
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::net;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+/// Wait up to @param seconds for a condition
+template <typename F>
+bool eventually(F f, int seconds = 10) {
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (!f()) {
+        if (std::chrono::steady_clock::now() > end) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+class Pipe {
+public:
+
+    Pipe() { ASSERT(::pipe(fds_) == 0); }
+
+    ~Pipe() {
+        ::close(fds_[0]);
+        ::close(fds_[1]);
+    }
+
+    int in() const { return fds_[0]; }
+
+    void write(const std::string& s) const { ASSERT(::write(fds_[1], s.data(), s.size()) == long(s.size())); }
+
+    char read() const {
+        char c = 0;
+        ASSERT(::read(fds_[0], &c, 1) == 1);
+        return c;
+    }
+
+private:
+
+    int fds_[2];
+};
+
+/// Echoes one line per connection
+class EchoUser : public NetUser {
+public:
+
+    explicit EchoUser(TCPSocket& socket) : NetUser(socket) { users++; }
+
+    ~EchoUser() override { users--; }
+
+    static std::atomic<int> users;
+    static std::atomic<int> served;
+
+private:
+
+    void serve(Stream&, std::istream& in, std::ostream& out) override {
+        std::string line;
+        if (std::getline(in, line)) {
+            out << line << std::endl;
+        }
+        served++;
+    }
+};
+
+std::atomic<int> EchoUser::users{0};
+std::atomic<int> EchoUser::served{0};
+
+class EchoService : public NetService {
+public:
+
+    EchoService() : NetService(0, false) {}
+
+private:
+
+    NetUser* newUser(TCPSocket& socket) const override { return new EchoUser(socket); }
+    std::string name() const override { return "test_reactor"; }
+
+    bool preferToRunInReactor() const override { return true; }
+    long timeout() const override { return 1; }
+    long idleTimeout() const override { return 1; }
+    long readTimeout() const override { return 1; }
+};
+
+/// True if the server closes the connection within a few seconds
+bool closedByPeer(int fd) {
+    pollfd p{fd, POLLIN, 0};
+    char c;
+    return ::poll(&p, 1, 10000) == 1 && ::recv(fd, &c, 1, 0) == 0;
+}
+
+std::string request(int port, const std::string& line) {
+    TCPClient client;
+    TCPSocket& socket = client.connect("localhost", port);
+
+    std::string message = line + "\n";
+    EXPECT(socket.write(message.data(), message.size()) == long(message.size()));
+
+    std::string reply;
+    char c;
+    while (socket.read(&c, 1) == 1 && c != '\n') {
+        reply += c;
+    }
+    return reply;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Descriptors are called back once until rearmed") {
+    if (!Reactor::available()) {
+        return;
+    }
+
+    Reactor reactor("test_reactor", 0);
+    Pipe pipe;
+
+    int calls = 0;
+    reactor.add(pipe.in(), [&] {
+        pipe.read();
+        calls++;
+    });
+    EXPECT(reactor.size() == 1);
+
+    pipe.write("ab");
+
+    EXPECT(reactor.poll(100));
+    EXPECT(calls == 1);
+
+    EXPECT(reactor.poll(100));
+    EXPECT(calls == 1);
+
+    reactor.rearm(pipe.in());
+    EXPECT(reactor.poll(100));
+    EXPECT(calls == 2);
+
+    reactor.remove(pipe.in());
+    EXPECT(reactor.size() == 0);
+
+    reactor.stop();
+    EXPECT(!reactor.poll(100));
+}
+
+CASE("Event-loop threads call back and stop") {
+    if (!Reactor::available()) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<Pipe>> pipes;
+    std::atomic<int> calls{0};
+    {
+        Reactor reactor("test_reactor", 2);
+
+        for (size_t i = 0; i < 16; ++i) {
+            pipes.emplace_back(new Pipe);
+            const Pipe& pipe = *pipes.back();
+            reactor.add(pipe.in(), [&pipe, &calls] {
+                pipe.read();
+                calls++;
+            });
+        }
+
+        for (auto& p : pipes) {
+            p->write("x");
+        }
+
+        EXPECT(eventually([&] { return calls == 16; }));
+
+        // n.b. the destructor stops and joins the threads
+    }
+    EXPECT(calls == 16);
+}
+
+CASE("TCPServer::tryAccept accepts until there is no connection left") {
+    TCPServer server(0);
+    const int port = server.localPort();
+
+    std::vector<std::unique_ptr<TCPClient>> clients;
+    for (size_t i = 0; i < 3; ++i) {
+        clients.emplace_back(new TCPClient);
+        clients.back()->connect("localhost", port);
+    }
+
+    size_t accepted = 0;
+    EXPECT(eventually([&] {
+        while (server.tryAccept()) {
+            TCPSocket socket(server);
+
+            // used for blocking i/o, as with accept()
+            EXPECT((::fcntl(socket.socket(), F_GETFL) & O_NONBLOCK) == 0);
+            accepted++;
+        }
+        return accepted == 3;
+    }));
+
+    EXPECT(!server.tryAccept());
+}
+
+CASE("NetService serves its connections from a reactor") {
+    if (!Reactor::available()) {
+        return;
+    }
+
+    EchoService* service = new EchoService;
+    const int port       = service->port();
+
+    ThreadControler thread(service, false);
+    thread.start();
+
+    SECTION("Requests are handed to the pool") {
+        std::vector<std::thread> clients;
+        std::atomic<int> ok{0};
+        for (size_t i = 0; i < 8; ++i) {
+            clients.emplace_back([port, i, &ok] {
+                std::string line = "hello " + std::to_string(i);
+                if (request(port, line) == line) {
+                    ok++;
+                }
+            });
+        }
+        for (auto& c : clients) {
+            c.join();
+        }
+        EXPECT(ok == 8);
+    }
+
+    SECTION("Connections closed without a request are released") {
+        const int served = EchoUser::served;
+        {
+            TCPClient client;
+            client.connect("localhost", port);
+        }
+        EXPECT(eventually([&] { return EchoUser::served == served + 1; }));
+        EXPECT(request(port, "after") == "after");
+    }
+
+    SECTION("Idle connections are closed") {
+        TCPClient client;
+        TCPSocket& socket = client.connect("localhost", port);
+        EXPECT(closedByPeer(socket.socket()));
+    }
+
+    SECTION("Stalled clients do not starve the pool") {
+        // More than the workers, each sending part of a request and nothing else
+        std::vector<std::unique_ptr<TCPClient>> stalled;
+        for (size_t i = 0; i < 16; ++i) {
+            stalled.emplace_back(new TCPClient);
+            TCPSocket& socket = stalled.back()->connect("localhost", port);
+            EXPECT(socket.write("x", 1) == 1);
+        }
+
+        EXPECT(request(port, "after") == "after");
+
+        for (auto& client : stalled) {
+            EXPECT(closedByPeer(client->socket()));
+        }
+    }
+
+    SECTION("The service keeps accepting after a failed accept") {
+        EXPECT(request(port, "before") == "before");
+
+        const std::string line = "after EMFILE\n";
+
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_port        = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        EXPECT(fd >= 0);
+
+        // No descriptor left for accept()
+        rlimit saved;
+        EXPECT(::getrlimit(RLIMIT_NOFILE, &saved) == 0);
+
+        int next = ::dup(fd);
+        ::close(next);
+
+        rlimit limit = saved;
+        limit.rlim_cur = next;
+        EXPECT(::setrlimit(RLIMIT_NOFILE, &limit) == 0);
+
+        EXPECT(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        EXPECT(::setrlimit(RLIMIT_NOFILE, &saved) == 0);
+
+        EXPECT(::write(fd, line.data(), line.size()) == long(line.size()));
+
+        std::string reply;
+        char c;
+        while (::read(fd, &c, 1) == 1) {
+            reply += c;
+        }
+        ::close(fd);
+
+        EXPECT(reply == line);
+    }
+
+    thread.stop();
+    thread.wait();
+
+    EXPECT(eventually([] { return EchoUser::users == 0; }));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,147 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "eckit/io/MemoryHandle.h"
+#include "eckit/io/StatsHandle.h"
+#include "eckit/log/JSON.h"
+#include "eckit/parser/JSONParser.h"
+#include "eckit/runtime/Metrics.h"
+#include "eckit/runtime/MetricsRegistry.h"
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+Value snapshot() {
+    std::ostringstream out;
+    JSON j(out);
+    j.startObject();
+    MetricsRegistry::json(j);
+    j.endObject();
+    return JSONParser::decodeString(out.str());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("Counters are summed over the threads") {
+    auto& counter = MetricsRegistry::counter("test.counter");
+    EXPECT(&counter == &MetricsRegistry::counter("test.counter"));
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 8; ++t) {
+        threads.emplace_back([&counter] {
+            for (size_t i = 0; i < 100000; ++i) {
+                counter.add();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT(counter.value() == 800000);
+    EXPECT(uint64_t(snapshot()["counters"]["test.counter"]) == 800000);
+}
+
+CASE("Gauges are set") {
+    auto& gauge = MetricsRegistry::gauge("test.gauge");
+    gauge.set(10);
+    gauge.add(-15);
+    EXPECT(gauge.value() == -5);
+    EXPECT(long(snapshot()["gauges"]["test.gauge"]) == -5);
+}
+
+CASE("Histograms give percentiles within 1/16") {
+    auto& histogram = MetricsRegistry::histogram("test.histogram");
+    EXPECT(histogram.percentile(0.5) == 0);
+
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        histogram.record(v);
+    }
+
+    EXPECT(histogram.count() == 100000);
+    EXPECT(histogram.min() == 1);
+    EXPECT(histogram.max() == 100000);
+    EXPECT(histogram.sum() == uint64_t(100000) * 100001 / 2);
+
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        double expected = q * 100000;
+        double actual   = histogram.percentile(q);
+        EXPECT(actual >= expected);
+        EXPECT(actual <= expected * (1 + 1. / 16));
+    }
+    EXPECT(histogram.percentile(1) == 100000);
+
+    // Small values are exact
+
+    auto& small = MetricsRegistry::histogram("test.small");
+    for (uint64_t v = 0; v < 16; ++v) {
+        small.record(v);
+    }
+    EXPECT(small.percentile(0.5) == 7);
+    EXPECT(small.min() == 0);
+
+    Value h = snapshot()["histograms"]["test.histogram"];
+    EXPECT(uint64_t(h["count"]) == 100000);
+    EXPECT(uint64_t(h["p50"]) == histogram.percentile(0.5));
+}
+
+CASE("StatsHandle records its reads and writes") {
+    auto& reads  = MetricsRegistry::counter("io.stats.reads");
+    auto& bytes  = MetricsRegistry::counter("io.stats.read_bytes");
+    auto& writes = MetricsRegistry::counter("io.stats.writes");
+
+    const uint64_t readsBefore  = reads.value();
+    const uint64_t bytesBefore  = bytes.value();
+    const uint64_t writesBefore = writes.value();
+
+    std::string data(1000, 'x');
+    {
+        StatsHandle h(new MemoryHandle(data.data(), data.size()));
+        h.openForRead();
+        char buffer[300];
+        while (h.read(buffer, sizeof(buffer)) > 0) {
+        }
+        h.close();
+    }
+
+    EXPECT(reads.value() - readsBefore == 5);
+    EXPECT(bytes.value() - bytesBefore == 1000);
+    EXPECT(writes.value() == writesBefore);
+    EXPECT(MetricsRegistry::histogram("io.stats.read_size").max() == 300);
+}
+
+CASE("Metrics are collected") {
+    MetricsRegistry::counter("test.collected").add(42);
+
+    CollectMetrics metrics;
+    MetricsRegistry::collect();
+
+    std::ostringstream out;
+    out << metrics;
+    EXPECT(out.str().find("\"collected\":42") != std::string::npos);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,183 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "eckit/log/Timer.h"
+#include "eckit/sql/SQLColumn.h"
+#include "eckit/sql/SQLDatabase.h"
+#include "eckit/sql/SQLOutput.h"
+#include "eckit/sql/SQLParser.h"
+#include "eckit/sql/SQLSelect.h"
+#include "eckit/sql/SQLSession.h"
+#include "eckit/sql/SQLStatement.h"
+#include "eckit/sql/SQLTable.h"
+#include "eckit/sql/expression/SQLExpressions.h"
+#include "eckit/sql/type/SQLBitfield.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define NROWS 2000000
+
+/// A table of observations, as filtered by typical ODB queries
+
+class ObservationTable : public sql::SQLTable {
+public:
+
+    ObservationTable(sql::SQLDatabase& db) : SQLTable(db, "observations", "obs") {
+        std::vector<std::string> names = {"active", "passive", "rejected", "blacklisted"};
+        std::vector<int32_t> sizes     = {1, 1, 1, 1};
+        std::string status             = sql::type::SQLBitfield::make("Bitfield", names, sizes, "status_t");
+
+        addColumn("obstype", 0, sql::type::SQLType::lookup("integer"), false, 0);
+        addColumn("varno", 1, sql::type::SQLType::lookup("integer"), false, 0);
+        addColumn("lat", 2, sql::type::SQLType::lookup("real"), false, 0);
+        addColumn("lon", 3, sql::type::SQLType::lookup("real"), false, 0);
+        addColumn("obsvalue", 4, sql::type::SQLType::lookup("real"), false, 0);
+        addColumn("status", 5, sql::type::SQLType::lookup(status), false, 0, true, std::make_pair(names, sizes));
+    }
+
+private:
+
+    class Iterator : public sql::SQLTableIterator {
+    public:
+
+        Iterator(const std::vector<std::reference_wrapper<const sql::SQLColumn>>& columns) : row_(0), data_(6) {
+            for (const auto& col : columns) {
+                offsets_.push_back(col.get().index());
+            }
+        }
+
+    private:
+
+        void rewind() override { row_ = 0; }
+
+        bool next() override {
+            if (row_ == NROWS) {
+                return false;
+            }
+
+            // Deterministic, but not ordered
+            size_t x = (row_ * 2654435761UL) % 1000003;
+            data_[0] = 1 + x % 10;
+            data_[1] = 1 + (x / 10) % 40;
+            data_[2] = -90 + (x % 18000) / 100.;
+            data_[3] = (x % 36000) / 100.;
+            data_[4] = 250 + (x % 5000) / 100.;
+            data_[5] = (x / 7) % 16;
+
+            row_++;
+            return true;
+        }
+
+        std::vector<size_t> columnOffsets() const override { return offsets_; }
+        std::vector<size_t> doublesDataSizes() const override { return std::vector<size_t>(offsets_.size(), 1); }
+        std::vector<char> columnsHaveMissing() const override { return std::vector<char>(offsets_.size(), false); }
+        std::vector<double> missingValues() const override { return std::vector<double>(offsets_.size(), 0); }
+        const double* data() const override { return data_.data(); }
+
+        size_t row_;
+        std::vector<size_t> offsets_;
+        std::vector<double> data_;
+    };
+
+    sql::SQLTableIterator* iterator(const std::vector<std::reference_wrapper<const sql::SQLColumn>>& columns,
+                                    std::function<void(sql::SQLTableIterator&)> callback) const override {
+        Iterator* it = new Iterator(columns);
+        callback(*it);
+        return it;
+    }
+};
+
+
+/// Counts the rows selected
+
+class CountOutput : public sql::SQLOutput {
+public:
+
+    unsigned long long rows = 0;
+
+private:
+
+    void cleanup(sql::SQLSelect&) override {}
+    void reset() override { rows = 0; }
+    void flush() override {}
+    bool output(const sql::expression::Expressions&) override { return ++rows; }
+    void prepare(sql::SQLSelect&) override {}
+    void outputReal(double, bool) override {}
+    void outputDouble(double, bool) override {}
+    void outputInt(double, bool) override {}
+    void outputUnsignedInt(double, bool) override {}
+    void outputString(const char*, size_t, bool) override {}
+    void outputBitfield(double, bool) override {}
+    unsigned long long count() override { return rows; }
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("benchmark_where") {
+    sql::SQLSession session(std::unique_ptr<CountOutput>(new CountOutput));
+    session.currentDatabase().addTable(new ObservationTable(session.currentDatabase()));
+
+    CountOutput& output(static_cast<CountOutput&>(session.output()));
+
+    std::vector<std::string> queries = {
+        "select lat,lon,obsvalue from obs where obstype = 2 and varno in (1, 2, 3, 29, 39) and lat > 30 and lat < 60",
+        "select obsvalue from obs where status.active = 1 and status.rejected = 0 and (varno = 2 or varno = 39)",
+        "select lat,lon from obs where abs(lat) < 90 - 60 and lon between 0 and 180 and obsvalue * 2 > 550",
+        "select count(*) from obs where (obstype = 1 or obstype = 5 or obstype = 7) and not status.blacklisted = 1",
+    };
+
+    // Rows are evaluated one by one, walking the expression trees or running the compiled programs
+
+    ::setenv("ECKIT_SQL_BLOCK_SIZE", "0", 1);
+
+    for (const auto& sql : queries) {
+        std::cout << "-------------------------------------------------------------" << std::endl;
+        std::cout << sql << std::endl;
+
+        unsigned long long rows = 0;
+        for (const auto* compile : {"0", "1"}) {
+            ::setenv("ECKIT_SQL_COMPILE", compile, 1);
+
+            sql::SQLParser::parseString(session, sql);
+            {
+                Timer timer(std::string(compile[0] == '1' ? "compiled" : "tree"));
+                session.statement().execute();
+            }
+
+            if (compile[0] == '0') {
+                rows = output.rows;
+            }
+            EXPECT(output.rows == rows);
+        }
+    }
+
+    ::unsetenv("ECKIT_SQL_COMPILE");
+    ::unsetenv("ECKIT_SQL_BLOCK_SIZE");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -8,6 +8,8 @@
  * does it submit to any jurisdiction.
  */
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 
 #include "eckit/sql/SQLColumn.h"
@@ -102,6 +104,12 @@ private:
                 updateCallback_(*this);
             }
 
+            // Refresh midway (with the same layout), so we can test this happening while fetching blocks of rows
+
+            if (idx_ == 5) {
+                updateCallback_(*this);
+            }
+
             if (idx_ < INTEGER_DATA.size()) {
                 copyRow();
                 idx_++;
@@ -206,6 +214,89 @@ public:  // visible members
 
 //----------------------------------------------------------------------------------------------------------------------
 
+/// Values taken by environment variables, in turn
+using Variables = std::vector<std::pair<std::string, std::vector<std::string>>>;
+
+/// Environment variables set for the lifetime of the object, unset on destruction (including when a test fails)
+class ScopedEnvironment {
+public:
+
+    ScopedEnvironment() = default;
+
+    ScopedEnvironment(const ScopedEnvironment&)            = delete;
+    ScopedEnvironment& operator=(const ScopedEnvironment&) = delete;
+
+    ~ScopedEnvironment() {
+        for (const auto& name : names_) {
+            ::unsetenv(name.c_str());
+        }
+    }
+
+    void set(const std::string& name, const std::string& value) {
+        ::setenv(name.c_str(), value.c_str(), 1);
+        if (std::find(names_.begin(), names_.end(), name) == names_.end()) {
+            names_.push_back(name);
+        }
+    }
+
+private:
+
+    std::vector<std::string> names_;
+};
+
+/// Checks that the queries give the same results under every combination of the values of the variables as under
+/// their first values. Real results are compared within a relative tolerance, if any.
+void expectSameResults(const std::vector<std::string>& queries, const Variables& variables, double tolerance = 0) {
+
+    eckit::sql::SQLSession session(std::unique_ptr<TestOutput>(new TestOutput));
+    eckit::sql::SQLDatabase& db(session.currentDatabase());
+
+    db.addTable(new TestTable(db, "a/b/c.path", "table1"));
+
+    TestOutput& o(static_cast<TestOutput&>(session.output()));
+
+    ScopedEnvironment environment;
+
+    for (const auto& sql : queries) {
+        std::vector<long> intOutput;
+        std::vector<double> floatOutput;
+        std::vector<std::string> strOutput;
+
+        // Odometer over the values, the last variable changing fastest
+        std::vector<size_t> index(variables.size(), 0);
+        for (bool first = true;; first = false) {
+            for (size_t v = 0; v < variables.size(); ++v) {
+                environment.set(variables[v].first, variables[v].second[index[v]]);
+            }
+
+            eckit::sql::SQLParser::parseString(session, sql);
+            session.statement().execute();
+
+            if (first) {
+                intOutput   = o.intOutput;
+                floatOutput = o.floatOutput;
+                strOutput   = o.strOutput;
+            }
+            else {
+                EXPECT(o.intOutput == intOutput);
+                EXPECT(tolerance > 0 ? eckit::testing::is_approximately_equal(o.floatOutput, floatOutput, tolerance)
+                                     : o.floatOutput == floatOutput);
+                EXPECT(o.strOutput == strOutput);
+            }
+
+            size_t v = variables.size();
+            while (v > 0 && ++index[v - 1] == variables[v - 1].second.size()) {
+                index[--v] = 0;
+            }
+            if (v == 0) {
+                break;
+            }
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 // TODO: Test explicit vs implicit table
 // TODO: Test if database has a table
 
@@ -497,6 +588,89 @@ CASE("Test with implicit tables") {
 }
 
 
+CASE("Test select a block of rows at a time") {
+
+    // The results are the same evaluating blocks of rows (of different sizes) as one row at a time (size 0)
+
+    expectSameResults(
+        {
+            "select icol,rcol from table1 where icol > 4000 and rcol < 80",
+            "select rcol from table1 where icol = 6666 or rcol * 2 >= 150",
+            "select icol from table1 where icol in (1111, 6666, 9999)",
+            "select icol,rcol - 1 from table1 where not icol between 3000 and 8000",
+            "select rcol from table1 where scol = 'cccc' and bfcolumn.bf2 < 2",
+            "select bfcolumn.bf1,icol from table1 where bfcolumn.bf3 = 1",
+            "select rownumber(),icol from table1 where rcol > 50",
+            "select icol from table1 where rownumber() > 3",
+            "select count(*),sum(rcol),min(icol),max(icol),avg(rcol) from table1 where icol <> 6666",
+            "select count(icol),max(rcol) from table1 where icol < 0",
+            "select distinct icol from table1 where rcol > 20 order by icol",
+            "select icol,max(rcol) from table1 where icol > 2000",
+        },
+        {{"ECKIT_SQL_BLOCK_SIZE", {"0", "1", "4", "1024"}}});
+}
+
+
+CASE("Test order by spilling sorted runs") {
+
+    // The results are the same sorting in memory as merging runs spilled to temporary files (one row per run)
+
+    expectSameResults(
+        {
+            "select icol,rcol from table1 order by icol DESC",
+            "select icol,scol from table1 order by rcol, icol DESC",
+            "select scol,icol from table1 order by scol DESC, rcol",
+            "select rownumber(),icol from table1 order by icol",
+            "select distinct rcol,scol from table1 order by scol DESC, icol ASC",
+            "select bfcolumn.bf1,bfcolumn.bf2,icol from table1 order by 2 DESC, 1",
+        },
+        {{"ECKIT_SQL_SORT_MEMORY", {"1073741824", "1"}}});
+}
+
+
+CASE("Test select with several threads") {
+
+    // The results are the same filtering and aggregating the blocks of a batch concurrently as in one thread
+    // n.b. partial sums are accumulated in a different order
+
+    expectSameResults(
+        {
+            "select icol,rcol from table1 where icol > 4000 and rcol < 80",
+            "select icol from table1 where icol in (1111, 6666, 9999) or bfcolumn.bf3 = 1",
+            "select rcol from table1 where scol = 'cccc'",
+            "select count(*),sum(rcol),min(icol),max(icol),avg(rcol) from table1 where icol <> 6666",
+            "select var(icol),stdev(icol),rms(rcol) from table1 where rcol > 20",
+            "select count(icol),max(rcol) from table1 where icol < 0",
+            "select bfcolumn.bf3,count(*),min(icol),max(rcol) from table1",
+            "select rcol > 50,bfcolumn.bf1,sum(icol),avg(rcol) from table1 where icol > 2000",
+            "select distinct bfcolumn.bf3 from table1 where rcol > 20",
+        },
+        {{"ECKIT_SQL_THREADS", {"1", "2", "4"}}, {"ECKIT_SQL_BLOCK_SIZE", {"1", "4"}}}, 1e-9);
+}
+
+
+CASE("Test select with compiled conditions") {
+
+    // The results are the same evaluating the conditions (one row at a time) as programs as walking the expressions
+
+    expectSameResults(
+        {
+            "select icol,rcol from table1 where icol > 4000 and rcol < 80 and icol <> 6666",
+            "select rcol from table1 where icol = 6666 or rcol * 2 >= 150 or icol < 1200",
+            "select icol from table1 where (icol > 5000 or rcol < 20) and not (icol > 8000 and rcol > 90)",
+            "select icol from table1 where icol in (1111, 6666, 9999) and icol * 0 = 0",
+            "select icol from table1 where icol in (1000 + 111, rcol, 9999)",
+            "select icol,rcol - 1 from table1 where not icol between 3000 and 8000",
+            "select rcol from table1 where abs(rcol - 50) < 2 * 10 + 5",
+            "select rcol from table1 where scol = 'cccc' and bfcolumn.bf2 < 2",
+            "select bfcolumn.bf1,icol from table1 where bfcolumn.bf3 = 1 and bfcolumn.bf1 = 1",
+            "select icol from table1 where rownumber() > 3 and icol < 9000",
+            "select count(*),sum(rcol) from table1 where icol <> 6666 or 1 = 0",
+        },
+        {{"ECKIT_SQL_BLOCK_SIZE", {"0"}}, {"ECKIT_SQL_COMPILE", {"0", "1"}}});
+}
+
+
 //----------------------------------------------------------------------------------------------------------------------
 
 }  // namespace
@@ -0,0 +1,87 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <atomic>
+#include <cmath>
+#include <iostream>
+
+#include "eckit/log/Timer.h"
+#include "eckit/thread/ThreadPool.h"
+#include "eckit/thread/WorkStealingPool.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define NTASKS 200000
+#define WORK 64
+
+std::atomic<double> sink{0};
+
+/// Fine-grained task: a few hundred nanoseconds of arithmetic
+class Work : public ThreadPoolTask {
+public:
+
+    explicit Work(size_t seed) : seed_(seed) {}
+
+private:
+
+    size_t seed_;
+
+    void execute() override {
+        double x = 0;
+        for (size_t i = 0; i < WORK; ++i) {
+            x += std::sqrt(static_cast<double>(seed_ + i));
+        }
+        sink.store(x, std::memory_order_relaxed);
+    }
+};
+
+
+template <typename POOL>
+void benchmark(const std::string& name, size_t threads) {
+    POOL pool(name, threads);
+
+    Timer timer(name + " " + std::to_string(threads) + " threads");
+    for (size_t i = 0; i < NTASKS; ++i) {
+        pool.push(new Work(i));
+    }
+    pool.wait();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("benchmark_threadpool") {
+    for (size_t threads : {1, 4, 16}) {
+        std::cout << "-------------------------------------------------------------" << std::endl;
+        benchmark<ThreadPool>("ThreadPool", threads);
+        benchmark<WorkStealingPool>("WorkStealingPool", threads);
+
+        WorkStealingPool pool("WorkStealingPool::submit", threads);
+        Timer timer(pool.name() + " " + std::to_string(threads) + " threads");
+        for (size_t i = 0; i < NTASKS; ++i) {
+            pool.submit([i] { return std::sqrt(static_cast<double>(i)); });
+        }
+        pool.wait();
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}
@@ -0,0 +1,163 @@
+/*
+ * (C) Copyright 1996- ECMWF.
+ *
+ * This software is licensed under the terms of the Apache Licence Version 2.0
+ * which can be obtained at http://www.apache.org/licenses/LICENSE-2.0.
+ * In applying this licence, ECMWF does not waive the privileges and immunities
+ * granted to it by virtue of its status as an intergovernmental organisation nor
+ * does it submit to any jurisdiction.
+ */
+
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include "eckit/exception/Exceptions.h"
+#include "eckit/thread/WorkStealingPool.h"
+
+#include "eckit/testing/Test.h"
+
+using namespace eckit;
+using namespace eckit::testing;
+
+namespace eckit::test {
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class Counter : public ThreadPoolTask {
+public:
+
+    explicit Counter(std::atomic<size_t>& count) : count_(count) {}
+
+private:
+
+    std::atomic<size_t>& count_;
+    void execute() override { count_++; }
+};
+
+
+class Failure : public ThreadPoolTask {
+    void execute() override { throw UserError("Failure::execute"); }
+};
+
+
+long fibonacci(WorkStealingPool& pool, long n) {
+    if (n < 2) {
+        return n;
+    }
+    auto a = pool.submit([&pool, n] { return fibonacci(pool, n - 1); });
+    long b = fibonacci(pool, n - 2);
+    return a.get() + b;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+CASE("push and wait, as ThreadPool") {
+    std::atomic<size_t> count{0};
+
+    WorkStealingPool pool("test", 4);
+    EXPECT(pool.size() == 4);
+
+    for (size_t i = 0; i < 1000; ++i) {
+        pool.push(new Counter(count));
+    }
+
+    std::list<ThreadPoolTask*> tasks;
+    for (size_t i = 0; i < 1000; ++i) {
+        tasks.push_back(new Counter(count));
+    }
+    pool.push(tasks);
+    EXPECT(tasks.empty());
+
+    pool.wait();
+    EXPECT(pool.done());
+    EXPECT(count == 2000);
+}
+
+CASE("task errors are reported by wait") {
+    std::atomic<size_t> count{0};
+
+    WorkStealingPool pool("test", 2);
+    pool.push(new Counter(count));
+    pool.push(new Failure);
+    pool.push(new Counter(count));
+
+    EXPECT_THROWS_AS(pool.wait(), SeriousBug);
+    EXPECT(count == 2);
+
+    // error is cleared
+    EXPECT_NO_THROW(pool.wait());
+}
+
+CASE("futures") {
+    WorkStealingPool pool("test", 3);
+
+    std::vector<TaskFuture<size_t>> futures;
+    for (size_t i = 0; i < 100; ++i) {
+        futures.push_back(pool.submit([i] { return i * i; }));
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        EXPECT(futures[i].get() == i * i);
+        EXPECT(futures[i].ready());
+    }
+
+    auto v = pool.submit([] {});
+    EXPECT_NO_THROW(v.get());
+
+    auto e = pool.submit([]() -> int { throw UserError("submit"); });
+    EXPECT_THROWS_AS(e.get(), UserError);
+    EXPECT_NO_THROW(pool.wait());
+}
+
+CASE("continuations") {
+    WorkStealingPool pool("test", 2);
+
+    auto f = pool.submit([] { return 20; }).then([](int x) { return x + 1; }).then([](int x) { return 2. * x; });
+    EXPECT(f.get() == 42.);
+
+    std::atomic<bool> flag{false};
+    auto g = pool.submit([] {}).then([&flag] { flag = true; });
+    g.wait();
+    EXPECT(flag);
+
+    // Errors propagate along the chain, skipping the continuations
+    std::atomic<bool> called{false};
+    auto h = pool.submit([]() -> int { throw UserError("chain"); }).then([&called](int x) {
+        called = true;
+        return x;
+    });
+    EXPECT_THROWS_AS(h.get(), UserError);
+    EXPECT(!called);
+}
+
+CASE("nested tasks waiting on their children") {
+    WorkStealingPool pool("test", 2);
+    EXPECT(pool.submit([&pool] { return fibonacci(pool, 18); }).get() == 2584);
+    EXPECT(WorkStealingPool::current() == nullptr);
+}
+
+CASE("pinned workers") {
+    for (auto affinity : {WorkStealingPool::Affinity::Compact, WorkStealingPool::Affinity::Spread}) {
+        WorkStealingPool pool("test", 2, 0, affinity);
+
+        std::vector<TaskFuture<size_t>> futures;
+        for (size_t i = 0; i < 10; ++i) {
+            futures.push_back(pool.submit([i] { return i; }));
+        }
+
+        size_t sum = 0;
+        for (auto& f : futures) {
+            sum += f.get();
+        }
+        EXPECT(sum == 45);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+}  // namespace eckit::test
+
+int main(int argc, char** argv) {
+    return run_tests(argc, argv);
+}